@@ -211,8 +211,10 @@ bool AbstractCommand::execute()
                          getCuid()));
         // Request::isPipeliningEnabled() == true means aria2
         // accessed the remote server and discovered that the server
-        // supports pipelining.
-        if (req_ && req_->isPipeliningEnabled()) {
+        // supports pipelining.  The socket is pooled only when no
+        // response to a pipelined request is still to arrive.
+        if (req_ && req_->isPipeliningEnabled() && socket_ &&
+            isSocketIdle()) {
           e_->poolSocket(req_, createProxyRequest(), socket_);
         }
         return prepareForRetry(0);
@@ -930,7 +932,7 @@ const std::shared_ptr<PieceStorage>& AbstractCommand::getPieceStorage() const
 void AbstractCommand::checkSocketRecvBuffer()
 {
   if (socketRecvBuffer_->bufferEmpty() &&
-      socket_->getRecvBufferedLength() == 0) {
+      (!socket_ || socket_->getRecvBufferedLength() == 0)) {
     return;
   }
 
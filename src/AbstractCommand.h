@@ -223,6 +223,11 @@ protected:
   // executeInternal() unconditionally
   virtual bool noCheck() const { return false; }
 
+  // Returns true if no request is in flight on the socket, and thus
+  // it can be pooled for reuse when this command has no segment to
+  // download.
+  virtual bool isSocketIdle() const { return false; }
+
 public:
   AbstractCommand(
       cuid_t cuid, const std::shared_ptr<Request>& req,
@@ -53,6 +53,8 @@
 #include "DownloadFailureException.h"
 #include "error_code.h"
 #include "LogFactory.h"
+#include "WorkerThreadPool.h"
+#include "SharedFileDescriptor.h"
 
 namespace aria2 {
 
@@ -67,7 +69,10 @@ AbstractDiskWriter::AbstractDiskWriter(const std::string& filename)
       enableMmap_(false),
       mapaddr_(nullptr),
       maplen_(0)
-
+#ifdef A2_ASYNC_DISK_WRITE
+      ,
+      numAsyncWrite_(0)
+#endif // A2_ASYNC_DISK_WRITE
 {
 }
 
@@ -130,6 +135,9 @@ void AbstractDiskWriter::openFile(int64_t totalLength)
 
 void AbstractDiskWriter::closeFile()
 {
+#ifdef A2_ASYNC_DISK_WRITE
+  waitForAsyncWrite();
+#endif // A2_ASYNC_DISK_WRITE
 #if defined(HAVE_MMAP) || defined(__MINGW32__)
   if (mapaddr_) {
     int errNum = 0;
@@ -156,6 +164,9 @@ void AbstractDiskWriter::closeFile()
     maplen_ = 0;
   }
 #endif // HAVE_MMAP || defined __MINGW32__
+  // The uploads in progress keep the descriptor open.  The next
+  // upload after the file is opened again gets a new one.
+  sharedFd_.reset();
   if (fd_ != A2_BAD_FD) {
 #ifdef __MINGW32__
     CloseHandle(fd_);
@@ -263,7 +274,9 @@ ssize_t AbstractDiskWriter::writeDataInternal(const unsigned char* data,
   }
   else {
     ssize_t writtenLength = 0;
+#if defined(__MINGW32__) || !defined(HAVE_PWRITE)
     seek(offset);
+#endif // defined(__MINGW32__) || !defined(HAVE_PWRITE)
     while ((size_t)writtenLength < len) {
 #ifdef __MINGW32__
       DWORD nwrite;
@@ -276,13 +289,26 @@ ssize_t AbstractDiskWriter::writeDataInternal(const unsigned char* data,
       }
 #else  // !__MINGW32__
       ssize_t ret = 0;
+#  ifdef HAVE_PWRITE
+      while ((ret = a2pwrite(fd_, data + writtenLength, len - writtenLength,
+                             offset + writtenLength)) == -1 &&
+             errno == EINTR)
+        ;
+#  else  // !HAVE_PWRITE
       while ((ret = write(fd_, data + writtenLength, len - writtenLength)) ==
                  -1 &&
              errno == EINTR)
         ;
+#  endif // !HAVE_PWRITE
       if (ret == -1) {
         return -1;
       }
+      if (ret == 0) {
+        // No progress is made.  Treat this as disk full instead of
+        // retrying forever.
+        errno = ENOSPC;
+        return -1;
+      }
       writtenLength += ret;
 #endif // !__MINGW32__
     }
@@ -302,7 +328,9 @@ ssize_t AbstractDiskWriter::readDataInternal(unsigned char* data, size_t len,
     return readlen;
   }
   else {
+#if defined(__MINGW32__) || !defined(HAVE_PREAD)
     seek(offset);
+#endif // defined(__MINGW32__) || !defined(HAVE_PREAD)
 #ifdef __MINGW32__
     DWORD nread;
     if (ReadFile(fd_, data, len, &nread, 0)) {
@@ -313,13 +341,60 @@ ssize_t AbstractDiskWriter::readDataInternal(unsigned char* data, size_t len,
     }
 #else  // !__MINGW32__
     ssize_t ret = 0;
+#  ifdef HAVE_PREAD
+    while ((ret = a2pread(fd_, data, len, offset)) == -1 && errno == EINTR)
+      ;
+#  else  // !HAVE_PREAD
     while ((ret = read(fd_, data, len)) == -1 && errno == EINTR)
       ;
+#  endif // !HAVE_PREAD
     return ret;
 #endif // !__MINGW32__
   }
 }
 
+#if !defined(__MINGW32__) && defined(HAVE_PWRITEV)
+ssize_t AbstractDiskWriter::writeDataVInternal(a2iovec* iov, size_t iovcnt,
+                                               int64_t offset)
+{
+  ssize_t writtenLength = 0;
+  while (iovcnt > 0) {
+    if (iov->iov_len == 0) {
+      ++iov;
+      --iovcnt;
+      continue;
+    }
+    ssize_t ret = 0;
+    while ((ret = a2pwritev(fd_, iov,
+                            std::min(iovcnt, static_cast<size_t>(A2_IOV_MAX)),
+                            offset)) == -1 &&
+           errno == EINTR)
+      ;
+    if (ret == -1) {
+      return -1;
+    }
+    if (ret == 0) {
+      // No progress is made.  Treat this as disk full instead of
+      // retrying forever.
+      errno = ENOSPC;
+      return -1;
+    }
+    writtenLength += ret;
+    offset += ret;
+    for (; iovcnt > 0 && static_cast<size_t>(ret) >= iov->iov_len;
+         ++iov, --iovcnt) {
+      ret -= iov->iov_len;
+    }
+    if (ret > 0) {
+      // Short write.  Resume from the middle of this buffer.
+      iov->iov_base = reinterpret_cast<char*>(iov->iov_base) + ret;
+      iov->iov_len -= ret;
+    }
+  }
+  return writtenLength;
+}
+#endif // !defined(__MINGW32__) && defined(HAVE_PWRITEV)
+
 void AbstractDiskWriter::seek(int64_t offset)
 {
   assert(offset >= 0);
@@ -441,28 +516,91 @@ bool isDiskFullError(int errNum)
 }
 } // namespace
 
+void AbstractDiskWriter::throwOnWriteError()
+{
+  int errNum = fileError();
+  // If the error indicates disk full situation, throw
+  // DownloadFailureException and abort download instantly.
+  if (isDiskFullError(errNum)) {
+    throw DOWNLOAD_FAILURE_EXCEPTION3(
+        errNum,
+        fmt(EX_FILE_WRITE, filename_.c_str(), fileStrerror(errNum).c_str()),
+        error_code::NOT_ENOUGH_DISK_SPACE);
+  }
+  else {
+    throw DL_ABORT_EX3(
+        errNum,
+        fmt(EX_FILE_WRITE, filename_.c_str(), fileStrerror(errNum).c_str()),
+        error_code::FILE_IO_ERROR);
+  }
+}
+
 void AbstractDiskWriter::writeData(const unsigned char* data, size_t len,
                                    int64_t offset)
 {
   ensureMmapWrite(len, offset);
   if (writeDataInternal(data, len, offset) < 0) {
-    int errNum = fileError();
-    // If the error indicates disk full situation, throw
-    // DownloadFailureException and abort download instantly.
-    if (isDiskFullError(errNum)) {
-      throw DOWNLOAD_FAILURE_EXCEPTION3(
-          errNum,
-          fmt(EX_FILE_WRITE, filename_.c_str(), fileStrerror(errNum).c_str()),
-          error_code::NOT_ENOUGH_DISK_SPACE);
+    throwOnWriteError();
+  }
+}
+
+void AbstractDiskWriter::writeDataV(a2iovec* iov, size_t iovcnt,
+                                    int64_t offset)
+{
+#if !defined(__MINGW32__) && defined(HAVE_PWRITEV)
+  size_t len = 0;
+  for (size_t i = 0; i < iovcnt; ++i) {
+    len += iov[i].iov_len;
+  }
+  ensureMmapWrite(len, offset);
+  if (!mapaddr_) {
+    if (writeDataVInternal(iov, iovcnt, offset) < 0) {
+      throwOnWriteError();
     }
-    else {
-      throw DL_ABORT_EX3(
-          errNum,
-          fmt(EX_FILE_WRITE, filename_.c_str(), fileStrerror(errNum).c_str()),
-          error_code::FILE_IO_ERROR);
+    return;
+  }
+#endif // !defined(__MINGW32__) && defined(HAVE_PWRITEV)
+  DiskWriter::writeDataV(iov, iovcnt, offset);
+}
+
+void AbstractDiskWriter::writeDataVAsync(
+    WorkerThreadPool* pool, std::vector<a2iovec> iov, int64_t offset,
+    std::function<void(const RecoverableException*)> done)
+{
+#ifdef A2_ASYNC_DISK_WRITE
+  // mmap'ed region may be remapped by the main thread.
+  if (!enableMmap_) {
+    {
+      std::lock_guard<std::mutex> lock(asyncWriteMutex_);
+      ++numAsyncWrite_;
     }
+    pool->submit([this, iov, offset, done]() mutable {
+      try {
+        writeDataV(iov.data(), iov.size(), offset);
+        done(nullptr);
+      }
+      catch (RecoverableException& e) {
+        done(&e);
+      }
+      // Notify while holding the lock; this object may be destroyed
+      // as soon as closeFile() returns.
+      std::lock_guard<std::mutex> lock(asyncWriteMutex_);
+      --numAsyncWrite_;
+      asyncWriteCond_.notify_all();
+    });
+    return;
   }
+#endif // A2_ASYNC_DISK_WRITE
+  DiskWriter::writeDataVAsync(pool, std::move(iov), offset, std::move(done));
+}
+
+#ifdef A2_ASYNC_DISK_WRITE
+void AbstractDiskWriter::waitForAsyncWrite()
+{
+  std::unique_lock<std::mutex> lock(asyncWriteMutex_);
+  asyncWriteCond_.wait(lock, [this]() { return numAsyncWrite_ == 0; });
 }
+#endif // A2_ASYNC_DISK_WRITE
 
 ssize_t AbstractDiskWriter::readData(unsigned char* data, size_t len,
                                      int64_t offset)
@@ -590,6 +728,15 @@ void AbstractDiskWriter::dropCache(int64_t len, int64_t offset)
 #endif // HAVE_POSIX_FADVISE
 }
 
+void AbstractDiskWriter::prefetch(int64_t len, int64_t offset)
+{
+#ifdef HAVE_POSIX_FADVISE
+  if (fd_ != A2_BAD_FD && !mapaddr_) {
+    posix_fadvise(fd_, offset, len, POSIX_FADV_WILLNEED);
+  }
+#endif // HAVE_POSIX_FADVISE
+}
+
 void AbstractDiskWriter::flushOSBuffers()
 {
   if (fd_ == A2_BAD_FD) {
@@ -602,4 +749,20 @@ void AbstractDiskWriter::flushOSBuffers()
 #endif // __MINGW32__
 }
 
+std::shared_ptr<SharedFileDescriptor> AbstractDiskWriter::shareFileDescriptor(
+    const std::shared_ptr<OpenedFileCounter>& openedFileCounter)
+{
+#ifdef __MINGW32__
+  return nullptr;
+#else  // !__MINGW32__
+  if (fd_ == A2_BAD_FD) {
+    return nullptr;
+  }
+  if (!sharedFd_) {
+    sharedFd_ = SharedFileDescriptor::duplicate(fd_, openedFileCounter);
+  }
+  return sharedFd_;
+#endif // !__MINGW32__
+}
+
 } // namespace aria2
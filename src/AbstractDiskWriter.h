@@ -38,6 +38,15 @@
 #include "DiskWriter.h"
 #include <string>
 
+// Asynchronous writes need positional I/O so that the worker threads
+// and the main thread do not share the file offset.
+#if defined(HAVE_STD_THREAD) && !defined(__MINGW32__) &&                      \
+    defined(HAVE_PREAD) && defined(HAVE_PWRITE)
+#  define A2_ASYNC_DISK_WRITE 1
+#  include <mutex>
+#  include <condition_variable>
+#endif
+
 namespace aria2 {
 
 class AbstractDiskWriter : public DiskWriter {
@@ -58,9 +67,29 @@ private:
   unsigned char* mapaddr_;
   int64_t maplen_;
 
+  // The descriptor shared by uploads.  Created on demand and released
+  // when the file is closed.
+  std::shared_ptr<SharedFileDescriptor> sharedFd_;
+
+#ifdef A2_ASYNC_DISK_WRITE
+  // The number of writes started by writeDataVAsync() and not
+  // finished yet.  closeFile() waits for them to finish.
+  size_t numAsyncWrite_;
+  std::mutex asyncWriteMutex_;
+  std::condition_variable asyncWriteCond_;
+
+  void waitForAsyncWrite();
+#endif // A2_ASYNC_DISK_WRITE
+
   ssize_t writeDataInternal(const unsigned char* data, size_t len,
                             int64_t offset);
   ssize_t readDataInternal(unsigned char* data, size_t len, int64_t offset);
+#if !defined(__MINGW32__) && defined(HAVE_PWRITEV)
+  ssize_t writeDataVInternal(a2iovec* iov, size_t iovcnt, int64_t offset);
+#endif // !defined(__MINGW32__) && defined(HAVE_PWRITEV)
+
+  // Throws exception built from the last write error.
+  void throwOnWriteError();
 
   void seek(int64_t offset);
 
@@ -82,6 +111,13 @@ public:
   virtual void writeData(const unsigned char* data, size_t len,
                          int64_t offset) CXX11_OVERRIDE;
 
+  virtual void writeDataV(a2iovec* iov, size_t iovcnt,
+                          int64_t offset) CXX11_OVERRIDE;
+
+  virtual void writeDataVAsync(
+      WorkerThreadPool* pool, std::vector<a2iovec> iov, int64_t offset,
+      std::function<void(const RecoverableException*)> done) CXX11_OVERRIDE;
+
   virtual ssize_t readData(unsigned char* data, size_t len,
                            int64_t offset) CXX11_OVERRIDE;
 
@@ -101,7 +137,13 @@ public:
 
   virtual void dropCache(int64_t len, int64_t offset) CXX11_OVERRIDE;
 
+  virtual void prefetch(int64_t len, int64_t offset) CXX11_OVERRIDE;
+
   virtual void flushOSBuffers() CXX11_OVERRIDE;
+
+  virtual std::shared_ptr<SharedFileDescriptor> shareFileDescriptor(
+      const std::shared_ptr<OpenedFileCounter>& openedFileCounter)
+      CXX11_OVERRIDE;
 };
 
 } // namespace aria2
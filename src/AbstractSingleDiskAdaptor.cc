@@ -38,8 +38,7 @@
 #include "DiskWriter.h"
 #include "FileEntry.h"
 #include "TruncFileAllocationIterator.h"
-#include "WrDiskCacheEntry.h"
-#include "LogFactory.h"
+#include "DiskWriteQueue.h"
 #ifdef HAVE_SOME_FALLOCATE
 #  include "FallocFileAllocationIterator.h"
 #endif // HAVE_SOME_FALLOCATE
@@ -94,13 +93,30 @@ ssize_t AbstractSingleDiskAdaptor::readDataDropCache(unsigned char* data,
   return rv;
 }
 
-void AbstractSingleDiskAdaptor::writeCache(const WrDiskCacheEntry* entry)
+void AbstractSingleDiskAdaptor::prefetch(int64_t len, int64_t offset)
 {
-  for (auto& d : entry->getDataSet()) {
-    A2_LOG_DEBUG(fmt("Cache flush goff=%" PRId64 ", len=%lu", d->goff,
-                     static_cast<unsigned long>(d->len)));
-    writeData(d->data + d->offset, d->len, d->goff);
-  }
+  diskWriter_->prefetch(len, offset);
+}
+
+std::shared_ptr<SharedFileDescriptor>
+AbstractSingleDiskAdaptor::shareFileDescriptor(int64_t offset, int64_t len,
+                                               int64_t& fileOffset)
+{
+  fileOffset = offset;
+  return diskWriter_->shareFileDescriptor(getOpenedFileCounter());
+}
+
+void AbstractSingleDiskAdaptor::writeDataV(a2iovec* iov, size_t iovcnt,
+                                           int64_t offset)
+{
+  diskWriter_->writeDataV(iov, iovcnt, offset);
+}
+
+void AbstractSingleDiskAdaptor::writeDataVAsync(a2iovec* iov, size_t iovcnt,
+                                                int64_t offset,
+                                                DiskWriteBatch* batch)
+{
+  batch->push(diskWriter_.get(), iov, iovcnt, offset);
 }
 
 void AbstractSingleDiskAdaptor::flushOSBuffers()
@@ -0,0 +1,71 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_API_DOWNLOAD_EVENT_QUEUE_H
+#define D_API_DOWNLOAD_EVENT_QUEUE_H
+
+#include "Notifier.h"
+
+#include <utility>
+
+#include "SpscQueue.h"
+#include "WakeupFd.h"
+
+namespace aria2 {
+
+// Stores download events so that a thread other than the one which
+// runs the session can consume them without locking.  Only one
+// thread may call pop() at a time.
+class ApiDownloadEventQueue : public DownloadEventListener {
+public:
+  ApiDownloadEventQueue();
+  virtual ~ApiDownloadEventQueue();
+  virtual void onEvent(DownloadEvent event,
+                       const RequestGroup* group) CXX11_OVERRIDE;
+
+  // Pops the oldest event.  Returns false if there is no event.
+  bool pop(DownloadEvent& event, A2Gid& gid);
+
+  // Returns the file descriptor which is readable while there are
+  // events to pop, or -1.
+  int getFd() const { return wakeup_.getFd(); }
+
+private:
+  SpscQueue<std::pair<DownloadEvent, A2Gid>> queue_;
+  WakeupFd wakeup_;
+};
+
+} // namespace aria2
+
+#endif // D_API_DOWNLOAD_EVENT_QUEUE_H
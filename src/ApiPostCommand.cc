@@ -0,0 +1,109 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "ApiPostCommand.h"
+
+#include <vector>
+
+#include "DownloadEngine.h"
+#include "RequestGroupMan.h"
+#include "WakeupFd.h"
+#include "aria2api.h"
+
+namespace aria2 {
+
+ApiPostCommand::ApiPostCommand(cuid_t cuid, DownloadEngine* e,
+                               Session* session)
+    : Command(cuid), e_(e), session_(session)
+{
+  if (session_->postWakeup->getFd() != -1) {
+    e_->addFdForReadCheck(session_->postWakeup->getFd(), this);
+  }
+}
+
+ApiPostCommand::~ApiPostCommand()
+{
+  if (session_->postWakeup->getFd() != -1) {
+    e_->deleteFdForReadCheck(session_->postWakeup->getFd(), this);
+  }
+}
+
+bool ApiPostCommand::execute()
+{
+  session_->postWakeup->drain();
+  runPostedFunctions();
+  if (stopping()) {
+    // Refuse new functions, and run the ones posted in the meantime.
+    setPostClosed(true);
+    runPostedFunctions();
+    if (stopping()) {
+      return true;
+    }
+    // The last functions added downloads, or resumed them.
+    setPostClosed(false);
+  }
+  e_->addCommand(std::unique_ptr<Command>(this));
+  return false;
+}
+
+bool ApiPostCommand::stopping() const
+{
+  return e_->isHaltRequested() ||
+         e_->getRequestGroupMan()->downloadFinished();
+}
+
+void ApiPostCommand::runPostedFunctions()
+{
+  std::vector<PostedFunction> funcs;
+  session_->postQueue.popAll(std::back_inserter(funcs));
+  if (funcs.empty()) {
+    return;
+  }
+  for (auto& func : funcs) {
+    func(session_);
+  }
+  // The functions may have added or changed downloads.  Run all
+  // commands in the next iteration rather than after the timeout.
+  e_->setRefreshInterval(std::chrono::milliseconds(0));
+}
+
+void ApiPostCommand::setPostClosed(bool closed)
+{
+#ifdef HAVE_STD_THREAD
+  std::lock_guard<std::mutex> lock(session_->postMutex);
+#endif // HAVE_STD_THREAD
+  session_->postClosed = closed;
+}
+
+} // namespace aria2
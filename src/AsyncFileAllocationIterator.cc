@@ -0,0 +1,182 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "AsyncFileAllocationIterator.h"
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#ifdef HAVE_STD_THREAD
+#  include <mutex>
+#  include <condition_variable>
+#endif // HAVE_STD_THREAD
+
+#include "WorkerThreadPool.h"
+#include "WakeupFd.h"
+
+namespace aria2 {
+
+namespace {
+// A job returns after allocating chunks for this long, so that the
+// progress is updated and the other files get their share of the
+// worker threads.
+constexpr auto JOB_SLICE = std::chrono::milliseconds(100);
+} // namespace
+
+struct AsyncFileAllocationIterator::Job {
+  Job(std::unique_ptr<FileAllocationIterator> itr, WakeupFd* wakeupFd)
+      : itr(std::move(itr)), wakeupFd(wakeupFd), cancel(false), running(false)
+  {
+  }
+
+  void run()
+  {
+    auto start = std::chrono::steady_clock::now();
+    try {
+      while (!cancel && !itr->finished()) {
+        itr->allocateChunk();
+        if (std::chrono::steady_clock::now() - start >= JOB_SLICE) {
+          break;
+        }
+      }
+    }
+    catch (...) {
+      error = std::current_exception();
+    }
+#ifdef HAVE_STD_THREAD
+    std::lock_guard<std::mutex> lock(mutex);
+#endif // HAVE_STD_THREAD
+    running = false;
+    // Notify while holding the lock: the destructor of
+    // AsyncFileAllocationIterator waits for it, and wakeupFd may be
+    // gone after that.
+    if (wakeupFd) {
+      wakeupFd->notify();
+    }
+#ifdef HAVE_STD_THREAD
+    cond.notify_all();
+#endif // HAVE_STD_THREAD
+  }
+
+  bool isRunning()
+  {
+#ifdef HAVE_STD_THREAD
+    std::lock_guard<std::mutex> lock(mutex);
+#endif // HAVE_STD_THREAD
+    return running;
+  }
+
+  std::unique_ptr<FileAllocationIterator> itr;
+  WakeupFd* wakeupFd;
+  // The exception thrown by itr in the last run().
+  std::exception_ptr error;
+  std::atomic<bool> cancel;
+  bool running;
+#ifdef HAVE_STD_THREAD
+  std::mutex mutex;
+  std::condition_variable cond;
+#endif // HAVE_STD_THREAD
+};
+
+AsyncFileAllocationIterator::AsyncFileAllocationIterator(
+    std::unique_ptr<FileAllocationIterator> itr, WorkerThreadPool* pool,
+    WakeupFd* wakeupFd)
+    : job_(std::make_shared<Job>(std::move(itr), wakeupFd)),
+      pool_(pool),
+      currentLength_(0),
+      totalLength_(0),
+      finished_(false)
+{
+  update();
+}
+
+AsyncFileAllocationIterator::~AsyncFileAllocationIterator()
+{
+  job_->cancel = true;
+#ifdef HAVE_STD_THREAD
+  std::unique_lock<std::mutex> lock(job_->mutex);
+  job_->cond.wait(lock, [this]() { return !job_->running; });
+#endif // HAVE_STD_THREAD
+}
+
+bool AsyncFileAllocationIterator::update()
+{
+  if (job_->isRunning()) {
+    return false;
+  }
+  currentLength_ = job_->itr->getCurrentLength();
+  totalLength_ = job_->itr->getTotalLength();
+  finished_ = job_->itr->finished();
+  return true;
+}
+
+void AsyncFileAllocationIterator::allocateChunk()
+{
+  if (!update()) {
+    return;
+  }
+  if (job_->error) {
+    std::exception_ptr error;
+    std::swap(error, job_->error);
+    std::rethrow_exception(error);
+  }
+  if (finished_) {
+    return;
+  }
+  job_->running = true;
+  auto job = job_;
+  pool_->submit([job]() { job->run(); });
+  // Without worker threads, the job has already finished.
+  update();
+}
+
+bool AsyncFileAllocationIterator::finished()
+{
+  update();
+  return finished_;
+}
+
+int64_t AsyncFileAllocationIterator::getCurrentLength()
+{
+  update();
+  return currentLength_;
+}
+
+int64_t AsyncFileAllocationIterator::getTotalLength()
+{
+  update();
+  return totalLength_;
+}
+
+} // namespace aria2
@@ -0,0 +1,89 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_ASYNC_FILE_ALLOCATION_ITERATOR_H
+#define D_ASYNC_FILE_ALLOCATION_ITERATOR_H
+
+#include "FileAllocationIterator.h"
+
+#include <memory>
+
+namespace aria2 {
+
+class WorkerThreadPool;
+class WakeupFd;
+
+// FileAllocationIterator which runs another FileAllocationIterator in
+// WorkerThreadPool.  allocateChunk() does not block: it submits a job
+// which keeps allocating chunks for a while, and does nothing if such
+// a job is still running.  finished() returns false while a job is
+// running, and getCurrentLength() returns the value observed when
+// the last job finished.
+class AsyncFileAllocationIterator : public FileAllocationIterator {
+public:
+  // If |wakeupFd| is not nullptr, it is notified whenever a job
+  // returns.  It must outlive this object.
+  AsyncFileAllocationIterator(std::unique_ptr<FileAllocationIterator> itr,
+                              WorkerThreadPool* pool,
+                              WakeupFd* wakeupFd = nullptr);
+
+  // Stops the running job, if any, and waits for it to return.
+  virtual ~AsyncFileAllocationIterator();
+
+  // Throws the exception which the last job failed with.
+  virtual void allocateChunk() CXX11_OVERRIDE;
+
+  virtual bool finished() CXX11_OVERRIDE;
+
+  virtual int64_t getCurrentLength() CXX11_OVERRIDE;
+
+  virtual int64_t getTotalLength() CXX11_OVERRIDE;
+
+private:
+  struct Job;
+
+  // Updates the values below from the iterator if no job is running.
+  // Returns false if a job is running.
+  bool update();
+
+  std::shared_ptr<Job> job_;
+  WorkerThreadPool* pool_;
+  int64_t currentLength_;
+  int64_t totalLength_;
+  bool finished_;
+};
+
+} // namespace aria2
+
+#endif // D_ASYNC_FILE_ALLOCATION_ITERATOR_H
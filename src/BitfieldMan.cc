@@ -491,6 +491,49 @@ bool BitfieldMan::getAllMissingIndexes(unsigned char* misbitfield,
   }
 }
 
+namespace {
+// Stores ~have & peer & ~use & filter to dst, 64 bits at a time.  use
+// and filter may be nullptr, in which case they are ignored.  Returns
+// true if any bit is set in dst.
+bool copyMissingBitfield(unsigned char* dst, const unsigned char* have,
+                         const unsigned char* peer, const unsigned char* use,
+                         const unsigned char* filter, size_t blocks)
+{
+  using bitfield::loadWord;
+  size_t len = (blocks + 7) / 8;
+  uint64_t bits = 0;
+  size_t i = 0;
+  // The last byte is always handled by the byte loop below to mask
+  // it.
+  for (; i + 8 < len; i += 8) {
+    uint64_t v = ~loadWord(have + i) & loadWord(peer + i);
+    if (use) {
+      v &= ~loadWord(use + i);
+    }
+    if (filter) {
+      v &= loadWord(filter + i);
+    }
+    bitfield::storeWord(dst + i, v);
+    bits |= v;
+  }
+  for (; i < len; ++i) {
+    unsigned char v = ~have[i] & peer[i];
+    if (use) {
+      v &= ~use[i];
+    }
+    if (filter) {
+      v &= filter[i];
+    }
+    if (i == len - 1) {
+      v &= bitfield::lastByteMask(blocks);
+    }
+    dst[i] = v;
+    bits |= v;
+  }
+  return bits != 0;
+}
+} // namespace
+
 bool BitfieldMan::getAllMissingIndexes(unsigned char* misbitfield, size_t len,
                                        const unsigned char* peerBitfield,
                                        size_t peerBitfieldLength) const
@@ -499,16 +542,9 @@ bool BitfieldMan::getAllMissingIndexes(unsigned char* misbitfield, size_t len,
   if (bitfieldLength_ != peerBitfieldLength) {
     return false;
   }
-  if (filterEnabled_) {
-    return copyBitfield(misbitfield,
-                        ~array(bitfield_) & array(peerBitfield) &
-                            array(filterBitfield_),
-                        blocks_);
-  }
-  else {
-    return copyBitfield(misbitfield, ~array(bitfield_) & array(peerBitfield),
-                        blocks_);
-  }
+  return copyMissingBitfield(misbitfield, bitfield_, peerBitfield, nullptr,
+                             filterEnabled_ ? filterBitfield_ : nullptr,
+                             blocks_);
 }
 
 bool BitfieldMan::getAllMissingUnusedIndexes(unsigned char* misbitfield,
@@ -520,18 +556,9 @@ bool BitfieldMan::getAllMissingUnusedIndexes(unsigned char* misbitfield,
   if (bitfieldLength_ != peerBitfieldLength) {
     return false;
   }
-  if (filterEnabled_) {
-    return copyBitfield(misbitfield,
-                        ~array(bitfield_) & ~array(useBitfield_) &
-                            array(peerBitfield) & array(filterBitfield_),
-                        blocks_);
-  }
-  else {
-    return copyBitfield(misbitfield,
-                        ~array(bitfield_) & ~array(useBitfield_) &
-                            array(peerBitfield),
-                        blocks_);
-  }
+  return copyMissingBitfield(misbitfield, bitfield_, peerBitfield, useBitfield_,
+                             filterEnabled_ ? filterBitfield_ : nullptr,
+                             blocks_);
 }
 
 size_t BitfieldMan::countMissingBlock() const { return cachedNumMissingBlock_; }
@@ -540,8 +567,7 @@ size_t BitfieldMan::countMissingBlockNow() const
 {
   if (filterEnabled_) {
     return bitfield::countSetBit(filterBitfield_, blocks_) -
-           bitfield::countSetBitSlow(array(bitfield_) & array(filterBitfield_),
-                                     blocks_);
+           bitfield::countSetBitAnd(bitfield_, filterBitfield_, blocks_);
   }
   else {
     return blocks_ - bitfield::countSetBit(bitfield_, blocks_);
@@ -797,39 +823,39 @@ int64_t BitfieldMan::getFilteredTotalLengthNow() const
 }
 
 namespace {
-template <typename Array, typename CountFun>
-int64_t computeCompletedLength(const Array& bitfield, const BitfieldMan* btman,
-                               CountFun cntfun)
+// Returns the length of |completedBlocks| blocks.  |lastBlockSet| is
+// true if the last block, which may be shorter, is one of them.
+int64_t computeCompletedLength(size_t completedBlocks, bool lastBlockSet,
+                               const BitfieldMan* btman)
 {
-  size_t nbits = btman->countBlock();
-  size_t completedBlocks = cntfun(bitfield, nbits);
-  int64_t completedLength = 0;
   if (completedBlocks == 0) {
-    completedLength = 0;
+    return 0;
   }
-  else {
-    if (bitfield::test(bitfield, nbits, nbits - 1)) {
-      completedLength =
-          ((int64_t)completedBlocks - 1) * btman->getBlockLength() +
-          btman->getLastBlockLength();
-    }
-    else {
-      completedLength = ((int64_t)completedBlocks) * btman->getBlockLength();
-    }
+  if (lastBlockSet) {
+    return ((int64_t)completedBlocks - 1) * btman->getBlockLength() +
+           btman->getLastBlockLength();
   }
-  return completedLength;
+  return ((int64_t)completedBlocks) * btman->getBlockLength();
 }
 } // namespace
 
 int64_t BitfieldMan::getCompletedLength(bool useFilter) const
 {
+  if (blocks_ == 0) {
+    return 0;
+  }
   if (useFilter && filterEnabled_) {
-    auto arr = array(bitfield_) & array(filterBitfield_);
-    return computeCompletedLength(arr, this,
-                                  &bitfield::countSetBitSlow<decltype(arr)>);
+    return computeCompletedLength(
+        bitfield::countSetBitAnd(bitfield_, filterBitfield_, blocks_),
+        bitfield::test(bitfield_, blocks_, blocks_ - 1) &&
+            bitfield::test(filterBitfield_, blocks_, blocks_ - 1),
+        this);
   }
   else {
-    return computeCompletedLength(bitfield_, this, &bitfield::countSetBit);
+    return computeCompletedLength(bitfield::countSetBit(bitfield_, blocks_),
+                                  bitfield::test(bitfield_, blocks_,
+                                                 blocks_ - 1),
+                                  this);
   }
 }
 
@@ -37,6 +37,7 @@
 #include <cstring>
 #include <cstdlib>
 #include <cassert>
+#include <algorithm>
 
 #include "bittorrent_helper.h"
 #include "util.h"
@@ -59,6 +60,7 @@
 #include "array_fun.h"
 #include "WrDiskCache.h"
 #include "WrDiskCacheEntry.h"
+#include "BufferPool.h"
 #include "DownloadFailureException.h"
 #include "BtRejectMessage.h"
 
@@ -115,13 +117,35 @@ void BtPieceMessage::doReceivedAction()
       A2_LOG_DEBUG("Already have this block.");
       return;
     }
+    // Update hash first, since data_ may be handed over to the write
+    // disk cache below, which might write it out and free it
+    // immediately.
+    piece->updateHash(begin_, data_ + 9, blockLength_);
     if (piece->getWrDiskCacheEntry()) {
-      // Write Disk Cache enabled. Unfortunately, it incurs extra data
-      // copy.
-      auto dataCopy = new unsigned char[blockLength_];
-      memcpy(dataCopy, data_ + 9, blockLength_);
-      piece->updateWrCache(getPieceStorage()->getWrDiskCache(), dataCopy, 0,
-                           blockLength_, blockLength_, offset);
+      // Write Disk Cache enabled.  Adopt the receive buffer of
+      // PeerConnection if possible to avoid extra data copy.
+      size_t bufOffset, bufCapacity;
+      PoolBuffer buf;
+      if (getPeerConnection()) {
+        buf = getPeerConnection()->detachMsgPayloadBuffer(bufOffset,
+                                                          bufCapacity);
+      }
+      if (buf) {
+        assert(buf.get() + bufOffset == data_);
+        piece->updateWrCache(getPieceStorage()->getWrDiskCache(),
+                             buf.release(), bufOffset + 9, blockLength_,
+                             bufCapacity - 9, offset);
+      }
+      else {
+        auto& pool = BufferPool::getInstance();
+        size_t capacity =
+            std::max(static_cast<size_t>(blockLength_), pool.getBufferSize());
+        auto dataCopy = pool.allocate(capacity);
+        memcpy(dataCopy, data_ + 9, blockLength_);
+        piece->updateWrCache(getPieceStorage()->getWrDiskCache(), dataCopy, 0,
+                             blockLength_, capacity, offset);
+      }
+      data_ = nullptr;
     }
     else {
       getPieceStorage()->getDiskAdaptor()->writeData(data_ + 9, blockLength_,
@@ -131,7 +155,6 @@ void BtPieceMessage::doReceivedAction()
     A2_LOG_DEBUG(fmt(
         MSG_PIECE_BITFIELD, getCuid(),
         util::toHex(piece->getBitfield(), piece->getBitfieldLength()).c_str()));
-    piece->updateHash(begin_, data_ + 9, blockLength_);
     getBtMessageDispatcher()->removeOutstandingRequest(slot);
     if (piece->pieceComplete()) {
       if (checkPieceHash(piece)) {
@@ -215,6 +238,30 @@ void BtPieceMessage::send()
 void BtPieceMessage::pushPieceData(int64_t offset, int32_t length) const
 {
   assert(length <= static_cast<int32_t>(MAX_BLOCK_LENGTH));
+#ifdef A2_HAVE_SENDFILE
+  // If the data are sent as-is, let the kernel send them directly
+  // from the file.  Only the message header is pushed as bytes.
+  if (!getPeerConnection()->isEncryptionEnabled()) {
+    // All blocks from the same file share one descriptor.  If it is
+    // not available, e.g., because of --bt-max-open-files, the block
+    // is read into memory below.
+    int64_t fileOffset;
+    auto fd = getPieceStorage()->getDiskAdaptor()->shareFileDescriptor(
+        offset, length, fileOffset);
+    if (fd) {
+      auto header = std::vector<unsigned char>(MESSAGE_HEADER_LENGTH);
+      createMessageHeader(header.data());
+      const auto& peer = getPeer();
+      getPeerConnection()->pushBytes(std::move(header));
+      getPeerConnection()->pushFile(
+          std::move(fd), fileOffset, length,
+          make_unique<PieceSendUpdate>(downloadContext_, peer, 0));
+      peer->updateUploadSpeed(length);
+      downloadContext_->updateUploadSpeed(length);
+      return;
+    }
+  }
+#endif // A2_HAVE_SENDFILE
   auto buf = std::vector<unsigned char>(length + MESSAGE_HEADER_LENGTH);
   createMessageHeader(buf.data());
   ssize_t r;
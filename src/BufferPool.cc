@@ -0,0 +1,172 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "BufferPool.h"
+
+#include <cassert>
+#include <algorithm>
+
+#include "a2functional.h"
+
+namespace aria2 {
+
+BufferPool::BufferPool(size_t bufferSize, size_t numBuffersPerSlab)
+    : bufferSize_(bufferSize),
+      numBuffersPerSlab_(numBuffersPerSlab),
+      numEmptySlabs_(0),
+      maxNumSlabs_(0),
+      numBuffersInUse_(0),
+      maxNumBuffersInUse_(0)
+{
+  assert(bufferSize_ > 0);
+  assert(numBuffersPerSlab_ > 0);
+}
+
+BufferPool::~BufferPool() = default;
+
+unsigned char* BufferPool::allocate(size_t size)
+{
+  if (size > bufferSize_) {
+    return new unsigned char[size];
+  }
+#ifdef HAVE_STD_THREAD
+  std::lock_guard<std::mutex> lock(mutex_);
+#endif // HAVE_STD_THREAD
+  Slab* slab;
+  if (availableSlabs_.empty()) {
+    auto newSlab = make_unique<Slab>();
+    // Don't use make_unique here; zero-filling the slab is just a
+    // waste of time.
+    newSlab->mem.reset(new unsigned char[bufferSize_ * numBuffersPerSlab_]);
+    newSlab->freeBuffers.reserve(numBuffersPerSlab_);
+    // Push in reverse order so that buffers are handed out from the
+    // beginning of the slab.
+    for (size_t i = numBuffersPerSlab_; i > 0; --i) {
+      newSlab->freeBuffers.push_back(newSlab->mem.get() +
+                                     (i - 1) * bufferSize_);
+    }
+    slab = newSlab.get();
+    availableSlabs_.insert(slab->mem.get());
+    slabs_.emplace(slab->mem.get(), std::move(newSlab));
+    maxNumSlabs_ = std::max(maxNumSlabs_, slabs_.size());
+  }
+  else {
+    slab = slabs_[*availableSlabs_.begin()].get();
+    if (slab->freeBuffers.size() == numBuffersPerSlab_) {
+      --numEmptySlabs_;
+    }
+  }
+  auto buf = slab->freeBuffers.back();
+  slab->freeBuffers.pop_back();
+  if (slab->freeBuffers.empty()) {
+    availableSlabs_.erase(slab->mem.get());
+  }
+  ++numBuffersInUse_;
+  maxNumBuffersInUse_ = std::max(maxNumBuffersInUse_, numBuffersInUse_);
+  return buf;
+}
+
+bool BufferPool::inSlab(const unsigned char* first,
+                        const unsigned char* buf) const
+{
+  return first <= buf && buf < first + bufferSize_ * numBuffersPerSlab_;
+}
+
+void BufferPool::deallocate(unsigned char* buf)
+{
+  if (!buf) {
+    return;
+  }
+  {
+#ifdef HAVE_STD_THREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif // HAVE_STD_THREAD
+    auto i = slabs_.upper_bound(buf);
+    if (i != std::begin(slabs_) && inSlab((--i)->first, buf)) {
+      auto& slab = i->second;
+      assert((buf - slab->mem.get()) % bufferSize_ == 0);
+      slab->freeBuffers.push_back(buf);
+      --numBuffersInUse_;
+      if (slab->freeBuffers.size() == 1) {
+        availableSlabs_.insert(slab->mem.get());
+      }
+      if (slab->freeBuffers.size() == numBuffersPerSlab_) {
+        if (numEmptySlabs_ > 0) {
+          availableSlabs_.erase(slab->mem.get());
+          slabs_.erase(i);
+        }
+        else {
+          ++numEmptySlabs_;
+        }
+      }
+      return;
+    }
+  }
+  delete[] buf;
+}
+
+BufferPool::Stat BufferPool::getStat() const
+{
+#ifdef HAVE_STD_THREAD
+  std::lock_guard<std::mutex> lock(mutex_);
+#endif // HAVE_STD_THREAD
+  return Stat{slabs_.size(), maxNumSlabs_, numBuffersInUse_,
+              maxNumBuffersInUse_};
+}
+
+namespace {
+// Large enough to hold a piece message of 16KiB block in wire
+// format.
+constexpr size_t POOL_BUFFER_SIZE = 16_k + 128;
+// 32 buffers make a slab of a little more than 512KiB, which the
+// system allocator usually serves by mmap and can give back to the
+// system.
+constexpr size_t NUM_POOL_BUFFERS_PER_SLAB = 32;
+} // namespace
+
+BufferPool& BufferPool::getInstance()
+{
+  // Intentionally never destroyed: buffers may be freed during the
+  // destruction of other static objects.
+  static BufferPool* pool =
+      new BufferPool(POOL_BUFFER_SIZE, NUM_POOL_BUFFERS_PER_SLAB);
+  return *pool;
+}
+
+PoolBuffer allocatePoolBuffer(size_t size)
+{
+  return PoolBuffer(BufferPool::getInstance().allocate(size));
+}
+
+} // namespace aria2
@@ -0,0 +1,136 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_BUFFER_POOL_H
+#define D_BUFFER_POOL_H
+
+#include "common.h"
+
+#include <cstdlib>
+#include <memory>
+#include <map>
+#include <set>
+#include <vector>
+#ifdef HAVE_STD_THREAD
+#  include <mutex>
+#endif // HAVE_STD_THREAD
+
+namespace aria2 {
+
+// Pool of fixed size buffers used for the data received from the
+// network and cached in WrDiskCache.  Buffers are carved out of large
+// slabs, and a slab is returned to the system once all its buffers
+// are freed, which keeps long running processes from fragmenting the
+// heap with short-lived block sized allocations.  Requests larger than
+// the buffer size are served by new[].  This class is thread-safe
+// because cached data may be freed in disk I/O threads.
+class BufferPool {
+public:
+  struct Stat {
+    // The number of slabs currently allocated
+    size_t numSlabs;
+    // The maximum number of slabs allocated at the same time
+    size_t maxNumSlabs;
+    // The number of buffers handed out from the slabs
+    size_t numBuffersInUse;
+    // The maximum number of buffers handed out at the same time
+    size_t maxNumBuffersInUse;
+  };
+
+  BufferPool(size_t bufferSize, size_t numBuffersPerSlab);
+  ~BufferPool();
+
+  // Returns a buffer of at least |size| bytes.  If |size| is less than
+  // or equal to getBufferSize(), the returned buffer has
+  // getBufferSize() bytes.  The buffer must be freed by deallocate().
+  unsigned char* allocate(size_t size);
+
+  // Frees |buf|, which was returned by allocate().  For convenience,
+  // |buf| may also be a memory allocated by new[], in which case it
+  // is freed by delete[].  |buf| may be nullptr.
+  void deallocate(unsigned char* buf);
+
+  size_t getBufferSize() const { return bufferSize_; }
+
+  Stat getStat() const;
+
+  // Returns the pool shared by the whole process.
+  static BufferPool& getInstance();
+
+private:
+  struct Slab {
+    std::unique_ptr<unsigned char[]> mem;
+    std::vector<unsigned char*> freeBuffers;
+  };
+
+  // Returns true if |buf| is in |slab| which begins at |first|.
+  bool inSlab(const unsigned char* first, const unsigned char* buf) const;
+
+  size_t bufferSize_;
+  size_t numBuffersPerSlab_;
+  // Slabs keyed by the start address
+  std::map<unsigned char*, std::unique_ptr<Slab>> slabs_;
+  // The start addresses of slabs which have free buffers.  Buffers
+  // are taken from the slab at the lowest address, so that the slabs
+  // at higher addresses become empty and get freed.
+  std::set<unsigned char*> availableSlabs_;
+  // The number of slabs with no buffer in use.  We keep at most one
+  // of them to avoid allocating and freeing a slab repeatedly.
+  size_t numEmptySlabs_;
+  size_t maxNumSlabs_;
+  size_t numBuffersInUse_;
+  size_t maxNumBuffersInUse_;
+#ifdef HAVE_STD_THREAD
+  mutable std::mutex mutex_;
+#endif // HAVE_STD_THREAD
+};
+
+// Deleter for std::unique_ptr to give the buffer back to
+// BufferPool::getInstance().
+struct PoolBufferDeleter {
+  void operator()(unsigned char* buf) const
+  {
+    BufferPool::getInstance().deallocate(buf);
+  }
+};
+
+typedef std::unique_ptr<unsigned char[], PoolBufferDeleter> PoolBuffer;
+
+// Allocates a buffer of at least |size| bytes from
+// BufferPool::getInstance().
+PoolBuffer allocatePoolBuffer(size_t size);
+
+} // namespace aria2
+
+#endif // D_BUFFER_POOL_H
@@ -57,6 +57,8 @@ CheckIntegrityDispatcherCommand::createCommand(CheckIntegrityEntry* entry)
   A2_LOG_INFO(fmt("CUID#%" PRId64 " - Dispatching CheckIntegrityCommand "
                   "CUID#%" PRId64 ".",
                   getCuid(), newCUID));
+  entry->setWorkerThreadPool(
+      getDownloadEngine()->getCheckIntegrityWorkerPool().get());
   return make_unique<CheckIntegrityCommand>(newCUID, entry->getRequestGroup(),
                                             getDownloadEngine(), entry);
 }
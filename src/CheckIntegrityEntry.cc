@@ -54,6 +54,13 @@ CheckIntegrityEntry::~CheckIntegrityEntry() = default;
 
 void CheckIntegrityEntry::validateChunk() { validator_->validateChunk(); }
 
+void CheckIntegrityEntry::setWorkerThreadPool(WorkerThreadPool* pool)
+{
+  if (validator_) {
+    validator_->setWorkerThreadPool(pool);
+  }
+}
+
 int64_t CheckIntegrityEntry::getTotalLength()
 {
   if (!validator_) {
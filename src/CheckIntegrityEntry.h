@@ -47,6 +47,7 @@ namespace aria2 {
 class IteratableValidator;
 class DownloadEngine;
 class FileAllocationEntry;
+class WorkerThreadPool;
 
 class CheckIntegrityEntry : public RequestGroupEntry,
                             public ProgressAwareEntry {
@@ -73,6 +74,9 @@ public:
 
   virtual void validateChunk();
 
+  // Passes |pool| to the validator.  Call this after initValidator().
+  void setWorkerThreadPool(WorkerThreadPool* pool);
+
   virtual bool finished() CXX11_OVERRIDE;
 
   virtual bool isValidationReady() = 0;
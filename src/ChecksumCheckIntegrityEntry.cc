@@ -41,6 +41,8 @@
 #include "PieceStorage.h"
 #include "FileAllocationEntry.h"
 #include "StreamFileAllocationEntry.h"
+#include "Option.h"
+#include "prefs.h"
 
 namespace aria2 {
 
@@ -65,6 +67,8 @@ void ChecksumCheckIntegrityEntry::initValidator()
   auto validator = make_unique<IteratableChecksumValidator>(
       getRequestGroup()->getDownloadContext(),
       getRequestGroup()->getPieceStorage());
+  validator->setReadBufferSize(getRequestGroup()->getOption()->getAsInt(
+      PREF_CHECK_INTEGRITY_READ_SIZE));
   validator->init();
   setValidator(std::move(validator));
 }
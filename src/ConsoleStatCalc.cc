@@ -347,8 +347,9 @@ void ConsoleStatCalc::calculateStat(const DownloadEngine* e)
   }
 
   {
-    auto& entry = e->getFileAllocationMan()->getPickedEntry();
-    if (entry) {
+    auto& entries = e->getFileAllocationMan()->getPickedEntries();
+    if (!entries.empty()) {
+      auto& entry = entries.front();
       o << " [FileAlloc:#"
         << GroupId::toAbbrevHex(entry->getRequestGroup()->getGID()) << " "
         << sizeFormatter(entry->getCurrentLength()) << "B/"
@@ -360,14 +361,17 @@ void ConsoleStatCalc::calculateStat(const DownloadEngine* e)
         o << "--";
       }
       o << "%)]";
-      if (e->getFileAllocationMan()->hasNext()) {
-        o << "(+" << e->getFileAllocationMan()->countEntryInQueue() << ")";
+      auto rest = entries.size() - 1 +
+                  e->getFileAllocationMan()->countEntryInQueue();
+      if (rest > 0) {
+        o << "(+" << rest << ")";
       }
     }
   }
   {
-    auto& entry = e->getCheckIntegrityMan()->getPickedEntry();
-    if (entry) {
+    auto& entries = e->getCheckIntegrityMan()->getPickedEntries();
+    if (!entries.empty()) {
+      auto& entry = entries.front();
       o << " [Checksum:#"
         << GroupId::toAbbrevHex(entry->getRequestGroup()->getGID()) << " "
         << sizeFormatter(entry->getCurrentLength()) << "B/"
@@ -379,8 +383,10 @@ void ConsoleStatCalc::calculateStat(const DownloadEngine* e)
         o << "--";
       }
       o << "%)]";
-      if (e->getCheckIntegrityMan()->hasNext()) {
-        o << "(+" << e->getCheckIntegrityMan()->countEntryInQueue() << ")";
+      auto rest = entries.size() - 1 +
+                  e->getCheckIntegrityMan()->countEntryInQueue();
+      if (rest > 0) {
+        o << "(+" << rest << ")";
       }
     }
   }
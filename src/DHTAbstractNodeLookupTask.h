@@ -54,6 +54,7 @@
 #include "Logger.h"
 #include "util.h"
 #include "DHTIDCloser.h"
+#include "DHTClosestNodeCache.h"
 #include "a2functional.h"
 #include "fmt.h"
 
@@ -71,6 +72,8 @@ private:
 
   size_t inFlightMessage_;
 
+  DHTClosestNodeCache* nodeCache_;
+
   template <typename Container>
   void toEntries(Container& entries,
                  const std::vector<std::shared_ptr<DHTNode>>& nodes) const
@@ -93,6 +96,42 @@ private:
     }
   }
 
+  // Sorts entries_ by distance to targetID_ and keeps the closest K
+  // unique ones.
+  void pruneEntries()
+  {
+    std::stable_sort(std::begin(entries_), std::end(entries_),
+                     DHTIDCloser(targetID_));
+    entries_.erase(
+        std::unique(std::begin(entries_), std::end(entries_),
+                    DerefEqualTo<std::unique_ptr<DHTNodeLookupEntry>>{}),
+        std::end(entries_));
+    A2_LOG_DEBUG(fmt("%lu node lookup entries are unique.",
+                     static_cast<unsigned long>(entries_.size())));
+    if (entries_.size() > DHTBucket::K) {
+      entries_.erase(std::begin(entries_) + DHTBucket::K, std::end(entries_));
+    }
+  }
+
+  // Stores the nodes which answered this lookup to nodeCache_.
+  void storeNodes()
+  {
+    if (!nodeCache_) {
+      return;
+    }
+    std::vector<std::shared_ptr<DHTNode>> nodes;
+    for (auto& entry : entries_) {
+      // Since no message is in flight, used entries have replied.
+      // The ones timed out were removed.
+      if (entry->used) {
+        nodes.push_back(entry->node);
+      }
+    }
+    if (!nodes.empty()) {
+      nodeCache_->put(targetID_, nodes);
+    }
+  }
+
   void sendMessageAndCheckFinish()
   {
     if (needsAdditionalOutgoingMessage()) {
@@ -102,6 +141,7 @@ private:
       A2_LOG_DEBUG(fmt("Finished node_lookup for node ID %s",
                        util::toHex(targetID_, DHT_ID_LENGTH).c_str()));
       onFinish();
+      storeNodes();
       updateBucket();
       setFinished(true);
     }
@@ -137,7 +177,8 @@ protected:
   virtual std::unique_ptr<DHTMessageCallback> createCallback() = 0;
 
 public:
-  DHTAbstractNodeLookupTask(const unsigned char* targetID) : inFlightMessage_(0)
+  DHTAbstractNodeLookupTask(const unsigned char* targetID)
+      : inFlightMessage_(0), nodeCache_(nullptr)
   {
     memcpy(targetID_, targetID, DHT_ID_LENGTH);
   }
@@ -149,7 +190,14 @@ public:
     std::vector<std::shared_ptr<DHTNode>> nodes;
     getRoutingTable()->getClosestKNodes(nodes, targetID_);
     entries_.clear();
-    toEntries(entries_, nodes);
+    if (nodeCache_) {
+      nodeCache_->get(nodes, targetID_);
+      toEntries(entries_, nodes);
+      pruneEntries();
+    }
+    else {
+      toEntries(entries_, nodes);
+    }
     if (entries_.empty()) {
       setFinished(true);
     }
@@ -164,6 +212,8 @@ public:
     }
   }
 
+  void setNodeCache(DHTClosestNodeCache* nodeCache) { nodeCache_ = nodeCache; }
+
   void onReceived(const ResponseMessage* message)
   {
     --inFlightMessage_;
@@ -194,17 +244,7 @@ public:
     }
     A2_LOG_DEBUG(fmt("%lu node lookup entries added.",
                      static_cast<unsigned long>(count)));
-    std::stable_sort(std::begin(entries_), std::end(entries_),
-                     DHTIDCloser(targetID_));
-    entries_.erase(
-        std::unique(std::begin(entries_), std::end(entries_),
-                    DerefEqualTo<std::unique_ptr<DHTNodeLookupEntry>>{}),
-        std::end(entries_));
-    A2_LOG_DEBUG(fmt("%lu node lookup entries are unique.",
-                     static_cast<unsigned long>(entries_.size())));
-    if (entries_.size() > DHTBucket::K) {
-      entries_.erase(std::begin(entries_) + DHTBucket::K, std::end(entries_));
-    }
+    pruneEntries();
     sendMessageAndCheckFinish();
   }
 
@@ -53,17 +53,21 @@ namespace aria2 {
 
 DHTBucket::DHTBucket(size_t prefixLength, const unsigned char* max,
                      const unsigned char* min,
-                     const std::shared_ptr<DHTNode>& localNode)
+                     const std::shared_ptr<DHTNode>& localNode, size_t k)
     : prefixLength_(prefixLength),
       localNode_(localNode),
+      k_(k),
       lastUpdated_(global::wallclock())
 {
   memcpy(max_, max, DHT_ID_LENGTH);
   memcpy(min_, min, DHT_ID_LENGTH);
 }
 
-DHTBucket::DHTBucket(const std::shared_ptr<DHTNode>& localNode)
-    : prefixLength_(0), localNode_(localNode), lastUpdated_(global::wallclock())
+DHTBucket::DHTBucket(const std::shared_ptr<DHTNode>& localNode, size_t k)
+    : prefixLength_(0),
+      localNode_(localNode),
+      k_(k),
+      lastUpdated_(global::wallclock())
 {
   memset(max_, 0xffu, DHT_ID_LENGTH);
   memset(min_, 0, DHT_ID_LENGTH);
@@ -108,7 +112,7 @@ bool DHTBucket::addNode(const std::shared_ptr<DHTNode>& node)
   notifyUpdate();
   auto itr = std::find_if(nodes_.begin(), nodes_.end(), derefEqual(node));
   if (itr == nodes_.end()) {
-    if (nodes_.size() < K) {
+    if (nodes_.size() < k_) {
       nodes_.push_back(node);
       return true;
     }
@@ -187,7 +191,8 @@ std::unique_ptr<DHTBucket> DHTBucket::split()
   bitfield::flipBit(min_, DHT_ID_LENGTH, prefixLength_);
 
   ++prefixLength_;
-  auto rBucket = make_unique<DHTBucket>(prefixLength_, rMax, rMin, localNode_);
+  auto rBucket =
+      make_unique<DHTBucket>(prefixLength_, rMax, rMin, localNode_, k_);
 
   std::deque<std::shared_ptr<DHTNode>> lNodes;
   for (auto& elem : nodes_) {
@@ -245,8 +250,8 @@ bool DHTBucket::operator==(const DHTBucket& bucket) const
 
 bool DHTBucket::needsRefresh() const
 {
-  return nodes_.size() < K || lastUpdated_.difference(global::wallclock()) >=
-                                  DHT_BUCKET_REFRESH_INTERVAL;
+  return nodes_.size() < k_ || lastUpdated_.difference(global::wallclock()) >=
+                                   DHT_BUCKET_REFRESH_INTERVAL;
 }
 
 void DHTBucket::notifyUpdate() { lastUpdated_ = global::wallclock(); }
@@ -60,6 +60,9 @@ private:
 
   std::shared_ptr<DHTNode> localNode_;
 
+  // The maximum number of nodes this bucket holds.
+  size_t k_;
+
   // sorted in ascending order
   std::deque<std::shared_ptr<DHTNode>> nodes_;
 
@@ -73,14 +76,18 @@ private:
                  const unsigned char* min) const;
 
 public:
-  DHTBucket(const std::shared_ptr<DHTNode>& localNode);
+  DHTBucket(const std::shared_ptr<DHTNode>& localNode,
+            size_t k = DHT_BUCKET_SIZE);
 
   DHTBucket(size_t prefixLength, const unsigned char* max,
             const unsigned char* min,
-            const std::shared_ptr<DHTNode>& localNode);
+            const std::shared_ptr<DHTNode>& localNode,
+            size_t k = DHT_BUCKET_SIZE);
 
   ~DHTBucket();
 
+  // The number of nodes sent in find_node and get_peers replies, and
+  // the number of nodes a lookup converges to.
   static const size_t K = 8;
 
   static const size_t CACHE_SIZE = 2;
@@ -107,6 +114,8 @@ public:
 
   size_t countNode() const { return nodes_.size(); }
 
+  size_t getBucketSize() const { return k_; }
+
   const std::deque<std::shared_ptr<DHTNode>>& getNodes() const
   {
     return nodes_;
@@ -0,0 +1,96 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "DHTClosestNodeCache.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include "DHTNode.h"
+#include "XORCloser.h"
+#include "wallclock.h"
+
+namespace aria2 {
+
+DHTClosestNodeCache::DHTClosestNodeCache(size_t capacity) : capacity_(capacity)
+{
+}
+
+void DHTClosestNodeCache::put(
+    const unsigned char* targetID,
+    const std::vector<std::shared_ptr<DHTNode>>& nodes)
+{
+  if (capacity_ == 0) {
+    return;
+  }
+  entries_.erase(std::remove_if(std::begin(entries_), std::end(entries_),
+                                [targetID](const Entry& e) {
+                                  return memcmp(e.targetID, targetID,
+                                                DHT_ID_LENGTH) == 0;
+                                }),
+                 std::end(entries_));
+  while (entries_.size() >= capacity_ ||
+         (!entries_.empty() &&
+          entries_.front().stored.difference(global::wallclock()) >=
+              DHT_BUCKET_REFRESH_INTERVAL)) {
+    entries_.pop_front();
+  }
+  Entry e;
+  memcpy(e.targetID, targetID, DHT_ID_LENGTH);
+  e.nodes = nodes;
+  e.stored = global::wallclock();
+  entries_.push_back(std::move(e));
+}
+
+void DHTClosestNodeCache::get(std::vector<std::shared_ptr<DHTNode>>& nodes,
+                              const unsigned char* targetID) const
+{
+  XORCloser closer(targetID, DHT_ID_LENGTH);
+  const Entry* closest = nullptr;
+  for (auto& e : entries_) {
+    if (e.stored.difference(global::wallclock()) >=
+        DHT_BUCKET_REFRESH_INTERVAL) {
+      continue;
+    }
+    if (!closest || closer(e.targetID, closest->targetID)) {
+      closest = &e;
+    }
+  }
+  if (closest) {
+    nodes.insert(std::end(nodes), std::begin(closest->nodes),
+                 std::end(closest->nodes));
+  }
+}
+
+} // namespace aria2
@@ -0,0 +1,87 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_DHT_CLOSEST_NODE_CACHE_H
+#define D_DHT_CLOSEST_NODE_CACHE_H
+
+#include "common.h"
+
+#include <deque>
+#include <vector>
+#include <memory>
+
+#include "DHTConstants.h"
+#include "TimerA2.h"
+
+namespace aria2 {
+
+class DHTNode;
+
+// Remembers the nodes which answered a lookup, keyed by its target
+// ID.  A later lookup starts from the nodes found for the closest
+// target, so that lookups for the same or nearby targets take fewer
+// hops than starting from the routing table alone.
+class DHTClosestNodeCache {
+public:
+  DHTClosestNodeCache(size_t capacity = 2048);
+
+  // Stores |nodes| found by the lookup for |targetID|.  The entry
+  // stored for the same target is replaced.
+  void put(const unsigned char* targetID,
+           const std::vector<std::shared_ptr<DHTNode>>& nodes);
+
+  // Appends the nodes stored for the target closest to |targetID| to
+  // |nodes|.  The entries older than DHT_BUCKET_REFRESH_INTERVAL are
+  // ignored.
+  void get(std::vector<std::shared_ptr<DHTNode>>& nodes,
+           const unsigned char* targetID) const;
+
+  size_t size() const { return entries_.size(); }
+
+private:
+  struct Entry {
+    unsigned char targetID[DHT_ID_LENGTH];
+    std::vector<std::shared_ptr<DHTNode>> nodes;
+    Timer stored;
+  };
+
+  // Sorted by the time stored, the oldest one first.
+  std::deque<Entry> entries_;
+
+  size_t capacity_;
+};
+
+} // namespace aria2
+
+#endif // D_DHT_CLOSEST_NODE_CACHE_H
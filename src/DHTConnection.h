@@ -39,6 +39,8 @@
 #include <sys/types.h>
 #include <string>
 
+struct Datagram;
+
 namespace aria2 {
 
 class DHTConnection {
@@ -48,6 +50,10 @@ public:
   virtual ssize_t receiveMessage(unsigned char* data, size_t len,
                                  std::string& host, uint16_t& port) = 0;
 
+  // Receives at most |count| messages into |datagrams| at once.
+  // Returns the number of messages received.
+  virtual size_t receiveMessages(Datagram* datagrams, size_t count) = 0;
+
   virtual ssize_t sendMessage(const unsigned char* data, size_t len,
                               const std::string& host, uint16_t port) = 0;
 };
@@ -102,6 +102,11 @@ ssize_t DHTConnectionImpl::receiveMessage(unsigned char* data, size_t len,
   return length;
 }
 
+size_t DHTConnectionImpl::receiveMessages(Datagram* datagrams, size_t count)
+{
+  return socket_->readDataFrom(datagrams, count);
+}
+
 ssize_t DHTConnectionImpl::sendMessage(const unsigned char* data, size_t len,
                                        const std::string& host, uint16_t port)
 {
@@ -81,6 +81,9 @@ public:
                                  std::string& host,
                                  uint16_t& port) CXX11_OVERRIDE;
 
+  virtual size_t receiveMessages(Datagram* datagrams,
+                                 size_t count) CXX11_OVERRIDE;
+
   virtual ssize_t sendMessage(const unsigned char* data, size_t len,
                               const std::string& host,
                               uint16_t port) CXX11_OVERRIDE;
@@ -52,6 +52,15 @@ constexpr size_t DHT_TRANSACTION_ID_LENGTH = 4;
 // See --dht-message-timeout option.
 constexpr auto DHT_MESSAGE_TIMEOUT = 10_s;
 
+// See --dht-bucket-size option.
+constexpr size_t DHT_BUCKET_SIZE = 8;
+
+// See --dht-peer-store-size option.
+constexpr size_t DHT_PEER_ANNOUNCE_STORAGE_SIZE = 10000;
+
+// The maximum number of peers stored per info hash.
+constexpr size_t DHT_PEER_ANNOUNCE_MAX_PEER = 100;
+
 constexpr auto DHT_NODE_CONTACT_INTERVAL = 15_min;
 
 constexpr auto DHT_BUCKET_REFRESH_INTERVAL = 15_min;
@@ -66,6 +75,8 @@ constexpr auto DHT_PEER_ANNOUNCE_CHECK_INTERVAL = 5_min;
 
 constexpr auto DHT_TOKEN_UPDATE_INTERVAL = 10_min;
 
+constexpr auto DHT_STAT_INTERVAL = 1_min;
+
 } // namespace aria2
 
 #endif // D_DHT_CONSTANTS_H
@@ -104,7 +104,9 @@ bool DHTGetPeersCommand::execute()
     task_ = taskFactory_->createPeerLookupTask(
         requestGroup_->getDownloadContext(), e_->getBtRegistry()->getTcpPort(),
         peerStorage_);
-    taskQueue_->addPeriodicTask2(task_);
+    // Look up the torrents which have no peer at all first.
+    taskQueue_->addPeerLookupTask(task_, peerStorage_->countAllPeer() == 0 &&
+                                             btRuntime_->getConnections() == 0);
   }
   else if (task_ && task_->finished()) {
     A2_LOG_DEBUG("task finished detected");
@@ -34,8 +34,6 @@
 /* copyright --> */
 #include "DHTInteractionCommand.h"
 
-#include <array>
-
 #include "DownloadEngine.h"
 #include "RecoverableException.h"
 #include "DHTMessageDispatcher.h"
@@ -58,6 +56,13 @@
 
 namespace aria2 {
 
+namespace {
+// The number of datagrams received at once.
+constexpr size_t DATAGRAM_BATCH_SIZE = 16;
+// The maximum size of UDP datagram.
+constexpr size_t DATAGRAM_SIZE = 64_k;
+} // namespace
+
 // TODO This name of this command is misleading, because now it also
 // handles UDP trackers as well as DHT.
 DHTInteractionCommand::DHTInteractionCommand(cuid_t cuid, DownloadEngine* e)
@@ -65,9 +70,15 @@ DHTInteractionCommand::DHTInteractionCommand(cuid_t cuid, DownloadEngine* e)
       e_{e},
       dispatcher_{nullptr},
       receiver_{nullptr},
-      taskQueue_{nullptr}
+      taskQueue_{nullptr},
+      buffer_{new unsigned char[DATAGRAM_BATCH_SIZE * DATAGRAM_SIZE]},
+      datagrams_(DATAGRAM_BATCH_SIZE)
 {
   setStatusRealtime();
+  for (size_t i = 0; i < DATAGRAM_BATCH_SIZE; ++i) {
+    datagrams_[i].data = buffer_.get() + i * DATAGRAM_SIZE;
+    datagrams_[i].capacity = DATAGRAM_SIZE;
+  }
 }
 
 DHTInteractionCommand::~DHTInteractionCommand()
@@ -92,6 +103,32 @@ void DHTInteractionCommand::disableReadCheckSocket(
   }
 }
 
+void DHTInteractionCommand::processDatagram(const Datagram& datagram)
+{
+  auto& sender = datagram.sender;
+  if (datagram.data[0] == 'd') {
+    // udp tracker response does not start with 'd', so assume
+    // this message belongs to DHT. nothrow.
+    receiver_->receiveMessage(sender.addr, sender.port, datagram.data,
+                              datagram.length);
+  }
+  else {
+    // this may be udp tracker response. nothrow.
+    std::shared_ptr<UDPTrackerRequest> req;
+    if (udpTrackerClient_->receiveReply(req, datagram.data, datagram.length,
+                                        sender.addr, sender.port,
+                                        global::wallclock()) == 0) {
+      if (req->action == UDPT_ACT_ANNOUNCE) {
+        auto c = static_cast<TrackerWatcherCommand*>(req->user_data);
+        if (c) {
+          c->setStatus(Command::STATUS_ONESHOT_REALTIME);
+          e_->setNoWait(true);
+        }
+      }
+    }
+  }
+}
+
 bool DHTInteractionCommand::execute()
 {
   // We need to keep this command alive while TrackerWatcherCommand
@@ -109,36 +146,18 @@ bool DHTInteractionCommand::execute()
 
   taskQueue_->executeTask();
 
-  std::string remoteAddr;
-  uint16_t remotePort;
-  std::array<unsigned char, 64_k> data;
   try {
-    while (1) {
-      ssize_t length = connection_->receiveMessage(data.data(), data.size(),
-                                                   remoteAddr, remotePort);
-      if (length <= 0) {
-        break;
-      }
-      if (data[0] == 'd') {
-        // udp tracker response does not start with 'd', so assume
-        // this message belongs to DHT. nothrow.
-        receiver_->receiveMessage(remoteAddr, remotePort, data.data(), length);
-      }
-      else {
-        // this may be udp tracker response. nothrow.
-        std::shared_ptr<UDPTrackerRequest> req;
-        if (udpTrackerClient_->receiveReply(req, data.data(), length,
-                                            remoteAddr, remotePort,
-                                            global::wallclock()) == 0) {
-          if (req->action == UDPT_ACT_ANNOUNCE) {
-            auto c = static_cast<TrackerWatcherCommand*>(req->user_data);
-            if (c) {
-              c->setStatus(Command::STATUS_ONESHOT_REALTIME);
-              e_->setNoWait(true);
-            }
-          }
+    for (;;) {
+      auto n = connection_->receiveMessages(datagrams_.data(),
+                                            datagrams_.size());
+      for (size_t i = 0; i < n; ++i) {
+        if (datagrams_[i].length > 0) {
+          processDatagram(datagrams_[i]);
         }
       }
+      if (n < datagrams_.size()) {
+        break;
+      }
     }
   }
   catch (RecoverableException& e) {
@@ -147,16 +166,20 @@ bool DHTInteractionCommand::execute()
   receiver_->handleTimeout();
   udpTrackerClient_->handleTimeout(global::wallclock());
   dispatcher_->sendMessages();
+  std::string remoteAddr;
+  uint16_t remotePort;
+  auto data = datagrams_[0].data;
   while (!udpTrackerClient_->getPendingRequests().empty()) {
     // no throw
     ssize_t length = udpTrackerClient_->createRequest(
-        data.data(), data.size(), remoteAddr, remotePort, global::wallclock());
+        data, datagrams_[0].capacity, remoteAddr, remotePort,
+        global::wallclock());
     if (length == -1) {
       break;
     }
     try {
       // throw
-      connection_->sendMessage(data.data(), length, remoteAddr, remotePort);
+      connection_->sendMessage(data, length, remoteAddr, remotePort);
       udpTrackerClient_->requestSent(global::wallclock());
     }
     catch (RecoverableException& e) {
@@ -38,6 +38,9 @@
 #include "Command.h"
 
 #include <memory>
+#include <vector>
+
+#include "a2netcompat.h"
 
 namespace aria2 {
 
@@ -58,6 +61,12 @@ private:
   std::shared_ptr<SocketCore> readCheckSocket_;
   std::unique_ptr<DHTConnection> connection_;
   std::shared_ptr<UDPTrackerClient> udpTrackerClient_;
+  // Storage of datagrams_, which is not touched until data is
+  // received into it.
+  std::unique_ptr<unsigned char[]> buffer_;
+  std::vector<Datagram> datagrams_;
+
+  void processDatagram(const Datagram& datagram);
 
 public:
   DHTInteractionCommand(cuid_t cuid, DownloadEngine* e);
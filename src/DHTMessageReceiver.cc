@@ -52,12 +52,20 @@
 #include "util.h"
 #include "bencode2.h"
 #include "fmt.h"
+#include "wallclock.h"
+#include "DHTConstants.h"
 
 namespace aria2 {
 
 DHTMessageReceiver::DHTMessageReceiver(
-    const std::shared_ptr<DHTMessageTracker>& tracker)
-    : tracker_{tracker}, factory_{nullptr}, routingTable_{nullptr}
+    const std::shared_ptr<DHTMessageTracker>& tracker, size_t queryRateLimit)
+    : tracker_{tracker},
+      factory_{nullptr},
+      routingTable_{nullptr},
+      rateLimiter_{queryRateLimit},
+      numQuery_{0},
+      numDroppedQuery_{0},
+      statTimer_{global::wallclock()}
 {
 }
 
@@ -102,6 +110,13 @@ DHTMessageReceiver::receiveMessage(const std::string& remoteAddr,
       return std::move(p.first);
     }
     else {
+      if (!rateLimiter_.accept(remoteAddr, global::wallclock())) {
+        ++numDroppedQuery_;
+        A2_LOG_DEBUG(fmt("Dropped DHT query from %s:%u. Rate limit exceeded.",
+                         remoteAddr.c_str(), remotePort));
+        return nullptr;
+      }
+      ++numQuery_;
       auto message = factory_->createQueryMessage(dict, remoteAddr, remotePort);
       if (*message->getLocalNode() == *message->getRemoteNode()) {
         // drop message from localnode
@@ -128,7 +143,24 @@ void DHTMessageReceiver::onMessageReceived(DHTMessage* message)
   routingTable_->addGoodNode(message->getRemoteNode());
 }
 
-void DHTMessageReceiver::handleTimeout() { tracker_->handleTimeout(); }
+void DHTMessageReceiver::handleTimeout()
+{
+  tracker_->handleTimeout();
+  auto elapsed = statTimer_.difference(global::wallclock());
+  if (elapsed < DHT_STAT_INTERVAL) {
+    return;
+  }
+  auto secs = std::chrono::duration_cast<std::chrono::seconds>(elapsed).count();
+  rateLimiter_.purge(global::wallclock());
+  A2_LOG_INFO(fmt("DHT: %.1f queries/s served, %.1f queries/s dropped,"
+                  " %lu query sources tracked",
+                  static_cast<double>(numQuery_) / secs,
+                  static_cast<double>(numDroppedQuery_) / secs,
+                  static_cast<unsigned long>(rateLimiter_.countSource())));
+  numQuery_ = 0;
+  numDroppedQuery_ = 0;
+  statTimer_ = global::wallclock();
+}
 
 std::unique_ptr<DHTUnknownMessage> DHTMessageReceiver::handleUnknownMessage(
     const unsigned char* data, size_t length, const std::string& remoteAddr,
@@ -40,6 +40,9 @@
 #include <string>
 #include <memory>
 
+#include "DHTQueryRateLimiter.h"
+#include "TimerA2.h"
+
 namespace aria2 {
 
 class DHTMessageTracker;
@@ -56,6 +59,15 @@ private:
 
   DHTRoutingTable* routingTable_;
 
+  DHTQueryRateLimiter rateLimiter_;
+
+  // The number of queries processed and dropped since statTimer_.
+  size_t numQuery_;
+
+  size_t numDroppedQuery_;
+
+  Timer statTimer_;
+
   std::unique_ptr<DHTUnknownMessage>
   handleUnknownMessage(const unsigned char* data, size_t length,
                        const std::string& remoteAddr, uint16_t remotePort);
@@ -63,13 +75,18 @@ private:
   void onMessageReceived(DHTMessage* message);
 
 public:
-  DHTMessageReceiver(const std::shared_ptr<DHTMessageTracker>& tracker);
+  // |queryRateLimit| is the number of queries per second accepted
+  // from one IP address.  0 means unlimited.
+  DHTMessageReceiver(const std::shared_ptr<DHTMessageTracker>& tracker,
+                     size_t queryRateLimit = 0);
 
   std::unique_ptr<DHTMessage> receiveMessage(const std::string& remoteAddr,
                                              uint16_t remotePort,
                                              unsigned char* data,
                                              size_t length);
 
+  // Handles timeout of the messages sent and logs the number of
+  // queries served per second at DHT_STAT_INTERVAL.
   void handleTimeout();
 
   const std::shared_ptr<DHTMessageTracker>& getMessageTracker() const
@@ -35,6 +35,7 @@
 #include "DHTMessageTracker.h"
 
 #include <utility>
+#include <algorithm>
 
 #include "DHTMessage.h"
 #include "DHTMessageCallback.h"
@@ -48,11 +49,56 @@
 #include "DlAbortEx.h"
 #include "DHTConstants.h"
 #include "fmt.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
+namespace {
+// The number of slots in the timer wheel.  It covers the maximum
+// value of --dht-message-timeout, so that most entries are visited
+// only when they time out.
+constexpr size_t WHEEL_SIZE = 64;
+} // namespace
+
+namespace {
+int64_t toTick(const Timer::Clock::time_point& t)
+{
+  return std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch())
+      .count();
+}
+} // namespace
+
+namespace {
+const char V4_MAPPED_PREFIX[] = "::ffff:";
+} // namespace
+
+namespace {
+// Returns the key of entries_ for the message with |transactionID|
+// exchanged with |ipaddr|:|port|.  IPv4-mapped IPv6 address has the
+// same key as the IPv4 address, like DHTMessageTrackerEntry::match().
+std::string makeKey(const std::string& transactionID,
+                    const std::string& ipaddr, uint16_t port)
+{
+  std::string key = transactionID;
+  key += '\0';
+  if (util::startsWith(ipaddr, V4_MAPPED_PREFIX)) {
+    key.append(std::begin(ipaddr) + sizeof(V4_MAPPED_PREFIX) - 1,
+               std::end(ipaddr));
+  }
+  else {
+    key += ipaddr;
+  }
+  key += '\0';
+  key += util::uitos(port);
+  return key;
+}
+} // namespace
+
 DHTMessageTracker::DHTMessageTracker()
-    : routingTable_{nullptr}, factory_{nullptr}
+    : wheel_(WHEEL_SIZE),
+      lastTick_{toTick(global::wallclock().getTime())},
+      routingTable_{nullptr},
+      factory_{nullptr}
 {
 }
 
@@ -60,9 +106,17 @@ void DHTMessageTracker::addMessage(DHTMessage* message,
                                    std::chrono::seconds timeout,
                                    std::unique_ptr<DHTMessageCallback> callback)
 {
-  entries_.push_back(make_unique<DHTMessageTrackerEntry>(
+  auto entry = make_unique<DHTMessageTrackerEntry>(
       message->getRemoteNode(), message->getTransactionID(),
-      message->getMessageType(), std::move(timeout), std::move(callback)));
+      message->getMessageType(), std::move(timeout), std::move(callback));
+  auto key = makeKey(message->getTransactionID(),
+                     message->getRemoteNode()->getIPAddress(),
+                     message->getRemoteNode()->getPort());
+  // Entries which have already timed out are handled in the next
+  // handleTimeout().
+  auto tick = std::max(lastTick_, toTick(entry->getTimeoutTime()));
+  wheel_[tick % WHEEL_SIZE].emplace_back(key, entry.get());
+  entries_.emplace(std::move(key), std::move(entry));
 }
 
 std::pair<std::unique_ptr<DHTResponseMessage>,
@@ -77,9 +131,10 @@ DHTMessageTracker::messageArrived(const Dict* dict, const std::string& ipaddr,
   }
   A2_LOG_DEBUG(fmt("Searching tracker entry for TransactionID=%s, Remote=%s:%u",
                    util::toHex(tid->s()).c_str(), ipaddr.c_str(), port));
-  for (auto i = std::begin(entries_), eoi = std::end(entries_); i != eoi; ++i) {
-    if ((*i)->match(tid->s(), ipaddr, port)) {
-      auto entry = std::move(*i);
+  auto range = entries_.equal_range(makeKey(tid->s(), ipaddr, port));
+  for (auto i = range.first; i != range.second; ++i) {
+    if ((*i).second->match(tid->s(), ipaddr, port)) {
+      auto entry = std::move((*i).second);
       entries_.erase(i);
       A2_LOG_DEBUG("Tracker entry found.");
       auto& targetNode = entry->getTargetNode();
@@ -142,28 +197,52 @@ void DHTMessageTracker::handleTimeoutEntry(DHTMessageTrackerEntry* entry)
 
 void DHTMessageTracker::handleTimeout()
 {
-  entries_.erase(
-      std::remove_if(std::begin(entries_), std::end(entries_),
-                     [&](const std::unique_ptr<DHTMessageTrackerEntry>& ent) {
-                       if (ent->isTimeout()) {
-                         handleTimeoutEntry(ent.get());
-                         return true;
-                       }
-                       else {
-                         return false;
-                       }
-                     }),
-      std::end(entries_));
+  auto now = toTick(global::wallclock().getTime());
+  // The slot of now is visited again next time, because the entries
+  // in it may time out later in this second.
+  auto first = std::max(lastTick_, now - static_cast<int64_t>(WHEEL_SIZE) + 1);
+  lastTick_ = now;
+  for (auto tick = first; tick <= now; ++tick) {
+    auto& slot = wheel_[tick % WHEEL_SIZE];
+    std::vector<std::unique_ptr<DHTMessageTrackerEntry>> timedout;
+    auto last = std::remove_if(
+        std::begin(slot), std::end(slot),
+        [&](const std::pair<std::string, DHTMessageTrackerEntry*>& item) {
+          auto range = entries_.equal_range(item.first);
+          for (auto i = range.first; i != range.second; ++i) {
+            if ((*i).second.get() != item.second) {
+              continue;
+            }
+            if (!(*i).second->isTimeout()) {
+              return false;
+            }
+            timedout.push_back(std::move((*i).second));
+            entries_.erase(i);
+            return true;
+          }
+          // The entry has been answered.
+          return true;
+        });
+    slot.erase(last, std::end(slot));
+    // Callbacks may add messages to this slot.
+    for (auto& entry : timedout) {
+      handleTimeoutEntry(entry.get());
+    }
+  }
 }
 
 const DHTMessageTrackerEntry*
 DHTMessageTracker::getEntryFor(const DHTMessage* message) const
 {
-  for (auto& ent : entries_) {
-    if (ent->match(message->getTransactionID(),
-                   message->getRemoteNode()->getIPAddress(),
-                   message->getRemoteNode()->getPort())) {
-      return ent.get();
+  auto range = entries_.equal_range(
+      makeKey(message->getTransactionID(),
+              message->getRemoteNode()->getIPAddress(),
+              message->getRemoteNode()->getPort()));
+  for (auto i = range.first; i != range.second; ++i) {
+    if ((*i).second->match(message->getTransactionID(),
+                           message->getRemoteNode()->getIPAddress(),
+                           message->getRemoteNode()->getPort())) {
+      return (*i).second.get();
     }
   }
   return nullptr;
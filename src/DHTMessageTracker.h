@@ -38,7 +38,8 @@
 #include "common.h"
 
 #include <utility>
-#include <deque>
+#include <vector>
+#include <unordered_map>
 #include <memory>
 
 #include "a2time.h"
@@ -55,7 +56,22 @@ class DHTMessageTrackerEntry;
 
 class DHTMessageTracker {
 private:
-  std::deque<std::unique_ptr<DHTMessageTrackerEntry>> entries_;
+  // Entries keyed by transaction ID and remote endpoint.  See
+  // makeKey().
+  std::unordered_multimap<std::string,
+                          std::unique_ptr<DHTMessageTrackerEntry>>
+      entries_;
+
+  // Timer wheel.  The slot at index i lists the keys of entries which
+  // time out in the second whose count since the epoch of
+  // Timer::Clock modulo the number of slots is i.  The answered
+  // entries are left in the slots and skipped when their slot is
+  // visited.
+  std::vector<std::vector<std::pair<std::string, DHTMessageTrackerEntry*>>>
+      wheel_;
+
+  // The second handleTimeout() visited last.
+  int64_t lastTick_;
 
   DHTRoutingTable* routingTable_;
 
@@ -74,7 +90,6 @@ public:
 
   void handleTimeout();
 
-  // Made public so that unnamed functor can access this
   void handleTimeoutEntry(DHTMessageTrackerEntry* entry);
 
   // // For unittest only
@@ -78,10 +78,16 @@ public:
              uint16_t port) const;
 
   const std::shared_ptr<DHTNode>& getTargetNode() const;
+  const std::string& getTransactionID() const { return transactionID_; }
   const std::string& getMessageType() const;
   const std::unique_ptr<DHTMessageCallback>& getCallback() const;
   std::unique_ptr<DHTMessageCallback> popCallback();
   Timer::Clock::duration getElapsed() const;
+  // Returns the time when this entry times out.
+  Timer::Clock::time_point getTimeoutTime() const
+  {
+    return dispatchedTime_.getTime() + timeout_;
+  }
 };
 
 } // namespace aria2
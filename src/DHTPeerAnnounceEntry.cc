@@ -53,7 +53,17 @@ void DHTPeerAnnounceEntry::addPeerAddrEntry(const PeerAddrEntry& entry)
 {
   auto i = std::find(peerAddrEntries_.begin(), peerAddrEntries_.end(), entry);
   if (i == peerAddrEntries_.end()) {
-    peerAddrEntries_.push_back(entry);
+    if (peerAddrEntries_.size() < DHT_PEER_ANNOUNCE_MAX_PEER) {
+      peerAddrEntries_.push_back(entry);
+    }
+    else {
+      // Replace the peer which has not announced for the longest time.
+      *std::min_element(std::begin(peerAddrEntries_),
+                        std::end(peerAddrEntries_),
+                        [](const PeerAddrEntry& lhs, const PeerAddrEntry& rhs) {
+                          return lhs.getLastUpdated() < rhs.getLastUpdated();
+                        }) = entry;
+    }
   }
   else {
     (*i).notifyUpdate();
@@ -36,8 +36,8 @@
 
 #include <cstring>
 #include <algorithm>
+#include <iterator>
 
-#include "DHTPeerAnnounceEntry.h"
 #include "Peer.h"
 #include "DHTConstants.h"
 #include "DHTTaskQueue.h"
@@ -52,33 +52,26 @@
 
 namespace aria2 {
 
-DHTPeerAnnounceStorage::DHTPeerAnnounceStorage()
-    : taskQueue_{nullptr}, taskFactory_{nullptr}
+namespace {
+std::string toKey(const unsigned char* infoHash)
 {
+  return std::string(reinterpret_cast<const char*>(infoHash), DHT_ID_LENGTH);
 }
+} // namespace
 
-bool DHTPeerAnnounceStorage::InfoHashLess::operator()(
-    const std::shared_ptr<DHTPeerAnnounceEntry>& lhs,
-    const std::shared_ptr<DHTPeerAnnounceEntry>& rhs) const
+DHTPeerAnnounceStorage::DHTPeerAnnounceStorage(size_t capacity)
+    : capacity_{capacity}, taskQueue_{nullptr}, taskFactory_{nullptr}
 {
-  return memcmp(lhs->getInfoHash(), rhs->getInfoHash(), DHT_ID_LENGTH) < 0;
 }
 
-std::shared_ptr<DHTPeerAnnounceEntry>
-DHTPeerAnnounceStorage::getPeerAnnounceEntry(const unsigned char* infoHash)
+DHTPeerAnnounceEntry*
+DHTPeerAnnounceStorage::findEntry(const unsigned char* infoHash) const
 {
-  auto entry = std::make_shared<DHTPeerAnnounceEntry>(infoHash);
-
-  auto i = entries_.lower_bound(entry);
-
-  if (i != entries_.end() &&
-      memcmp(infoHash, (*i)->getInfoHash(), DHT_ID_LENGTH) == 0) {
-    entry = *i;
+  auto i = index_.find(toKey(infoHash));
+  if (i == std::end(index_)) {
+    return nullptr;
   }
-  else {
-    entries_.insert(i, entry);
-  }
-  return entry;
+  return &*(*i).second;
 }
 
 void DHTPeerAnnounceStorage::addPeerAnnounce(const unsigned char* infoHash,
@@ -88,24 +81,40 @@ void DHTPeerAnnounceStorage::addPeerAnnounce(const unsigned char* infoHash,
   A2_LOG_DEBUG(fmt("Adding %s:%u to peer announce list: infoHash=%s",
                    ipaddr.c_str(), port,
                    util::toHex(infoHash, DHT_ID_LENGTH).c_str()));
-  getPeerAnnounceEntry(infoHash)->addPeerAddrEntry(PeerAddrEntry(ipaddr, port));
+  auto key = toKey(infoHash);
+  auto i = index_.find(key);
+  if (i == std::end(index_)) {
+    if (entries_.size() >= capacity_) {
+      if (entries_.empty()) {
+        return;
+      }
+      auto& victim = entries_.front();
+      A2_LOG_DEBUG(
+          fmt("Peer announce storage is full. Evicting infoHash=%s",
+              util::toHex(victim.getInfoHash(), DHT_ID_LENGTH).c_str()));
+      index_.erase(toKey(victim.getInfoHash()));
+      entries_.pop_front();
+    }
+    entries_.emplace_back(infoHash);
+    i = index_.emplace(std::move(key), std::prev(std::end(entries_))).first;
+  }
+  else {
+    entries_.splice(std::end(entries_), entries_, (*i).second);
+  }
+  (*i).second->addPeerAddrEntry(PeerAddrEntry(ipaddr, port));
 }
 
 bool DHTPeerAnnounceStorage::contains(const unsigned char* infoHash) const
 {
-  auto entry = std::make_shared<DHTPeerAnnounceEntry>(infoHash);
-  return std::binary_search(entries_.begin(), entries_.end(), entry,
-                            InfoHashLess());
+  return findEntry(infoHash);
 }
 
 void DHTPeerAnnounceStorage::getPeers(std::vector<std::shared_ptr<Peer>>& peers,
                                       const unsigned char* infoHash)
 {
-  auto entry = std::make_shared<DHTPeerAnnounceEntry>(infoHash);
-
-  auto i = entries_.find(entry);
-  if (i != entries_.end()) {
-    (*i)->getPeers(peers);
+  auto entry = findEntry(infoHash);
+  if (entry) {
+    entry->getPeers(peers);
   }
 }
 
@@ -113,14 +122,11 @@ void DHTPeerAnnounceStorage::handleTimeout()
 {
   A2_LOG_DEBUG(fmt("Now purge peer announces(%lu entries) which are timed out.",
                    static_cast<unsigned long>(entries_.size())));
-  std::for_each(std::begin(entries_), std::end(entries_),
-                [](const std::shared_ptr<DHTPeerAnnounceEntry>& e) {
-                  e->removeStalePeerAddrEntry(DHT_PEER_ANNOUNCE_PURGE_INTERVAL);
-                });
-
   for (auto i = std::begin(entries_); i != std::end(entries_);) {
-    if ((*i)->empty()) {
-      entries_.erase(i++);
+    (*i).removeStalePeerAddrEntry(DHT_PEER_ANNOUNCE_PURGE_INTERVAL);
+    if ((*i).empty()) {
+      index_.erase(toKey((*i).getInfoHash()));
+      i = entries_.erase(i);
     }
     else {
       ++i;
@@ -134,15 +140,15 @@ void DHTPeerAnnounceStorage::announcePeer()
 {
   A2_LOG_DEBUG("Now announcing peer.");
   for (auto& e : entries_) {
-    if (e->getLastUpdated().difference(global::wallclock()) <
+    if (e.getLastUpdated().difference(global::wallclock()) <
         DHT_PEER_ANNOUNCE_INTERVAL) {
       continue;
     }
-    e->notifyUpdate();
-    auto task = taskFactory_->createPeerAnnounceTask(e->getInfoHash());
+    e.notifyUpdate();
+    auto task = taskFactory_->createPeerAnnounceTask(e.getInfoHash());
     taskQueue_->addPeriodicTask2(task);
     A2_LOG_DEBUG(fmt("Added 1 peer announce: infoHash=%s",
-                     util::toHex(e->getInfoHash(), DHT_ID_LENGTH).c_str()));
+                     util::toHex(e.getInfoHash(), DHT_ID_LENGTH).c_str()));
   }
 }
 
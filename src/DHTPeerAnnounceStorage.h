@@ -37,44 +37,50 @@
 
 #include "common.h"
 
-#include <set>
+#include <list>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <memory>
 
+#include "DHTPeerAnnounceEntry.h"
+
 namespace aria2 {
 
 class Peer;
-class DHTPeerAnnounceEntry;
 class DHTTaskQueue;
 class DHTTaskFactory;
 
 class DHTPeerAnnounceStorage {
 private:
-  class InfoHashLess {
-  public:
-    bool operator()(const std::shared_ptr<DHTPeerAnnounceEntry>& lhs,
-                    const std::shared_ptr<DHTPeerAnnounceEntry>& rhs) const;
-  };
-  typedef std::set<std::shared_ptr<DHTPeerAnnounceEntry>, InfoHashLess>
-      DHTPeerAnnounceEntrySet;
-  DHTPeerAnnounceEntrySet entries_;
-
-  std::shared_ptr<DHTPeerAnnounceEntry>
-  getPeerAnnounceEntry(const unsigned char* infoHash);
+  // Sorted by the time of the last announce, the most recent one
+  // last.  When the storage is full, the entry at the front is
+  // evicted.
+  std::list<DHTPeerAnnounceEntry> entries_;
+
+  // Maps info hash to the entry in entries_.
+  std::unordered_map<std::string, std::list<DHTPeerAnnounceEntry>::iterator>
+      index_;
+
+  // The maximum number of info hashes stored.
+  size_t capacity_;
+
+  DHTPeerAnnounceEntry* findEntry(const unsigned char* infoHash) const;
 
   DHTTaskQueue* taskQueue_;
 
   DHTTaskFactory* taskFactory_;
 
 public:
-  DHTPeerAnnounceStorage();
+  DHTPeerAnnounceStorage(size_t capacity = DHT_PEER_ANNOUNCE_STORAGE_SIZE);
 
   void addPeerAnnounce(const unsigned char* infoHash, const std::string& ipaddr,
                        uint16_t port);
 
   bool contains(const unsigned char* infoHash) const;
 
+  size_t countEntry() const { return entries_.size(); }
+
   void getPeers(std::vector<std::shared_ptr<Peer>>& peers,
                 const unsigned char* infoHash);
 
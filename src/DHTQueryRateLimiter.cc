@@ -0,0 +1,92 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "DHTQueryRateLimiter.h"
+
+#include <algorithm>
+
+namespace aria2 {
+
+DHTQueryRateLimiter::DHTQueryRateLimiter(size_t rate) : rate_(rate) {}
+
+void DHTQueryRateLimiter::refill(Bucket& bucket, const Timer& now) const
+{
+  auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(
+      bucket.lastRefill.difference(now));
+  if (elapsed.count() > 0) {
+    bucket.tokens = std::min(rate_, bucket.tokens + elapsed.count() * rate_);
+    bucket.lastRefill = now;
+  }
+}
+
+bool DHTQueryRateLimiter::accept(const std::string& ipaddr, const Timer& now)
+{
+  if (rate_ == 0) {
+    return true;
+  }
+  auto i = buckets_.find(ipaddr);
+  if (i == std::end(buckets_)) {
+    if (buckets_.size() >= MAX_SOURCE) {
+      buckets_.erase(lru_.front());
+      lru_.pop_front();
+    }
+    lru_.push_back(ipaddr);
+    buckets_.emplace(ipaddr, Bucket{rate_ - 1, now, --std::end(lru_)});
+    return true;
+  }
+  auto& bucket = (*i).second;
+  lru_.splice(std::end(lru_), lru_, bucket.lruEntry);
+  refill(bucket, now);
+  if (bucket.tokens < 1) {
+    return false;
+  }
+  bucket.tokens -= 1;
+  return true;
+}
+
+void DHTQueryRateLimiter::purge(const Timer& now)
+{
+  for (auto i = std::begin(buckets_); i != std::end(buckets_);) {
+    refill((*i).second, now);
+    if ((*i).second.tokens >= rate_) {
+      lru_.erase((*i).second.lruEntry);
+      i = buckets_.erase(i);
+    }
+    else {
+      ++i;
+    }
+  }
+}
+
+} // namespace aria2
@@ -0,0 +1,97 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_DHT_QUERY_RATE_LIMITER_H
+#define D_DHT_QUERY_RATE_LIMITER_H
+
+#include "common.h"
+
+#include <string>
+#include <list>
+#include <unordered_map>
+
+#include "TimerA2.h"
+
+namespace aria2 {
+
+// Limits the number of DHT queries accepted from each IP address
+// using a token bucket per address.  The bucket holds at most one
+// second worth of tokens.
+class DHTQueryRateLimiter {
+public:
+  // |rate| is the number of queries per second accepted from one IP
+  // address.  0 means unlimited.
+  DHTQueryRateLimiter(size_t rate);
+
+  // Returns true if the query from |ipaddr| received at |now| should
+  // be processed, and consumes a token.  Returns false if it should
+  // be dropped.
+  bool accept(const std::string& ipaddr, const Timer& now);
+
+  // Forgets the addresses whose bucket is full at |now|.  This
+  // function visits all addresses, and is meant to be called
+  // periodically.
+  void purge(const Timer& now);
+
+  size_t countSource() const { return buckets_.size(); }
+
+  // The maximum number of addresses tracked.  When a query comes from
+  // a new address and this many addresses are tracked, the address
+  // which sent a query least recently is forgotten.
+  static const size_t MAX_SOURCE = 65536;
+
+private:
+  struct Bucket {
+    double tokens;
+    Timer lastRefill;
+    // The position of the address in lru_.
+    std::list<std::string>::iterator lruEntry;
+  };
+
+  // Adds the tokens accumulated since the last refill.
+  void refill(Bucket& bucket, const Timer& now) const;
+
+  std::unordered_map<std::string, Bucket> buckets_;
+
+  // The addresses in buckets_, sorted by the time of the last query,
+  // the oldest first.  The bucket of the first one has been refilled
+  // the longest, so forgetting it costs the least.
+  std::list<std::string> lru_;
+
+  double rate_;
+};
+
+} // namespace aria2
+
+#endif // D_DHT_QUERY_RATE_LIMITER_H
@@ -49,10 +49,11 @@
 
 namespace aria2 {
 
-DHTRoutingTable::DHTRoutingTable(const std::shared_ptr<DHTNode>& localNode)
+DHTRoutingTable::DHTRoutingTable(const std::shared_ptr<DHTNode>& localNode,
+                                 size_t bucketSize)
     : localNode_(localNode),
       root_(make_unique<DHTBucketTreeNode>(
-          std::make_shared<DHTBucket>(localNode_))),
+          std::make_shared<DHTBucket>(localNode_, bucketSize))),
       numBucket_(1),
       taskQueue_{nullptr},
       taskFactory_{nullptr}
@@ -41,6 +41,8 @@
 #include <vector>
 #include <memory>
 
+#include "DHTConstants.h"
+
 namespace aria2 {
 
 class DHTNode;
@@ -64,7 +66,9 @@ private:
   bool addNode(const std::shared_ptr<DHTNode>& node, bool good);
 
 public:
-  DHTRoutingTable(const std::shared_ptr<DHTNode>& localNode);
+  // |bucketSize| is the maximum number of nodes in each bucket.
+  DHTRoutingTable(const std::shared_ptr<DHTNode>& localNode,
+                  size_t bucketSize = DHT_BUCKET_SIZE);
 
   ~DHTRoutingTable();
 
@@ -140,13 +140,16 @@ DHTSetup::setup(DownloadEngine* e, int family)
     A2_LOG_DEBUG(fmt("Initialized local node ID=%s",
                      util::toHex(localNode->getID(), DHT_ID_LENGTH).c_str()));
     auto tracker = std::make_shared<DHTMessageTracker>();
-    auto routingTable = make_unique<DHTRoutingTable>(localNode);
+    auto routingTable = make_unique<DHTRoutingTable>(
+        localNode, e->getOption()->getAsInt(PREF_DHT_BUCKET_SIZE));
     auto factory = make_unique<DHTMessageFactoryImpl>(family);
     auto dispatcher = make_unique<DHTMessageDispatcherImpl>(tracker);
-    auto receiver = make_unique<DHTMessageReceiver>(tracker);
+    auto receiver = make_unique<DHTMessageReceiver>(
+        tracker, e->getOption()->getAsInt(PREF_DHT_QUERY_RATE_LIMIT));
     auto taskQueue = make_unique<DHTTaskQueueImpl>();
     auto taskFactory = make_unique<DHTTaskFactoryImpl>();
-    auto peerAnnounceStorage = make_unique<DHTPeerAnnounceStorage>();
+    auto peerAnnounceStorage = make_unique<DHTPeerAnnounceStorage>(
+        e->getOption()->getAsInt(PREF_DHT_PEER_STORE_SIZE));
     auto tokenTracker = make_unique<DHTTokenTracker>();
     // For now, UDPTrackerClient was enabled along with DHT
     auto udpTrackerClient = std::make_shared<UDPTrackerClient>();
@@ -63,9 +63,10 @@ void DHTTaskExecutor::update()
   else {
     r = 0;
   }
-  while (r && !queue_.empty()) {
-    std::shared_ptr<DHTTask> task = queue_.front();
-    queue_.pop_front();
+  while (r && (!priorityQueue_.empty() || !queue_.empty())) {
+    auto& q = priorityQueue_.empty() ? queue_ : priorityQueue_;
+    std::shared_ptr<DHTTask> task = q.front();
+    q.pop_front();
     task->startup();
     if (!task->finished()) {
       execTasks_.push_back(task);
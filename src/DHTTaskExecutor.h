@@ -50,6 +50,8 @@ private:
   int numConcurrent_;
   std::vector<std::shared_ptr<DHTTask>> execTasks_;
   std::deque<std::shared_ptr<DHTTask>> queue_;
+  // Tasks started before the ones in queue_.
+  std::deque<std::shared_ptr<DHTTask>> priorityQueue_;
 
 public:
   DHTTaskExecutor(int numConcurrent);
@@ -60,11 +62,19 @@ public:
 
   void addTask(const std::shared_ptr<DHTTask>& task) { queue_.push_back(task); }
 
+  void addPriorityTask(const std::shared_ptr<DHTTask>& task)
+  {
+    priorityQueue_.push_back(task);
+  }
+
   size_t getExecutingTaskSize() const { return execTasks_.size(); }
 
   int getNumConcurrent() const { return numConcurrent_; }
 
-  size_t getQueueSize() const { return queue_.size(); }
+  size_t getQueueSize() const
+  {
+    return queue_.size() + priorityQueue_.size();
+  }
 };
 
 } // namespace aria2
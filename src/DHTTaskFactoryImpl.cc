@@ -93,6 +93,7 @@ std::shared_ptr<DHTTask> DHTTaskFactoryImpl::createPeerLookupTask(
   auto task = std::make_shared<DHTPeerLookupTask>(ctx, tcpPort);
   // TODO this may be not freed by RequestGroup::releaseRuntimeResource()
   task->setPeerStorage(peerStorage);
+  task->setNodeCache(&nodeCache_);
   setCommonProperty(task);
   return task;
 }
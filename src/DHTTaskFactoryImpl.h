@@ -37,6 +37,7 @@
 
 #include "DHTTaskFactory.h"
 #include "a2time.h"
+#include "DHTClosestNodeCache.h"
 
 namespace aria2 {
 
@@ -61,6 +62,9 @@ private:
 
   std::chrono::seconds timeout_;
 
+  // Shared by peer lookups.
+  DHTClosestNodeCache nodeCache_;
+
   void setCommonProperty(const std::shared_ptr<DHTAbstractTask>& task);
 
 public:
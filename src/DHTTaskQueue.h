@@ -54,6 +54,11 @@ public:
   virtual void addPeriodicTask2(const std::shared_ptr<DHTTask>& task) = 0;
 
   virtual void addImmediateTask(const std::shared_ptr<DHTTask>& task) = 0;
+
+  // Adds get_peers lookup.  If |priority| is true, the task is started
+  // before the other lookups waiting in the queue.
+  virtual void addPeerLookupTask(const std::shared_ptr<DHTTask>& task,
+                                 bool priority) = 0;
 };
 
 } // namespace aria2
@@ -41,12 +41,17 @@ namespace aria2 {
 
 namespace {
 const size_t NUM_CONCURRENT_TASK = 15;
+// The number of get_peers lookups run at once.  Each lookup has at
+// most DHTAbstractNodeLookupTask::ALPHA(=3) messages in flight, so
+// this bounds the get_peers messages in flight to 300.
+const size_t NUM_CONCURRENT_PEER_LOOKUP_TASK = 100;
 } // namespace
 
 DHTTaskQueueImpl::DHTTaskQueueImpl()
     : periodicTaskQueue1_(NUM_CONCURRENT_TASK),
       periodicTaskQueue2_(NUM_CONCURRENT_TASK),
-      immediateTaskQueue_(NUM_CONCURRENT_TASK)
+      immediateTaskQueue_(NUM_CONCURRENT_TASK),
+      peerLookupTaskQueue_(NUM_CONCURRENT_PEER_LOOKUP_TASK)
 {
 }
 
@@ -60,6 +65,8 @@ void DHTTaskQueueImpl::executeTask()
   periodicTaskQueue2_.update();
   A2_LOG_DEBUG("Updating immediateTaskQueue");
   immediateTaskQueue_.update();
+  A2_LOG_DEBUG("Updating peerLookupTaskQueue");
+  peerLookupTaskQueue_.update();
 }
 
 void DHTTaskQueueImpl::addPeriodicTask1(const std::shared_ptr<DHTTask>& task)
@@ -77,4 +84,15 @@ void DHTTaskQueueImpl::addImmediateTask(const std::shared_ptr<DHTTask>& task)
   immediateTaskQueue_.addTask(task);
 }
 
+void DHTTaskQueueImpl::addPeerLookupTask(const std::shared_ptr<DHTTask>& task,
+                                         bool priority)
+{
+  if (priority) {
+    peerLookupTaskQueue_.addPriorityTask(task);
+  }
+  else {
+    peerLookupTaskQueue_.addTask(task);
+  }
+}
+
 } // namespace aria2
@@ -48,6 +48,8 @@ private:
 
   DHTTaskExecutor immediateTaskQueue_;
 
+  DHTTaskExecutor peerLookupTaskQueue_;
+
 public:
   DHTTaskQueueImpl();
 
@@ -63,6 +65,9 @@ public:
 
   virtual void
   addImmediateTask(const std::shared_ptr<DHTTask>& task) CXX11_OVERRIDE;
+
+  virtual void addPeerLookupTask(const std::shared_ptr<DHTTask>& task,
+                                 bool priority) CXX11_OVERRIDE;
 };
 
 } // namespace aria2
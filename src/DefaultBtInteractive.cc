@@ -304,6 +304,7 @@ size_t DefaultBtInteractive::receiveMessages()
   size_t msgcount = 0;
   while (1) {
     if (requestGroupMan_->doesOverallDownloadSpeedExceed() ||
+        requestGroupMan_->isDiskWriteQueueFull() ||
         downloadContext_->getOwnerRequestGroup()->doesDownloadSpeedExceed()) {
       break;
     }
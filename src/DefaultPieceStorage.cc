@@ -164,23 +164,19 @@ std::shared_ptr<Piece> DefaultPieceStorage::getPiece(size_t index)
 
 void DefaultPieceStorage::addUsedPiece(const std::shared_ptr<Piece>& piece)
 {
-  usedPieces_.insert(piece);
+  usedPieces_.insert(std::make_pair(piece->getIndex(), piece));
   A2_LOG_DEBUG(fmt("usedPieces_.size()=%lu",
                    static_cast<unsigned long>(usedPieces_.size())));
 }
 
 std::shared_ptr<Piece> DefaultPieceStorage::findUsedPiece(size_t index) const
 {
-  auto p = std::make_shared<Piece>();
-  p->setIndex(index);
-
-  auto i = usedPieces_.find(p);
+  auto i = usedPieces_.find(index);
   if (i == usedPieces_.end()) {
-    p.reset();
-    return p;
+    return nullptr;
   }
   else {
-    return *i;
+    return (*i).second;
   }
 }
 
@@ -416,7 +412,7 @@ void DefaultPieceStorage::deleteUsedPiece(const std::shared_ptr<Piece>& piece)
   if (!piece) {
     return;
   }
-  usedPieces_.erase(piece);
+  usedPieces_.erase(piece->getIndex());
   piece->releaseWrCache(wrDiskCache_);
 }
 
@@ -471,6 +467,7 @@ void DefaultPieceStorage::completePiece(const std::shared_ptr<Piece>& piece)
   bitfieldMan_->setBit(piece->getIndex());
   bitfieldMan_->unsetUseBit(piece->getIndex());
   addPieceStats(piece->getIndex());
+  pieceStatMan_->addHave(piece->getIndex());
   if (downloadFinished()) {
     downloadContext_->resetDownloadStopTime();
     if (isSelectiveDownloadingMode()) {
@@ -574,7 +571,7 @@ int64_t DefaultPieceStorage::getInFlightPieceCompletedLength() const
 {
   int64_t len = 0;
   for (auto& elem : usedPieces_) {
-    len += elem->getCompletedLength();
+    len += elem.second->getCompletedLength();
   }
   return len;
 }
@@ -583,8 +580,8 @@ int64_t DefaultPieceStorage::getInFlightPieceFilteredCompletedLength() const
 {
   int64_t len = 0;
   for (auto& elem : usedPieces_) {
-    if (bitfieldMan_->isFilterBitSet(elem->getIndex())) {
-      len += elem->getCompletedLength();
+    if (bitfieldMan_->isFilterBitSet(elem.first)) {
+      len += elem.second->getCompletedLength();
     }
   }
   return len;
@@ -666,6 +663,7 @@ void DefaultPieceStorage::setBitfield(const unsigned char* bitfield,
 {
   bitfieldMan_->setBitfield(bitfield, bitfieldLength);
   addPieceStats(bitfield, bitfieldLength);
+  updateHave();
 }
 
 size_t DefaultPieceStorage::getBitfieldLength()
@@ -690,10 +688,11 @@ void DefaultPieceStorage::flushWrDiskCacheEntry(bool releaseEntries)
   if (!wrDiskCache_) {
     return;
   }
-  // UsedPieceSet is sorted by piece index. It means we can flush
+  // UsedPieceMap is sorted by piece index. It means we can flush
   // cache by non-decreasing offset, which is good to reduce disk seek
   // unless the file is heavily fragmented.
-  for (auto& piece : usedPieces_) {
+  for (auto& elem : usedPieces_) {
+    auto& piece = elem.second;
     auto ce = piece->getWrDiskCacheEntry();
     if (ce) {
       piece->flushWrCache(wrDiskCache_);
@@ -749,7 +748,17 @@ void DefaultPieceStorage::removeAdvertisedPiece(const Timer& expiry)
   haves_.erase(std::begin(haves_), it);
 }
 
-void DefaultPieceStorage::markAllPiecesDone() { bitfieldMan_->setAllBit(); }
+void DefaultPieceStorage::markAllPiecesDone()
+{
+  bitfieldMan_->setAllBit();
+  updateHave();
+}
+
+void DefaultPieceStorage::updateHave()
+{
+  pieceStatMan_->setHave(bitfieldMan_->getBitfield(),
+                         bitfieldMan_->getBitfieldLength());
+}
 
 void DefaultPieceStorage::markPiecesDone(int64_t length)
 {
@@ -780,17 +789,21 @@ void DefaultPieceStorage::markPiecesDone(int64_t length)
       addUsedPiece(p);
     }
   }
+  updateHave();
 }
 
 void DefaultPieceStorage::markPieceMissing(size_t index)
 {
   bitfieldMan_->unsetBit(index);
+  pieceStatMan_->removeHave(index);
 }
 
 void DefaultPieceStorage::addInFlightPiece(
     const std::vector<std::shared_ptr<Piece>>& pieces)
 {
-  usedPieces_.insert(pieces.begin(), pieces.end());
+  for (auto& piece : pieces) {
+    usedPieces_.insert(std::make_pair(piece->getIndex(), piece));
+  }
 }
 
 size_t DefaultPieceStorage::countInFlightPiece() { return usedPieces_.size(); }
@@ -798,7 +811,9 @@ size_t DefaultPieceStorage::countInFlightPiece() { return usedPieces_.size(); }
 void DefaultPieceStorage::getInFlightPieces(
     std::vector<std::shared_ptr<Piece>>& pieces)
 {
-  pieces.insert(pieces.end(), usedPieces_.begin(), usedPieces_.end());
+  for (auto& elem : usedPieces_) {
+    pieces.push_back(elem.second);
+  }
 }
 
 void DefaultPieceStorage::setDiskWriterFactory(
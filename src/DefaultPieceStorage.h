@@ -38,7 +38,7 @@
 #include "PieceStorage.h"
 
 #include <deque>
-#include <set>
+#include <map>
 
 #include "a2functional.h"
 
@@ -76,9 +76,10 @@ private:
   std::unique_ptr<BitfieldMan> bitfieldMan_;
   std::shared_ptr<DiskAdaptor> diskAdaptor_;
   std::shared_ptr<DiskWriterFactory> diskWriterFactory_;
-  typedef std::set<std::shared_ptr<Piece>, DerefLess<std::shared_ptr<Piece>>>
-      UsedPieceSet;
-  UsedPieceSet usedPieces_;
+  // In-flight pieces keyed by piece index, so that they can be
+  // looked up without creating a probe Piece object.
+  typedef std::map<size_t, std::shared_ptr<Piece>> UsedPieceMap;
+  UsedPieceMap usedPieces_;
 
   bool endGame_;
   size_t endGamePieceNum_;
@@ -116,6 +117,10 @@ private:
   // intersecting filter ranges.
   int64_t getInFlightPieceFilteredCompletedLength() const;
 
+  // Tells pieceStatMan_ all pieces we have after bitfieldMan_ is
+  // changed in bulk.
+  void updateHave();
+
 public:
   // Setting randomPieceStatsOrdering to true means a piece is chosen in
   // random when more than 2 pieces has the same rarity.
@@ -33,8 +33,15 @@
  */
 /* copyright --> */
 #include "DiskAdaptor.h"
+
+#include <array>
+
 #include "FileEntry.h"
 #include "OpenedFileCounter.h"
+#include "WrDiskCacheEntry.h"
+#include "DiskWriteQueue.h"
+#include "LogFactory.h"
+#include "fmt.h"
 
 namespace aria2 {
 
@@ -42,4 +49,76 @@ DiskAdaptor::DiskAdaptor() : fileAllocationMethod_(FILE_ALLOC_ADAPTIVE) {}
 
 DiskAdaptor::~DiskAdaptor() = default;
 
+void DiskAdaptor::writeDataV(a2iovec* iov, size_t iovcnt, int64_t offset)
+{
+  for (size_t i = 0; i < iovcnt; ++i) {
+    writeData(reinterpret_cast<unsigned char*>(iov[i].A2IOVEC_BASE),
+              iov[i].A2IOVEC_LEN, offset);
+    offset += iov[i].A2IOVEC_LEN;
+  }
+}
+
+void DiskAdaptor::writeDataVAsync(a2iovec* iov, size_t iovcnt, int64_t offset,
+                                  DiskWriteBatch* batch)
+{
+  writeDataV(iov, iovcnt, offset);
+}
+
+namespace {
+// Writes |dataSet| to |adaptor|, coalescing adjacent data cells.  If
+// |batch| is not nullptr, the data are written by
+// DiskAdaptor::writeDataVAsync().
+void writeDataSet(DiskAdaptor* adaptor,
+                  const WrDiskCacheEntry::DataCellSet& dataSet,
+                  DiskWriteBatch* batch)
+{
+  std::array<a2iovec, A2_IOV_MAX> iov;
+  size_t iovcnt = 0;
+  // [start, end) is the range covered by iov
+  int64_t start = 0;
+  int64_t end = 0;
+  auto flush = [&]() {
+    if (batch) {
+      adaptor->writeDataVAsync(iov.data(), iovcnt, start, batch);
+    }
+    else {
+      adaptor->writeDataV(iov.data(), iovcnt, start);
+    }
+  };
+  for (auto& d : dataSet) {
+    A2_LOG_DEBUG(fmt("Cache flush goff=%" PRId64 ", len=%lu", d->goff,
+                     static_cast<unsigned long>(d->len)));
+    if (iovcnt > 0 && (d->goff != end || iovcnt == iov.size())) {
+      flush();
+      iovcnt = 0;
+    }
+    if (iovcnt == 0) {
+      start = end = d->goff;
+    }
+    iov[iovcnt].A2IOVEC_BASE = reinterpret_cast<char*>(d->data + d->offset);
+    iov[iovcnt].A2IOVEC_LEN = d->len;
+    ++iovcnt;
+    end += d->len;
+  }
+  if (iovcnt > 0) {
+    flush();
+  }
+}
+} // namespace
+
+void DiskAdaptor::writeCache(const WrDiskCacheEntry* entry)
+{
+  writeDataSet(this, entry->getDataSet(), nullptr);
+}
+
+void DiskAdaptor::writeDataCells(const WrDiskCacheEntry::DataCellSet& dataSet)
+{
+  writeDataSet(this, dataSet, nullptr);
+}
+
+void DiskAdaptor::writeCacheAsync(DiskWriteBatch* batch)
+{
+  writeDataSet(this, batch->getDataSet(), batch);
+}
+
 } // namespace aria2
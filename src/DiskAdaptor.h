@@ -42,13 +42,16 @@
 #include <memory>
 
 #include "TimeA2.h"
+#include "a2netcompat.h"
+#include "WrDiskCacheEntry.h"
 
 namespace aria2 {
 
 class FileEntry;
 class FileAllocationIterator;
-class WrDiskCacheEntry;
 class OpenedFileCounter;
+class SharedFileDescriptor;
+class DiskWriteBatch;
 
 class DiskAdaptor : public BinaryStream {
 public:
@@ -111,12 +114,49 @@ public:
   virtual ssize_t readDataDropCache(unsigned char* data, size_t len,
                                     int64_t offset) = 0;
 
-  // Writes cached data to the underlying disk.
-  virtual void writeCache(const WrDiskCacheEntry* entry) = 0;
+  // Tells OS that data in range [offset, offset + len) will be read
+  // soon.  This is just a hint and never fails.
+  virtual void prefetch(int64_t len, int64_t offset) {}
+
+  // Writes |iovcnt| buffers pointed by |iov| to the contiguous range
+  // starting at |offset|.  The contents of |iov| may be modified.
+  // The default implementation calls writeData() for each buffer.
+  virtual void writeDataV(a2iovec* iov, size_t iovcnt, int64_t offset);
+
+  // Like writeDataV(), but the writes to the underlying DiskWriters
+  // are handed over to |batch|.  Files are opened in the calling
+  // thread.  The default implementation writes synchronously.
+  virtual void writeDataVAsync(a2iovec* iov, size_t iovcnt, int64_t offset,
+                               DiskWriteBatch* batch);
+
+  // Writes cached data to the underlying disk.  Adjacent data cells
+  // are coalesced and written by a single writeDataV() call.
+  virtual void writeCache(const WrDiskCacheEntry* entry);
+
+  // Writes |dataSet| in the same way as writeCache().  The data cells
+  // may come from more than one WrDiskCacheEntry.
+  void writeDataCells(const WrDiskCacheEntry::DataCellSet& dataSet);
+
+  // Like writeCache(), but writes the data cells owned by |batch|
+  // using writeDataVAsync().
+  void writeCacheAsync(DiskWriteBatch* batch);
 
   // Force physical write of data from OS buffer cache.
   virtual void flushOSBuffers(){};
 
+  // Returns the descriptor of the file which contains the whole
+  // range [offset, offset + len), and assigns the offset of the range
+  // in that file to |fileOffset|.  The descriptor is shared with
+  // other uploads from the same file (see
+  // DiskWriter::shareFileDescriptor()).  Returns nullptr if the range
+  // spans multiple files or the descriptor is not available.  The
+  // default implementation returns nullptr.
+  virtual std::shared_ptr<SharedFileDescriptor>
+  shareFileDescriptor(int64_t offset, int64_t len, int64_t& fileOffset)
+  {
+    return nullptr;
+  }
+
   void setFileAllocationMethod(FileAllocationMethod method)
   {
     fileAllocationMethod_ = method;
@@ -0,0 +1,148 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "DiskWriteQueue.h"
+
+#include <vector>
+
+#include "DiskAdaptor.h"
+#include "DiskWriter.h"
+#include "RecoverableException.h"
+#include "BufferPool.h"
+
+namespace aria2 {
+
+DiskWriteBatch::DiskWriteBatch(DiskWriteQueue* queue,
+                               WrDiskCacheEntry::DataCellSet dataSet,
+                               size_t size)
+    : queue_(queue),
+      dataSet_(std::move(dataSet)),
+      size_(size),
+      numPending_(1),
+      failed_(false),
+      errorCode_(error_code::UNDEFINED)
+{
+}
+
+DiskWriteBatch::~DiskWriteBatch() { deleteDataCells(); }
+
+void DiskWriteBatch::deleteDataCells()
+{
+  for (auto& e : dataSet_) {
+    BufferPool::getInstance().deallocate(e->data);
+    delete e;
+  }
+  dataSet_.clear();
+}
+
+void DiskWriteBatch::push(DiskWriter* diskWriter, a2iovec* iov, size_t iovcnt,
+                          int64_t offset)
+{
+  {
+#ifdef HAVE_STD_THREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif // HAVE_STD_THREAD
+    ++numPending_;
+  }
+  auto self = shared_from_this();
+  try {
+    diskWriter->writeDataVAsync(
+        queue_->getWorkerThreadPool(), std::vector<a2iovec>(iov, iov + iovcnt),
+        offset, [self](const RecoverableException* e) { self->done(e); });
+  }
+  catch (RecoverableException& e) {
+    // DiskWriter which does not support asynchronous write throws
+    // here.
+    done(&e);
+  }
+}
+
+void DiskWriteBatch::done(const RecoverableException* e)
+{
+#ifdef HAVE_STD_THREAD
+  std::lock_guard<std::mutex> lock(mutex_);
+#endif // HAVE_STD_THREAD
+  if (e && !failed_) {
+    failed_ = true;
+    errorCode_ = e->getErrorCode();
+    errorMessage_ = e->stackTrace();
+  }
+  if (--numPending_ == 0) {
+    queue_->release(size_);
+#ifdef HAVE_STD_THREAD
+    cond_.notify_all();
+#endif // HAVE_STD_THREAD
+  }
+}
+
+void DiskWriteBatch::wait()
+{
+#ifdef HAVE_STD_THREAD
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this]() { return numPending_ == 0; });
+#endif // HAVE_STD_THREAD
+}
+
+bool DiskWriteBatch::finished() const
+{
+#ifdef HAVE_STD_THREAD
+  std::lock_guard<std::mutex> lock(mutex_);
+#endif // HAVE_STD_THREAD
+  return numPending_ == 0;
+}
+
+DiskWriteQueue::DiskWriteQueue(size_t numThreads, size_t maxPendingSize)
+    : pendingSize_(0), maxPendingSize_(maxPendingSize), pool_(numThreads)
+{
+}
+
+DiskWriteQueue::~DiskWriteQueue() = default;
+
+std::shared_ptr<DiskWriteBatch>
+DiskWriteQueue::write(DiskAdaptor* diskAdaptor,
+                      WrDiskCacheEntry::DataCellSet dataSet, size_t size)
+{
+  pendingSize_ += size;
+  auto batch = std::make_shared<DiskWriteBatch>(this, std::move(dataSet), size);
+  try {
+    diskAdaptor->writeCacheAsync(batch.get());
+    batch->done(nullptr);
+  }
+  catch (RecoverableException& e) {
+    batch->done(&e);
+  }
+  return batch;
+}
+
+} // namespace aria2
@@ -0,0 +1,156 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_DISK_WRITE_QUEUE_H
+#define D_DISK_WRITE_QUEUE_H
+
+#include "common.h"
+
+#include <memory>
+#include <string>
+#include <atomic>
+#ifdef HAVE_STD_THREAD
+#  include <mutex>
+#  include <condition_variable>
+#endif // HAVE_STD_THREAD
+
+#include "WrDiskCacheEntry.h"
+#include "WorkerThreadPool.h"
+#include "a2netcompat.h"
+#include "error_code.h"
+
+namespace aria2 {
+
+class DiskAdaptor;
+class DiskWriter;
+class DiskWriteQueue;
+class RecoverableException;
+
+// The data cells of WrDiskCacheEntry which are being written to the
+// disk by DiskWriteQueue.  This object owns the data cells and frees
+// them when it is destroyed.
+class DiskWriteBatch : public std::enable_shared_from_this<DiskWriteBatch> {
+public:
+  DiskWriteBatch(DiskWriteQueue* queue, WrDiskCacheEntry::DataCellSet dataSet,
+                 size_t size);
+  ~DiskWriteBatch();
+
+  const WrDiskCacheEntry::DataCellSet& getDataSet() const { return dataSet_; }
+
+  size_t getSize() const { return size_; }
+
+  // Writes |iovcnt| buffers pointed by |iov| to |diskWriter| at
+  // |offset|.  This function is called by DiskAdaptor in the main
+  // thread.
+  void push(DiskWriter* diskWriter, a2iovec* iov, size_t iovcnt,
+            int64_t offset);
+
+  // Marks one write finished.  |e| is the error which happened in
+  // that write, or nullptr on success.  This function may be called
+  // in a worker thread.
+  void done(const RecoverableException* e);
+
+  // Blocks until all writes finish.
+  void wait();
+
+  // Returns true if all writes finish.
+  bool finished() const;
+
+  // The following functions are only meaningful after wait()
+  // returns.
+  bool failed() const { return failed_; }
+  error_code::Value getErrorCode() const { return errorCode_; }
+  const std::string& getErrorMessage() const { return errorMessage_; }
+
+private:
+  void deleteDataCells();
+
+  DiskWriteQueue* queue_;
+  WrDiskCacheEntry::DataCellSet dataSet_;
+  size_t size_;
+  // The number of writes not finished yet, plus one for the
+  // submitter until DiskWriteQueue::write() returns.
+  size_t numPending_;
+  bool failed_;
+  error_code::Value errorCode_;
+  std::string errorMessage_;
+#ifdef HAVE_STD_THREAD
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+#endif // HAVE_STD_THREAD
+};
+
+// Writes the data evicted from WrDiskCache in worker threads so that
+// slow storage does not stall the event loop.  The amount of data
+// being written is bounded by maxPendingSize; callers are expected to
+// check isFull() and stop reading from the network (or fall back to
+// synchronous writes) while it returns true.
+class DiskWriteQueue {
+public:
+  DiskWriteQueue(size_t numThreads, size_t maxPendingSize);
+  // Waits for all pending writes to finish.
+  ~DiskWriteQueue();
+
+  // Starts writing |dataSet|, which contains |size| bytes, to
+  // |diskAdaptor| and returns the object to track the progress.
+  // Files are opened in the calling thread; only the actual writes
+  // are done in the worker threads.
+  std::shared_ptr<DiskWriteBatch>
+  write(DiskAdaptor* diskAdaptor, WrDiskCacheEntry::DataCellSet dataSet,
+        size_t size);
+
+  // Returns the number of bytes being written.
+  size_t getPendingSize() const { return pendingSize_; }
+
+  size_t getMaxPendingSize() const { return maxPendingSize_; }
+
+  bool isFull() const { return pendingSize_ >= maxPendingSize_; }
+
+  WorkerThreadPool* getWorkerThreadPool() { return &pool_; }
+
+private:
+  friend class DiskWriteBatch;
+
+  void release(size_t size) { pendingSize_ -= size; }
+
+  std::atomic<size_t> pendingSize_;
+  size_t maxPendingSize_;
+  // Declared last so that the worker threads are joined before other
+  // members are destroyed.
+  WorkerThreadPool pool_;
+};
+
+} // namespace aria2
+
+#endif // D_DISK_WRITE_QUEUE_H
@@ -37,8 +37,19 @@
 
 #include "BinaryStream.h"
 
+#include <vector>
+#include <functional>
+#include <memory>
+
+#include "a2netcompat.h"
+
 namespace aria2 {
 
+class WorkerThreadPool;
+class RecoverableException;
+class SharedFileDescriptor;
+class OpenedFileCounter;
+
 /**
  * Interface for writing to a binary stream of bytes.
  *
@@ -70,6 +81,32 @@ public:
   // Returns file length
   virtual int64_t size() = 0;
 
+  // Writes |iovcnt| buffers pointed by |iov| to the contiguous range
+  // starting at |offset|.  The contents of |iov| may be modified.
+  // The default implementation calls writeData() for each buffer.
+  virtual void writeDataV(a2iovec* iov, size_t iovcnt, int64_t offset)
+  {
+    for (size_t i = 0; i < iovcnt; ++i) {
+      writeData(reinterpret_cast<unsigned char*>(iov[i].A2IOVEC_BASE),
+                iov[i].A2IOVEC_LEN, offset);
+      offset += iov[i].A2IOVEC_LEN;
+    }
+  }
+
+  // Like writeDataV(), but the write may be performed in one of the
+  // threads in |pool|.  |done| is called when the write finishes,
+  // possibly in the worker thread, with the error or nullptr on
+  // success.  The default implementation writes synchronously and
+  // throws on error without calling |done|.
+  virtual void
+  writeDataVAsync(WorkerThreadPool* pool, std::vector<a2iovec> iov,
+                  int64_t offset,
+                  std::function<void(const RecoverableException*)> done)
+  {
+    writeDataV(iov.data(), iov.size(), offset);
+    done(nullptr);
+  }
+
   // Enables read-only mode. After this call, openExistingFile() opens
   // file in read-only mode. This is an optional functionality. The
   // default implementation is do nothing.
@@ -86,8 +123,23 @@ public:
   // Drops cache in range [offset, offset + len)
   virtual void dropCache(int64_t len, int64_t offset) {}
 
+  // Tells OS that data in range [offset, offset + len) will be read
+  // soon so that it can be read ahead in background.
+  virtual void prefetch(int64_t len, int64_t offset) {}
+
   // Force physical write of data from OS buffer cache.
   virtual void flushOSBuffers() {}
+
+  // Returns the descriptor of the opened file shared by uploads, or
+  // nullptr if it is not available.  The descriptor is duplicated
+  // once after the file is opened, and it is counted by
+  // |openedFileCounter| if it is not nullptr.  The default
+  // implementation returns nullptr.
+  virtual std::shared_ptr<SharedFileDescriptor> shareFileDescriptor(
+      const std::shared_ptr<OpenedFileCounter>& openedFileCounter)
+  {
+    return nullptr;
+  }
 };
 
 } // namespace aria2
@@ -135,13 +135,14 @@ bool DownloadCommand::executeInternal()
   if (getDownloadEngine()
           ->getRequestGroupMan()
           ->doesOverallDownloadSpeedExceed() ||
+      getDownloadEngine()->getRequestGroupMan()->isDiskWriteQueueFull() ||
       getRequestGroup()->doesDownloadSpeedExceed()) {
     addCommandSelf();
     disableReadCheckSocket();
     disableWriteCheckSocket();
     return false;
   }
-  setReadCheckSocket(getSocket());
+  setReadCheckSocketIf(getSocket(), shouldEnableReadCheck());
 
   const std::shared_ptr<DiskAdaptor>& diskAdaptor =
       getPieceStorage()->getDiskAdaptor();
@@ -157,11 +158,12 @@ bool DownloadCommand::executeInternal()
     // read data from socket here, we will get EOF and leaves 2nd
     // response unprocessed.  To prevent this, we don't read from
     // socket when buffer is not empty.
-    eof = getSocketRecvBuffer()->recv() == 0 && !getSocket()->wantRead() &&
-          !getSocket()->wantWrite();
+    eof = receiveData();
   }
   if (!eof) {
     size_t bufSize;
+    // true if the receive buffer is handed over to write disk cache
+    bool bufDetached = false;
     if (sinkFilterOnly_) {
       if (segment->getLength() > 0) {
         if (segment->getPosition() + segment->getLength() <=
@@ -180,8 +182,25 @@ bool DownloadCommand::executeInternal()
       else {
         bufSize = getSocketRecvBuffer()->getBufferLength();
       }
-      streamFilter_->transform(diskAdaptor, segment,
-                               getSocketRecvBuffer()->getBuffer(), bufSize);
+      // If write disk cache is enabled and all buffered data go to
+      // this segment, hand the receive buffer over to the cache
+      // instead of copying the data.
+      size_t bufOffset, bufCapacity;
+      PoolBuffer buf;
+      if (segment->getPiece()->getWrDiskCacheEntry() &&
+          bufSize == getSocketRecvBuffer()->getBufferLength()) {
+        buf = getSocketRecvBuffer()->detachBuffer(bufOffset, bufCapacity);
+      }
+      if (buf) {
+        static_cast<SinkStreamFilter*>(streamFilter_.get())
+            ->transform(segment, std::move(buf), bufOffset, bufSize,
+                        bufCapacity);
+        bufDetached = true;
+      }
+      else {
+        streamFilter_->transform(diskAdaptor, segment,
+                                 getSocketRecvBuffer()->getBuffer(), bufSize);
+      }
     }
     else {
       // It is possible that segment is completed but we have some bytes
@@ -193,7 +212,9 @@ bool DownloadCommand::executeInternal()
                                getSocketRecvBuffer()->getBufferLength());
       bufSize = streamFilter_->getBytesProcessed();
     }
-    getSocketRecvBuffer()->drain(bufSize);
+    if (!bufDetached) {
+      getSocketRecvBuffer()->drain(bufSize);
+    }
     peerStat_->updateDownload(bufSize);
     getDownloadContext()->updateDownload(bufSize);
   }
@@ -299,6 +320,14 @@ bool DownloadCommand::shouldEnableWriteCheck()
   return getSocket()->wantWrite();
 }
 
+bool DownloadCommand::shouldEnableReadCheck() { return true; }
+
+bool DownloadCommand::receiveData()
+{
+  return getSocketRecvBuffer()->recv() == 0 && !getSocket()->wantRead() &&
+         !getSocket()->wantWrite();
+}
+
 void DownloadCommand::checkLowestDownloadSpeed() const
 {
   if (lowestDownloadSpeedLimit_ > 0 &&
@@ -84,6 +84,15 @@ protected:
   // getSocket()->wantWrite().
   virtual bool shouldEnableWriteCheck();
 
+  // Returns true if socket should be monitored for reading.  The
+  // default implementation returns true.
+  virtual bool shouldEnableReadCheck();
+
+  // Reads data into the receive buffer.  Returns true if the remote
+  // endpoint has finished sending data.  The default implementation
+  // reads from the socket.
+  virtual bool receiveData();
+
 public:
   DownloadCommand(cuid_t cuid, const std::shared_ptr<Request>& req,
                   const std::shared_ptr<FileEntry>& fileEntry,
@@ -75,6 +75,10 @@
 #endif // ENABLE_WEBSOCKET
 #include "Option.h"
 #include "util_security.h"
+#include "WorkerThreadPool.h"
+#ifdef HAVE_LIBNGHTTP2
+#  include "Http2Session.h"
+#endif // HAVE_LIBNGHTTP2
 
 namespace aria2 {
 
@@ -92,6 +96,9 @@ volatile sig_atomic_t globalHaltRequested = 0;
 
 namespace {
 constexpr auto DEFAULT_REFRESH_INTERVAL = 1_s;
+// How long HTTP pipelining is not used for a server after it closes
+// the connection before a pipelined response.
+constexpr auto PIPELINING_UNSUPPORTED_TIMEOUT = 1_h;
 } // namespace
 
 DownloadEngine::DownloadEngine(std::unique_ptr<EventPoll> eventPoll)
@@ -213,6 +220,16 @@ bool DownloadEngine::deleteSocketForReadCheck(
                                   EventPoll::EVENT_READ);
 }
 
+bool DownloadEngine::addFdForReadCheck(sock_t fd, Command* command)
+{
+  return eventPoll_->addEvents(fd, command, EventPoll::EVENT_READ);
+}
+
+bool DownloadEngine::deleteFdForReadCheck(sock_t fd, Command* command)
+{
+  return eventPoll_->deleteEvents(fd, command, EventPoll::EVENT_READ);
+}
+
 bool DownloadEngine::addSocketForWriteCheck(
     const std::shared_ptr<SocketCore>& socket, Command* command)
 {
@@ -506,6 +523,35 @@ DownloadEngine::popPooledSocket(std::string& options,
   return s;
 }
 
+void DownloadEngine::markPipeliningUnsupported(const std::string& host,
+                                               uint16_t port)
+{
+  // Servers are marked rarely.  Forget the expired ones here, rather
+  // than scanning them periodically.
+  for (auto i = std::begin(pipeliningUnsupportedHosts_);
+       i != std::end(pipeliningUnsupportedHosts_);) {
+    if ((*i).second.difference(global::wallclock()) >=
+        PIPELINING_UNSUPPORTED_TIMEOUT) {
+      i = pipeliningUnsupportedHosts_.erase(i);
+    }
+    else {
+      ++i;
+    }
+  }
+  pipeliningUnsupportedHosts_[fmt("%s(%u)", host.c_str(), port)] =
+      global::wallclock();
+}
+
+bool DownloadEngine::isPipeliningUnsupported(const std::string& host,
+                                             uint16_t port) const
+{
+  auto i = pipeliningUnsupportedHosts_.find(
+      fmt("%s(%u)", host.c_str(), port));
+  return i != std::end(pipeliningUnsupportedHosts_) &&
+         (*i).second.difference(global::wallclock()) <
+             PIPELINING_UNSUPPORTED_TIMEOUT;
+}
+
 DownloadEngine::SocketPoolEntry::SocketPoolEntry(
     const std::shared_ptr<SocketCore>& socket, const std::string& options,
     std::chrono::seconds timeout)
@@ -604,6 +650,18 @@ void DownloadEngine::setCheckIntegrityMan(
   checkIntegrityMan_ = std::move(ciman);
 }
 
+void DownloadEngine::setCheckIntegrityWorkerPool(
+    std::unique_ptr<WorkerThreadPool> pool)
+{
+  checkIntegrityWorkerPool_ = std::move(pool);
+}
+
+void DownloadEngine::setFileAllocationWorkerPool(
+    std::unique_ptr<WorkerThreadPool> pool)
+{
+  fileAllocationWorkerPool_ = std::move(pool);
+}
+
 #ifdef ENABLE_WEBSOCKET
 void DownloadEngine::setWebSocketSessionMan(
     std::unique_ptr<rpc::WebSocketSessionMan> wsman)
@@ -612,6 +670,47 @@ void DownloadEngine::setWebSocketSessionMan(
 }
 #endif // ENABLE_WEBSOCKET
 
+#ifdef HAVE_LIBNGHTTP2
+void DownloadEngine::addHttp2Session(
+    const std::shared_ptr<Http2Session>& session)
+{
+  http2Sessions_[session->getOrigin()] = session;
+}
+
+std::shared_ptr<Http2Session>
+DownloadEngine::getHttp2Session(const std::string& origin)
+{
+  auto i = http2Sessions_.find(origin);
+  if (i == std::end(http2Sessions_)) {
+    return nullptr;
+  }
+  if (!(*i).second->isUsable()) {
+    http2Sessions_.erase(i);
+    return nullptr;
+  }
+  return (*i).second;
+}
+
+void DownloadEngine::removeHttp2Session(
+    const std::shared_ptr<Http2Session>& session)
+{
+  auto i = http2Sessions_.find(session->getOrigin());
+  if (i != std::end(http2Sessions_) && (*i).second == session) {
+    http2Sessions_.erase(i);
+  }
+}
+
+void DownloadEngine::markHttp2Unsupported(const std::string& origin)
+{
+  http2UnsupportedOrigins_.insert(origin);
+}
+
+bool DownloadEngine::isHttp2Unsupported(const std::string& origin) const
+{
+  return http2UnsupportedOrigins_.count(origin);
+}
+#endif // HAVE_LIBNGHTTP2
+
 bool DownloadEngine::validateToken(const std::string& token)
 {
   using namespace util::security;
@@ -40,6 +40,7 @@
 #include <string>
 #include <deque>
 #include <map>
+#include <set>
 #include <vector>
 #include <memory>
 
@@ -65,9 +66,13 @@ class AuthConfigFactory;
 class Request;
 class EventPoll;
 class Command;
+class WorkerThreadPool;
 #ifdef ENABLE_BITTORRENT
 class BtRegistry;
 #endif // ENABLE_BITTORRENT
+#ifdef HAVE_LIBNGHTTP2
+class Http2Session;
+#endif // HAVE_LIBNGHTTP2
 #ifdef ENABLE_WEBSOCKET
 namespace rpc {
 class WebSocketSessionMan;
@@ -124,6 +129,10 @@ private:
 
   Timer lastSocketPoolScan_;
 
+  // Servers which do not keep the connection alive for pipelined
+  // requests, key = host(port), value = the time when it is found
+  std::map<std::string, Timer> pipeliningUnsupportedHosts_;
+
   bool noWait_;
 
   std::chrono::milliseconds refreshInterval_;
@@ -145,6 +154,15 @@ private:
   std::unique_ptr<rpc::WebSocketSessionMan> webSocketSessionMan_;
 #endif // ENABLE_WEBSOCKET
 
+#ifdef HAVE_LIBNGHTTP2
+  // key = origin (scheme://host:port), value = HTTP/2 session shared
+  // by the downloads from the origin
+  std::map<std::string, std::shared_ptr<Http2Session>> http2Sessions_;
+
+  // Origins which did not negotiate HTTP/2
+  std::set<std::string> http2UnsupportedOrigins_;
+#endif // HAVE_LIBNGHTTP2
+
   /**
    * Delegates to StatCalc
    */
@@ -162,6 +180,12 @@ private:
   std::unique_ptr<RequestGroupMan> requestGroupMan_;
   std::unique_ptr<FileAllocationMan> fileAllocationMan_;
   std::unique_ptr<CheckIntegrityMan> checkIntegrityMan_;
+  // Worker threads to hash pieces while checking integrity. nullptr
+  // if hashing is done in the main thread.
+  std::unique_ptr<WorkerThreadPool> checkIntegrityWorkerPool_;
+  // Worker threads to allocate files.  nullptr if files are allocated
+  // in the main thread.
+  std::unique_ptr<WorkerThreadPool> fileAllocationWorkerPool_;
   Option* option_;
   // Ensure that Commands are cleaned up before requestGroupMan_ is
   // deleted.
@@ -190,6 +214,10 @@ public:
                               Command* command);
   bool deleteSocketForWriteCheck(const std::shared_ptr<SocketCore>& socket,
                                  Command* command);
+  // Same as addSocketForReadCheck(), but takes the file descriptor
+  // which is not a socket, such as eventfd(2).
+  bool addFdForReadCheck(sock_t fd, Command* command);
+  bool deleteFdForReadCheck(sock_t fd, Command* command);
 
 #ifdef ENABLE_ASYNC_DNS
 
@@ -225,6 +253,20 @@ public:
 
   void setCheckIntegrityMan(std::unique_ptr<CheckIntegrityMan> ciman);
 
+  const std::unique_ptr<WorkerThreadPool>& getCheckIntegrityWorkerPool() const
+  {
+    return checkIntegrityWorkerPool_;
+  }
+
+  void setCheckIntegrityWorkerPool(std::unique_ptr<WorkerThreadPool> pool);
+
+  const std::unique_ptr<WorkerThreadPool>& getFileAllocationWorkerPool() const
+  {
+    return fileAllocationWorkerPool_;
+  }
+
+  void setFileAllocationWorkerPool(std::unique_ptr<WorkerThreadPool> pool);
+
   Option* getOption() const { return option_; }
 
   void setOption(Option* op) { option_ = op; }
@@ -285,6 +327,13 @@ public:
 
   void evictSocketPool();
 
+  // Remembers that the server at |host|:|port| does not keep the
+  // connection alive, so that HTTP pipelining is not used for it for
+  // a while.
+  void markPipeliningUnsupported(const std::string& host, uint16_t port);
+
+  bool isPipeliningUnsupported(const std::string& host, uint16_t port) const;
+
   const std::unique_ptr<CookieStorage>& getCookieStorage() const;
 
 #ifdef ENABLE_BITTORRENT
@@ -320,6 +369,11 @@ public:
 
   void setRefreshInterval(std::chrono::milliseconds interval);
 
+  const std::chrono::milliseconds& getRefreshInterval() const
+  {
+    return refreshInterval_;
+  }
+
   const std::string getSessionId() const { return sessionId_; }
 
 #ifdef ENABLE_WEBSOCKET
@@ -331,6 +385,25 @@ public:
   }
 #endif // ENABLE_WEBSOCKET
 
+#ifdef HAVE_LIBNGHTTP2
+  // Registers |session| for its origin, replacing the existing one.
+  void addHttp2Session(const std::shared_ptr<Http2Session>& session);
+
+  // Returns the session for |origin| which accepts new requests, or
+  // nullptr.
+  std::shared_ptr<Http2Session> getHttp2Session(const std::string& origin);
+
+  // Unregisters |session|.  Does nothing if |session| is not
+  // registered.
+  void removeHttp2Session(const std::shared_ptr<Http2Session>& session);
+
+  // Remembers that |origin| does not support HTTP/2, so that HTTP/1.1
+  // is used for it from now on.
+  void markHttp2Unsupported(const std::string& origin);
+
+  bool isHttp2Unsupported(const std::string& origin) const;
+#endif // HAVE_LIBNGHTTP2
+
   bool validateToken(const std::string& token);
 };
 
@@ -64,6 +64,9 @@
 #ifdef HAVE_EPOLL
 #  include "EpollEventPoll.h"
 #endif // HAVE_EPOLL
+#ifdef HAVE_IO_URING
+#  include "IoUringEventPoll.h"
+#endif // HAVE_IO_URING
 #ifdef HAVE_PORT_ASSOCIATE
 #  include "PortEventPoll.h"
 #endif // HAVE_PORT_ASSOCIATE
@@ -78,6 +81,7 @@
 #include "FileAllocationEntry.h"
 #include "HttpListenCommand.h"
 #include "LogFactory.h"
+#include "WorkerThreadPool.h"
 
 namespace aria2 {
 
@@ -109,6 +113,17 @@ std::unique_ptr<EventPoll> createEventPoll(Option* op)
   }
   else
 #endif // HAVE_EPLL
+#ifdef HAVE_IO_URING
+      if (pollMethod == V_IO_URING) {
+    auto ep = make_unique<IoUringEventPoll>();
+    if (!ep->good()) {
+      throw DL_ABORT_EX("Initializing IoUringEventPoll failed."
+                        " Try --event-poll=epoll");
+    }
+    return std::move(ep);
+  }
+  else
+#endif // HAVE_IO_URING
 #ifdef HAVE_KQUEUE
       if (pollMethod == V_KQUEUE) {
     auto kp = make_unique<KqueueEventPoll>();
@@ -158,8 +173,28 @@ std::unique_ptr<DownloadEngine> DownloadEngineFactory::newDownloadEngine(
     requestGroupMan->initWrDiskCache();
     e->setRequestGroupMan(std::move(requestGroupMan));
   }
-  e->setFileAllocationMan(make_unique<FileAllocationMan>());
-  e->setCheckIntegrityMan(make_unique<CheckIntegrityMan>());
+  {
+    const size_t numThreads = op->getAsInt(PREF_FILE_ALLOCATION_THREADS);
+    // 0 means that files are allocated in the main thread one at a
+    // time.
+    e->setFileAllocationMan(
+        make_unique<FileAllocationMan>(std::max<size_t>(1, numThreads)));
+    if (numThreads > 0) {
+      e->setFileAllocationWorkerPool(make_unique<WorkerThreadPool>(numThreads));
+    }
+  }
+  {
+    const size_t numThreads = op->getAsInt(PREF_CHECK_INTEGRITY_THREADS);
+    // The worker threads are shared by all downloads being checked.
+    // Allow as many downloads as threads to be checked at once so
+    // that the main thread can keep them busy.  0 means that pieces
+    // are hashed in the main thread one download at a time.
+    e->setCheckIntegrityMan(
+        make_unique<CheckIntegrityMan>(std::max<size_t>(1, numThreads)));
+    if (numThreads > 0) {
+      e->setCheckIntegrityWorkerPool(make_unique<WorkerThreadPool>(numThreads));
+    }
+  }
   e->addRoutineCommand(
       make_unique<FillRequestGroupCommand>(e->newCUID(), e.get()));
   e->addRoutineCommand(make_unique<FileAllocationDispatcherCommand>(
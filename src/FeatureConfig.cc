@@ -70,6 +70,9 @@
 #ifdef HAVE_LIBSSH2
 #  include <libssh2.h>
 #endif // HAVE_LIBSSH2
+#ifdef HAVE_LIBNGHTTP2
+#  include <nghttp2/nghttp2.h>
+#endif // HAVE_LIBNGHTTP2
 #include "util.h"
 
 namespace aria2 {
@@ -183,6 +186,14 @@ const char* strSupportedFeature(int feature)
 #endif // !HAVE_LIBSSH2
     break;
 
+  case (FEATURE_HTTP2):
+#ifdef HAVE_LIBNGHTTP2
+    return "HTTP/2";
+#else  // !HAVE_LIBNGHTTP2
+    return nullptr;
+#endif // !HAVE_LIBNGHTTP2
+    break;
+
   default:
     return nullptr;
   }
@@ -241,6 +252,10 @@ std::string usedLibs()
   res += "libssh2/" LIBSSH2_VERSION " ";
 #endif // HAVE_LIBSSH2
 
+#ifdef HAVE_LIBNGHTTP2
+  res += "nghttp2/" NGHTTP2_VERSION " ";
+#endif // HAVE_LIBNGHTTP2
+
   if (!res.empty()) {
     res.erase(res.length() - 1);
   }
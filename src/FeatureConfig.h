@@ -54,6 +54,7 @@ enum FeatureType {
   FEATURE_METALINK,
   FEATURE_XML_RPC,
   FEATURE_SFTP,
+  FEATURE_HTTP2,
   MAX_FEATURE
 };
 
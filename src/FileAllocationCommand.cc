@@ -49,20 +49,43 @@
 #include "wallclock.h"
 #include "RequestGroupMan.h"
 #include "fmt.h"
+#include "WakeupFd.h"
+#include "WorkerThreadPool.h"
 
 namespace aria2 {
 
+namespace {
+// While a job runs in the worker threads and no descriptor can wake
+// us up, check the progress at this interval.
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(50);
+} // namespace
+
 FileAllocationCommand::FileAllocationCommand(
     cuid_t cuid, RequestGroup* requestGroup, DownloadEngine* e,
     FileAllocationEntry* fileAllocationEntry)
     : RealtimeCommand{cuid, requestGroup, e},
       fileAllocationEntry_{fileAllocationEntry}
 {
+  if (e->getFileAllocationWorkerPool()) {
+    try {
+      wakeupFd_ = make_unique<WakeupFd>();
+      if (wakeupFd_->getFd() != -1) {
+        e->addFdForReadCheck(wakeupFd_->getFd(), this);
+      }
+    }
+    catch (RecoverableException& ex) {
+      A2_LOG_INFO_EX("Checking the file allocation periodically instead", ex);
+    }
+  }
 }
 
 FileAllocationCommand::~FileAllocationCommand()
 {
-  getDownloadEngine()->getFileAllocationMan()->dropPickedEntry();
+  if (wakeupFd_ && wakeupFd_->getFd() != -1) {
+    getDownloadEngine()->deleteFdForReadCheck(wakeupFd_->getFd(), this);
+  }
+  getDownloadEngine()->getFileAllocationMan()->dropPickedEntry(
+      fileAllocationEntry_);
 }
 
 bool FileAllocationCommand::executeInternal()
@@ -70,6 +93,9 @@ bool FileAllocationCommand::executeInternal()
   if (getRequestGroup()->isHaltRequested()) {
     return true;
   }
+  if (wakeupFd_) {
+    wakeupFd_->drain();
+  }
   fileAllocationEntry_->allocateChunk();
   if (fileAllocationEntry_->finished()) {
     A2_LOG_DEBUG(fmt(
@@ -85,6 +111,17 @@ bool FileAllocationCommand::executeInternal()
     return true;
   }
   else {
+    if (getDownloadEngine()->getFileAllocationWorkerPool()) {
+      // The worker threads are allocating the files.  Rather than
+      // spinning until they are done, sleep until a job returns.
+      setStatusInactive();
+      if (!wakeupFd_ || wakeupFd_->getFd() == -1) {
+        auto e = getDownloadEngine();
+        if (e->getRefreshInterval() > POLL_INTERVAL) {
+          e->setRefreshInterval(POLL_INTERVAL);
+        }
+      }
+    }
     getDownloadEngine()->addCommand(std::unique_ptr<Command>(this));
     return false;
   }
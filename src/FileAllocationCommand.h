@@ -44,11 +44,16 @@
 namespace aria2 {
 
 class FileAllocationEntry;
+class WakeupFd;
 
 class FileAllocationCommand : public RealtimeCommand {
 private:
   FileAllocationEntry* fileAllocationEntry_;
   Timer timer_;
+  // Notified when a job allocating the files in the worker threads
+  // returns.  It outlives the entry, which is dropped in the
+  // destructor.
+  std::unique_ptr<WakeupFd> wakeupFd_;
 
 public:
   FileAllocationCommand(cuid_t cuid, RequestGroup* requestGroup,
@@ -57,6 +62,10 @@ public:
 
   virtual ~FileAllocationCommand();
 
+  // Returns the descriptor to be notified by the worker threads, or
+  // nullptr if files are allocated in the main thread.
+  WakeupFd* getWakeupFd() const { return wakeupFd_.get(); }
+
   virtual bool executeInternal() CXX11_OVERRIDE;
 
   virtual bool handleException(Exception& e) CXX11_OVERRIDE;
@@ -54,8 +54,12 @@ FileAllocationDispatcherCommand::createCommand(FileAllocationEntry* entry)
 {
   cuid_t newCUID = getDownloadEngine()->newCUID();
   A2_LOG_INFO(fmt(MSG_FILE_ALLOCATION_DISPATCH, newCUID));
-  return make_unique<FileAllocationCommand>(newCUID, entry->getRequestGroup(),
-                                            getDownloadEngine(), entry);
+  auto command = make_unique<FileAllocationCommand>(
+      newCUID, entry->getRequestGroup(), getDownloadEngine(), entry);
+  entry->setWorkerThreadPool(
+      getDownloadEngine()->getFileAllocationWorkerPool().get(),
+      command->getWakeupFd());
+  return std::move(command);
 }
 
 } // namespace aria2
@@ -34,6 +34,7 @@
 /* copyright --> */
 #include "FileAllocationEntry.h"
 #include "FileAllocationIterator.h"
+#include "AsyncFileAllocationIterator.h"
 #include "DownloadEngine.h"
 #include "RequestGroup.h"
 #include "PieceStorage.h"
@@ -72,4 +73,14 @@ void FileAllocationEntry::allocateChunk()
   fileAllocationIterator_->allocateChunk();
 }
 
+void FileAllocationEntry::setWorkerThreadPool(WorkerThreadPool* pool,
+                                              WakeupFd* wakeupFd)
+{
+  if (!pool || fileAllocationIterator_->setWorkerThreadPool(pool, wakeupFd)) {
+    return;
+  }
+  fileAllocationIterator_ = make_unique<AsyncFileAllocationIterator>(
+      std::move(fileAllocationIterator_), pool, wakeupFd);
+}
+
 } // namespace aria2
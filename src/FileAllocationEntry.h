@@ -47,6 +47,8 @@ namespace aria2 {
 class FileAllocationIterator;
 class Command;
 class DownloadEngine;
+class WorkerThreadPool;
+class WakeupFd;
 
 class FileAllocationEntry : public RequestGroupEntry,
                             public ProgressAwareEntry {
@@ -68,6 +70,13 @@ public:
 
   void allocateChunk();
 
+  // Allocates space in the worker threads of |pool| instead of the
+  // calling thread.  |wakeupFd|, if not nullptr, is notified whenever
+  // a job in |pool| returns, so that the caller can wait for it
+  // instead of calling allocateChunk() repeatedly.  Must be called
+  // before the first allocateChunk().
+  void setWorkerThreadPool(WorkerThreadPool* pool, WakeupFd* wakeupFd);
+
   virtual void
   prepareForNextAction(std::vector<std::unique_ptr<Command>>& commands,
                        DownloadEngine* e) = 0;
@@ -41,6 +41,9 @@
 
 namespace aria2 {
 
+class WorkerThreadPool;
+class WakeupFd;
+
 class FileAllocationIterator {
 public:
   virtual ~FileAllocationIterator() = default;
@@ -52,6 +55,17 @@ public:
   virtual int64_t getCurrentLength() = 0;
 
   virtual int64_t getTotalLength() = 0;
+
+  // Makes this iterator allocate space in the worker threads of
+  // |pool|, so that allocateChunk() does not block.  |wakeupFd|, if
+  // not nullptr, is notified whenever a job in |pool| returns.
+  // Returns false if this iterator cannot do that by itself; such an
+  // iterator can be wrapped with AsyncFileAllocationIterator instead.
+  virtual bool setWorkerThreadPool(WorkerThreadPool* pool,
+                                   WakeupFd* wakeupFd)
+  {
+    return false;
+  }
 };
 
 } // namespace aria2
@@ -0,0 +1,90 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_HTTP2_CONNECT_CHAIN_H
+#define D_HTTP2_CONNECT_CHAIN_H
+
+#include "ControlChain.h"
+#include "ConnectCommand.h"
+#include "DownloadEngine.h"
+#include "Request.h"
+#include "Option.h"
+#include "prefs.h"
+#include "Http2Session.h"
+#include "Http2SessionCommand.h"
+#include "Http2RequestCommand.h"
+
+namespace aria2 {
+
+// Starts Http2SessionCommand for |session| over the newly connected
+// socket, and submits the request of the ConnectCommand as the first
+// stream.  If the connection could not be established, |session| is
+// closed so that the requests queued in it are retried.
+struct Http2ConnectChain : public ControlChain<ConnectCommand*> {
+  Http2ConnectChain(const std::shared_ptr<Http2Session>& session,
+                    DownloadEngine* e)
+      : session_(session), e_(e), started_(false)
+  {
+  }
+  virtual ~Http2ConnectChain()
+  {
+    if (!started_) {
+      session_->terminate("Could not connect to the server");
+      e_->removeHttp2Session(session_);
+    }
+  }
+  virtual int run(ConnectCommand* t, DownloadEngine* e) CXX11_OVERRIDE
+  {
+    started_ = true;
+    e->addCommand(make_unique<Http2SessionCommand>(
+        e->newCUID(), session_, t->getSocket(), t->getRequest()->getHost(), e,
+        std::chrono::seconds(t->getOption()->getAsInt(PREF_TIMEOUT))));
+    auto c = make_unique<Http2RequestCommand>(
+        t->getCuid(), t->getRequest(), t->getFileEntry(), t->getRequestGroup(),
+        session_, e);
+    c->setStatus(Command::STATUS_ONESHOT_REALTIME);
+    e->setNoWait(true);
+    e->addCommand(std::move(c));
+    return 0;
+  }
+
+private:
+  std::shared_ptr<Http2Session> session_;
+  DownloadEngine* e_;
+  bool started_;
+};
+
+} // namespace aria2
+
+#endif // D_HTTP2_CONNECT_CHAIN_H
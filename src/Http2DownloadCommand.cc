@@ -0,0 +1,109 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "Http2DownloadCommand.h"
+#include "Http2Session.h"
+#include "HttpRequest.h"
+#include "HttpResponse.h"
+#include "HttpHeader.h"
+#include "Range.h"
+#include "SocketRecvBuffer.h"
+#include "DownloadEngine.h"
+#include "DlRetryEx.h"
+#include "fmt.h"
+
+namespace aria2 {
+
+Http2DownloadCommand::Http2DownloadCommand(
+    cuid_t cuid, const std::shared_ptr<Request>& req,
+    const std::shared_ptr<FileEntry>& fileEntry, RequestGroup* requestGroup,
+    std::unique_ptr<HttpResponse> httpResponse,
+    const std::shared_ptr<Http2Session>& session,
+    std::shared_ptr<Http2Stream> stream, DownloadEngine* e)
+    : DownloadCommand(cuid, req, fileEntry, requestGroup, e, nullptr,
+                      std::make_shared<SocketRecvBuffer>(nullptr)),
+      httpResponse_(std::move(httpResponse)),
+      session_(session),
+      stream_(std::move(stream))
+{
+  stream_->setCommand(this);
+}
+
+Http2DownloadCommand::~Http2DownloadCommand()
+{
+  session_->closeStream(stream_);
+}
+
+int64_t Http2DownloadCommand::getRequestEndOffset() const
+{
+  auto endByte = httpResponse_->getHttpHeader()->getRange().endByte;
+  if (endByte > 0) {
+    return endByte + 1;
+  }
+  return endByte;
+}
+
+bool Http2DownloadCommand::shouldEnableWriteCheck() { return false; }
+
+bool Http2DownloadCommand::shouldEnableReadCheck() { return false; }
+
+bool Http2DownloadCommand::receiveData()
+{
+  auto session = session_.get();
+  auto stream = stream_.get();
+  getSocketRecvBuffer()->recv([session, stream](unsigned char* data,
+                                                size_t len) {
+    return session->readData(stream, data, len);
+  });
+  if (stream_->getBufferedLength()) {
+    // Process the rest in the next iteration without waiting for the
+    // session.
+    setStatus(Command::STATUS_ONESHOT_REALTIME);
+    getDownloadEngine()->setNoWait(true);
+    return false;
+  }
+  if (!getSocketRecvBuffer()->bufferEmpty() || !stream_->closed()) {
+    return false;
+  }
+  if (stream_->getErrorCode() != NGHTTP2_NO_ERROR) {
+    if (!session_->getError().empty()) {
+      throw DL_RETRY_EX(session_->getError());
+    }
+    throw DL_RETRY_EX(fmt("HTTP/2 stream was closed: %s",
+                          nghttp2_http2_strerror(stream_->getErrorCode())));
+  }
+  return true;
+}
+
+} // namespace aria2
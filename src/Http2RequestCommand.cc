@@ -0,0 +1,219 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "Http2RequestCommand.h"
+#include "Http2Session.h"
+#include "Http2DownloadCommand.h"
+#include "HttpRequestCommand.h"
+#include "HttpRequest.h"
+#include "HttpResponse.h"
+#include "HttpHeader.h"
+#include "Request.h"
+#include "RequestGroup.h"
+#include "FileEntry.h"
+#include "DownloadEngine.h"
+#include "DlAbortEx.h"
+#include "DlRetryEx.h"
+#include "Option.h"
+#include "prefs.h"
+#include "Logger.h"
+#include "LogFactory.h"
+#include "AuthConfigFactory.h"
+#include "URISelector.h"
+#include "message.h"
+#include "fmt.h"
+#include "util.h"
+#include "error_code.h"
+
+namespace aria2 {
+
+Http2RequestCommand::Http2RequestCommand(
+    cuid_t cuid, const std::shared_ptr<Request>& req,
+    const std::shared_ptr<FileEntry>& fileEntry, RequestGroup* requestGroup,
+    const std::shared_ptr<Http2Session>& session, DownloadEngine* e)
+    : AbstractCommand(cuid, req, fileEntry, requestGroup, e),
+      session_(session)
+{
+}
+
+Http2RequestCommand::~Http2RequestCommand()
+{
+  if (stream_) {
+    session_->closeStream(stream_);
+  }
+}
+
+void Http2RequestCommand::submitRequest()
+{
+  const auto& segment = getSegments().front();
+  httpRequest_ = createHttpRequest(
+      getRequest(), getFileEntry(), segment, getOption(), getRequestGroup(),
+      getDownloadEngine(), nullptr,
+      getRangeEndOffset(getRequest(), getFileEntry(), getRequestGroup(),
+                        segment));
+  auto headers = httpRequest_->createHttp2Request();
+  std::string text;
+  for (auto& hd : headers) {
+    text += hd.first;
+    text += ": ";
+    if (hd.first == "authorization" || hd.first == "cookie") {
+      text += "<snip>";
+    }
+    else {
+      text += hd.second;
+    }
+    text += "\n";
+  }
+  A2_LOG_INFO(fmt(MSG_SENDING_REQUEST, getCuid(), text.c_str()));
+  stream_ = session_->submitRequest(headers, this);
+}
+
+bool Http2RequestCommand::executeInternal()
+{
+  if (!stream_) {
+    if (getDownloadEngine()->isHttp2Unsupported(session_->getOrigin())) {
+      return prepareForRetry(0);
+    }
+    submitRequest();
+    addCommandSelf();
+    return false;
+  }
+  if (stream_->headersReceived()) {
+    return processResponse();
+  }
+  if (stream_->closed()) {
+    auto stream = std::move(stream_);
+    session_->closeStream(stream);
+    if (getDownloadEngine()->isHttp2Unsupported(session_->getOrigin())) {
+      // ALPN told us that the server does not speak HTTP/2.  Retry
+      // with HTTP/1.1.
+      return prepareForRetry(0);
+    }
+    if (!session_->getError().empty()) {
+      throw DL_RETRY_EX(session_->getError());
+    }
+    throw DL_RETRY_EX(fmt("HTTP/2 stream was closed: %s",
+                          nghttp2_http2_strerror(stream->getErrorCode())));
+  }
+  addCommandSelf();
+  return false;
+}
+
+bool Http2RequestCommand::processResponse()
+{
+  auto httpResponse = make_unique<HttpResponse>();
+  httpResponse->setCuid(getCuid());
+  httpResponse->setHttpHeader(stream_->popHttpHeader());
+  httpResponse->setHttpRequest(std::move(httpRequest_));
+  auto statusCode = httpResponse->getStatusCode();
+  A2_LOG_INFO(fmt("CUID#%" PRId64 " - HTTP/2 response received: status=%d",
+                  getCuid(), statusCode));
+
+  httpResponse->validateResponse();
+  httpResponse->retrieveCookie();
+
+  if (httpResponse->isRedirect()) {
+    int rnum =
+        httpResponse->getHttpRequest()->getRequest()->getRedirectCount();
+    if (rnum >= Request::MAX_REDIRECT) {
+      throw DL_ABORT_EX2(fmt("Too many redirects: count=%u", rnum),
+                         error_code::HTTP_TOO_MANY_REDIRECTS);
+    }
+    httpResponse->processRedirect();
+    return prepareForRetry(0);
+  }
+
+  if (statusCode >= 400) {
+    switch (statusCode) {
+    case 401:
+      if (getOption()->getAsBool(PREF_HTTP_AUTH_CHALLENGE) &&
+          !httpResponse->getHttpRequest()->authenticationUsed() &&
+          getDownloadEngine()->getAuthConfigFactory()->activateBasicCred(
+              getRequest()->getHost(), getRequest()->getPort(),
+              getRequest()->getDir(), getOption().get())) {
+        return prepareForRetry(0);
+      }
+      throw DL_ABORT_EX2(EX_AUTH_FAILED, error_code::HTTP_AUTH_FAILED);
+    case 404:
+      getRequestGroup()->increaseAndValidateFileNotFoundCount();
+      if (getOption()->getAsInt(PREF_MAX_FILE_NOT_FOUND) == 0) {
+        throw DL_ABORT_EX2(MSG_RESOURCE_NOT_FOUND,
+                           error_code::RESOURCE_NOT_FOUND);
+      }
+      throw DL_RETRY_EX2(MSG_RESOURCE_NOT_FOUND,
+                         error_code::RESOURCE_NOT_FOUND);
+    case 502:
+    case 503:
+      // Only retry if pretry-wait > 0. Hammering 'busy' server is not
+      // a good idea.
+      if (getOption()->getAsInt(PREF_RETRY_WAIT) > 0) {
+        throw DL_RETRY_EX2(fmt(EX_BAD_STATUS, statusCode),
+                           error_code::HTTP_SERVICE_UNAVAILABLE);
+      }
+      throw DL_ABORT_EX2(fmt(EX_BAD_STATUS, statusCode),
+                         error_code::HTTP_SERVICE_UNAVAILABLE);
+    case 504:
+      // This is Gateway Timeout, so try again
+      throw DL_RETRY_EX2(fmt(EX_BAD_STATUS, statusCode),
+                         error_code::HTTP_SERVICE_UNAVAILABLE);
+    };
+
+    throw DL_ABORT_EX2(fmt(EX_BAD_STATUS, statusCode),
+                       error_code::HTTP_PROTOCOL_ERROR);
+  }
+
+  if (statusCode >= 300) {
+    return prepareForRetry(0);
+  }
+
+  getRequestGroup()->validateTotalLength(getFileEntry()->getLength(),
+                                         httpResponse->getEntityLength());
+
+  auto command = make_unique<Http2DownloadCommand>(
+      getCuid(), getRequest(), getFileEntry(), getRequestGroup(),
+      std::move(httpResponse), session_, std::move(stream_),
+      getDownloadEngine());
+  command->setStartupIdleTime(
+      std::chrono::seconds(getOption()->getAsInt(PREF_STARTUP_IDLE_TIME)));
+  command->setLowestDownloadSpeedLimit(
+      getOption()->getAsInt(PREF_LOWEST_SPEED_LIMIT));
+  getRequestGroup()->getURISelector()->tuneDownloadCommand(
+      getFileEntry()->getRemainingUris(), command.get());
+  command->setStatus(Command::STATUS_ONESHOT_REALTIME);
+  getDownloadEngine()->setNoWait(true);
+  getDownloadEngine()->addCommand(std::move(command));
+  return true;
+}
+
+} // namespace aria2
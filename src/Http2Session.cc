@@ -0,0 +1,561 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "Http2Session.h"
+
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+
+#include "SocketCore.h"
+#include "HttpHeader.h"
+#include "Command.h"
+#include "DownloadEngine.h"
+#include "DlAbortEx.h"
+#include "DlRetryEx.h"
+#include "LogFactory.h"
+#include "Logger.h"
+#include "message.h"
+#include "fmt.h"
+#include "util.h"
+#include "wallclock.h"
+#include "a2functional.h"
+#include "Request.h"
+#include "RequestGroup.h"
+#include "Option.h"
+#include "prefs.h"
+
+namespace aria2 {
+
+Http2Stream::Http2Stream(Command* command)
+    : streamId_(-1),
+      command_(command),
+      httpHeader_(make_unique<HttpHeader>()),
+      headersReceived_(false),
+      bufOffset_(0),
+      closed_(false),
+      errorCode_(NGHTTP2_NO_ERROR)
+{
+}
+
+Http2Stream::~Http2Stream() = default;
+
+std::unique_ptr<HttpHeader> Http2Stream::popHttpHeader()
+{
+  return std::move(httpHeader_);
+}
+
+void Http2Stream::onHeader(const std::string& name, const std::string& value)
+{
+  if (headersReceived_ || !httpHeader_) {
+    // Ignore trailer fields
+    return;
+  }
+  if (name == ":status") {
+    uint32_t statusCode;
+    if (value.size() != 3 || !util::parseUIntNoThrow(statusCode, value)) {
+      throw DL_ABORT_EX2(fmt("Invalid HTTP/2 status %s", value.c_str()),
+                         error_code::HTTP_PROTOCOL_ERROR);
+    }
+    httpHeader_->setStatusCode(statusCode);
+    return;
+  }
+  auto hdKey = idInterestingHeader(name.c_str());
+  if (hdKey != HttpHeader::MAX_INTERESTING_HEADER) {
+    httpHeader_->put(hdKey, value);
+  }
+}
+
+bool Http2Stream::onHeadersComplete()
+{
+  if (headersReceived_ || !httpHeader_) {
+    return false;
+  }
+  if (httpHeader_->getStatusCode() / 100 == 1) {
+    httpHeader_ = make_unique<HttpHeader>();
+    return false;
+  }
+  httpHeader_->setVersion("HTTP/2");
+  headersReceived_ = true;
+  return true;
+}
+
+void Http2Stream::onData(const uint8_t* data, size_t len)
+{
+  if (bufOffset_ > 0 && bufOffset_ >= buf_.size() / 2) {
+    buf_.erase(0, bufOffset_);
+    bufOffset_ = 0;
+  }
+  buf_.append(data, data + len);
+}
+
+void Http2Stream::onClose(uint32_t errorCode)
+{
+  closed_ = true;
+  errorCode_ = errorCode;
+}
+
+size_t Http2Stream::drain(unsigned char* data, size_t len)
+{
+  len = std::min(len, getBufferedLength());
+  memcpy(data, buf_.data() + bufOffset_, len);
+  bufOffset_ += len;
+  if (bufOffset_ == buf_.size()) {
+    buf_.clear();
+    bufOffset_ = 0;
+  }
+  return len;
+}
+
+namespace {
+Http2Stream* getStream(nghttp2_session* session, int32_t streamId)
+{
+  return static_cast<Http2Stream*>(
+      nghttp2_session_get_stream_user_data(session, streamId));
+}
+} // namespace
+
+namespace {
+int onHeaderCallback(nghttp2_session* session, const nghttp2_frame* frame,
+                     const uint8_t* name, size_t namelen, const uint8_t* value,
+                     size_t valuelen, uint8_t flags, void* userData)
+{
+  if (frame->hd.type != NGHTTP2_HEADERS) {
+    return 0;
+  }
+  auto stream = getStream(session, frame->hd.stream_id);
+  if (!stream) {
+    return 0;
+  }
+  try {
+    stream->onHeader(std::string(name, name + namelen),
+                     std::string(value, value + valuelen));
+  }
+  catch (RecoverableException& e) {
+    A2_LOG_INFO_EX("HTTP/2 header error", e);
+    return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+  }
+  return 0;
+}
+} // namespace
+
+namespace {
+int onFrameRecvCallback(nghttp2_session* session, const nghttp2_frame* frame,
+                        void* userData)
+{
+  auto http2Session = static_cast<Http2Session*>(userData);
+  switch (frame->hd.type) {
+  case NGHTTP2_HEADERS: {
+    auto stream = getStream(session, frame->hd.stream_id);
+    if (stream && stream->onHeadersComplete()) {
+      http2Session->wakeUp(stream->getCommand());
+    }
+    break;
+  }
+  case NGHTTP2_GOAWAY:
+    A2_LOG_INFO(fmt("HTTP/2 GOAWAY received from %s, error=%s",
+                    http2Session->getOrigin().c_str(),
+                    nghttp2_http2_strerror(frame->goaway.error_code)));
+    http2Session->onGoaway();
+    break;
+  }
+  return 0;
+}
+} // namespace
+
+namespace {
+int onDataChunkRecvCallback(nghttp2_session* session, uint8_t flags,
+                            int32_t streamId, const uint8_t* data, size_t len,
+                            void* userData)
+{
+  auto stream = getStream(session, streamId);
+  if (!stream) {
+    // The stream was detached.  Nobody reads the data, so open the
+    // window for them here.
+    nghttp2_session_consume(session, streamId, len);
+    return 0;
+  }
+  stream->onData(data, len);
+  static_cast<Http2Session*>(userData)->wakeUp(stream->getCommand());
+  return 0;
+}
+} // namespace
+
+namespace {
+int onStreamCloseCallback(nghttp2_session* session, int32_t streamId,
+                          uint32_t errorCode, void* userData)
+{
+  static_cast<Http2Session*>(userData)->onStreamClose(streamId, errorCode);
+  return 0;
+}
+} // namespace
+
+Http2Session::Http2Session(std::string origin, int32_t windowSize,
+                           DownloadEngine* e)
+    : origin_(std::move(origin)),
+      windowSize_(windowSize),
+      e_(e),
+      state_(STATE_CONNECTING),
+      session_(nullptr),
+      command_(nullptr),
+      sendBufOffset_(0),
+      goawayReceived_(false)
+{
+  nghttp2_session_callbacks* callbacks;
+  if (nghttp2_session_callbacks_new(&callbacks) != 0) {
+    throw DL_ABORT_EX("Could not allocate nghttp2 callbacks");
+  }
+  nghttp2_session_callbacks_set_on_header_callback(callbacks,
+                                                   onHeaderCallback);
+  nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks,
+                                                       onFrameRecvCallback);
+  nghttp2_session_callbacks_set_on_data_chunk_recv_callback(
+      callbacks, onDataChunkRecvCallback);
+  nghttp2_session_callbacks_set_on_stream_close_callback(
+      callbacks, onStreamCloseCallback);
+
+  nghttp2_option* option;
+  if (nghttp2_option_new(&option) != 0) {
+    nghttp2_session_callbacks_del(callbacks);
+    throw DL_ABORT_EX("Could not allocate nghttp2 option");
+  }
+  // WINDOW_UPDATE is sent when the data are read by readData().
+  nghttp2_option_set_no_auto_window_update(option, 1);
+
+  int rv = nghttp2_session_client_new2(&session_, callbacks, this, option);
+  nghttp2_option_del(option);
+  nghttp2_session_callbacks_del(callbacks);
+  if (rv != 0) {
+    throw DL_ABORT_EX(
+        fmt("Could not create HTTP/2 session: %s", nghttp2_strerror(rv)));
+  }
+
+  nghttp2_settings_entry iv[] = {
+      {NGHTTP2_SETTINGS_ENABLE_PUSH, 0},
+      {NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE,
+       static_cast<uint32_t>(windowSize_)}};
+  rv = nghttp2_submit_settings(session_, NGHTTP2_FLAG_NONE, iv,
+                               sizeof(iv) / sizeof(iv[0]));
+  if (rv == 0) {
+    rv = nghttp2_session_set_local_window_size(session_, NGHTTP2_FLAG_NONE, 0,
+                                               NGHTTP2_MAX_WINDOW_SIZE);
+  }
+  if (rv != 0) {
+    nghttp2_session_del(session_);
+    throw DL_ABORT_EX(
+        fmt("Could not initialize HTTP/2 session: %s", nghttp2_strerror(rv)));
+  }
+}
+
+Http2Session::~Http2Session()
+{
+  for (auto& e : streams_) {
+    e.second->setCommand(nullptr);
+  }
+  nghttp2_session_del(session_);
+}
+
+void Http2Session::onConnected(const std::shared_ptr<SocketCore>& socket)
+{
+  assert(state_ == STATE_CONNECTING);
+  socket_ = socket;
+  state_ = STATE_CONNECTED;
+  lastReceiveTime_ = global::wallclock();
+}
+
+bool Http2Session::isUsable() const
+{
+  return state_ != STATE_CLOSED && !goawayReceived_ &&
+         nghttp2_session_check_request_allowed(session_);
+}
+
+std::shared_ptr<Http2Stream> Http2Session::submitRequest(
+    const std::vector<std::pair<std::string, std::string>>& headers,
+    Command* command)
+{
+  if (!isUsable()) {
+    throw DL_RETRY_EX(
+        fmt("HTTP/2 session with %s is not usable", origin_.c_str()));
+  }
+  std::vector<nghttp2_nv> nva;
+  nva.reserve(headers.size());
+  for (auto& hd : headers) {
+    nva.push_back(
+        {reinterpret_cast<uint8_t*>(const_cast<char*>(hd.first.c_str())),
+         reinterpret_cast<uint8_t*>(const_cast<char*>(hd.second.c_str())),
+         hd.first.size(), hd.second.size(), NGHTTP2_NV_FLAG_NONE});
+  }
+  auto stream = std::make_shared<Http2Stream>(command);
+  auto streamId = nghttp2_submit_request(session_, nullptr, nva.data(),
+                                         nva.size(), nullptr, stream.get());
+  if (streamId < 0) {
+    throw DL_ABORT_EX(fmt("Could not submit HTTP/2 request: %s",
+                          nghttp2_strerror(streamId)));
+  }
+  stream->setStreamId(streamId);
+  if (streams_.empty()) {
+    // Start the receive timeout from now, not from the end of the
+    // last idle period.
+    lastReceiveTime_ = global::wallclock();
+  }
+  streams_.emplace(streamId, stream);
+  wakeUp(command_);
+  return stream;
+}
+
+void Http2Session::closeStream(const std::shared_ptr<Http2Stream>& stream)
+{
+  stream->setCommand(nullptr);
+  if (state_ == STATE_CLOSED) {
+    return;
+  }
+  // Give back the window held by the data which will not be read.
+  if (stream->getBufferedLength()) {
+    nghttp2_session_consume_connection(session_, stream->getBufferedLength());
+    wakeUp(command_);
+  }
+  auto i = streams_.find(stream->getStreamId());
+  if (i == std::end(streams_) || (*i).second != stream) {
+    return;
+  }
+  streams_.erase(i);
+  if (streams_.empty()) {
+    idleStartTime_ = global::wallclock();
+  }
+  auto streamId = stream->getStreamId();
+  // The data received after this point are consumed by
+  // onDataChunkRecvCallback().
+  nghttp2_session_set_stream_user_data(session_, streamId, nullptr);
+  nghttp2_submit_rst_stream(session_, NGHTTP2_FLAG_NONE, streamId,
+                            NGHTTP2_CANCEL);
+  wakeUp(command_);
+}
+
+size_t Http2Session::readData(Http2Stream* stream, unsigned char* data,
+                              size_t len)
+{
+  auto n = stream->drain(data, len);
+  if (n > 0 && state_ != STATE_CLOSED) {
+    // If the stream has been closed, this only opens the connection
+    // window.
+    nghttp2_session_consume(session_, stream->getStreamId(), n);
+    wakeUp(command_);
+  }
+  return n;
+}
+
+void Http2Session::onStreamClose(int32_t streamId, uint32_t errorCode)
+{
+  auto i = streams_.find(streamId);
+  if (i == std::end(streams_)) {
+    return;
+  }
+  auto stream = (*i).second;
+  streams_.erase(i);
+  if (streams_.empty()) {
+    idleStartTime_ = global::wallclock();
+  }
+  if (errorCode != NGHTTP2_NO_ERROR) {
+    A2_LOG_DEBUG(fmt("HTTP/2 stream %d closed with %s", streamId,
+                     nghttp2_http2_strerror(errorCode)));
+  }
+  stream->onClose(errorCode);
+  wakeUp(stream->getCommand());
+}
+
+void Http2Session::performIO()
+{
+  if (state_ != STATE_CONNECTED) {
+    return;
+  }
+  recv();
+  send();
+}
+
+void Http2Session::recv()
+{
+  unsigned char buf[16_k];
+  // Limit the amount of data read at once, so that this session does
+  // not starve the other commands.
+  for (int i = 0; i < 8; ++i) {
+    size_t len = sizeof(buf);
+    socket_->readData(buf, len);
+    if (len == 0) {
+      if (socket_->wantRead() || socket_->wantWrite()) {
+        return;
+      }
+      throw DL_RETRY_EX(EX_GOT_EOF);
+    }
+    lastReceiveTime_ = global::wallclock();
+    auto rv = nghttp2_session_mem_recv(session_, buf, len);
+    if (rv < 0) {
+      throw DL_RETRY_EX(
+          fmt("HTTP/2 protocol error: %s", nghttp2_strerror(rv)));
+    }
+  }
+}
+
+void Http2Session::send()
+{
+  for (;;) {
+    if (sendBufOffset_ == sendBuf_.size()) {
+      sendBuf_.clear();
+      sendBufOffset_ = 0;
+      while (sendBuf_.size() < 16_k) {
+        const uint8_t* data;
+        auto n = nghttp2_session_mem_send(session_, &data);
+        if (n < 0) {
+          throw DL_RETRY_EX(
+              fmt("HTTP/2 protocol error: %s", nghttp2_strerror(n)));
+        }
+        if (n == 0) {
+          break;
+        }
+        sendBuf_.append(data, data + n);
+      }
+      if (sendBuf_.empty()) {
+        return;
+      }
+    }
+    // SocketCore::writeData() requires the same data to be passed
+    // again if it could not write them, so sendBuf_ is not modified
+    // until it is written out.
+    auto n = socket_->writeData(sendBuf_.data() + sendBufOffset_,
+                                sendBuf_.size() - sendBufOffset_);
+    if (n == 0) {
+      return;
+    }
+    sendBufOffset_ += n;
+  }
+}
+
+bool Http2Session::wantRead() const
+{
+  if (state_ != STATE_CONNECTED) {
+    return false;
+  }
+  return nghttp2_session_want_read(session_) || socket_->wantRead();
+}
+
+bool Http2Session::wantWrite() const
+{
+  if (state_ != STATE_CONNECTED) {
+    return false;
+  }
+  return sendBufOffset_ < sendBuf_.size() ||
+         nghttp2_session_want_write(session_) || socket_->wantWrite();
+}
+
+void Http2Session::terminate(const std::string& error)
+{
+  if (state_ == STATE_CLOSED) {
+    return;
+  }
+  if (state_ == STATE_CONNECTED) {
+    nghttp2_session_terminate_session(session_, NGHTTP2_NO_ERROR);
+    try {
+      send();
+    }
+    catch (RecoverableException& e) {
+      // The connection is being closed anyway.
+    }
+  }
+  state_ = STATE_CLOSED;
+  error_ = error;
+  auto streams = std::move(streams_);
+  streams_.clear();
+  idleStartTime_ = global::wallclock();
+  for (auto& e : streams) {
+    auto& stream = e.second;
+    nghttp2_session_set_stream_user_data(session_, stream->getStreamId(),
+                                         nullptr);
+    stream->onClose(NGHTTP2_INTERNAL_ERROR);
+    wakeUp(stream->getCommand());
+  }
+}
+
+bool Http2Session::hasBufferedData() const
+{
+  return std::any_of(std::begin(streams_), std::end(streams_),
+                     [](const std::pair<const int32_t,
+                                        std::shared_ptr<Http2Stream>>& e) {
+                       return e.second->getBufferedLength() > 0;
+                     });
+}
+
+void Http2Session::wakeUp(Command* command)
+{
+  if (!command) {
+    return;
+  }
+  command->setStatusActive();
+  if (e_) {
+    e_->setNoWait(true);
+  }
+}
+
+std::string createHttp2Origin(const std::shared_ptr<Request>& req)
+{
+  return fmt("%s://%s:%u", req->getProtocol().c_str(), req->getHost().c_str(),
+             req->getPort());
+}
+
+bool shouldUseHttp2(const std::shared_ptr<Request>& req,
+                    const RequestGroup* requestGroup, const Option* option,
+                    const DownloadEngine* e)
+{
+  if (!option->getAsBool(PREF_ENABLE_HTTP2) ||
+      req->getMethod() != Request::METHOD_GET ||
+      !requestGroup->getPieceStorage() ||
+      requestGroup->getTotalLength() == 0) {
+    return false;
+  }
+  if (req->getProtocol() == "http") {
+    if (!option->getAsBool(PREF_HTTP2_PRIOR_KNOWLEDGE)) {
+      return false;
+    }
+  }
+#ifdef ENABLE_SSL
+  else if (req->getProtocol() != "https") {
+    return false;
+  }
+#else  // !ENABLE_SSL
+  else {
+    return false;
+  }
+#endif // !ENABLE_SSL
+  return !e->isHttp2Unsupported(createHttp2Origin(req));
+}
+
+} // namespace aria2
@@ -0,0 +1,263 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_HTTP2_SESSION_H
+#define D_HTTP2_SESSION_H
+
+#include "common.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+
+#include <nghttp2/nghttp2.h>
+
+#include "TimerA2.h"
+
+namespace aria2 {
+
+class SocketCore;
+class HttpHeader;
+class Command;
+class DownloadEngine;
+class Request;
+class RequestGroup;
+class Option;
+
+// A client side HTTP/2 stream, which carries one request and its
+// response.  The received data are kept until they are read by
+// Http2Session::readData().
+class Http2Stream {
+public:
+  Http2Stream(Command* command);
+  ~Http2Stream();
+
+  int32_t getStreamId() const { return streamId_; }
+
+  void setStreamId(int32_t streamId) { streamId_ = streamId; }
+
+  // The command which is woken up when something happens in this
+  // stream.  nullptr is allowed.
+  Command* getCommand() const { return command_; }
+
+  void setCommand(Command* command) { command_ = command; }
+
+  // Returns true if the final (non-1xx) response header has been
+  // received.
+  bool headersReceived() const { return headersReceived_; }
+
+  // The response header.  Status code is stored with
+  // HttpHeader::setStatusCode().
+  const std::unique_ptr<HttpHeader>& getHttpHeader() const
+  {
+    return httpHeader_;
+  }
+
+  std::unique_ptr<HttpHeader> popHttpHeader();
+
+  size_t getBufferedLength() const { return buf_.size() - bufOffset_; }
+
+  // Returns true if the stream has been closed, either normally or
+  // abnormally.  The buffered data are still available after the
+  // stream is closed.
+  bool closed() const { return closed_; }
+
+  // Returns the error code of RST_STREAM, or NGHTTP2_NO_ERROR if the
+  // stream was closed normally.
+  uint32_t getErrorCode() const { return errorCode_; }
+
+  // Following functions are called by Http2Session.
+  void onHeader(const std::string& name, const std::string& value);
+
+  // Returns false if the header block just received is an
+  // informational (1xx) response and was discarded.
+  bool onHeadersComplete();
+
+  void onData(const uint8_t* data, size_t len);
+
+  void onClose(uint32_t errorCode);
+
+  // Copies at most |len| bytes of the buffered data to |data| and
+  // removes them from the buffer.  Returns the number of bytes
+  // copied.
+  size_t drain(unsigned char* data, size_t len);
+
+private:
+  int32_t streamId_;
+  Command* command_;
+  std::unique_ptr<HttpHeader> httpHeader_;
+  bool headersReceived_;
+  std::string buf_;
+  size_t bufOffset_;
+  bool closed_;
+  uint32_t errorCode_;
+};
+
+// Client side HTTP/2 session over a single connection, shared by the
+// commands downloading from the same origin.  Each request is mapped
+// to a stream, and the session is driven by Http2SessionCommand.
+//
+// The session does not send WINDOW_UPDATE for the data until they
+// are read by readData(), so that the per-stream window set by the
+// constructor bounds the data buffered for each stream, and a slow
+// disk or the speed limit slows down the sender instead of filling
+// memory.  The connection level window is opened to the maximum so
+// that a stalled stream does not block the other streams.
+class Http2Session {
+public:
+  enum State {
+    // Waiting for the connection to be established.  Requests
+    // submitted in this state are sent when the connection is ready.
+    STATE_CONNECTING,
+    STATE_CONNECTED,
+    STATE_CLOSED
+  };
+
+  // |origin| is the key of this session, in the form of
+  // scheme://host:port.  |windowSize| is the initial window size of
+  // each stream.  |e| is used to wake up the commands, and can be
+  // nullptr.
+  Http2Session(std::string origin, int32_t windowSize, DownloadEngine* e);
+  ~Http2Session();
+
+  const std::string& getOrigin() const { return origin_; }
+
+  State getState() const { return state_; }
+
+  const std::shared_ptr<SocketCore>& getSocket() const { return socket_; }
+
+  // Associates the connected socket and switches the state to
+  // STATE_CONNECTED.  The connection preface and queued requests are
+  // sent by the next performIO() call.
+  void onConnected(const std::shared_ptr<SocketCore>& socket);
+
+  // The command driving this session, which is woken up when the
+  // session has something to send.
+  void setCommand(Command* command) { command_ = command; }
+
+  // Returns true if a new request can be submitted to this session.
+  bool isUsable() const;
+
+  // Submits a request with |headers|, which must include the pseudo
+  // header fields, and returns the stream for it.  Throws
+  // DlAbortEx on failure.
+  std::shared_ptr<Http2Stream>
+  submitRequest(const std::vector<std::pair<std::string, std::string>>& headers,
+                Command* command);
+
+  // Detaches |stream| from this session.  If the stream is still open,
+  // it is reset with CANCEL.
+  void closeStream(const std::shared_ptr<Http2Stream>& stream);
+
+  // Reads at most |len| bytes of the data received in |stream| into
+  // |data|, and returns the number of bytes read.  The window of the
+  // stream is opened by the same amount.
+  size_t readData(Http2Stream* stream, unsigned char* data, size_t len);
+
+  // Reads data from the socket and sends pending frames.  Throws
+  // RecoverableException on error.
+  void performIO();
+
+  bool wantRead() const;
+
+  bool wantWrite() const;
+
+  // Closes this session.  The remaining streams are closed with
+  // |error|, and their commands are woken up.  GOAWAY is sent if
+  // possible.
+  void terminate(const std::string& error);
+
+  // The error which closed this session.  Empty if the session is
+  // closed without error.
+  const std::string& getError() const { return error_; }
+
+  // The number of streams which are not closed yet.
+  size_t countStream() const { return streams_.size(); }
+
+  // Returns true if any stream holds data not read yet.
+  bool hasBufferedData() const;
+
+  // The time when the data were last received from the server.
+  const Timer& getLastReceiveTime() const { return lastReceiveTime_; }
+
+  // The time when the last stream was closed.  Used to close idle
+  // sessions.
+  const Timer& getIdleStartTime() const { return idleStartTime_; }
+
+  // Following functions are called from nghttp2 callbacks.
+  void onStreamClose(int32_t streamId, uint32_t errorCode);
+
+  void onGoaway() { goawayReceived_ = true; }
+
+  void wakeUp(Command* command);
+
+private:
+  void recv();
+
+  void send();
+
+  std::string origin_;
+  int32_t windowSize_;
+  DownloadEngine* e_;
+  State state_;
+  std::shared_ptr<SocketCore> socket_;
+  nghttp2_session* session_;
+  Command* command_;
+  std::map<int32_t, std::shared_ptr<Http2Stream>> streams_;
+  // Serialized frames which are not written to the socket yet
+  std::string sendBuf_;
+  size_t sendBufOffset_;
+  bool goawayReceived_;
+  std::string error_;
+  Timer lastReceiveTime_;
+  Timer idleStartTime_;
+};
+
+// Returns the origin of |req| in the form of scheme://host:port,
+// which is the key of Http2Session.
+std::string createHttp2Origin(const std::shared_ptr<Request>& req);
+
+// Returns true if the request for |req| should be sent over HTTP/2.
+// HTTP/2 is used only for the range requests issued after the file
+// size is known, so that the first request, which determines the
+// file size and name, always goes through HTTP/1.1.  The caller must
+// make sure that no proxy is used.
+bool shouldUseHttp2(const std::shared_ptr<Request>& req,
+                    const RequestGroup* requestGroup, const Option* option,
+                    const DownloadEngine* e);
+
+} // namespace aria2
+
+#endif // D_HTTP2_SESSION_H
@@ -0,0 +1,206 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "Http2SessionCommand.h"
+#include "Http2Session.h"
+#include "DownloadEngine.h"
+#include "RequestGroupMan.h"
+#include "SocketCore.h"
+#include "DlRetryEx.h"
+#include "Logger.h"
+#include "LogFactory.h"
+#include "message.h"
+#include "fmt.h"
+#include "util.h"
+#include "wallclock.h"
+#include "error_code.h"
+#include "A2STR.h"
+
+namespace aria2 {
+
+namespace {
+// The session is closed if it has no stream for this period.
+constexpr auto IDLE_TIMEOUT = 15_s;
+} // namespace
+
+Http2SessionCommand::Http2SessionCommand(
+    cuid_t cuid, const std::shared_ptr<Http2Session>& session,
+    const std::shared_ptr<SocketCore>& socket, std::string hostname,
+    DownloadEngine* e, std::chrono::seconds timeout)
+    : Command(cuid),
+      session_(session),
+      socket_(socket),
+      hostname_(std::move(hostname)),
+      e_(e),
+      timeout_(std::move(timeout)),
+      startTime_(global::wallclock()),
+      tls_(util::startsWith(session->getOrigin(), "https://")),
+      readCheck_(false),
+      writeCheck_(false)
+{
+  session_->setCommand(this);
+#ifdef ENABLE_SSL
+  if (tls_) {
+    socket_->setAlpnProtocols({"h2", "http/1.1"});
+  }
+#endif // ENABLE_SSL
+  setStatus(Command::STATUS_ONESHOT_REALTIME);
+}
+
+Http2SessionCommand::~Http2SessionCommand()
+{
+  session_->setCommand(nullptr);
+  updateReadWriteCheck(false, false);
+}
+
+void Http2SessionCommand::updateReadWriteCheck(bool wantRead, bool wantWrite)
+{
+  if (wantRead) {
+    if (!readCheck_) {
+      readCheck_ = true;
+      e_->addSocketForReadCheck(socket_, this);
+    }
+  }
+  else if (readCheck_) {
+    readCheck_ = false;
+    e_->deleteSocketForReadCheck(socket_, this);
+  }
+  if (wantWrite) {
+    if (!writeCheck_) {
+      writeCheck_ = true;
+      e_->addSocketForWriteCheck(socket_, this);
+    }
+  }
+  else if (writeCheck_) {
+    writeCheck_ = false;
+    e_->deleteSocketForWriteCheck(socket_, this);
+  }
+}
+
+void Http2SessionCommand::closeSession(const std::string& error)
+{
+  session_->terminate(error);
+  e_->removeHttp2Session(session_);
+}
+
+bool Http2SessionCommand::connect()
+{
+#ifdef ENABLE_SSL
+  if (tls_) {
+    if (!socket_->tlsConnect(hostname_)) {
+      if (startTime_.difference(global::wallclock()) >= timeout_) {
+        throw DL_RETRY_EX2(EX_TIME_OUT, error_code::TIME_OUT);
+      }
+      updateReadWriteCheck(socket_->wantRead(), socket_->wantWrite());
+      return false;
+    }
+    if (socket_->getAlpnSelectedProtocol() != "h2") {
+      A2_LOG_INFO(fmt("CUID#%" PRId64 " - %s does not support HTTP/2."
+                      " Falling back to HTTP/1.1.",
+                      getCuid(), session_->getOrigin().c_str()));
+      e_->markHttp2Unsupported(session_->getOrigin());
+      updateReadWriteCheck(false, false);
+      // The TLS connection is still good for HTTP/1.1.
+      auto peer = socket_->getPeerInfo();
+      e_->poolSocket(peer.addr, peer.port, A2STR::NIL, 0, socket_);
+      closeSession("The server does not support HTTP/2");
+      return false;
+    }
+  }
+#endif // ENABLE_SSL
+  session_->onConnected(socket_);
+  A2_LOG_INFO(fmt("CUID#%" PRId64 " - HTTP/2 session with %s established",
+                  getCuid(), session_->getOrigin().c_str()));
+  return true;
+}
+
+bool Http2SessionCommand::execute()
+{
+  if (e_->isHaltRequested()) {
+    closeSession(A2STR::NIL);
+    return true;
+  }
+  try {
+    if (session_->getState() == Http2Session::STATE_CONNECTING &&
+        !connect()) {
+      if (session_->getState() == Http2Session::STATE_CLOSED) {
+        return true;
+      }
+      e_->addCommand(std::unique_ptr<Command>(this));
+      return false;
+    }
+    if (session_->getState() == Http2Session::STATE_CLOSED) {
+      e_->removeHttp2Session(session_);
+      return true;
+    }
+    session_->performIO();
+    if (!session_->wantRead() && !session_->wantWrite()) {
+      // GOAWAY was exchanged and all streams are closed.
+      closeSession(A2STR::NIL);
+      return true;
+    }
+    if (session_->countStream() == 0) {
+      if (e_->getRequestGroupMan()->downloadFinished() ||
+          session_->getIdleStartTime().difference(global::wallclock()) >=
+              IDLE_TIMEOUT) {
+        A2_LOG_DEBUG(fmt("CUID#%" PRId64 " - Closing idle HTTP/2 session",
+                         getCuid()));
+        closeSession(A2STR::NIL);
+        return true;
+      }
+    }
+    else if (!session_->hasBufferedData() &&
+             session_->getLastReceiveTime().difference(global::wallclock()) >=
+                 timeout_) {
+      throw DL_RETRY_EX2(EX_TIME_OUT, error_code::TIME_OUT);
+    }
+  }
+  catch (RecoverableException& ex) {
+    A2_LOG_INFO_EX(fmt("CUID#%" PRId64 " - HTTP/2 session with %s failed",
+                       getCuid(), session_->getOrigin().c_str()),
+                   ex);
+    closeSession(ex.what());
+    return true;
+  }
+  updateReadWriteCheck(session_->wantRead(), session_->wantWrite());
+  if (socket_->getRecvBufferedLength()) {
+    // TLS layer holds decrypted data, which poll cannot see.
+    setStatus(Command::STATUS_ONESHOT_REALTIME);
+    e_->setNoWait(true);
+  }
+  e_->addCommand(std::unique_ptr<Command>(this));
+  return false;
+}
+
+} // namespace aria2
@@ -0,0 +1,91 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_HTTP2_SESSION_COMMAND_H
+#define D_HTTP2_SESSION_COMMAND_H
+
+#include "Command.h"
+
+#include <string>
+#include <memory>
+#include <chrono>
+
+#include "TimerA2.h"
+
+namespace aria2 {
+
+class DownloadEngine;
+class SocketCore;
+class Http2Session;
+
+// Drives Http2Session: performs TLS handshake with ALPN, reads and
+// writes frames, and closes the session when it becomes idle or
+// fails.  If the server does not select h2, the origin is marked as
+// HTTP/2 unsupported and the session is closed, so that the requests
+// in it fall back to HTTP/1.1.
+class Http2SessionCommand : public Command {
+private:
+  std::shared_ptr<Http2Session> session_;
+  std::shared_ptr<SocketCore> socket_;
+  std::string hostname_;
+  DownloadEngine* e_;
+  std::chrono::seconds timeout_;
+  // The time when this command started, used for the timeout of TLS
+  // handshake.
+  Timer startTime_;
+  bool tls_;
+  bool readCheck_;
+  bool writeCheck_;
+
+  // Returns true if the connection is ready for HTTP/2 frames.
+  bool connect();
+
+  void updateReadWriteCheck(bool wantRead, bool wantWrite);
+
+  void closeSession(const std::string& error);
+
+public:
+  Http2SessionCommand(cuid_t cuid, const std::shared_ptr<Http2Session>& session,
+                      const std::shared_ptr<SocketCore>& socket,
+                      std::string hostname, DownloadEngine* e,
+                      std::chrono::seconds timeout);
+
+  virtual ~Http2SessionCommand();
+
+  virtual bool execute() CXX11_OVERRIDE;
+};
+
+} // namespace aria2
+
+#endif // D_HTTP2_SESSION_COMMAND_H
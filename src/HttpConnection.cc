@@ -193,6 +193,11 @@ bool HttpConnection::isIssued(const std::shared_ptr<Segment>& segment) const
   return false;
 }
 
+size_t HttpConnection::countOutstandingRequest() const
+{
+  return outstandingHttpRequests_.size();
+}
+
 bool HttpConnection::sendBufferIsEmpty() const
 {
   return socketBuffer_.sendBufferIsEmpty();
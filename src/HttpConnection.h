@@ -125,6 +125,10 @@ public:
 
   bool isIssued(const std::shared_ptr<Segment>& segment) const;
 
+  // Returns the number of requests whose response header has not
+  // been received yet.
+  size_t countOutstandingRequest() const;
+
   bool sendBufferIsEmpty() const;
 
   void sendPendingData();
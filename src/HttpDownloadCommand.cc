@@ -88,7 +88,8 @@ bool HttpDownloadCommand::prepareForNextSegment()
   }
 
   const std::string& streamFilterName = getStreamFilter()->getName();
-  if (getRequest()->isPipeliningEnabled() ||
+  if ((getRequest()->isPipeliningEnabled() &&
+       httpConnection_->countOutstandingRequest() == 0) ||
       (getRequest()->isKeepAliveEnabled() &&
        (
            // Make sure that all filters are finished to pool socket
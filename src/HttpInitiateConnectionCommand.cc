@@ -55,6 +55,11 @@
 #include "ConnectCommand.h"
 #include "HttpRequestConnectChain.h"
 #include "HttpProxyRequestConnectChain.h"
+#ifdef HAVE_LIBNGHTTP2
+#  include "Http2Session.h"
+#  include "Http2RequestCommand.h"
+#  include "Http2ConnectChain.h"
+#endif // HAVE_LIBNGHTTP2
 
 namespace aria2 {
 
@@ -116,6 +121,12 @@ std::unique_ptr<Command> HttpInitiateConnectionCommand::createNextCommand(
     }
   }
   else {
+#ifdef HAVE_LIBNGHTTP2
+    if (shouldUseHttp2(getRequest(), getRequestGroup(), getOption().get(),
+                       getDownloadEngine())) {
+      return createHttp2Command(hostname, addr, port);
+    }
+#endif // HAVE_LIBNGHTTP2
     std::shared_ptr<SocketCore> pooledSocket =
         getDownloadEngine()->popPooledSocket(resolvedAddresses,
                                              getRequest()->getPort());
@@ -147,4 +158,41 @@ std::unique_ptr<Command> HttpInitiateConnectionCommand::createNextCommand(
   }
 }
 
+#ifdef HAVE_LIBNGHTTP2
+std::unique_ptr<Command> HttpInitiateConnectionCommand::createHttp2Command(
+    const std::string& hostname, const std::string& addr, uint16_t port)
+{
+  auto e = getDownloadEngine();
+  auto session = e->getHttp2Session(createHttp2Origin(getRequest()));
+  if (session) {
+    A2_LOG_DEBUG(fmt("CUID#%" PRId64 " - Reusing HTTP/2 session with %s",
+                     getCuid(), session->getOrigin().c_str()));
+    if (session->getSocket()) {
+      setConnectedAddrInfo(getRequest(), hostname, session->getSocket());
+    }
+    else {
+      // The session is still connecting.
+      getRequest()->setConnectedAddrInfo(hostname, addr, port);
+    }
+    return make_unique<Http2RequestCommand>(getCuid(), getRequest(),
+                                            getFileEntry(), getRequestGroup(),
+                                            session, e);
+  }
+  A2_LOG_INFO(fmt(MSG_CONNECTING_TO_SERVER, getCuid(), addr.c_str(), port));
+  createSocket();
+  getSocket()->establishConnection(addr, port);
+
+  getRequest()->setConnectedAddrInfo(hostname, addr, port);
+  session = std::make_shared<Http2Session>(
+      createHttp2Origin(getRequest()),
+      getOption()->getAsInt(PREF_HTTP2_WINDOW_SIZE), e);
+  e->addHttp2Session(session);
+  auto c = make_unique<ConnectCommand>(getCuid(), getRequest(), nullptr,
+                                       getFileEntry(), getRequestGroup(), e,
+                                       getSocket());
+  c->setControlChain(std::make_shared<Http2ConnectChain>(session, e));
+  return std::move(c);
+}
+#endif // HAVE_LIBNGHTTP2
+
 } // namespace aria2
@@ -58,6 +58,11 @@ namespace aria2 {
 //                 |                +------------> HttpProxyRequestCommand
 //                 |                |  otherwise
 //                 |                +------------> HttpRequestCommand
+//                 | HTTP/2 session exists?
+//                 +-----------------------------> Http2RequestCommand
+//                 | HTTP/2 is used?
+//                 +-----------------------------> Http2SessionCommand
+//                 |                               + Http2RequestCommand
 //                 | direct connection
 //                 +-----------------------------> HttpRequestCommand
 //
@@ -67,6 +72,13 @@ namespace aria2 {
 // resolution is in progress. After address resolution completed,
 // calling execute() returns true.
 class HttpInitiateConnectionCommand : public InitiateConnectionCommand {
+private:
+#ifdef HAVE_LIBNGHTTP2
+  std::unique_ptr<Command> createHttp2Command(const std::string& hostname,
+                                              const std::string& addr,
+                                              uint16_t port);
+#endif // HAVE_LIBNGHTTP2
+
 protected:
   virtual std::unique_ptr<Command> createNextCommand(
       const std::string& hostname, const std::string& addr, uint16_t port,
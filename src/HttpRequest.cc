@@ -141,11 +141,9 @@ std::string getHostText(const std::string& host, uint16_t port)
 }
 } // namespace
 
-std::string HttpRequest::createRequest()
+std::string HttpRequest::createRequestTarget() const
 {
-  authConfig_ = authConfigFactory_->createAuthConfig(request_, option_);
-  auto requestLine = request_->getMethod();
-  requestLine += ' ';
+  std::string target;
   if (proxyRequest_) {
     if (getProtocol() == "ftp" && request_->getUsername().empty() &&
         authConfig_) {
@@ -153,19 +151,22 @@ std::string HttpRequest::createRequest()
       auto uri = getCurrentURI();
       assert(uri.size() >= 6);
       uri.insert(6, util::percentEncode(authConfig_->getUser()) + '@');
-      requestLine += uri;
+      target += uri;
     }
     else {
-      requestLine += getCurrentURI();
+      target += getCurrentURI();
     }
   }
   else {
-    requestLine += getDir();
-    requestLine += getFile();
-    requestLine += getQuery();
+    target += getDir();
+    target += getFile();
+    target += getQuery();
   }
-  requestLine += " HTTP/1.1\r\n";
+  return target;
+}
 
+std::vector<std::string> HttpRequest::createHeaderFields() const
+{
   std::vector<std::pair<std::string, std::string>> builtinHds;
   builtinHds.reserve(20);
   builtinHds.emplace_back("User-Agent:", userAgent_);
@@ -265,27 +266,71 @@ std::string HttpRequest::createRequest()
       builtinHds.emplace_back("Want-Digest:", wantDigest);
     }
   }
+  std::vector<std::string> fields;
   for (const auto& builtinHd : builtinHds) {
     auto it = std::find_if(std::begin(headers_), std::end(headers_),
                            [&builtinHd](const std::string& hd) {
                              return util::istartsWith(hd, builtinHd.first);
                            });
     if (it == std::end(headers_)) {
-      requestLine += builtinHd.first;
-      requestLine += ' ';
-      requestLine += builtinHd.second;
-      requestLine += "\r\n";
+      auto field = builtinHd.first;
+      field += ' ';
+      field += builtinHd.second;
+      fields.push_back(std::move(field));
     }
   }
   // append additional headers given by user.
-  for (const auto& hd : headers_) {
-    requestLine += hd;
+  fields.insert(std::end(fields), std::begin(headers_), std::end(headers_));
+  return fields;
+}
+
+std::string HttpRequest::createRequest()
+{
+  authConfig_ = authConfigFactory_->createAuthConfig(request_, option_);
+  auto requestLine = request_->getMethod();
+  requestLine += ' ';
+  requestLine += createRequestTarget();
+  requestLine += " HTTP/1.1\r\n";
+  for (const auto& field : createHeaderFields()) {
+    requestLine += field;
     requestLine += "\r\n";
   }
   requestLine += "\r\n";
   return requestLine;
 }
 
+std::vector<std::pair<std::string, std::string>>
+HttpRequest::createHttp2Request()
+{
+  assert(!proxyRequest_);
+  authConfig_ = authConfigFactory_->createAuthConfig(request_, option_);
+  std::vector<std::pair<std::string, std::string>> nva;
+  nva.emplace_back(":method", request_->getMethod());
+  nva.emplace_back(":scheme", getProtocol());
+  nva.emplace_back(":authority", getHostText(getURIHost(), getPort()));
+  nva.emplace_back(":path", createRequestTarget());
+  for (const auto& field : createHeaderFields()) {
+    auto colon = field.find(':');
+    if (colon == std::string::npos) {
+      continue;
+    }
+    auto name = util::toLower(util::strip(field.substr(0, colon)));
+    auto value = util::strip(field.substr(colon + 1));
+    if (name == "host") {
+      nva[2].second = value;
+      continue;
+    }
+    // Connection-specific header fields must not be used in HTTP/2.
+    if (name.empty() || name == "connection" || name == "keep-alive" ||
+        name == "proxy-connection" || name == "transfer-encoding" ||
+        name == "upgrade" || name == "te") {
+      continue;
+    }
+    nva.emplace_back(std::move(name), std::move(value));
+  }
+  return nva;
+}
+
 std::string HttpRequest::createProxyRequest() const
 {
   assert(proxyRequest_);
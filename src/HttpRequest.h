@@ -103,6 +103,13 @@ private:
 
   std::pair<std::string, std::string> getProxyAuthString() const;
 
+  // Returns the request target used in the request line.
+  std::string createRequestTarget() const;
+
+  // Returns the request header fields in the form of "Name: value".
+  // The header fields given by the user override the built-in ones.
+  std::vector<std::string> createHeaderFields() const;
+
 public:
   HttpRequest();
   ~HttpRequest();
@@ -156,6 +163,13 @@ public:
    */
   std::string createRequest();
 
+  // Returns the header fields of HTTP/2 request, including pseudo
+  // header fields, in the order to be sent.  Names are lower-cased,
+  // and connection-specific header fields are removed.  Requests via
+  // proxy are not supported.  The AuthConfig is resolved as
+  // createRequest() does.
+  std::vector<std::pair<std::string, std::string>> createHttp2Request();
+
   /**
    * Returns string representation of http tunnel request.
    * It usually starts with "CONNECT ..." and ends with "\r\n".
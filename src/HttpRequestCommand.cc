@@ -78,7 +78,6 @@ HttpRequestCommand::HttpRequestCommand(
 
 HttpRequestCommand::~HttpRequestCommand() = default;
 
-namespace {
 std::unique_ptr<HttpRequest>
 createHttpRequest(const std::shared_ptr<Request>& req,
                   const std::shared_ptr<FileEntry>& fileEntry,
@@ -86,7 +85,7 @@ createHttpRequest(const std::shared_ptr<Request>& req,
                   const std::shared_ptr<Option>& option, const RequestGroup* rg,
                   const DownloadEngine* e,
                   const std::shared_ptr<Request>& proxyRequest,
-                  int64_t endOffset = 0)
+                  int64_t endOffset)
 {
   auto httpRequest = make_unique<HttpRequest>();
   httpRequest->setUserAgent(option->get(PREF_USER_AGENT));
@@ -118,7 +117,24 @@ createHttpRequest(const std::shared_ptr<Request>& req,
   }
   return httpRequest;
 }
-} // namespace
+
+int64_t getRangeEndOffset(const std::shared_ptr<Request>& req,
+                          const std::shared_ptr<FileEntry>& fileEntry,
+                          const RequestGroup* rg,
+                          const std::shared_ptr<Segment>& segment)
+{
+  // FTP via HTTP proxy does not support end byte marker
+  if (req->getProtocol() == "ftp" || rg->getTotalLength() == 0 ||
+      !rg->getPieceStorage()) {
+    return 0;
+  }
+  size_t nextIndex =
+      rg->getPieceStorage()->getNextUsedIndex(segment->getIndex());
+  return std::min(fileEntry->getLength(),
+                  fileEntry->gtoloff(
+                      static_cast<int64_t>(segment->getSegmentLength()) *
+                      nextIndex));
+}
 
 bool HttpRequestCommand::executeInternal()
 {
@@ -174,18 +190,8 @@ bool HttpRequestCommand::executeInternal()
     else {
       for (auto& segment : getSegments()) {
         if (!httpConnection_->isIssued(segment)) {
-          int64_t endOffset = 0;
-          // FTP via HTTP proxy does not support end byte marker
-          if (getRequest()->getProtocol() != "ftp" &&
-              getRequestGroup()->getTotalLength() > 0 && getPieceStorage()) {
-            size_t nextIndex =
-                getPieceStorage()->getNextUsedIndex(segment->getIndex());
-            endOffset =
-                std::min(getFileEntry()->getLength(),
-                         getFileEntry()->gtoloff(
-                             static_cast<int64_t>(segment->getSegmentLength()) *
-                             nextIndex));
-          }
+          auto endOffset = getRangeEndOffset(getRequest(), getFileEntry(),
+                                             getRequestGroup(), segment);
           httpConnection_->sendRequest(
               createHttpRequest(getRequest(), getFileEntry(), segment,
                                 getOption(), getRequestGroup(),
@@ -211,6 +217,13 @@ bool HttpRequestCommand::executeInternal()
   }
 }
 
+bool HttpRequestCommand::isSocketIdle() const
+{
+  return httpConnection_->countOutstandingRequest() == 0 &&
+         httpConnection_->sendBufferIsEmpty() &&
+         httpConnection_->getSocketRecvBuffer()->bufferEmpty();
+}
+
 void HttpRequestCommand::setProxyRequest(
     const std::shared_ptr<Request>& proxyRequest)
 {
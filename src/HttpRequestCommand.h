@@ -40,7 +40,30 @@
 namespace aria2 {
 
 class HttpConnection;
+class HttpRequest;
 class SocketCore;
+class Segment;
+class Option;
+
+// Creates HttpRequest to download |segment| of |fileEntry| from
+// |req|.  If |endOffset| is greater than 0, the range ends at
+// |endOffset| (exclusive, file local offset).
+std::unique_ptr<HttpRequest>
+createHttpRequest(const std::shared_ptr<Request>& req,
+                  const std::shared_ptr<FileEntry>& fileEntry,
+                  const std::shared_ptr<Segment>& segment,
+                  const std::shared_ptr<Option>& option, const RequestGroup* rg,
+                  const DownloadEngine* e,
+                  const std::shared_ptr<Request>& proxyRequest,
+                  int64_t endOffset = 0);
+
+// Returns the file local end offset of the range request for
+// |segment|, which is the beginning of the next segment in use, or 0
+// if the end of range should not be specified.
+int64_t getRangeEndOffset(const std::shared_ptr<Request>& req,
+                          const std::shared_ptr<FileEntry>& fileEntry,
+                          const RequestGroup* rg,
+                          const std::shared_ptr<Segment>& segment);
 
 // HttpRequestCommand sends HTTP request header to remote server.
 // Because network I/O is non-blocking, execute() returns false if all
@@ -57,6 +80,8 @@ private:
 protected:
   virtual bool executeInternal() CXX11_OVERRIDE;
 
+  virtual bool isSocketIdle() const CXX11_OVERRIDE;
+
 public:
   HttpRequestCommand(cuid_t cuid, const std::shared_ptr<Request>& req,
                      const std::shared_ptr<FileEntry>& fileEntry,
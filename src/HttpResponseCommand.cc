@@ -164,6 +164,21 @@ bool HttpResponseCommand::executeInternal()
   auto& req = getRequest();
   req->supportsPersistentConnection(
       httpResponse->supportsPersistentConnection());
+  // If the server closes the connection before any pipelined response
+  // arrives, it will do so for the following connections, which
+  // reduces pipelining to one segment per connection.  Fall back to
+  // downloading contiguous segments over a connection for this server.
+  // Error responses and redirects often close the connection
+  // regardless, so only successful ones count.
+  if (req->isPipeliningHint() && !req->isPipeliningEnabled() &&
+      req->getMaxPipelinedRequest() == 1 &&
+      httpResponse->getStatusCode() / 100 == 2) {
+    A2_LOG_INFO(fmt("CUID#%" PRId64 " - %s(%u) does not keep the connection"
+                    " alive. HTTP pipelining is disabled for it.",
+                    getCuid(), req->getHost().c_str(), req->getPort()));
+    getDownloadEngine()->markPipeliningUnsupported(req->getHost(),
+                                                   req->getPort());
+  }
   if (req->isPipeliningEnabled()) {
     req->setMaxPipelinedRequest(
         getOption()->getAsInt(PREF_MAX_HTTP_PIPELINING));
@@ -371,14 +386,18 @@ bool HttpResponseCommand::handleDefaultEncoding(
   // have segment after PieceStorage is initialized. See
   // AbstractCommand::execute()
   auto segment = getSegmentMan()->getSegmentWithIndex(getCuid(), 0);
-  // pipelining requires implicit range specified. But the request for
-  // this response most likely doesn't contains range header. This means
-  // we can't continue to use this socket because server sends all entity
-  // body instead of a segment.
-  // Therefore, we shutdown the socket here if pipelining is enabled.
   if (getRequest()->getMethod() == Request::METHOD_GET && segment &&
-      segment->getPositionToWrite() == 0 &&
-      !getRequest()->isPipeliningEnabled()) {
+      segment->getPositionToWrite() == 0) {
+    // pipelining requires implicit range specified. But the request
+    // for this response doesn't contain range header, and server
+    // sends all entity body instead of a segment.  Instead of
+    // shutting down the socket, we keep reading the body without
+    // pipelining on this connection.  Pipelining is enabled again
+    // when the next connection is made.
+    if (getRequest()->isPipeliningEnabled()) {
+      getRequest()->setPipeliningHint(false);
+      getRequest()->setMaxPipelinedRequest(1);
+    }
     auto teFilter = getTransferEncodingStreamFilter(httpResponse.get());
     checkEntry->pushNextCommand(createHttpDownloadCommand(
         std::move(httpResponse), std::move(teFilter)));
@@ -263,18 +263,19 @@ void HttpServer::feedResponse(std::string text, const std::string& contentType)
   feedResponse(200, "", std::move(text), contentType);
 }
 
-void HttpServer::feedResponse(int status, const std::string& headers,
-                              std::string text, const std::string& contentType)
+std::string HttpServer::createResponseHeader(int status,
+                                             const std::string& framing,
+                                             const std::string& headers,
+                                             const std::string& contentType)
 {
   std::string httpDate = Time().toHTTPDate();
-  std::string header =
-      fmt("HTTP/1.1 %s\r\n"
-          "Date: %s\r\n"
-          "Content-Length: %lu\r\n"
-          "Expires: %s\r\n"
-          "Cache-Control: no-cache\r\n",
-          getStatusString(status), httpDate.c_str(),
-          static_cast<unsigned long>(text.size()), httpDate.c_str());
+  std::string header = fmt("HTTP/1.1 %s\r\n"
+                           "Date: %s\r\n"
+                           "%s"
+                           "Expires: %s\r\n"
+                           "Cache-Control: no-cache\r\n",
+                           getStatusString(status), httpDate.c_str(),
+                           framing.c_str(), httpDate.c_str());
   if (!contentType.empty()) {
     header += "Content-Type: ";
     header += contentType;
@@ -294,10 +295,89 @@ void HttpServer::feedResponse(int status, const std::string& headers,
   header += headers;
   header += "\r\n";
   A2_LOG_DEBUG(fmt("HTTP Server sends response:\n%s", header.c_str()));
-  socketBuffer_.pushStr(std::move(header));
+  return header;
+}
+
+void HttpServer::feedResponse(int status, const std::string& headers,
+                              std::string text, const std::string& contentType)
+{
+  socketBuffer_.pushStr(createResponseHeader(
+      status,
+      fmt("Content-Length: %lu\r\n", static_cast<unsigned long>(text.size())),
+      headers, contentType));
   socketBuffer_.pushStr(std::move(text));
 }
 
+namespace {
+// Threshold of the body size above which the response generated by
+// BufferSource is streamed.
+constexpr size_t STREAM_THRESHOLD = 64_k;
+} // namespace
+
+namespace {
+void appendChunk(std::string& out, const std::string& data)
+{
+  out += fmt("%lx\r\n", static_cast<unsigned long>(data.size()));
+  out += data;
+  out += "\r\n";
+}
+} // namespace
+
+namespace {
+// Formats the data generated by the underlying source in chunked
+// transfer-encoding.
+class ChunkedBufferSource : public BufferSource {
+public:
+  ChunkedBufferSource(std::unique_ptr<BufferSource> source)
+      : source_(std::move(source))
+  {
+  }
+
+  virtual bool read(std::string& buf) CXX11_OVERRIDE
+  {
+    std::string data;
+    bool eof = source_->read(data);
+    if (!data.empty()) {
+      appendChunk(buf, data);
+    }
+    if (eof) {
+      buf += "0\r\n\r\n";
+    }
+    return eof;
+  }
+
+private:
+  std::unique_ptr<BufferSource> source_;
+};
+} // namespace
+
+void HttpServer::feedResponse(std::unique_ptr<BufferSource> body,
+                              const std::string& contentType)
+{
+  std::string text;
+  while (text.size() < STREAM_THRESHOLD) {
+    if (body->read(text)) {
+      feedResponse(std::move(text), contentType);
+      return;
+    }
+  }
+  if (lastRequestHeader_->getVersion() == "HTTP/1.1") {
+    socketBuffer_.pushStr(createResponseHeader(
+        200, "Transfer-Encoding: chunked\r\n", "", contentType));
+    std::string chunk;
+    appendChunk(chunk, text);
+    socketBuffer_.pushSource(make_unique<ChunkedBufferSource>(std::move(body)),
+                             std::move(chunk));
+  }
+  else {
+    // HTTP/1.0 client does not understand chunked transfer-encoding.
+    // Closing connection tells the end of the body.
+    disableKeepAlive();
+    socketBuffer_.pushStr(createResponseHeader(200, "", "", contentType));
+    socketBuffer_.pushSource(std::move(body), std::move(text));
+  }
+}
+
 void HttpServer::feedUpgradeResponse(const std::string& protocol,
                                      const std::string& headers)
 {
@@ -87,6 +87,13 @@ private:
   std::string allowOrigin_;
   bool secure_;
 
+  // Returns the header of the response with the status code
+  // |status|.  |framing| is the header field telling the length of
+  // the body.
+  std::string createResponseHeader(int status, const std::string& framing,
+                                   const std::string& headers,
+                                   const std::string& contentType);
+
 public:
   HttpServer(const std::shared_ptr<SocketCore>& socket);
 
@@ -119,6 +126,14 @@ public:
   void feedResponse(int status, const std::string& headers = "",
                     std::string text = "", const std::string& contentType = "");
 
+  // Feeds 200 response whose body is generated by |body| while the
+  // peer reads it.  If the body turns out to be small, it is sent
+  // with Content-Length as usual.  Otherwise, it is sent with chunked
+  // transfer-encoding, or delimited by closing connection if the
+  // peer is HTTP/1.0 client.
+  void feedResponse(std::unique_ptr<BufferSource> body,
+                    const std::string& contentType);
+
   // Feeds "101 Switching Protocols" response. The |protocol| will
   // appear in Upgrade header field. The |headers| is zero or more
   // lines of HTTP header field and each line must end with "\r\n".
@@ -100,17 +100,20 @@ std::string getJsonRpcContentType(bool script)
 }
 } // namespace
 
-void HttpServerBodyCommand::sendJsonRpcResponse(const rpc::RpcResponse& res,
-                                                const std::string& callback)
+void HttpServerBodyCommand::sendJsonRpcResponse(
+    rpc::RpcResponse res, const std::string& callback,
+    std::shared_ptr<ValueBaseArena> arena)
 {
   bool notauthorized = rpc::not_authorized(res);
   bool gzip = httpServer_->supportsGZip();
-  std::string responseData = rpc::toJson(res, callback, gzip);
   if (res.code == 0) {
-    httpServer_->feedResponse(std::move(responseData),
-                              getJsonRpcContentType(!callback.empty()));
+    httpServer_->feedResponse(
+        make_unique<rpc::JsonResponseSource>(std::move(arena), std::move(res),
+                                             callback, gzip),
+        getJsonRpcContentType(!callback.empty()));
   }
   else {
+    std::string responseData = rpc::toJson(res, callback, gzip);
     httpServer_->disableKeepAlive();
     int httpCode;
     switch (res.code) {
@@ -134,13 +137,15 @@ void HttpServerBodyCommand::sendJsonRpcResponse(const rpc::RpcResponse& res,
 }
 
 void HttpServerBodyCommand::sendJsonRpcBatchResponse(
-    const std::vector<rpc::RpcResponse>& results, const std::string& callback)
+    std::vector<rpc::RpcResponse> results, const std::string& callback,
+    std::shared_ptr<ValueBaseArena> arena)
 {
   bool notauthorized = rpc::any_not_authorized(results.begin(), results.end());
   bool gzip = httpServer_->supportsGZip();
-  std::string responseData = rpc::toJsonBatch(results, callback, gzip);
-  httpServer_->feedResponse(std::move(responseData),
-                            getJsonRpcContentType(!callback.empty()));
+  httpServer_->feedResponse(
+      make_unique<rpc::JsonResponseSource>(std::move(arena), std::move(results),
+                                           callback, gzip),
+      getJsonRpcContentType(!callback.empty()));
   addHttpServerResponseCommand(notauthorized);
 }
 
@@ -218,6 +223,10 @@ bool HttpServerBodyCommand::execute()
           return true;
         }
 
+        // The request and response trees are built in an arena which
+        // JSON-RPC response keeps until it is sent.
+        auto arena = std::make_shared<ValueBaseArena>();
+        ValueBaseArena::Scope arenaScope(*arena);
         // Do something for requestpath and body
         switch (httpServer_->getRequestType()) {
         case RPC_TYPE_XML: {
@@ -278,13 +287,13 @@ bool HttpServerBodyCommand::execute()
                             getCuid()));
             rpc::RpcResponse res(rpc::createJsonRpcErrorResponse(
                 -32700, "Parse error.", Null::g()));
-            sendJsonRpcResponse(res, callback);
+            sendJsonRpcResponse(std::move(res), callback, arena);
             return true;
           }
           Dict* jsondict = downcast<Dict>(json);
           if (jsondict) {
             auto res = rpc::processJsonRpcRequest(jsondict, e_);
-            sendJsonRpcResponse(res, callback);
+            sendJsonRpcResponse(std::move(res), callback, arena);
           }
           else {
             List* jsonlist = downcast<List>(json);
@@ -300,12 +309,12 @@ bool HttpServerBodyCommand::execute()
                   results.push_back(std::move(resp));
                 }
               }
-              sendJsonRpcBatchResponse(results, callback);
+              sendJsonRpcBatchResponse(std::move(results), callback, arena);
             }
             else {
               rpc::RpcResponse res(rpc::createJsonRpcErrorResponse(
                   -32600, "Invalid Request.", Null::g()));
-              sendJsonRpcResponse(res, callback);
+              sendJsonRpcResponse(std::move(res), callback, arena);
             }
           }
           return true;
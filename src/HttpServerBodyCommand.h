@@ -57,10 +57,13 @@ private:
   Timer timeoutTimer_;
   bool writeCheck_;
 
-  void sendJsonRpcResponse(const rpc::RpcResponse& res,
-                           const std::string& callback);
-  void sendJsonRpcBatchResponse(const std::vector<rpc::RpcResponse>& results,
-                                const std::string& callback);
+  // The response is streamed to the client while it keeps |arena|
+  // alive.
+  void sendJsonRpcResponse(rpc::RpcResponse res, const std::string& callback,
+                           std::shared_ptr<ValueBaseArena> arena);
+  void sendJsonRpcBatchResponse(std::vector<rpc::RpcResponse> results,
+                                const std::string& callback,
+                                std::shared_ptr<ValueBaseArena> arena);
   void addHttpServerResponseCommand(bool delayed);
   void updateWriteCheck();
 
@@ -164,11 +164,9 @@ bool HttpSkipResponseCommand::executeInternal()
     finished = streamFilter_->finished();
   }
   if (finished) {
-    if (getSegments().size() <= 1) {
-      // Don't pool connection if the command has multiple
-      // segments. This means it did HTTP pipelined request. If this
-      // response is for the first request, then successive response
-      // may arrived to the socket.
+    if (httpConnection_->countOutstandingRequest() == 0) {
+      // Don't pool connection if the responses to the other
+      // pipelined requests are still to arrive to the socket.
       poolConnection();
     }
     return processResponse();
@@ -64,7 +64,8 @@ InitiateConnectionCommandFactory::createInitiateConnectionCommand(
       req->setKeepAliveHint(true);
     }
     if (requestGroup->getOption()->getAsBool(PREF_ENABLE_HTTP_PIPELINING)) {
-      req->setPipeliningHint(true);
+      req->setPipeliningHint(
+          !e->isPipeliningUnsupported(req->getHost(), req->getPort()));
     }
 
     return make_unique<HttpInitiateConnectionCommand>(cuid, req, fileEntry,
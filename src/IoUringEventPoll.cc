@@ -0,0 +1,552 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "IoUringEventPoll.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <signal.h>
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <numeric>
+
+#include "Command.h"
+#include "LogFactory.h"
+#include "Logger.h"
+#include "util.h"
+#include "a2functional.h"
+#include "fmt.h"
+
+namespace aria2 {
+
+namespace {
+int ioUringSetup(unsigned entries, struct io_uring_params* p)
+{
+  return syscall(__NR_io_uring_setup, entries, p);
+}
+} // namespace
+
+namespace {
+int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete,
+                 unsigned flags, const void* arg, size_t argsz)
+{
+  return syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg,
+                 argsz);
+}
+} // namespace
+
+namespace {
+// user_data of the completions which should be ignored, e.g., the
+// result of IORING_OP_POLL_REMOVE.
+const uint64_t IGNORED_USER_DATA = 0;
+
+uint64_t makeUserData(sock_t socket, uint32_t generation)
+{
+  return (static_cast<uint64_t>(generation) << 32) |
+         static_cast<uint32_t>(socket);
+}
+} // namespace
+
+IoUringEventPoll::KSocketEntry::KSocketEntry(sock_t s)
+    : SocketEntry<KCommandEvent, KADNSEvent>(s),
+      generation(0),
+      armedEvents(0),
+      dirty(false)
+{
+}
+
+int accumulateEvent(int events, const IoUringEventPoll::KEvent& event)
+{
+  return events | event.getEvents();
+}
+
+int IoUringEventPoll::KSocketEntry::getEvents()
+{
+#ifdef ENABLE_ASYNC_DNS
+
+  return std::accumulate(adnsEvents_.begin(), adnsEvents_.end(),
+                         std::accumulate(commandEvents_.begin(),
+                                         commandEvents_.end(), 0,
+                                         accumulateEvent),
+                         accumulateEvent);
+
+#else // !ENABLE_ASYNC_DNS
+
+  return std::accumulate(commandEvents_.begin(), commandEvents_.end(), 0,
+                         accumulateEvent);
+
+#endif // !ENABLE_ASYNC_DNS
+}
+
+IoUringEventPoll::IoUringEventPoll(unsigned ringEntries)
+    : generation_(0),
+      ringfd_(-1),
+      sqRing_(MAP_FAILED),
+      sqRingSize_(0),
+      sqLocalTail_(0),
+      sqes_(static_cast<struct io_uring_sqe*>(MAP_FAILED)),
+      sqesSize_(0),
+      cqRing_(MAP_FAILED),
+      cqRingSize_(0)
+{
+  if (!setupRing(ringEntries)) {
+    int errNum = errno;
+    A2_LOG_INFO(fmt("Setting up io_uring failed: %s",
+                    util::safeStrerror(errNum).c_str()));
+  }
+}
+
+IoUringEventPoll::~IoUringEventPoll()
+{
+  if (sqes_ != MAP_FAILED) {
+    munmap(sqes_, sqesSize_);
+  }
+  if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) {
+    munmap(cqRing_, cqRingSize_);
+  }
+  if (sqRing_ != MAP_FAILED) {
+    munmap(sqRing_, sqRingSize_);
+  }
+  if (ringfd_ != -1) {
+    int r = close(ringfd_);
+    int errNum = errno;
+    if (r == -1) {
+      A2_LOG_ERROR(fmt("Error occurred while closing io_uring file descriptor"
+                       " %d: %s",
+                       ringfd_, util::safeStrerror(errNum).c_str()));
+    }
+  }
+}
+
+bool IoUringEventPoll::setupRing(unsigned ringEntries)
+{
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ringfd_ = ioUringSetup(ringEntries, &params);
+  if (ringfd_ == -1) {
+    return false;
+  }
+  if (!(params.features & IORING_FEAT_EXT_ARG)) {
+    errno = ENOSYS;
+    return false;
+  }
+  sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cqRingSize_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+  }
+  sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, ringfd_, IORING_OFF_SQ_RING);
+  if (sqRing_ == MAP_FAILED) {
+    return false;
+  }
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    cqRing_ = sqRing_;
+  }
+  else {
+    cqRing_ = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ringfd_, IORING_OFF_CQ_RING);
+    if (cqRing_ == MAP_FAILED) {
+      return false;
+    }
+  }
+  sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  sqes_ = static_cast<struct io_uring_sqe*>(
+      mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, ringfd_, IORING_OFF_SQES));
+  if (sqes_ == MAP_FAILED) {
+    return false;
+  }
+  auto sq = static_cast<char*>(sqRing_);
+  sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+  sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  sqEntries_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+  sqLocalTail_ = *sqTail_;
+  auto cq = static_cast<char*>(cqRing_);
+  cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+  return true;
+}
+
+bool IoUringEventPoll::good() const
+{
+  return ringfd_ != -1 && sqes_ != MAP_FAILED;
+}
+
+bool IoUringEventPoll::sqFull() const
+{
+  return sqLocalTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) ==
+         sqEntries_;
+}
+
+struct io_uring_sqe* IoUringEventPoll::getSqe()
+{
+  if (sqFull()) {
+    int rv = submit(nullptr);
+    if (rv < 0 || sqFull()) {
+      // The kernel refuses new entries, e.g., with EBUSY, while the
+      // completion queue is full.  Make room there and try again.
+      reapCompletions();
+      rv = submit(nullptr);
+    }
+    if (rv < 0 || sqFull()) {
+      A2_LOG_INFO(fmt("io_uring submission queue is full: %s",
+                      rv < 0 ? util::safeStrerror(-rv).c_str() : ""));
+      // Never overwrite the entries the kernel has not consumed.
+      return nullptr;
+    }
+  }
+  unsigned index = sqLocalTail_ & sqMask_;
+  auto sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqArray_[index] = index;
+  ++sqLocalTail_;
+  return sqe;
+}
+
+int IoUringEventPoll::submit(const struct __kernel_timespec* timeout)
+{
+  __atomic_store_n(sqTail_, sqLocalTail_, __ATOMIC_RELEASE);
+  // Includes the entries left by the previous short submission.
+  unsigned toSubmit =
+      sqLocalTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+  unsigned flags = 0;
+  unsigned minComplete = 0;
+  struct io_uring_getevents_arg arg;
+  memset(&arg, 0, sizeof(arg));
+  if (timeout) {
+    flags |= IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+    minComplete = 1;
+    arg.sigmask_sz = _NSIG / 8;
+    arg.ts = reinterpret_cast<uint64_t>(timeout);
+  }
+  for (;;) {
+    int rv = ioUringEnter(ringfd_, toSubmit, minComplete, flags,
+                          timeout ? &arg : nullptr, timeout ? sizeof(arg) : 0);
+    if (rv == -1) {
+      int errNum = errno;
+      if (errNum == EINTR) {
+        continue;
+      }
+      return -errNum;
+    }
+    if (rv > 0 && static_cast<unsigned>(rv) < toSubmit && timeout) {
+      // The kernel consumed only a part of the entries, e.g.,
+      // because the completion queue is about to overflow.  Try
+      // again; the completions are waited for in that call.
+      toSubmit -= rv;
+      continue;
+    }
+    return rv;
+  }
+}
+
+bool IoUringEventPoll::queuePollAdd(KSocketEntry& socketEntry)
+{
+  auto sqe = getSqe();
+  if (!sqe) {
+    markUpdate(socketEntry);
+    return false;
+  }
+  int events = socketEntry.getEvents();
+  socketEntry.generation = ++generation_;
+  socketEntry.armedEvents = events;
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = socketEntry.getSocket();
+  sqe->poll32_events = events;
+  sqe->user_data =
+      makeUserData(socketEntry.getSocket(), socketEntry.generation);
+  return true;
+}
+
+void IoUringEventPoll::queuePollRemove(KSocketEntry& socketEntry)
+{
+  socketEntry.armedEvents = 0;
+  // If the removal is delayed, the completion of the request is
+  // ignored because of the generation.
+  queuePollRemove(
+      makeUserData(socketEntry.getSocket(), socketEntry.generation));
+}
+
+bool IoUringEventPoll::queuePollRemove(uint64_t userData)
+{
+  auto sqe = getSqe();
+  if (!sqe) {
+    pendingRemoves_.push_back(userData);
+    return false;
+  }
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = userData;
+  sqe->user_data = IGNORED_USER_DATA;
+  return true;
+}
+
+void IoUringEventPoll::markUpdate(KSocketEntry& socketEntry)
+{
+  if (!socketEntry.dirty) {
+    socketEntry.dirty = true;
+    updates_.push_back(socketEntry.getSocket());
+  }
+}
+
+void IoUringEventPoll::flushUpdates()
+{
+  // Submit the delayed removals before any new poll request.
+  std::vector<uint64_t> removes;
+  removes.swap(pendingRemoves_);
+  for (auto i = std::begin(removes); i != std::end(removes); ++i) {
+    if (!queuePollRemove(*i)) {
+      pendingRemoves_.insert(std::end(pendingRemoves_), i + 1,
+                             std::end(removes));
+      break;
+    }
+  }
+  // getSqe() may reap completions, which adds sockets to updates_.
+  std::vector<sock_t> updates;
+  updates.swap(updates_);
+  for (auto socket : updates) {
+    auto i = socketEntries_.find(socket);
+    if (i == std::end(socketEntries_)) {
+      continue;
+    }
+    auto& socketEntry = (*i).second;
+    socketEntry.dirty = false;
+    int events = socketEntry.getEvents();
+    if (socketEntry.armedEvents == events) {
+      continue;
+    }
+    if (socketEntry.armedEvents) {
+      queuePollRemove(socketEntry);
+    }
+    queuePollAdd(socketEntry);
+  }
+}
+
+void IoUringEventPoll::reapCompletions()
+{
+  unsigned head = *cqHead_;
+  unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+  for (; head != tail; ++head) {
+    const auto& cqe = cqes_[head & cqMask_];
+    if (cqe.user_data == IGNORED_USER_DATA) {
+      continue;
+    }
+    sock_t socket = static_cast<sock_t>(cqe.user_data & 0xffffffffu);
+    uint32_t generation = cqe.user_data >> 32;
+    auto i = socketEntries_.find(socket);
+    if (i == std::end(socketEntries_) ||
+        (*i).second.generation != generation) {
+      // The request was superseded or its socket was removed.
+      continue;
+    }
+    auto& socketEntry = (*i).second;
+    socketEntry.armedEvents = 0;
+    // Poll requests are one-shot.  Submit the new one in the next
+    // poll().
+    markUpdate(socketEntry);
+    if (cqe.res == -ECANCELED) {
+      continue;
+    }
+    int events = cqe.res < 0 ? IEV_ERROR : cqe.res;
+    socketEntry.processEvents(events);
+  }
+  __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+}
+
+void IoUringEventPoll::poll(const struct timeval& tv)
+{
+  flushUpdates();
+
+  struct __kernel_timespec ts;
+  ts.tv_sec = tv.tv_sec;
+  ts.tv_nsec = tv.tv_usec * 1000;
+
+  int rv = submit(&ts);
+  if (rv < 0 && rv != -ETIME && rv != -EBUSY) {
+    A2_LOG_INFO(
+        fmt("io_uring_enter error: %s", util::safeStrerror(-rv).c_str()));
+  }
+  reapCompletions();
+
+#ifdef ENABLE_ASYNC_DNS
+  // It turns out that we have to call ares_process_fd before ares's
+  // own timeout and ares may create new sockets or closes socket in
+  // their API. So we call ares_process_fd for all ares_channel and
+  // re-register their sockets.
+  for (auto& i : nameResolverEntries_) {
+    auto& ent = i.second;
+    ent.processTimeout();
+    ent.removeSocketEvents(this);
+    ent.addSocketEvents(this);
+  }
+#endif // ENABLE_ASYNC_DNS
+
+  // TODO timeout of name resolver is determined in Command(AbstractCommand,
+  // DHTEntryPoint...Command)
+}
+
+namespace {
+int translateEvents(EventPoll::EventType events)
+{
+  int newEvents = 0;
+  if (EventPoll::EVENT_READ & events) {
+    newEvents |= IoUringEventPoll::IEV_READ;
+  }
+  if (EventPoll::EVENT_WRITE & events) {
+    newEvents |= IoUringEventPoll::IEV_WRITE;
+  }
+  if (EventPoll::EVENT_ERROR & events) {
+    newEvents |= IoUringEventPoll::IEV_ERROR;
+  }
+  if (EventPoll::EVENT_HUP & events) {
+    newEvents |= IoUringEventPoll::IEV_HUP;
+  }
+  return newEvents;
+}
+} // namespace
+
+bool IoUringEventPoll::addEvents(sock_t socket,
+                                 const IoUringEventPoll::KEvent& event)
+{
+  auto i = socketEntries_.lower_bound(socket);
+  if (i == std::end(socketEntries_) || (*i).first != socket) {
+    i = socketEntries_.insert(i, std::make_pair(socket, KSocketEntry(socket)));
+  }
+  auto& socketEntry = (*i).second;
+  event.addSelf(&socketEntry);
+  markUpdate(socketEntry);
+  return true;
+}
+
+bool IoUringEventPoll::addEvents(sock_t socket, Command* command,
+                                 EventPoll::EventType events)
+{
+  int pollEvents = translateEvents(events);
+  return addEvents(socket, KCommandEvent(command, pollEvents));
+}
+
+#ifdef ENABLE_ASYNC_DNS
+bool IoUringEventPoll::addEvents(sock_t socket, Command* command, int events,
+                                 const std::shared_ptr<AsyncNameResolver>& rs)
+{
+  return addEvents(socket, KADNSEvent(rs, command, socket, events));
+}
+#endif // ENABLE_ASYNC_DNS
+
+bool IoUringEventPoll::deleteEvents(sock_t socket,
+                                    const IoUringEventPoll::KEvent& event)
+{
+  auto i = socketEntries_.find(socket);
+  if (i == std::end(socketEntries_)) {
+    A2_LOG_DEBUG(fmt("Socket %d is not found in SocketEntries.", socket));
+    return false;
+  }
+
+  auto& socketEntry = (*i).second;
+  event.removeSelf(&socketEntry);
+  if (socketEntry.eventEmpty()) {
+    // The removal is queued here and submitted in the next poll().
+    // The poll request refers to the file, not to the descriptor, so
+    // even if the socket is closed and its descriptor is reused in
+    // the meantime, the request does not watch the new socket, and
+    // its completion is ignored because the entry is gone.
+    if (socketEntry.armedEvents) {
+      queuePollRemove(socketEntry);
+    }
+    socketEntries_.erase(i);
+  }
+  else {
+    markUpdate(socketEntry);
+  }
+  return true;
+}
+
+#ifdef ENABLE_ASYNC_DNS
+bool IoUringEventPoll::deleteEvents(
+    sock_t socket, Command* command,
+    const std::shared_ptr<AsyncNameResolver>& rs)
+{
+  return deleteEvents(socket, KADNSEvent(rs, command, socket, 0));
+}
+#endif // ENABLE_ASYNC_DNS
+
+bool IoUringEventPoll::deleteEvents(sock_t socket, Command* command,
+                                    EventPoll::EventType events)
+{
+  int pollEvents = translateEvents(events);
+  return deleteEvents(socket, KCommandEvent(command, pollEvents));
+}
+
+#ifdef ENABLE_ASYNC_DNS
+bool IoUringEventPoll::addNameResolver(
+    const std::shared_ptr<AsyncNameResolver>& resolver, Command* command)
+{
+  auto key = std::make_pair(resolver.get(), command);
+  auto itr = nameResolverEntries_.lower_bound(key);
+
+  if (itr != std::end(nameResolverEntries_) && (*itr).first == key) {
+    return false;
+  }
+
+  itr = nameResolverEntries_.insert(
+      itr, std::make_pair(key, KAsyncNameResolverEntry(resolver, command)));
+  (*itr).second.addSocketEvents(this);
+  return true;
+}
+
+bool IoUringEventPoll::deleteNameResolver(
+    const std::shared_ptr<AsyncNameResolver>& resolver, Command* command)
+{
+  auto key = std::make_pair(resolver.get(), command);
+  auto itr = nameResolverEntries_.find(key);
+  if (itr == std::end(nameResolverEntries_)) {
+    return false;
+  }
+
+  (*itr).second.removeSocketEvents(this);
+  nameResolverEntries_.erase(itr);
+  return true;
+}
+#endif // ENABLE_ASYNC_DNS
+
+} // namespace aria2
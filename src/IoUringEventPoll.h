@@ -0,0 +1,216 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_IO_URING_EVENT_POLL_H
+#define D_IO_URING_EVENT_POLL_H
+
+#include "EventPoll.h"
+
+#include <poll.h>
+#include <linux/io_uring.h>
+
+#include <map>
+#include <vector>
+
+#include "Event.h"
+#include "a2functional.h"
+#ifdef ENABLE_ASYNC_DNS
+#  include "AsyncNameResolver.h"
+#endif // ENABLE_ASYNC_DNS
+
+namespace aria2 {
+
+// EventPoll implementation using Linux io_uring.  Socket readiness is
+// watched by one-shot IORING_OP_POLL_ADD requests.  addEvents() and
+// deleteEvents() only record the change; the poll requests are
+// submitted, and the completions are reaped, by a single
+// io_uring_enter(2) call in poll().
+class IoUringEventPoll : public EventPoll {
+private:
+  class KSocketEntry;
+
+  typedef Event<KSocketEntry> KEvent;
+  typedef CommandEvent<KSocketEntry, IoUringEventPoll> KCommandEvent;
+  typedef ADNSEvent<KSocketEntry, IoUringEventPoll> KADNSEvent;
+  typedef AsyncNameResolverEntry<IoUringEventPoll> KAsyncNameResolverEntry;
+  friend class AsyncNameResolverEntry<IoUringEventPoll>;
+
+  class KSocketEntry : public SocketEntry<KCommandEvent, KADNSEvent> {
+  public:
+    KSocketEntry(sock_t socket);
+
+    KSocketEntry(const KSocketEntry&) = delete;
+    KSocketEntry(KSocketEntry&&) = default;
+
+    int getEvents();
+
+    // Identifies the poll request currently submitted for this
+    // socket.  Completions of older requests are ignored.
+    uint32_t generation;
+    // The events of the poll request in flight, or 0 if there is no
+    // request in flight.
+    int armedEvents;
+    // true if this entry is in IoUringEventPoll::updates_.
+    bool dirty;
+  };
+
+  friend int accumulateEvent(int events, const KEvent& event);
+
+private:
+  typedef std::map<sock_t, KSocketEntry> KSocketEntrySet;
+  KSocketEntrySet socketEntries_;
+#ifdef ENABLE_ASYNC_DNS
+  typedef std::map<std::pair<AsyncNameResolver*, Command*>,
+                   KAsyncNameResolverEntry>
+      KAsyncNameResolverEntrySet;
+  KAsyncNameResolverEntrySet nameResolverEntries_;
+#endif // ENABLE_ASYNC_DNS
+
+  // Sockets whose poll requests must be (re)submitted in the next
+  // poll().
+  std::vector<sock_t> updates_;
+
+  // user_data of the poll requests to be removed in the next poll().
+  // Until removed, a request holds a reference to the file of its
+  // socket, which is never released if the socket is idle.
+  std::vector<uint64_t> pendingRemoves_;
+
+  uint32_t generation_;
+
+  int ringfd_;
+
+  // Submission queue ring
+  void* sqRing_;
+  size_t sqRingSize_;
+  unsigned* sqHead_;
+  unsigned* sqTail_;
+  unsigned* sqArray_;
+  unsigned sqMask_;
+  unsigned sqEntries_;
+  // Tail of the submission queue including entries not yet made
+  // visible to the kernel.
+  unsigned sqLocalTail_;
+  struct io_uring_sqe* sqes_;
+  size_t sqesSize_;
+
+  // Completion queue ring.  It may share the mapping with sqRing_.
+  void* cqRing_;
+  size_t cqRingSize_;
+  unsigned* cqHead_;
+  unsigned* cqTail_;
+  unsigned cqMask_;
+  struct io_uring_cqe* cqes_;
+
+  static const unsigned RING_ENTRIES = 1024;
+
+  bool setupRing(unsigned ringEntries);
+
+  // Returns a cleared submission queue entry.  If the queue is full,
+  // the queued entries are submitted first.  If the kernel does not
+  // accept them even after the completions are reaped, returns
+  // nullptr.
+  struct io_uring_sqe* getSqe();
+
+  bool sqFull() const;
+
+  // Makes the queued submission queue entries visible to the kernel
+  // and calls io_uring_enter(2).  If |timeout| is not nullptr, waits
+  // for at least one completion up to |timeout|.  Returns the return
+  // value of io_uring_enter(2), or -errno.
+  int submit(const struct __kernel_timespec* timeout);
+
+  // Returns false if no submission queue entry is available.  In
+  // that case, the socket is left for the next poll().
+  bool queuePollAdd(KSocketEntry& socketEntry);
+
+  void queuePollRemove(KSocketEntry& socketEntry);
+
+  // Queues the removal of the poll request identified by |userData|.
+  // Returns false if no submission queue entry is available.  In that
+  // case, the removal is left in pendingRemoves_ for the next poll().
+  bool queuePollRemove(uint64_t userData);
+
+  void markUpdate(KSocketEntry& socketEntry);
+
+  // Submits poll requests for the sockets in updates_.
+  void flushUpdates();
+
+  // Processes all available completions.
+  void reapCompletions();
+
+  bool addEvents(sock_t socket, const KEvent& event);
+
+  bool deleteEvents(sock_t socket, const KEvent& event);
+
+  bool addEvents(sock_t socket, Command* command, int events,
+                 const std::shared_ptr<AsyncNameResolver>& rs);
+
+  bool deleteEvents(sock_t socket, Command* command,
+                    const std::shared_ptr<AsyncNameResolver>& rs);
+
+public:
+  // |ringEntries| is the number of submission queue entries, rounded
+  // up to a power of 2 by the kernel.
+  explicit IoUringEventPoll(unsigned ringEntries = RING_ENTRIES);
+
+  bool good() const;
+
+  virtual ~IoUringEventPoll();
+
+  virtual void poll(const struct timeval& tv) CXX11_OVERRIDE;
+
+  virtual bool addEvents(sock_t socket, Command* command,
+                         EventPoll::EventType events) CXX11_OVERRIDE;
+
+  virtual bool deleteEvents(sock_t socket, Command* command,
+                            EventPoll::EventType events) CXX11_OVERRIDE;
+#ifdef ENABLE_ASYNC_DNS
+
+  virtual bool
+  addNameResolver(const std::shared_ptr<AsyncNameResolver>& resolver,
+                  Command* command) CXX11_OVERRIDE;
+  virtual bool
+  deleteNameResolver(const std::shared_ptr<AsyncNameResolver>& resolver,
+                     Command* command) CXX11_OVERRIDE;
+#endif // ENABLE_ASYNC_DNS
+
+  static const int IEV_READ = POLLIN;
+  static const int IEV_WRITE = POLLOUT;
+  static const int IEV_ERROR = POLLERR;
+  static const int IEV_HUP = POLLHUP;
+};
+
+} // namespace aria2
+
+#endif // D_IO_URING_EVENT_POLL_H
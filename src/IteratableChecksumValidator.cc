@@ -34,7 +34,6 @@
 /* copyright --> */
 #include "IteratableChecksumValidator.h"
 
-#include <array>
 #include <cstdlib>
 
 #include "util.h"
@@ -53,7 +52,10 @@ namespace aria2 {
 IteratableChecksumValidator::IteratableChecksumValidator(
     const std::shared_ptr<DownloadContext>& dctx,
     const std::shared_ptr<PieceStorage>& pieceStorage)
-    : dctx_(dctx), pieceStorage_(pieceStorage), currentOffset_(0)
+    : dctx_(dctx),
+      pieceStorage_(pieceStorage),
+      currentOffset_(0),
+      readBufferSize_(1_m)
 {
 }
 
@@ -63,11 +65,14 @@ void IteratableChecksumValidator::validateChunk()
 {
   // Don't guard with !finished() to allow zero-length file to be
   // verified.
-  std::array<unsigned char, 4_k> buf;
   size_t length = pieceStorage_->getDiskAdaptor()->readDataDropCache(
-      buf.data(), buf.size(), currentOffset_);
-  ctx_->update(buf.data(), length);
+      buf_.data(), buf_.size(), currentOffset_);
   currentOffset_ += length;
+  if (!finished()) {
+    // Let OS read the next chunk while we are hashing this one.
+    pieceStorage_->getDiskAdaptor()->prefetch(buf_.size(), currentOffset_);
+  }
+  ctx_->update(buf_.data(), length);
   if (finished()) {
     std::string actualDigest = ctx_->digest();
     if (dctx_->getDigest() == actualDigest) {
@@ -104,6 +109,7 @@ void IteratableChecksumValidator::init()
 {
   currentOffset_ = 0;
   ctx_ = MessageDigest::create(dctx_->getHashType());
+  buf_.resize(readBufferSize_);
 }
 
 } // namespace aria2
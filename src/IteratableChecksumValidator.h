@@ -38,6 +38,7 @@
 #include "IteratableValidator.h"
 
 #include <memory>
+#include <vector>
 
 namespace aria2 {
 
@@ -55,6 +56,11 @@ private:
 
   std::unique_ptr<MessageDigest> ctx_;
 
+  std::vector<unsigned char> buf_;
+
+  // The number of bytes hashed in one validateChunk() call.
+  size_t readBufferSize_;
+
 public:
   IteratableChecksumValidator(
       const std::shared_ptr<DownloadContext>& dctx,
@@ -74,6 +80,9 @@ public:
   }
 
   virtual int64_t getTotalLength() const CXX11_OVERRIDE;
+
+  // Must be called before init().
+  void setReadBufferSize(size_t size) { readBufferSize_ = size; }
 };
 
 } // namespace aria2
@@ -34,7 +34,8 @@
 /* copyright --> */
 #include "IteratableChunkChecksumValidator.h"
 
-#include <array>
+#include <atomic>
+#include <vector>
 #include <cstring>
 #include <cstdlib>
 
@@ -51,9 +52,30 @@
 #include "MessageDigest.h"
 #include "fmt.h"
 #include "DlAbortEx.h"
+#include "WorkerThreadPool.h"
 
 namespace aria2 {
 
+struct IteratableChunkChecksumValidator::PieceDigestJob {
+  PieceDigestJob(size_t index) : index(index), done(false) {}
+
+  void computeDigest()
+  {
+    ctx->update(data.data(), data.size());
+    digest = ctx->digest();
+    // Release piece data as soon as possible.
+    std::vector<unsigned char>().swap(data);
+    done = true;
+  }
+
+  size_t index;
+  std::vector<unsigned char> data;
+  std::unique_ptr<MessageDigest> ctx;
+  // Empty if the piece could not be read.
+  std::string digest;
+  std::atomic<bool> done;
+};
+
 IteratableChunkChecksumValidator::IteratableChunkChecksumValidator(
     const std::shared_ptr<DownloadContext>& dctx,
     const std::shared_ptr<PieceStorage>& pieceStorage)
@@ -61,7 +83,10 @@ IteratableChunkChecksumValidator::IteratableChunkChecksumValidator(
       pieceStorage_(pieceStorage),
       bitfield_(make_unique<BitfieldMan>(dctx_->getPieceLength(),
                                          dctx_->getTotalLength())),
-      currentIndex_(0)
+      currentIndex_(0),
+      nextIndex_(0),
+      readBufferSize_(1_m),
+      workerPool_(nullptr)
 {
 }
 
@@ -69,22 +94,21 @@ IteratableChunkChecksumValidator::~IteratableChunkChecksumValidator() = default;
 
 void IteratableChunkChecksumValidator::validateChunk()
 {
-  if (!finished()) {
+  if (finished()) {
+    return;
+  }
+  if (workerPool_) {
+    if (nextIndex_ < dctx_->getNumPieces()) {
+      submitPiece();
+    }
+    collectPieces();
+  }
+  else {
+    prefetchPiece(currentIndex_ + 1);
     std::string actualChecksum;
     try {
-      actualChecksum = calculateActualChecksum();
-      if (actualChecksum == dctx_->getPieceHashes()[currentIndex_]) {
-        bitfield_->setBit(currentIndex_);
-      }
-      else {
-        A2_LOG_INFO(
-            fmt(EX_INVALID_CHUNK_CHECKSUM,
-                static_cast<unsigned long>(currentIndex_),
-                static_cast<int64_t>(getCurrentOffset()),
-                util::toHex(dctx_->getPieceHashes()[currentIndex_]).c_str(),
-                util::toHex(actualChecksum).c_str()));
-        bitfield_->unsetBit(currentIndex_);
-      }
+      actualChecksum = digest(getPieceOffset(currentIndex_),
+                              getPieceLength(currentIndex_));
     }
     catch (RecoverableException& ex) {
       A2_LOG_DEBUG_EX(fmt("Caught exception while validating piece index=%lu."
@@ -92,29 +116,96 @@ void IteratableChunkChecksumValidator::validateChunk()
                           " Continue operation.",
                           static_cast<unsigned long>(currentIndex_)),
                       ex);
-      bitfield_->unsetBit(currentIndex_);
     }
+    checkPiece(currentIndex_, actualChecksum);
+    nextIndex_ = ++currentIndex_;
+  }
+  if (finished()) {
+    pieceStorage_->setBitfield(bitfield_->getBitfield(),
+                               bitfield_->getBitfieldLength());
+  }
+}
+
+void IteratableChunkChecksumValidator::submitPiece()
+{
+  auto job = std::make_shared<PieceDigestJob>(nextIndex_++);
+  jobs_.push_back(job);
+  // Let OS read the next piece while we are reading this one and the
+  // worker threads are hashing.
+  prefetchPiece(nextIndex_);
+  try {
+    job->data.resize(getPieceLength(job->index));
+    readData(job->data.data(), getPieceOffset(job->index), job->data.size());
+  }
+  catch (RecoverableException& ex) {
+    A2_LOG_DEBUG_EX(fmt("Caught exception while validating piece index=%lu."
+                        " Some part of file may be missing."
+                        " Continue operation.",
+                        static_cast<unsigned long>(job->index)),
+                    ex);
+    std::vector<unsigned char>().swap(job->data);
+    job->done = true;
+    return;
+  }
+  job->ctx = MessageDigest::create(dctx_->getPieceHashType());
+  if (workerPool_->countPendingJob() < workerPool_->getNumThreads()) {
+    workerPool_->submit([job]() { job->computeDigest(); });
+  }
+  else {
+    job->computeDigest();
+  }
+}
+
+void IteratableChunkChecksumValidator::prefetchPiece(size_t index)
+{
+  if (index < dctx_->getNumPieces()) {
+    pieceStorage_->getDiskAdaptor()->prefetch(getPieceLength(index),
+                                              getPieceOffset(index));
+  }
+}
 
+void IteratableChunkChecksumValidator::collectPieces()
+{
+  while (!jobs_.empty() && jobs_.front()->done) {
+    const auto& job = jobs_.front();
+    checkPiece(job->index, job->digest);
+    jobs_.pop_front();
     ++currentIndex_;
-    if (finished()) {
-      pieceStorage_->setBitfield(bitfield_->getBitfield(),
-                                 bitfield_->getBitfieldLength());
-    }
   }
 }
 
-std::string IteratableChunkChecksumValidator::calculateActualChecksum()
+void IteratableChunkChecksumValidator::checkPiece(
+    size_t index, const std::string& actualChecksum)
+{
+  if (actualChecksum == dctx_->getPieceHashes()[index]) {
+    bitfield_->setBit(index);
+    return;
+  }
+  // Empty actualChecksum means that the piece could not be read,
+  // which has been logged already.
+  if (!actualChecksum.empty()) {
+    A2_LOG_INFO(fmt(EX_INVALID_CHUNK_CHECKSUM, static_cast<unsigned long>(index),
+                    static_cast<int64_t>(getPieceOffset(index)),
+                    util::toHex(dctx_->getPieceHashes()[index]).c_str(),
+                    util::toHex(actualChecksum).c_str()));
+  }
+  bitfield_->unsetBit(index);
+}
+
+int64_t IteratableChunkChecksumValidator::getPieceOffset(size_t index) const
+{
+  return static_cast<int64_t>(index) * dctx_->getPieceLength();
+}
+
+size_t IteratableChunkChecksumValidator::getPieceLength(size_t index) const
 {
-  int64_t offset = getCurrentOffset();
-  size_t length;
   // When validating last piece
-  if (currentIndex_ + 1 == dctx_->getNumPieces()) {
-    length = dctx_->getTotalLength() - offset;
+  if (index + 1 == dctx_->getNumPieces()) {
+    return dctx_->getTotalLength() - getPieceOffset(index);
   }
   else {
-    length = dctx_->getPieceLength();
+    return dctx_->getPieceLength();
   }
-  return digest(offset, length);
 }
 
 void IteratableChunkChecksumValidator::init()
@@ -122,28 +213,54 @@ void IteratableChunkChecksumValidator::init()
   ctx_ = MessageDigest::create(dctx_->getPieceHashType());
   bitfield_->clearAllBit();
   currentIndex_ = 0;
+  nextIndex_ = 0;
+  jobs_.clear();
+}
+
+void IteratableChunkChecksumValidator::setWorkerThreadPool(
+    WorkerThreadPool* pool)
+{
+  workerPool_ = pool;
 }
 
 std::string IteratableChunkChecksumValidator::digest(int64_t offset,
                                                      size_t length)
 {
-  std::array<unsigned char, 4_k> buf;
+  if (buf_.empty()) {
+    buf_.resize(std::min(static_cast<size_t>(dctx_->getPieceLength()),
+                         readBufferSize_));
+  }
   ctx_->reset();
   int64_t max = offset + length;
   while (offset < max) {
     size_t r = pieceStorage_->getDiskAdaptor()->readDataDropCache(
-        buf.data(), std::min(static_cast<int64_t>(buf.size()), max - offset),
+        buf_.data(), std::min(static_cast<int64_t>(buf_.size()), max - offset),
         offset);
     if (r == 0) {
       throw DL_ABORT_EX(
           fmt(EX_FILE_READ, dctx_->getBasePath().c_str(), "data is too short"));
     }
-    ctx_->update(buf.data(), r);
+    ctx_->update(buf_.data(), r);
     offset += r;
   }
   return ctx_->digest();
 }
 
+void IteratableChunkChecksumValidator::readData(unsigned char* data,
+                                                int64_t offset, size_t length)
+{
+  size_t nread = 0;
+  while (nread < length) {
+    size_t r = pieceStorage_->getDiskAdaptor()->readDataDropCache(
+        data + nread, length - nread, offset + nread);
+    if (r == 0) {
+      throw DL_ABORT_EX(
+          fmt(EX_FILE_READ, dctx_->getBasePath().c_str(), "data is too short"));
+    }
+    nread += r;
+  }
+}
+
 bool IteratableChunkChecksumValidator::finished() const
 {
   if (currentIndex_ >= dctx_->getNumPieces()) {
@@ -156,7 +273,7 @@ bool IteratableChunkChecksumValidator::finished() const
 
 int64_t IteratableChunkChecksumValidator::getCurrentOffset() const
 {
-  return static_cast<int64_t>(currentIndex_) * dctx_->getPieceLength();
+  return getPieceOffset(currentIndex_);
 }
 
 int64_t IteratableChunkChecksumValidator::getTotalLength() const
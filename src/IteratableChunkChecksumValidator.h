@@ -39,6 +39,8 @@
 
 #include <string>
 #include <memory>
+#include <deque>
+#include <vector>
 
 namespace aria2 {
 
@@ -49,16 +51,49 @@ class MessageDigest;
 
 class IteratableChunkChecksumValidator : public IteratableValidator {
 private:
+  struct PieceDigestJob;
+
   std::shared_ptr<DownloadContext> dctx_;
   std::shared_ptr<PieceStorage> pieceStorage_;
   std::unique_ptr<BitfieldMan> bitfield_;
+  // All pieces whose index is less than currentIndex_ have been
+  // verified.
   size_t currentIndex_;
+  // The index of the next piece to read.  This may be larger than
+  // currentIndex_ while pieces are hashed in worker threads.
+  size_t nextIndex_;
   std::unique_ptr<MessageDigest> ctx_;
+  // Buffer to read piece data when hashing in this thread.
+  std::vector<unsigned char> buf_;
+  // The size of buf_.  Large buffer reduces the number of read(2) and
+  // posix_fadvise(2) calls per piece.
+  size_t readBufferSize_;
+  WorkerThreadPool* workerPool_;
+  // Pieces read but not verified yet, in index order.
+  std::deque<std::shared_ptr<PieceDigestJob>> jobs_;
+
+  int64_t getPieceOffset(size_t index) const;
+
+  size_t getPieceLength(size_t index) const;
 
-  std::string calculateActualChecksum();
+  void checkPiece(size_t index, const std::string& actualChecksum);
 
   std::string digest(int64_t offset, size_t length);
 
+  void readData(unsigned char* data, int64_t offset, size_t length);
+
+  // Asks OS to read ahead the piece at |index| if it exists.
+  void prefetchPiece(size_t index);
+
+  // Reads the piece at nextIndex_ and queues its hash computation to
+  // workerPool_.  If the worker threads are all busy, computes the
+  // hash in the calling thread instead.
+  void submitPiece();
+
+  // Verifies the pieces at the front of jobs_ whose hashes have been
+  // computed.
+  void collectPieces();
+
 public:
   IteratableChunkChecksumValidator(
       const std::shared_ptr<DownloadContext>& dctx,
@@ -75,6 +110,10 @@ public:
   virtual int64_t getCurrentOffset() const CXX11_OVERRIDE;
 
   virtual int64_t getTotalLength() const CXX11_OVERRIDE;
+
+  virtual void setWorkerThreadPool(WorkerThreadPool* pool) CXX11_OVERRIDE;
+
+  void setReadBufferSize(size_t size) { readBufferSize_ = size; }
 };
 
 } // namespace aria2
@@ -41,6 +41,8 @@
 
 namespace aria2 {
 
+class WorkerThreadPool;
+
 /**
  * This class provides the interface to validate files.
  *
@@ -62,6 +64,11 @@ public:
   virtual int64_t getCurrentOffset() const = 0;
 
   virtual int64_t getTotalLength() const = 0;
+
+  // Sets the worker threads which the validator may use to compute
+  // hashes.  nullptr means that everything is done in the calling
+  // thread.  The default implementation ignores |pool|.
+  virtual void setWorkerThreadPool(WorkerThreadPool* pool) {}
 };
 
 } // namespace aria2
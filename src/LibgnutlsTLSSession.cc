@@ -178,6 +178,41 @@ int GnuTLSSession::setSNIHostname(const std::string& hostname)
   return TLS_ERR_OK;
 }
 
+int GnuTLSSession::setAlpnProtocols(const std::vector<std::string>& protocols)
+{
+#if GNUTLS_VERSION_NUMBER >= 0x030200
+  std::vector<gnutls_datum_t> protos;
+  for (const auto& proto : protocols) {
+    gnutls_datum_t d;
+    d.data =
+        reinterpret_cast<unsigned char*>(const_cast<char*>(proto.c_str()));
+    d.size = proto.size();
+    protos.push_back(d);
+  }
+  // gnutls_alpn_set_protocols copies the protocol names.
+  rv_ = gnutls_alpn_set_protocols(sslSession_, protos.data(), protos.size(),
+                                  0);
+  if (rv_ != GNUTLS_E_SUCCESS) {
+    return TLS_ERR_ERROR;
+  }
+  return TLS_ERR_OK;
+#else  // !(GNUTLS_VERSION_NUMBER >= 0x030200)
+  return TLS_ERR_ERROR;
+#endif // !(GNUTLS_VERSION_NUMBER >= 0x030200)
+}
+
+std::string GnuTLSSession::getAlpnSelectedProtocol()
+{
+#if GNUTLS_VERSION_NUMBER >= 0x030200
+  gnutls_datum_t proto;
+  if (gnutls_alpn_get_selected_protocol(sslSession_, &proto) ==
+      GNUTLS_E_SUCCESS) {
+    return std::string(reinterpret_cast<const char*>(proto.data), proto.size);
+  }
+#endif // GNUTLS_VERSION_NUMBER >= 0x030200
+  return std::string();
+}
+
 int GnuTLSSession::closeConnection()
 {
   rv_ = gnutls_bye(sslSession_, GNUTLS_SHUT_WR);
@@ -51,6 +51,9 @@ public:
   ~GnuTLSSession();
   virtual int init(sock_t sockfd) CXX11_OVERRIDE;
   virtual int setSNIHostname(const std::string& hostname) CXX11_OVERRIDE;
+  virtual int
+  setAlpnProtocols(const std::vector<std::string>& protocols) CXX11_OVERRIDE;
+  virtual std::string getAlpnSelectedProtocol() CXX11_OVERRIDE;
   virtual int closeConnection() CXX11_OVERRIDE;
   virtual int checkDirection() CXX11_OVERRIDE;
   virtual ssize_t writeData(const void* data, size_t len) CXX11_OVERRIDE;
@@ -96,6 +96,45 @@ int OpenSSLTLSSession::setSNIHostname(const std::string& hostname)
   return TLS_ERR_OK;
 }
 
+int OpenSSLTLSSession::setAlpnProtocols(
+    const std::vector<std::string>& protocols)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10002000L
+  std::string wire;
+  for (const auto& proto : protocols) {
+    if (proto.empty() || proto.size() > 255) {
+      return TLS_ERR_ERROR;
+    }
+    wire += static_cast<char>(proto.size());
+    wire += proto;
+  }
+  ERR_clear_error();
+  // Unlike most of OpenSSL functions, SSL_set_alpn_protos returns 0
+  // on success.
+  if (SSL_set_alpn_protos(ssl_,
+                          reinterpret_cast<const unsigned char*>(wire.c_str()),
+                          wire.size()) != 0) {
+    return TLS_ERR_ERROR;
+  }
+  return TLS_ERR_OK;
+#else  // !(OPENSSL_VERSION_NUMBER >= 0x10002000L)
+  return TLS_ERR_ERROR;
+#endif // !(OPENSSL_VERSION_NUMBER >= 0x10002000L)
+}
+
+std::string OpenSSLTLSSession::getAlpnSelectedProtocol()
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10002000L
+  const unsigned char* data = nullptr;
+  unsigned int len = 0;
+  SSL_get0_alpn_selected(ssl_, &data, &len);
+  if (data && len > 0) {
+    return std::string(reinterpret_cast<const char*>(data), len);
+  }
+#endif // OPENSSL_VERSION_NUMBER >= 0x10002000L
+  return std::string();
+}
+
 int OpenSSLTLSSession::closeConnection()
 {
   ERR_clear_error();
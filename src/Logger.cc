@@ -192,6 +192,9 @@ void writeStackTrace(Output& fp, const char* stackTrace)
 void Logger::writeLog(Logger::LEVEL level, const char* sourceFile, int lineNum,
                       const char* msg, const char* trace)
 {
+#ifdef HAVE_STD_THREAD
+  std::lock_guard<std::mutex> lock(mutex_);
+#endif // HAVE_STD_THREAD
   if (fileLogEnabled(level)) {
     writeHeader(*fpp_, level, sourceFile, lineNum);
     fpp_->printf("%s\n", msg);
@@ -0,0 +1,117 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_MPSC_QUEUE_H
+#define D_MPSC_QUEUE_H
+
+#include "common.h"
+
+#include <atomic>
+
+namespace aria2 {
+
+// Unbounded lock-free queue which any number of threads can push
+// values into, and one thread takes them out.  The values are taken
+// out all at once, in the order they were pushed.
+template <typename T> class MpscQueue {
+public:
+  MpscQueue() : head_{nullptr} {}
+
+  ~MpscQueue() { free(head_.load(std::memory_order_acquire)); }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  // Pushes |value|.  Returns true if the queue was empty.  This
+  // function is thread-safe.
+  bool push(T value)
+  {
+    auto node = new Node{std::move(value),
+                         head_.load(std::memory_order_relaxed)};
+    while (!head_.compare_exchange_weak(node->next, node,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed))
+      ;
+    return node->next == nullptr;
+  }
+
+  // Moves all values out of the queue to |out| in the order they were
+  // pushed.  Only one thread may call this function at a time.
+  template <typename OutputIterator> void popAll(OutputIterator out)
+  {
+    // Nodes are linked from the newest one.  Reverse the list.
+    Node* first = nullptr;
+    auto node = head_.exchange(nullptr, std::memory_order_acquire);
+    while (node) {
+      auto next = node->next;
+      node->next = first;
+      first = node;
+      node = next;
+    }
+    for (node = first; node;) {
+      *out++ = std::move(node->value);
+      auto next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  // Returns true if the queue is empty.  The result is only a hint if
+  // other threads are pushing values.
+  bool empty() const
+  {
+    return head_.load(std::memory_order_relaxed) == nullptr;
+  }
+
+private:
+  struct Node {
+    T value;
+    Node* next;
+  };
+
+  static void free(Node* node)
+  {
+    while (node) {
+      auto next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  std::atomic<Node*> head_;
+};
+
+} // namespace aria2
+
+#endif // D_MPSC_QUEUE_H
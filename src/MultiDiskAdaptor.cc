@@ -50,8 +50,8 @@
 #include "Logger.h"
 #include "LogFactory.h"
 #include "SimpleRandomizer.h"
-#include "WrDiskCacheEntry.h"
 #include "OpenedFileCounter.h"
+#include "DiskWriteQueue.h"
 
 namespace aria2 {
 
@@ -410,12 +410,116 @@ ssize_t MultiDiskAdaptor::readData(unsigned char* data, size_t len,
   return totalReadLength;
 }
 
-void MultiDiskAdaptor::writeCache(const WrDiskCacheEntry* entry)
+void MultiDiskAdaptor::prefetch(int64_t len, int64_t offset)
 {
-  for (auto& d : entry->getDataSet()) {
-    A2_LOG_DEBUG(fmt("Cache flush goff=%" PRId64 ", len=%lu", d->goff,
-                     static_cast<unsigned long>(d->len)));
-    writeData(d->data + d->offset, d->len, d->goff);
+  if (len <= 0 || diskWriterEntries_.empty() ||
+      offset >= diskWriterEntries_.back()->getFileEntry()->getLastOffset()) {
+    return;
+  }
+  auto first = findFirstDiskWriterEntry(diskWriterEntries_, offset);
+  int64_t fileOffset = offset - (*first)->getFileEntry()->getOffset();
+  for (auto i = first, eoi = diskWriterEntries_.cend(); i != eoi && len > 0;
+       ++i) {
+    int64_t fileLength =
+        std::min(len, (*i)->getFileEntry()->getLength() - fileOffset);
+    // Files are opened lazily by readData().  Don't open files just
+    // for a hint.
+    if ((*i)->isOpen()) {
+      (*i)->getDiskWriter()->prefetch(fileLength, fileOffset);
+    }
+    len -= fileLength;
+    fileOffset = 0;
+  }
+}
+
+std::shared_ptr<SharedFileDescriptor>
+MultiDiskAdaptor::shareFileDescriptor(int64_t offset, int64_t len,
+                                      int64_t& fileOffset)
+{
+  if (len <= 0 || diskWriterEntries_.empty() ||
+      offset >= diskWriterEntries_.back()->getFileEntry()->getLastOffset()) {
+    return nullptr;
+  }
+  auto& entry = *findFirstDiskWriterEntry(diskWriterEntries_, offset);
+  fileOffset = offset - entry->getFileEntry()->getOffset();
+  if (fileOffset + len > entry->getFileEntry()->getLength()) {
+    return nullptr;
+  }
+  openIfNot(entry.get(), &DiskWriterEntry::openFile);
+  if (!entry->isOpen()) {
+    return nullptr;
+  }
+  return entry->getDiskWriter()->shareFileDescriptor(getOpenedFileCounter());
+}
+
+void MultiDiskAdaptor::writeDataV(a2iovec* iov, size_t iovcnt, int64_t offset)
+{
+  writeDataVInternal(iov, iovcnt, offset, nullptr);
+}
+
+void MultiDiskAdaptor::writeDataVAsync(a2iovec* iov, size_t iovcnt,
+                                       int64_t offset, DiskWriteBatch* batch)
+{
+  writeDataVInternal(iov, iovcnt, offset, batch);
+}
+
+void MultiDiskAdaptor::writeDataVInternal(a2iovec* iov, size_t iovcnt,
+                                          int64_t offset, DiskWriteBatch* batch)
+{
+  int64_t len = 0;
+  for (size_t i = 0; i < iovcnt; ++i) {
+    len += iov[i].A2IOVEC_LEN;
+  }
+  if (len == 0) {
+    return;
+  }
+  auto first = findFirstDiskWriterEntry(diskWriterEntries_, offset);
+  ssize_t rem = len;
+  int64_t fileOffset = offset - (*first)->getFileEntry()->getOffset();
+  // Buffers are split at file boundaries; fiov holds the part of iov
+  // which goes to the current file.
+  std::vector<a2iovec> fiov;
+  fiov.reserve(iovcnt);
+  for (auto i = first, eoi = diskWriterEntries_.cend(); i != eoi; ++i) {
+    ssize_t writeLength = calculateLength((*i).get(), fileOffset, rem);
+    openIfNot((*i).get(), &DiskWriterEntry::openFile);
+    if (!(*i)->isOpen()) {
+      throwOnDiskWriterNotOpened((*i).get(), offset + (len - rem));
+    }
+
+    fiov.clear();
+    for (ssize_t flen = writeLength; flen > 0;) {
+      if (iov->A2IOVEC_LEN == 0) {
+        ++iov;
+        continue;
+      }
+      size_t n = std::min(static_cast<size_t>(flen),
+                          static_cast<size_t>(iov->A2IOVEC_LEN));
+      fiov.push_back(*iov);
+      fiov.back().A2IOVEC_LEN = n;
+      flen -= n;
+      if (n == iov->A2IOVEC_LEN) {
+        ++iov;
+      }
+      else {
+        iov->A2IOVEC_BASE = reinterpret_cast<char*>(iov->A2IOVEC_BASE) + n;
+        iov->A2IOVEC_LEN -= n;
+      }
+    }
+    if (!fiov.empty()) {
+      auto& dw = (*i)->getDiskWriter();
+      if (batch) {
+        batch->push(dw.get(), fiov.data(), fiov.size(), fileOffset);
+      }
+      else {
+        dw->writeDataV(fiov.data(), fiov.size(), fileOffset);
+      }
+    }
+    rem -= writeLength;
+    fileOffset = 0;
+    if (rem == 0) {
+      break;
+    }
   }
 }
 
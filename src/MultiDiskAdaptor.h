@@ -107,6 +107,11 @@ private:
 
   void openIfNot(DiskWriterEntry* entry, void (DiskWriterEntry::*f)());
 
+  // Writes iov using DiskWriteBatch::push() if |batch| is not
+  // nullptr, or DiskWriter::writeDataV() otherwise.
+  void writeDataVInternal(a2iovec* iov, size_t iovcnt, int64_t offset,
+                          DiskWriteBatch* batch);
+
   ssize_t readData(unsigned char* data, size_t len, int64_t offset,
                    bool dropCache);
 
@@ -133,7 +138,17 @@ public:
   virtual ssize_t readDataDropCache(unsigned char* data, size_t len,
                                     int64_t offset) CXX11_OVERRIDE;
 
-  virtual void writeCache(const WrDiskCacheEntry* entry) CXX11_OVERRIDE;
+  virtual void prefetch(int64_t len, int64_t offset) CXX11_OVERRIDE;
+
+  virtual std::shared_ptr<SharedFileDescriptor>
+  shareFileDescriptor(int64_t offset, int64_t len,
+                      int64_t& fileOffset) CXX11_OVERRIDE;
+
+  virtual void writeDataV(a2iovec* iov, size_t iovcnt,
+                          int64_t offset) CXX11_OVERRIDE;
+
+  virtual void writeDataVAsync(a2iovec* iov, size_t iovcnt, int64_t offset,
+                               DiskWriteBatch* batch) CXX11_OVERRIDE;
 
   virtual void flushOSBuffers() CXX11_OVERRIDE;
 
@@ -36,6 +36,7 @@
 #include "MultiDiskAdaptor.h"
 #include "FileEntry.h"
 #include "AdaptiveFileAllocationIterator.h"
+#include "AsyncFileAllocationIterator.h"
 #include "TruncFileAllocationIterator.h"
 #ifdef HAVE_SOME_FALLOCATE
 #  include "FallocFileAllocationIterator.h"
@@ -43,113 +44,149 @@
 #include "DiskWriter.h"
 #include "DefaultDiskWriterFactory.h"
 #include "LogFactory.h"
+#include "WorkerThreadPool.h"
 
 namespace aria2 {
 
 MultiFileAllocationIterator::MultiFileAllocationIterator(
     MultiDiskAdaptor* diskAdaptor)
     : diskAdaptor_{diskAdaptor},
-      entryItr_{std::begin(diskAdaptor_->getDiskWriterEntries())}
+      entryItr_{std::begin(diskAdaptor_->getDiskWriterEntries())},
+      workerPool_{nullptr},
+      wakeupFd_{nullptr}
 {
 }
 
 MultiFileAllocationIterator::~MultiFileAllocationIterator()
 {
-  if (diskWriter_) {
-    diskWriter_->closeFile();
+  for (auto& file : activeFiles_) {
+    closeFile(file);
+  }
+}
+
+void MultiFileAllocationIterator::closeFile(ActiveFile& file)
+{
+  // Stop allocation before the file is closed under it.
+  file.fileAllocationIterator.reset();
+  if (file.diskWriter) {
+    file.diskWriter->closeFile();
+    file.diskWriter.reset();
   }
 }
 
 void MultiFileAllocationIterator::allocateChunk()
 {
-  if (fileAllocationIterator_) {
-    if (!fileAllocationIterator_->finished()) {
-      fileAllocationIterator_->allocateChunk();
-      return;
+  for (auto i = std::begin(activeFiles_); i != std::end(activeFiles_);) {
+    if ((*i).fileAllocationIterator->finished()) {
+      closeFile(*i);
+      i = activeFiles_.erase(i);
     }
-
-    if (diskWriter_) {
-      diskWriter_->closeFile();
-      diskWriter_.reset();
+    else {
+      ++i;
     }
-    fileAllocationIterator_.reset();
-    ++entryItr_;
   }
 
+  const size_t maxActiveFiles = workerPool_ ? workerPool_->getNumThreads() : 1;
+  while (activeFiles_.size() < maxActiveFiles && openNextFile())
+    ;
+
+  for (auto& file : activeFiles_) {
+    file.fileAllocationIterator->allocateChunk();
+  }
+}
+
+bool MultiFileAllocationIterator::openNextFile()
+{
   while (entryItr_ != std::end(diskAdaptor_->getDiskWriterEntries())) {
-    if (!(*entryItr_)->getDiskWriter()) {
-      ++entryItr_;
+    auto& entry = *entryItr_++;
+    if (!entry->getDiskWriter()) {
       continue;
     }
 
-    auto& fileEntry = (*entryItr_)->getFileEntry();
+    auto& fileEntry = entry->getFileEntry();
     // we use dedicated DiskWriter instead of
-    // (*entryItr_)->getDiskWriter().  This is because
+    // entry->getDiskWriter().  This is because
     // SingleFileAllocationIterator cannot reopen file if file is
     // closed by OpenedFileCounter.
-    diskWriter_ =
-        DefaultDiskWriterFactory().newDiskWriter((*entryItr_)->getFilePath());
+    std::shared_ptr<DiskWriter> diskWriter =
+        DefaultDiskWriterFactory().newDiskWriter(entry->getFilePath());
     // Open file before calling DiskWriterEntry::size().  Calling
     // private function of MultiDiskAdaptor.
-    diskWriter_->openFile(fileEntry->getLength());
+    diskWriter->openFile(fileEntry->getLength());
 
-    if ((*entryItr_)->needsFileAllocation() &&
-        (*entryItr_)->size() < fileEntry->getLength()) {
+    if (entry->needsFileAllocation() &&
+        entry->size() < fileEntry->getLength()) {
       A2_LOG_INFO(fmt("Allocating file %s: target size=%" PRId64
                       ", current size=%" PRId64,
-                      (*entryItr_)->getFilePath().c_str(),
-                      fileEntry->getLength(), (*entryItr_)->size()));
+                      entry->getFilePath().c_str(), fileEntry->getLength(),
+                      entry->size()));
+      std::unique_ptr<FileAllocationIterator> itr;
       switch (diskAdaptor_->getFileAllocationMethod()) {
 #ifdef HAVE_SOME_FALLOCATE
       case (DiskAdaptor::FILE_ALLOC_FALLOC):
-        fileAllocationIterator_ = make_unique<FallocFileAllocationIterator>(
-            diskWriter_.get(), (*entryItr_)->size(), fileEntry->getLength());
+        itr = make_unique<FallocFileAllocationIterator>(
+            diskWriter.get(), entry->size(), fileEntry->getLength());
         break;
 #endif // HAVE_SOME_FALLOCATE
       case (DiskAdaptor::FILE_ALLOC_TRUNC):
-        fileAllocationIterator_ = make_unique<TruncFileAllocationIterator>(
-            diskWriter_.get(), (*entryItr_)->size(), fileEntry->getLength());
+        itr = make_unique<TruncFileAllocationIterator>(
+            diskWriter.get(), entry->size(), fileEntry->getLength());
         break;
       default:
-        fileAllocationIterator_ = make_unique<AdaptiveFileAllocationIterator>(
-            diskWriter_.get(), (*entryItr_)->size(), fileEntry->getLength());
+        itr = make_unique<AdaptiveFileAllocationIterator>(
+            diskWriter.get(), entry->size(), fileEntry->getLength());
         break;
       }
-      fileAllocationIterator_->allocateChunk();
-      return;
+      if (workerPool_) {
+        itr = make_unique<AsyncFileAllocationIterator>(
+            std::move(itr), workerPool_, wakeupFd_);
+      }
+      activeFiles_.push_back(ActiveFile{std::move(diskWriter), std::move(itr)});
+      return true;
     }
 
-    diskWriter_->closeFile();
-    diskWriter_.reset();
-
-    ++entryItr_;
+    diskWriter->closeFile();
   }
+  return false;
 }
 
 bool MultiFileAllocationIterator::finished()
 {
-  return entryItr_ == std::end(diskAdaptor_->getDiskWriterEntries()) &&
-         (!fileAllocationIterator_ || fileAllocationIterator_->finished());
+  if (entryItr_ != std::end(diskAdaptor_->getDiskWriterEntries())) {
+    return false;
+  }
+  for (auto& file : activeFiles_) {
+    if (!file.fileAllocationIterator->finished()) {
+      return false;
+    }
+  }
+  return true;
 }
 
 int64_t MultiFileAllocationIterator::getCurrentLength()
 {
-  if (!fileAllocationIterator_) {
-    return 0;
-  }
-  else {
-    return fileAllocationIterator_->getCurrentLength();
+  int64_t len = 0;
+  for (auto& file : activeFiles_) {
+    len += file.fileAllocationIterator->getCurrentLength();
   }
+  return len;
 }
 
 int64_t MultiFileAllocationIterator::getTotalLength()
 {
-  if (!fileAllocationIterator_) {
-    return 0;
-  }
-  else {
-    return fileAllocationIterator_->getTotalLength();
+  int64_t len = 0;
+  for (auto& file : activeFiles_) {
+    len += file.fileAllocationIterator->getTotalLength();
   }
+  return len;
+}
+
+bool MultiFileAllocationIterator::setWorkerThreadPool(WorkerThreadPool* pool,
+                                                      WakeupFd* wakeupFd)
+{
+  workerPool_ = pool;
+  wakeupFd_ = wakeupFd;
+  return true;
 }
 
 const DiskWriterEntries&
@@ -39,19 +39,34 @@
 
 #include <deque>
 #include <memory>
+#include <vector>
 
 #include "MultiDiskAdaptor.h"
 
 namespace aria2 {
 
 class DiskWriterEntry;
+class WorkerThreadPool;
 
 class MultiFileAllocationIterator : public FileAllocationIterator {
 private:
+  // A file being allocated.
+  struct ActiveFile {
+    std::shared_ptr<DiskWriter> diskWriter;
+    std::unique_ptr<FileAllocationIterator> fileAllocationIterator;
+  };
+
   MultiDiskAdaptor* diskAdaptor_;
   DiskWriterEntries::const_iterator entryItr_;
-  std::shared_ptr<DiskWriter> diskWriter_;
-  std::unique_ptr<FileAllocationIterator> fileAllocationIterator_;
+  std::vector<ActiveFile> activeFiles_;
+  WorkerThreadPool* workerPool_;
+  WakeupFd* wakeupFd_;
+
+  // Opens the files from entryItr_ until one needs allocation, and
+  // adds it to activeFiles_.  Returns false if there is no such file.
+  bool openNextFile();
+
+  void closeFile(ActiveFile& file);
 
 public:
   MultiFileAllocationIterator(MultiDiskAdaptor* diskAdaptor);
@@ -66,6 +81,11 @@ public:
 
   virtual int64_t getTotalLength() CXX11_OVERRIDE;
 
+  // Allocates up to as many files as the threads of |pool| at the
+  // same time, each of them in the worker threads.
+  virtual bool setWorkerThreadPool(WorkerThreadPool* pool,
+                                   WakeupFd* wakeupFd) CXX11_OVERRIDE;
+
   const DiskWriterEntries& getDiskWriterEntries() const;
 };
 
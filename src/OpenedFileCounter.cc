@@ -94,8 +94,23 @@ void OpenedFileCounter::ensureMaxOpenFileLimit(size_t numNewFiles)
     closeFun(*i);
   }
 
-  assert(left == 0);
-  numOpenFiles_ += numNewFiles - numClose;
+  // The descriptors shared by uploads (see SharedFileDescriptor)
+  // cannot be closed here.  They are released as soon as the
+  // uploads are sent, so we exceed the limit only for a while.
+  numOpenFiles_ += numNewFiles - (numClose - left);
+}
+
+bool OpenedFileCounter::tryIncrease(size_t numNewFiles)
+{
+  if (!rgman_) {
+    return true;
+  }
+
+  if (numOpenFiles_ + numNewFiles > maxOpenFiles_) {
+    return false;
+  }
+  numOpenFiles_ += numNewFiles;
+  return true;
 }
 
 void OpenedFileCounter::reduceNumOfOpenedFile(size_t numCloseFiles)
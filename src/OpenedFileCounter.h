@@ -54,6 +54,11 @@ public:
   // the global limit.
   void ensureMaxOpenFileLimit(size_t numNewFiles);
 
+  // Same as ensureMaxOpenFileLimit(), but never closes other files.
+  // Returns false, without counting the files, if they would exceed
+  // the limit.
+  bool tryIncrease(size_t numNewFiles);
+
   // Reduces the number of open files managed by this object.
   void reduceNumOfOpenedFile(size_t numCloseFiles);
 
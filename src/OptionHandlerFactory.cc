@@ -137,6 +137,25 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->setChangeOptionForReserved(true);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new NumberOptionHandler(PREF_CHECK_INTEGRITY_THREADS,
+                                              TEXT_CHECK_INTEGRITY_THREADS,
+                                              "0", 0, 256));
+    op->addTag(TAG_ADVANCED);
+    op->addTag(TAG_CHECKSUM);
+    handlers.push_back(op);
+  }
+  {
+    OptionHandler* op(new UnitNumberOptionHandler(
+        PREF_CHECK_INTEGRITY_READ_SIZE, TEXT_CHECK_INTEGRITY_READ_SIZE, "1M",
+        1_m, 8_m));
+    op->addTag(TAG_ADVANCED);
+    op->addTag(TAG_CHECKSUM);
+    op->setInitialOption(true);
+    op->setChangeGlobalOption(true);
+    op->setChangeOptionForReserved(true);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new BooleanOptionHandler(PREF_CONDITIONAL_GET,
                                                TEXT_CONDITIONAL_GET, A2_V_FALSE,
@@ -183,6 +202,12 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->addTag(TAG_ADVANCED);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new NumberOptionHandler(
+        PREF_DISK_IO_THREADS, TEXT_DISK_IO_THREADS, "0", 0, 64));
+    op->addTag(TAG_ADVANCED);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new ParameterOptionHandler(
         PREF_CONSOLE_LOG_LEVEL, TEXT_CONSOLE_LOG_LEVEL, V_NOTICE,
@@ -300,6 +325,9 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
 #ifdef HAVE_EPOLL
                                                      V_EPOLL,
 #endif // HAVE_EPOLL
+#ifdef HAVE_IO_URING
+                                                     V_IO_URING,
+#endif // HAVE_IO_URING
 #ifdef HAVE_KQUEUE
                                                      V_KQUEUE,
 #endif // HAVE_KQUEUE
@@ -332,6 +360,14 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->setChangeOptionForReserved(true);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new NumberOptionHandler(PREF_FILE_ALLOCATION_THREADS,
+                                              TEXT_FILE_ALLOCATION_THREADS,
+                                              "0", 0, 64));
+    op->addTag(TAG_ADVANCED);
+    op->addTag(TAG_FILE);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new BooleanOptionHandler(
         PREF_FORCE_SAVE, TEXT_FORCE_SAVE, A2_V_FALSE, OptionHandler::OPT_ARG));
@@ -704,6 +740,13 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->addTag(TAG_ADVANCED);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new UnitNumberOptionHandler(PREF_MAX_RECV_BUFFER_SIZE,
+                                                  TEXT_MAX_RECV_BUFFER_SIZE,
+                                                  "256K", 16_k, 16_m));
+    op->addTag(TAG_ADVANCED);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new BooleanOptionHandler(
         PREF_STDERR, TEXT_STDERR, A2_V_FALSE, OptionHandler::OPT_ARG));
@@ -1084,6 +1127,16 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->setChangeOptionForReserved(true);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new BooleanOptionHandler(PREF_ENABLE_HTTP2,
+                                               TEXT_ENABLE_HTTP2, A2_V_FALSE,
+                                               OptionHandler::OPT_ARG));
+    op->addTag(TAG_HTTP);
+    op->setInitialOption(true);
+    op->setChangeGlobalOption(true);
+    op->setChangeOptionForReserved(true);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new CumulativeOptionHandler(PREF_HEADER, TEXT_HEADER,
                                                   NO_DEFAULT_VALUE, "\n"));
@@ -1124,6 +1177,27 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->setChangeOptionForReserved(true);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new BooleanOptionHandler(
+        PREF_HTTP2_PRIOR_KNOWLEDGE, TEXT_HTTP2_PRIOR_KNOWLEDGE, A2_V_FALSE,
+        OptionHandler::OPT_ARG));
+    op->addTag(TAG_HTTP);
+    op->setInitialOption(true);
+    op->setChangeGlobalOption(true);
+    op->setChangeOptionForReserved(true);
+    handlers.push_back(op);
+  }
+  {
+    OptionHandler* op(
+        new UnitNumberOptionHandler(PREF_HTTP2_WINDOW_SIZE,
+                                    TEXT_HTTP2_WINDOW_SIZE, "1M", 64_k,
+                                    std::numeric_limits<int32_t>::max()));
+    op->addTag(TAG_HTTP);
+    op->setInitialOption(true);
+    op->setChangeGlobalOption(true);
+    op->setChangeOptionForReserved(true);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(
         new DefaultOptionHandler(PREF_HTTP_PASSWD, TEXT_HTTP_PASSWD));
@@ -1155,9 +1229,12 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     handlers.push_back(op);
   }
   {
-    OptionHandler* op(new NumberOptionHandler(PREF_MAX_HTTP_PIPELINING,
-                                              NO_DESCRIPTION, "2", 1, 8));
-    op->hide();
+    OptionHandler* op(new NumberOptionHandler(
+        PREF_MAX_HTTP_PIPELINING, TEXT_MAX_HTTP_PIPELINING, "2", 1, 8));
+    op->addTag(TAG_HTTP);
+    op->setInitialOption(true);
+    op->setChangeGlobalOption(true);
+    op->setChangeOptionForReserved(true);
     handlers.push_back(op);
   }
   {
@@ -1708,6 +1785,12 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->setChangeOptionForReserved(true);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new NumberOptionHandler(
+        PREF_DHT_BUCKET_SIZE, TEXT_DHT_BUCKET_SIZE, "8", 8, 64));
+    op->addTag(TAG_BITTORRENT);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new HostPortOptionHandler(
         PREF_DHT_ENTRY_POINT, TEXT_DHT_ENTRY_POINT, NO_DEFAULT_VALUE,
@@ -1765,6 +1848,19 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->addTag(TAG_BITTORRENT);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new NumberOptionHandler(PREF_DHT_PEER_STORE_SIZE,
+                                              TEXT_DHT_PEER_STORE_SIZE,
+                                              "10000", 1, 10000000));
+    op->addTag(TAG_BITTORRENT);
+    handlers.push_back(op);
+  }
+  {
+    OptionHandler* op(new NumberOptionHandler(
+        PREF_DHT_QUERY_RATE_LIMIT, TEXT_DHT_QUERY_RATE_LIMIT, "0", 0));
+    op->addTag(TAG_BITTORRENT);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new BooleanOptionHandler(
         PREF_ENABLE_DHT, TEXT_ENABLE_DHT, A2_V_TRUE, OptionHandler::OPT_ARG));
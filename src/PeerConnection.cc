@@ -69,8 +69,8 @@ PeerConnection::PeerConnection(cuid_t cuid, const std::shared_ptr<Peer>& peer,
       peer_(peer),
       socket_(socket),
       msgState_(BT_MSG_PREV_READ_LENGTH),
-      bufferCapacity_(MAX_BUFFER_CAPACITY),
-      resbuf_(make_unique<unsigned char[]>(bufferCapacity_)),
+      bufferCapacity_(DEFAULT_BUFFER_CAPACITY),
+      resbuf_(allocatePoolBuffer(bufferCapacity_)),
       resbufLength_(0),
       currentPayloadLength_(0),
       resbufOffset_(0),
@@ -92,6 +92,17 @@ void PeerConnection::pushBytes(std::vector<unsigned char> data,
   socketBuffer_.pushBytes(std::move(data), std::move(progressUpdate));
 }
 
+#ifdef A2_HAVE_SENDFILE
+void PeerConnection::pushFile(std::shared_ptr<SharedFileDescriptor> fd,
+                              int64_t offset, size_t length,
+                              std::unique_ptr<ProgressUpdate> progressUpdate)
+{
+  assert(!encryptionEnabled_);
+  socketBuffer_.pushFile(std::move(fd), offset, length,
+                         std::move(progressUpdate));
+}
+#endif // A2_HAVE_SENDFILE
+
 bool PeerConnection::receiveMessage(unsigned char* data, size_t& dataLength)
 {
   while (1) {
@@ -111,7 +122,11 @@ bool PeerConnection::receiveMessage(unsigned char* data, size_t& dataLength)
         // The message length is uint32_t
         if (i - msgOffset_ == 3) {
           if (currentPayloadLength_ + 4 > bufferCapacity_) {
-            throw DL_ABORT_EX(fmt(EX_TOO_LONG_PAYLOAD, currentPayloadLength_));
+            if (currentPayloadLength_ + 4 > MAX_BUFFER_CAPACITY) {
+              throw DL_ABORT_EX(
+                  fmt(EX_TOO_LONG_PAYLOAD, currentPayloadLength_));
+            }
+            reserveBuffer(currentPayloadLength_ + 4);
           }
           if (currentPayloadLength_ == 0) {
             // Length == 0 means keep-alive message.
@@ -276,11 +291,29 @@ const unsigned char* PeerConnection::getMsgPayloadBuffer() const
   return resbuf_.get() + msgOffset_ + 4;
 }
 
+PoolBuffer PeerConnection::detachMsgPayloadBuffer(size_t& offset,
+                                                 size_t& capacity)
+{
+  if (msgState_ != BT_MSG_PREV_READ_LENGTH ||
+      resbufLength_ != msgOffset_ + 4 + currentPayloadLength_ ||
+      currentPayloadLength_ * 2 < bufferCapacity_) {
+    return nullptr;
+  }
+  offset = msgOffset_ + 4;
+  capacity = bufferCapacity_ - offset;
+  auto buf = std::move(resbuf_);
+  resbuf_ = allocatePoolBuffer(bufferCapacity_);
+  resbufLength_ = 0;
+  resbufOffset_ = 0;
+  msgOffset_ = 0;
+  return buf;
+}
+
 void PeerConnection::reserveBuffer(size_t minSize)
 {
   if (bufferCapacity_ < minSize) {
     bufferCapacity_ = minSize;
-    auto buf = make_unique<unsigned char[]>(bufferCapacity_);
+    auto buf = allocatePoolBuffer(bufferCapacity_);
     std::copy_n(resbuf_.get(), resbufLength_, buf.get());
     resbuf_ = std::move(buf);
   }
@@ -44,6 +44,7 @@
 #include "Command.h"
 #include "a2functional.h"
 #include "BtConstants.h"
+#include "BufferPool.h"
 
 namespace aria2 {
 
@@ -56,6 +57,12 @@ class ARC4Encryptor;
 // dropped.
 constexpr size_t MAX_BUFFER_CAPACITY = MAX_BLOCK_LENGTH + 128;
 
+// The initial length of buffer, which is enough to hold a piece
+// message of 16KiB block.  The buffer grows up to MAX_BUFFER_CAPACITY
+// on demand.  Keeping it small lets detachMsgPayloadBuffer() hand the
+// buffer over without wasting much memory.
+constexpr size_t DEFAULT_BUFFER_CAPACITY = 16_k + 128;
+
 class PeerConnection {
 private:
   cuid_t cuid_;
@@ -66,7 +73,7 @@ private:
   // The capacity of the buffer resbuf_
   size_t bufferCapacity_;
   // The internal buffer of incoming handshakes and messages
-  std::unique_ptr<unsigned char[]> resbuf_;
+  PoolBuffer resbuf_;
   // The number of bytes written in resbuf_
   size_t resbufLength_;
   // The length of message (not handshake) currently receiving
@@ -100,6 +107,17 @@ public:
                  std::unique_ptr<ProgressUpdate> progressUpdate =
                      std::unique_ptr<ProgressUpdate>{});
 
+#ifdef A2_HAVE_SENDFILE
+  // Pushes |length| bytes of the file |fd| starting at |offset| into
+  // send buffer.  They are sent without being read into memory.  This
+  // function must not be called if isEncryptionEnabled() returns
+  // true.
+  void pushFile(std::shared_ptr<SharedFileDescriptor> fd, int64_t offset,
+                size_t length,
+                std::unique_ptr<ProgressUpdate> progressUpdate =
+                    std::unique_ptr<ProgressUpdate>{});
+#endif // A2_HAVE_SENDFILE
+
   bool receiveMessage(unsigned char* data, size_t& dataLength);
 
   /**
@@ -114,6 +132,8 @@ public:
   void enableEncryption(std::unique_ptr<ARC4Encryptor> encryptor,
                         std::unique_ptr<ARC4Encryptor> decryptor);
 
+  bool isEncryptionEnabled() const { return encryptionEnabled_; }
+
   void presetBuffer(const unsigned char* data, size_t length);
 
   bool sendBufferIsEmpty() const;
@@ -130,6 +150,16 @@ public:
   // must be called after receiveMessage() returned true.
   const unsigned char* getMsgPayloadBuffer() const;
 
+  // Hands the buffer holding the message last received by
+  // receiveMessage() over to the caller, and allocates a fresh buffer
+  // for the subsequent messages.  The message payload starts at
+  // |offset| bytes from the beginning of the returned buffer, and
+  // |capacity| bytes are valid from there.  Returns nullptr if the
+  // buffer contains bytes following the message, or it is much larger
+  // than the message.  In that case, the caller has to copy the
+  // payload.
+  PoolBuffer detachMsgPayloadBuffer(size_t& offset, size_t& capacity);
+
   // Reserves buffer at least minSize. Reallocate memory if current
   // buffer length < minSize
   void reserveBuffer(size_t minSize);
@@ -348,6 +348,7 @@ bool PeerInteractionCommand::executeInternal()
       if (getDownloadEngine()
               ->getRequestGroupMan()
               ->doesOverallDownloadSpeedExceed() ||
+          getDownloadEngine()->getRequestGroupMan()->isDiskWriteQueueFull() ||
           requestGroup_->doesDownloadSpeedExceed()) {
         disableReadCheckSocket();
         setNoCheck(true);
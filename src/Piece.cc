@@ -258,6 +258,8 @@ Piece::getDigestWithWrCache(size_t pieceLength,
   int64_t start = static_cast<int64_t>(index_) * pieceLength;
   int64_t goff = start;
   if (wrCache_) {
+    // Data handed over to DiskWriteQueue must reach the disk first.
+    wrCache_->waitForPendingWrite();
     const WrDiskCacheEntry::DataCellSet& dataSet = wrCache_->getDataSet();
     for (auto& d : dataSet) {
       if (goff < d->goff) {
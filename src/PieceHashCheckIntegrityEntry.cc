@@ -37,6 +37,8 @@
 #include "IteratableChunkChecksumValidator.h"
 #include "DownloadContext.h"
 #include "PieceStorage.h"
+#include "Option.h"
+#include "prefs.h"
 #include "a2functional.h"
 
 namespace aria2 {
@@ -61,6 +63,8 @@ void PieceHashCheckIntegrityEntry::initValidator()
   auto validator = make_unique<IteratableChunkChecksumValidator>(
       getRequestGroup()->getDownloadContext(),
       getRequestGroup()->getPieceStorage());
+  validator->setReadBufferSize(getRequestGroup()->getOption()->getAsInt(
+      PREF_CHECK_INTEGRITY_READ_SIZE));
   validator->init();
   setValidator(std::move(validator));
 }
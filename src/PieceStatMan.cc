@@ -43,7 +43,10 @@
 namespace aria2 {
 
 PieceStatMan::PieceStatMan(size_t pieceNum, bool randomShuffle)
-    : order_(pieceNum), counts_(pieceNum)
+    : order_(pieceNum),
+      counts_(pieceNum),
+      pos_(pieceNum),
+      randomShuffle_(randomShuffle)
 {
   for (size_t i = 0; i < pieceNum; ++i) {
     order_[i] = i;
@@ -53,66 +56,158 @@ PieceStatMan::PieceStatMan(size_t pieceNum, bool randomShuffle)
     std::shuffle(order_.begin(), order_.end(),
                  *SimpleRandomizer::getInstance());
   }
+  sorted_ = order_;
+  for (size_t i = 0; i < pieceNum; ++i) {
+    pos_[sorted_[i]] = i;
+  }
+  bucketStart_.push_back(0);
+  bucketStart_.push_back(pieceNum);
 }
 
 PieceStatMan::~PieceStatMan() = default;
 
-namespace {
-void inc(int& x)
+void PieceStatMan::swapPosition(size_t index, size_t pos)
+{
+  size_t other = sorted_[pos];
+  sorted_[pos_[index]] = other;
+  pos_[other] = pos_[index];
+  sorted_[pos] = index;
+  pos_[index] = pos;
+}
+
+void PieceStatMan::shufflePosition(size_t index, size_t first, size_t last)
 {
-  if (x < std::numeric_limits<int>::max()) {
-    ++x;
+  if (randomShuffle_ && last - first > 1) {
+    size_t pos =
+        first + SimpleRandomizer::getInstance()->getRandomNumber(last - first);
+    swapPosition(index, pos);
   }
 }
-} // namespace
 
-namespace {
-void sub(int& x)
+void PieceStatMan::dropEmptyBuckets()
 {
-  if (x > 0) {
-    --x;
+  while (bucketStart_.size() > 2 &&
+         bucketStart_[bucketStart_.size() - 2] == bucketStart_.back()) {
+    bucketStart_.pop_back();
   }
 }
-} // namespace
 
-void PieceStatMan::addPieceStats(const unsigned char* bitfield,
-                                 size_t bitfieldLength)
+void PieceStatMan::inc(size_t index)
+{
+  int c = counts_[index];
+  if (c == std::numeric_limits<int>::max()) {
+    return;
+  }
+  if (hasPiece(index)) {
+    ++counts_[index];
+    return;
+  }
+  // Move the piece to the last position of bucket c, which then
+  // becomes the first position of bucket c+1.
+  swapPosition(index, bucketStart_[c + 1] - 1);
+  if (static_cast<size_t>(c) + 2 == bucketStart_.size()) {
+    bucketStart_.push_back(bucketStart_.back());
+  }
+  --bucketStart_[c + 1];
+  ++counts_[index];
+  shufflePosition(index, bucketStart_[c + 1], bucketStart_[c + 2]);
+}
+
+void PieceStatMan::sub(size_t index)
+{
+  int c = counts_[index];
+  if (c == 0) {
+    return;
+  }
+  if (hasPiece(index)) {
+    --counts_[index];
+    return;
+  }
+  // Move the piece to the first position of bucket c, which then
+  // becomes the last position of bucket c-1.
+  swapPosition(index, bucketStart_[c]);
+  ++bucketStart_[c];
+  --counts_[index];
+  shufflePosition(index, bucketStart_[c - 1], bucketStart_[c]);
+  dropEmptyBuckets();
+}
+
+void PieceStatMan::addHave(size_t index)
+{
+  if (hasPiece(index)) {
+    return;
+  }
+  // Move the piece to the last position of its bucket, which then
+  // becomes the first position of the next bucket, and so on until it
+  // reaches the first position of the pieces we have.
+  for (size_t c = counts_[index] + 1; c < bucketStart_.size(); ++c) {
+    swapPosition(index, bucketStart_[c] - 1);
+    --bucketStart_[c];
+  }
+  dropEmptyBuckets();
+}
+
+void PieceStatMan::removeHave(size_t index)
+{
+  if (!hasPiece(index)) {
+    return;
+  }
+  size_t c = counts_[index];
+  while (bucketStart_.size() < c + 2) {
+    bucketStart_.push_back(bucketStart_.back());
+  }
+  // Move the piece to the first position of the pieces we have, which
+  // then becomes the last position of the last bucket, and walk it
+  // down in the same way to bucket c.
+  for (size_t d = bucketStart_.size() - 1; d > c; --d) {
+    swapPosition(index, bucketStart_[d]);
+    ++bucketStart_[d];
+  }
+  shufflePosition(index, bucketStart_[c], bucketStart_[c + 1]);
+}
+
+void PieceStatMan::setHave(const unsigned char* bitfield,
+                           size_t bitfieldLength)
 {
-  for (size_t i = 0, nbits = counts_.size(); i < nbits; ++i) {
-    if (bitfield::test(bitfield, nbits, i)) {
-      inc(counts_[i]);
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    if (bitfield::test(bitfield, counts_.size(), i)) {
+      addHave(i);
+    }
+    else {
+      removeHave(i);
     }
   }
 }
 
+void PieceStatMan::addPieceStats(const unsigned char* bitfield,
+                                 size_t bitfieldLength)
+{
+  bitfield::forEachSetBit(bitfield, counts_.size(),
+                          [this](size_t i) { inc(i); });
+}
+
 void PieceStatMan::subtractPieceStats(const unsigned char* bitfield,
                                       size_t bitfieldLength)
 {
-  for (size_t i = 0, nbits = counts_.size(); i < nbits; ++i) {
-    if (bitfield::test(bitfield, nbits, i)) {
-      sub(counts_[i]);
-    }
-  }
+  bitfield::forEachSetBit(bitfield, counts_.size(),
+                          [this](size_t i) { sub(i); });
 }
 
 void PieceStatMan::updatePieceStats(const unsigned char* newBitfield,
                                     size_t newBitfieldLength,
                                     const unsigned char* oldBitfield)
 {
-  for (size_t i = 0, nbits = counts_.size(); i < nbits; ++i) {
-    bool inNew = bitfield::test(newBitfield, nbits, i);
-    bool inOld = bitfield::test(oldBitfield, nbits, i);
-    if (inNew) {
-      if (!inOld) {
-        inc(counts_[i]);
-      }
-    }
-    else if (inOld) {
-      sub(counts_[i]);
-    }
-  }
+  bitfield::forEachDiffBit(newBitfield, oldBitfield, counts_.size(),
+                           [this](size_t i, bool inNew) {
+                             if (inNew) {
+                               inc(i);
+                             }
+                             else {
+                               sub(i);
+                             }
+                           });
 }
 
-void PieceStatMan::addPieceStats(size_t index) { inc(counts_[index]); }
+void PieceStatMan::addPieceStats(size_t index) { inc(index); }
 
 } // namespace aria2
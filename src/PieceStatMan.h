@@ -41,10 +41,38 @@
 
 namespace aria2 {
 
+// Keeps the number of peers which have each piece.  Besides the
+// counts, piece indexes are kept sorted by count, so that the rarest
+// pieces are found without scanning all pieces.  The sorted array is
+// divided into buckets of the same count, and changing the count of
+// a piece by one just swaps it with the piece at the edge of its
+// bucket and moves the bucket boundary.  If randomShuffle is true,
+// the piece is then swapped with a random piece in its new bucket, so
+// that ties are broken randomly.  The pieces we have are kept after
+// all buckets, where their counts are still updated but their
+// positions are not.
 class PieceStatMan {
 private:
   std::vector<size_t> order_;
   std::vector<int> counts_;
+  // Piece indexes sorted by counts_ in ascending order, followed by
+  // the pieces we have
+  std::vector<size_t> sorted_;
+  // pos_[i] is the position of piece i in sorted_
+  std::vector<size_t> pos_;
+  // bucketStart_[c] is the position in sorted_ where the pieces with
+  // count c start.  The last element is the position where the
+  // pieces we have start.
+  std::vector<size_t> bucketStart_;
+  bool randomShuffle_;
+
+  void inc(size_t index);
+  void sub(size_t index);
+  void swapPosition(size_t index, size_t pos);
+  // Swaps piece |index| with a random piece in [first, last) of
+  // sorted_ if randomShuffle_ is true.
+  void shufflePosition(size_t index, size_t first, size_t last);
+  void dropEmptyBuckets();
 
 public:
   PieceStatMan(size_t pieceNum, bool randomShuffle);
@@ -61,9 +89,44 @@ public:
                         size_t newBitfieldLength,
                         const unsigned char* oldBitfield);
 
+  // Moves piece |index| out of the buckets, so that it is not visited
+  // when looking for the rarest pieces.  Its count is still kept.
+  void addHave(size_t index);
+
+  // Puts piece |index| back into the bucket of its count.
+  void removeHave(size_t index);
+
+  // Calls addHave() for the pieces set in |bitfield|, and
+  // removeHave() for the others.
+  void setHave(const unsigned char* bitfield, size_t bitfieldLength);
+
+  bool hasPiece(size_t index) const
+  {
+    return pos_[index] >= bucketStart_.back();
+  }
+
   const std::vector<size_t>& getOrder() const { return order_; }
 
   const std::vector<int>& getCounts() const { return counts_; }
+
+  // Returns piece indexes sorted by count in ascending order,
+  // followed by the pieces we have in no particular order.  The order
+  // of the pieces with the same count is random if randomShuffle is
+  // true.  Otherwise, it is derived from getOrder().
+  const std::vector<size_t>& getSortedOrder() const { return sorted_; }
+
+  // Returns the range of getSortedOrder() holding the pieces which at
+  // least one peer has and we do not have, the rarest first.
+  std::vector<size_t>::const_iterator getAvailableBegin() const
+  {
+    return sorted_.begin() +
+           (bucketStart_.size() > 2 ? bucketStart_[1] : bucketStart_.back());
+  }
+
+  std::vector<size_t>::const_iterator getAvailableEnd() const
+  {
+    return sorted_.begin() + bucketStart_.back();
+  }
 };
 
 } // namespace aria2
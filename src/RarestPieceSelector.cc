@@ -34,9 +34,6 @@
 /* copyright --> */
 #include "RarestPieceSelector.h"
 
-#include <limits>
-#include <algorithm>
-
 #include "PieceStatMan.h"
 #include "bitfield.h"
 
@@ -51,24 +48,18 @@ RarestPieceSelector::RarestPieceSelector(
 bool RarestPieceSelector::select(size_t& index, const unsigned char* bitfield,
                                  size_t nbits) const
 {
-  const std::vector<size_t>& order = pieceStatMan_->getOrder();
-  const std::vector<int>& counts = pieceStatMan_->getCounts();
-  int min = std::numeric_limits<int>::max();
-  size_t bestIdx = nbits;
-  for (size_t i = 0; i < nbits; ++i) {
-    size_t idx = order[i];
-    if (bitfield::test(bitfield, nbits, idx) && counts[idx] < min) {
-      min = counts[idx];
-      bestIdx = idx;
+  // The pieces are sorted by count, so the first one found in
+  // bitfield is the rarest.  The pieces no peer has and the pieces we
+  // have are skipped without visiting them.
+  for (auto i = pieceStatMan_->getAvailableBegin(),
+            eoi = pieceStatMan_->getAvailableEnd();
+       i != eoi; ++i) {
+    if (bitfield::test(bitfield, nbits, *i)) {
+      index = *i;
+      return true;
     }
   }
-  if (bestIdx == nbits) {
-    return false;
-  }
-  else {
-    index = bestIdx;
-    return true;
-  }
+  return false;
 }
 
 } // namespace aria2
@@ -78,6 +78,7 @@
 #include "Notifier.h"
 #include "PeerStat.h"
 #include "WrDiskCache.h"
+#include "DiskWriteQueue.h"
 #include "PieceStorage.h"
 #include "DiskAdaptor.h"
 #include "SimpleRandomizer.h"
@@ -989,6 +990,11 @@ bool RequestGroupMan::doesOverallDownloadSpeedExceed()
          maxOverallDownloadSpeedLimit_ < netStat_.calculateDownloadSpeed();
 }
 
+bool RequestGroupMan::isDiskWriteQueueFull() const
+{
+  return diskWriteQueue_ && diskWriteQueue_->isFull();
+}
+
 bool RequestGroupMan::doesOverallUploadSpeedExceed()
 {
   return maxOverallUploadSpeedLimit_ > 0 &&
@@ -1051,6 +1057,11 @@ void RequestGroupMan::initWrDiskCache()
   size_t limit = option_->getAsInt(PREF_DISK_CACHE);
   if (limit > 0) {
     wrDiskCache_ = make_unique<WrDiskCache>(limit);
+    size_t numThreads = option_->getAsInt(PREF_DISK_IO_THREADS);
+    if (numThreads > 0) {
+      diskWriteQueue_ = make_unique<DiskWriteQueue>(numThreads, limit);
+      wrDiskCache_->setDiskWriteQueue(diskWriteQueue_.get());
+    }
   }
 }
 
@@ -60,6 +60,7 @@ class Option;
 class OutputFile;
 class UriListParser;
 class WrDiskCache;
+class DiskWriteQueue;
 class OpenedFileCounter;
 
 typedef IndexedList<a2_gid_t, std::shared_ptr<RequestGroup>> RequestGroupList;
@@ -121,6 +122,10 @@ private:
 
   std::unique_ptr<WrDiskCache> wrDiskCache_;
 
+  // Declared after wrDiskCache_ so that pending writes are finished
+  // before it is destroyed.
+  std::unique_ptr<DiskWriteQueue> diskWriteQueue_;
+
   std::shared_ptr<OpenedFileCounter> openedFileCounter_;
 
   // The number of stopped downloads so far in total, including
@@ -291,6 +296,11 @@ public:
   // maxOverallDownloadSpeedLimit_ == 0.  Otherwise returns false.
   bool doesOverallDownloadSpeedExceed();
 
+  // Returns true if too much data are waiting to be written by
+  // DiskWriteQueue.  Commands should stop reading from the network
+  // while this function returns true.
+  bool isDiskWriteQueueFull() const;
+
   void setMaxOverallDownloadSpeedLimit(int speed)
   {
     maxOverallDownloadSpeedLimit_ = speed;
@@ -345,6 +355,7 @@ public:
 
   // Initializes WrDiskCache according to PREF_DISK_CACHE option.  If
   // its value is 0, cache storage will not be initialized.
+  // DiskWriteQueue is also initialized if PREF_DISK_IO_THREADS > 0.
   void initWrDiskCache();
 
   void setKeepRunning(bool flag) { keepRunning_ = flag; }
@@ -88,6 +88,8 @@ std::vector<std::string> rpcMethodNames = {
     "aria2.forceShutdown",
     "aria2.getGlobalStat",
     "aria2.saveSession",
+    "aria2.subscribeStatus",
+    "aria2.unsubscribeStatus",
     "system.multicall",
     "system.listMethods",
     "system.listNotifications",
@@ -100,7 +102,7 @@ namespace {
 std::vector<std::string> rpcNotificationsNames = {
     "aria2.onDownloadStart",      "aria2.onDownloadPause",
     "aria2.onDownloadStop",       "aria2.onDownloadComplete",
-    "aria2.onDownloadError",
+    "aria2.onDownloadError",      "aria2.onStatusChange",
 #ifdef ENABLE_BITTORRENT
     "aria2.onBtDownloadComplete",
 #endif // ENABLE_BITTORRENT
@@ -251,6 +253,14 @@ std::unique_ptr<RpcMethod> createMethod(const std::string& methodName)
     return make_unique<SaveSessionRpcMethod>();
   }
 
+  if (methodName == SubscribeStatusRpcMethod::getMethodName()) {
+    return make_unique<SubscribeStatusRpcMethod>();
+  }
+
+  if (methodName == UnsubscribeStatusRpcMethod::getMethodName()) {
+    return make_unique<UnsubscribeStatusRpcMethod>();
+  }
+
   if (methodName == SystemMulticallRpcMethod::getMethodName()) {
     return make_unique<SystemMulticallRpcMethod>();
   }
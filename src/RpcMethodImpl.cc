@@ -69,6 +69,7 @@
 #include "MessageDigest.h"
 #include "message_digest_helper.h"
 #include "OpenedFileCounter.h"
+#include "BufferPool.h"
 #ifdef ENABLE_BITTORRENT
 #  include "bittorrent_helper.h"
 #  include "BtRegistry.h"
@@ -78,6 +79,12 @@
 #  include "BtAnnounce.h"
 #endif // ENABLE_BITTORRENT
 #include "CheckIntegrityEntry.h"
+#include "FileAllocationEntry.h"
+#include "WrDiskCache.h"
+#ifdef ENABLE_WEBSOCKET
+#  include "WebSocketSession.h"
+#  include "StatusSubscription.h"
+#endif // ENABLE_WEBSOCKET
 
 namespace aria2 {
 
@@ -145,8 +152,19 @@ const char KEY_NUM_WAITING[] = "numWaiting";
 const char KEY_NUM_STOPPED[] = "numStopped";
 const char KEY_NUM_ACTIVE[] = "numActive";
 const char KEY_NUM_STOPPED_TOTAL[] = "numStoppedTotal";
+const char KEY_NUM_POOL_SLABS[] = "numPoolSlabs";
+const char KEY_MAX_NUM_POOL_SLABS[] = "maxNumPoolSlabs";
+const char KEY_NUM_POOL_BUFFERS[] = "numPoolBuffers";
+const char KEY_MAX_NUM_POOL_BUFFERS[] = "maxNumPoolBuffers";
+const char KEY_DISK_CACHE_FLUSHES[] = "diskCacheFlushes";
+const char KEY_DISK_CACHE_BYTES_PER_WRITE[] = "diskCacheBytesPerWrite";
+const char KEY_DISK_CACHE_FLUSH_LATENCY[] = "diskCacheFlushLatency";
+const char KEY_DISK_CACHE_MAX_FLUSH_LATENCY[] = "diskCacheMaxFlushLatency";
 const char KEY_VERIFIED_LENGTH[] = "verifiedLength";
 const char KEY_VERIFY_PENDING[] = "verifyIntegrityPending";
+const char KEY_ALLOCATED_LENGTH[] = "allocatedLength";
+const char KEY_ALLOCATION_LENGTH[] = "allocationLength";
+const char KEY_ALLOCATION_PENDING[] = "allocationPending";
 } // namespace
 
 namespace {
@@ -798,14 +816,13 @@ void gatherProgress(Dict* entryDict, const std::shared_ptr<RequestGroup>& group,
   }
 #endif // ENABLE_BITTORRENT
   if (e->getCheckIntegrityMan()) {
-    if (e->getCheckIntegrityMan()->isPicked(
-            [&group](const CheckIntegrityEntry& ent) {
-              return ent.getRequestGroup() == group.get();
-            })) {
-      entryDict->put(
-          KEY_VERIFIED_LENGTH,
-          util::itos(
-              e->getCheckIntegrityMan()->getPickedEntry()->getCurrentLength()));
+    auto entry = e->getCheckIntegrityMan()->findPickedEntry(
+        [&group](const CheckIntegrityEntry& ent) {
+          return ent.getRequestGroup() == group.get();
+        });
+    if (entry) {
+      entryDict->put(KEY_VERIFIED_LENGTH,
+                     util::itos(entry->getCurrentLength()));
     }
     if (e->getCheckIntegrityMan()->isQueued(
             [&group](const CheckIntegrityEntry& ent) {
@@ -814,6 +831,24 @@ void gatherProgress(Dict* entryDict, const std::shared_ptr<RequestGroup>& group,
       entryDict->put(KEY_VERIFY_PENDING, VLB_TRUE);
     }
   }
+  if (e->getFileAllocationMan()) {
+    auto entry = e->getFileAllocationMan()->findPickedEntry(
+        [&group](const FileAllocationEntry& ent) {
+          return ent.getRequestGroup() == group.get();
+        });
+    if (entry) {
+      entryDict->put(KEY_ALLOCATED_LENGTH,
+                     util::itos(entry->getCurrentLength()));
+      entryDict->put(KEY_ALLOCATION_LENGTH,
+                     util::itos(entry->getTotalLength()));
+    }
+    if (e->getFileAllocationMan()->isQueued(
+            [&group](const FileAllocationEntry& ent) {
+              return ent.getRequestGroup() == group.get();
+            })) {
+      entryDict->put(KEY_ALLOCATION_PENDING, VLB_TRUE);
+    }
+  }
 }
 } // namespace
 
@@ -995,6 +1030,25 @@ std::unique_ptr<ValueBase> GetPeersRpcMethod::process(const RpcRequest& req,
 }
 #endif // ENABLE_BITTORRENT
 
+void gatherStatus(Dict* entryDict, const std::shared_ptr<RequestGroup>& group,
+                  DownloadEngine* e, const std::vector<std::string>& keys)
+{
+  if (requested_key(keys, KEY_STATUS)) {
+    if (group->getState() == RequestGroup::STATE_ACTIVE) {
+      entryDict->put(KEY_STATUS, VLB_ACTIVE);
+    }
+    else {
+      if (group->isPauseRequested()) {
+        entryDict->put(KEY_STATUS, VLB_PAUSED);
+      }
+      else {
+        entryDict->put(KEY_STATUS, VLB_WAITING);
+      }
+    }
+  }
+  gatherProgress(entryDict, group, e, keys);
+}
+
 std::unique_ptr<ValueBase> TellStatusRpcMethod::process(const RpcRequest& req,
                                                         DownloadEngine* e)
 {
@@ -1016,20 +1070,7 @@ std::unique_ptr<ValueBase> TellStatusRpcMethod::process(const RpcRequest& req,
     gatherStoppedDownload(entryDict.get(), ds, keys);
   }
   else {
-    if (requested_key(keys, KEY_STATUS)) {
-      if (group->getState() == RequestGroup::STATE_ACTIVE) {
-        entryDict->put(KEY_STATUS, VLB_ACTIVE);
-      }
-      else {
-        if (group->isPauseRequested()) {
-          entryDict->put(KEY_STATUS, VLB_PAUSED);
-        }
-        else {
-          entryDict->put(KEY_STATUS, VLB_WAITING);
-        }
-      }
-    }
-    gatherProgress(entryDict.get(), group, e, keys);
+    gatherStatus(entryDict.get(), group, e, keys);
   }
   return std::move(entryDict);
 }
@@ -1390,6 +1431,29 @@ GetGlobalStatRpcMethod::process(const RpcRequest& req, DownloadEngine* e)
   res->put(KEY_NUM_STOPPED, util::uitos(rgman->getDownloadResults().size()));
   res->put(KEY_NUM_STOPPED_TOTAL, util::uitos(rgman->getNumStoppedTotal()));
   res->put(KEY_NUM_ACTIVE, util::uitos(rgman->getRequestGroups().size()));
+  auto poolStat = BufferPool::getInstance().getStat();
+  res->put(KEY_NUM_POOL_SLABS, util::uitos(poolStat.numSlabs));
+  res->put(KEY_MAX_NUM_POOL_SLABS, util::uitos(poolStat.maxNumSlabs));
+  res->put(KEY_NUM_POOL_BUFFERS, util::uitos(poolStat.numBuffersInUse));
+  res->put(KEY_MAX_NUM_POOL_BUFFERS, util::uitos(poolStat.maxNumBuffersInUse));
+  if (rgman->getWrDiskCache()) {
+    auto& cacheStat = rgman->getWrDiskCache()->getStat();
+    res->put(KEY_DISK_CACHE_FLUSHES, util::uitos(cacheStat.numFlushes));
+    res->put(KEY_DISK_CACHE_BYTES_PER_WRITE,
+             util::uitos(cacheStat.numWrites == 0
+                             ? 0
+                             : cacheStat.numBytes / cacheStat.numWrites));
+    auto toUs = [](Timer::Clock::duration d) {
+      return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+    res->put(KEY_DISK_CACHE_FLUSH_LATENCY,
+             util::itos(cacheStat.numFlushes == 0
+                            ? 0
+                            : toUs(cacheStat.totalFlushTime) /
+                                  static_cast<int64_t>(cacheStat.numFlushes)));
+    res->put(KEY_DISK_CACHE_MAX_FLUSH_LATENCY,
+             util::itos(toUs(cacheStat.maxFlushTime)));
+  }
   return std::move(res);
 }
 
@@ -1410,6 +1474,46 @@ std::unique_ptr<ValueBase> SaveSessionRpcMethod::process(const RpcRequest& req,
       fmt("Failed to serialize session to '%s'.", filename.c_str()));
 }
 
+namespace {
+// The default and the minimum interval of status notifications.
+constexpr auto DEFAULT_STATUS_INTERVAL = std::chrono::milliseconds(1000);
+constexpr int32_t MIN_STATUS_INTERVAL_MILLIS = 100;
+} // namespace
+
+std::unique_ptr<ValueBase>
+SubscribeStatusRpcMethod::process(const RpcRequest& req, DownloadEngine* e)
+{
+  const List* keysParam = checkParam<List>(req, 0);
+  const Integer* intervalParam = checkParam<Integer>(req, 1);
+  std::vector<std::string> keys;
+  toStringList(std::back_inserter(keys), keysParam);
+  auto interval = DEFAULT_STATUS_INTERVAL;
+  if (intervalParam) {
+    checkRequiredInteger(req, 1, IntegerGE(MIN_STATUS_INTERVAL_MILLIS));
+    interval = std::chrono::milliseconds(intervalParam->i());
+  }
+  if (!req.wsSession) {
+    throw DL_ABORT_EX("Status subscription is only available over WebSocket.");
+  }
+#ifdef ENABLE_WEBSOCKET
+  req.wsSession->setStatusSubscription(
+      make_unique<StatusSubscription>(std::move(keys), interval));
+#endif // ENABLE_WEBSOCKET
+  return createOKResponse();
+}
+
+std::unique_ptr<ValueBase>
+UnsubscribeStatusRpcMethod::process(const RpcRequest& req, DownloadEngine* e)
+{
+  if (!req.wsSession) {
+    throw DL_ABORT_EX("Status subscription is only available over WebSocket.");
+  }
+#ifdef ENABLE_WEBSOCKET
+  req.wsSession->setStatusSubscription(nullptr);
+#endif // ENABLE_WEBSOCKET
+  return createOKResponse();
+}
+
 std::unique_ptr<ValueBase>
 SystemMulticallRpcMethod::process(const RpcRequest& req, DownloadEngine* e)
 {
@@ -1455,6 +1559,7 @@ RpcResponse SystemMulticallRpcMethod::execute(RpcRequest req, DownloadEngine* e)
       }
       RpcRequest r = {methodName->s(), std::move(paramsList), nullptr,
                       req.jsonRpc};
+      r.wsSession = req.wsSession;
       RpcResponse res = getMethod(methodName->s())->execute(std::move(r), e);
       if (rpc::not_authorized(res)) {
         authorized = RpcResponse::NOTAUTHORIZED;
@@ -516,6 +516,24 @@ public:
   static const char* getMethodName() { return "aria2.saveSession"; }
 };
 
+class SubscribeStatusRpcMethod : public RpcMethod {
+protected:
+  virtual std::unique_ptr<ValueBase> process(const RpcRequest& req,
+                                             DownloadEngine* e) CXX11_OVERRIDE;
+
+public:
+  static const char* getMethodName() { return "aria2.subscribeStatus"; }
+};
+
+class UnsubscribeStatusRpcMethod : public RpcMethod {
+protected:
+  virtual std::unique_ptr<ValueBase> process(const RpcRequest& req,
+                                             DownloadEngine* e) CXX11_OVERRIDE;
+
+public:
+  static const char* getMethodName() { return "aria2.unsubscribeStatus"; }
+};
+
 class SystemMulticallRpcMethod : public RpcMethod {
 protected:
   virtual std::unique_ptr<ValueBase> process(const RpcRequest& req,
@@ -567,6 +585,12 @@ void gatherProgressCommon(Dict* entryDict,
                           const std::shared_ptr<RequestGroup>& group,
                           const std::vector<std::string>& keys);
 
+// Helper function to store the status and progress of active or
+// waiting group to entryDict.  This function is used by tellStatus
+// method.
+void gatherStatus(Dict* entryDict, const std::shared_ptr<RequestGroup>& group,
+                  DownloadEngine* e, const std::vector<std::string>& keys);
+
 #ifdef ENABLE_BITTORRENT
 // Helper function to store BitTorrent metadata from torrentAttrs.
 void gatherBitTorrentMetadata(Dict* btDict, TorrentAttribute* torrentAttrs);
@@ -45,11 +45,15 @@ namespace aria2 {
 
 namespace rpc {
 
+class WebSocketSession;
+
 struct RpcRequest {
   std::string methodName;
   std::unique_ptr<List> params;
   std::unique_ptr<ValueBase> id;
   bool jsonRpc;
+  // The WebSocket session the request came from, or nullptr.
+  WebSocketSession* wsSession;
 
   RpcRequest();
 
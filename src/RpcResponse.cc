@@ -39,6 +39,7 @@
 
 #include "util.h"
 #include "json.h"
+#include "a2functional.h"
 #ifdef HAVE_ZLIB
 #  include "GZipEncoder.h"
 #endif // HAVE_ZLIB
@@ -243,6 +244,94 @@ std::string toJsonBatch(const std::vector<RpcResponse>& results,
   }
 }
 
+namespace {
+// The amount of JSON serialized by JsonResponseSource::read() at once.
+constexpr size_t JSON_CHUNK_SIZE = 16_k;
+} // namespace
+
+namespace {
+void pushJson(json::StreamEncoder& encoder, const RpcResponse& res)
+{
+  encoder.pushText("{\"id\":");
+  encoder.pushValue(res.id.get());
+  if (res.code == 0) {
+    encoder.pushText(",\"jsonrpc\":\"2.0\",\"result\":");
+  }
+  else {
+    encoder.pushText(",\"jsonrpc\":\"2.0\",\"error\":");
+  }
+  encoder.pushValue(res.param.get());
+  encoder.pushText("}");
+}
+} // namespace
+
+JsonResponseSource::JsonResponseSource(std::shared_ptr<ValueBaseArena> arena,
+                                       RpcResponse res,
+                                       const std::string& callback, bool gzip)
+    : arena_{std::move(arena)}, batch_{false}
+{
+  results_.push_back(std::move(res));
+  init(callback, gzip);
+}
+
+JsonResponseSource::JsonResponseSource(std::shared_ptr<ValueBaseArena> arena,
+                                       std::vector<RpcResponse> results,
+                                       const std::string& callback, bool gzip)
+    : arena_{std::move(arena)}, results_{std::move(results)}, batch_{true}
+{
+  init(callback, gzip);
+}
+
+JsonResponseSource::~JsonResponseSource() = default;
+
+void JsonResponseSource::init(const std::string& callback, bool gzip)
+{
+  if (!callback.empty()) {
+    encoder_.pushText(callback + "(");
+  }
+  if (batch_) {
+    encoder_.pushText("[");
+  }
+  for (auto i = std::begin(results_), eoi = std::end(results_); i != eoi;
+       ++i) {
+    if (i != std::begin(results_)) {
+      encoder_.pushText(",");
+    }
+    pushJson(encoder_, *i);
+  }
+  if (batch_) {
+    encoder_.pushText("]");
+  }
+  if (!callback.empty()) {
+    encoder_.pushText(")");
+  }
+  if (gzip) {
+#ifdef HAVE_ZLIB
+    gzip_ = make_unique<GZipEncoder>();
+    gzip_->init();
+#else  // !HAVE_ZLIB
+    abort();
+#endif // !HAVE_ZLIB
+  }
+}
+
+bool JsonResponseSource::read(std::string& buf)
+{
+#ifdef HAVE_ZLIB
+  if (gzip_) {
+    std::string data;
+    bool eof = encoder_.encode(data, JSON_CHUNK_SIZE);
+    buf += gzip_->encode(reinterpret_cast<const unsigned char*>(data.data()),
+                         data.size());
+    if (eof) {
+      buf += gzip_->str();
+    }
+    return eof;
+  }
+#endif // HAVE_ZLIB
+  return encoder_.encode(buf, buf.size() + JSON_CHUNK_SIZE);
+}
+
 } // namespace rpc
 
 } // namespace aria2
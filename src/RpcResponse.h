@@ -41,9 +41,15 @@
 #include <vector>
 
 #include "ValueBase.h"
+#include "SocketBuffer.h"
+#include "json.h"
 
 namespace aria2 {
 
+#ifdef HAVE_ZLIB
+class GZipEncoder;
+#endif // HAVE_ZLIB
+
 namespace rpc {
 
 struct RpcResponse {
@@ -80,6 +86,36 @@ std::string toJson(const RpcResponse& response, const std::string& callback,
 std::string toJsonBatch(const std::vector<RpcResponse>& results,
                         const std::string& callback, bool gzip = false);
 
+// Generates RPC response in JSON a chunk at a time.  It keeps the
+// responses and the arena they were built in until all data are
+// generated.  If callback is not empty, the result is JSONP.
+class JsonResponseSource : public BufferSource {
+public:
+  JsonResponseSource(std::shared_ptr<ValueBaseArena> arena, RpcResponse res,
+                     const std::string& callback, bool gzip = false);
+
+  // Generates batch response.
+  JsonResponseSource(std::shared_ptr<ValueBaseArena> arena,
+                     std::vector<RpcResponse> results,
+                     const std::string& callback, bool gzip = false);
+
+  ~JsonResponseSource();
+
+  virtual bool read(std::string& buf) CXX11_OVERRIDE;
+
+private:
+  void init(const std::string& callback, bool gzip);
+
+  // Declared first, so that it is destroyed after the responses.
+  std::shared_ptr<ValueBaseArena> arena_;
+  std::vector<RpcResponse> results_;
+  bool batch_;
+  json::StreamEncoder encoder_;
+#ifdef HAVE_ZLIB
+  std::unique_ptr<GZipEncoder> gzip_;
+#endif // HAVE_ZLIB
+};
+
 } // namespace rpc
 
 } // namespace aria2
@@ -43,26 +43,51 @@
 
 namespace aria2 {
 
+// Picks entries in FIFO order.  At most maxPicked entries can be
+// picked at the same time; each picked entry must be released by
+// dropPickedEntry() when its processing is done.
 template <typename T> class SequentialPicker {
 private:
   std::deque<std::unique_ptr<T>> entries_;
-  std::unique_ptr<T> pickedEntry_;
+  std::deque<std::unique_ptr<T>> pickedEntries_;
+  size_t maxPicked_;
 
 public:
-  bool isPicked() const { return pickedEntry_.get(); }
+  SequentialPicker(size_t maxPicked = 1) : maxPicked_(maxPicked) {}
 
-  const std::unique_ptr<T>& getPickedEntry() const { return pickedEntry_; }
+  bool isPicked() const { return !pickedEntries_.empty(); }
 
-  void dropPickedEntry() { pickedEntry_.reset(); }
+  const std::deque<std::unique_ptr<T>>& getPickedEntries() const
+  {
+    return pickedEntries_;
+  }
+
+  void dropPickedEntry(T* entry)
+  {
+    for (auto i = std::begin(pickedEntries_), eoi = std::end(pickedEntries_);
+         i != eoi; ++i) {
+      if ((*i).get() == entry) {
+        pickedEntries_.erase(i);
+        return;
+      }
+    }
+  }
 
   bool hasNext() const { return !entries_.empty(); }
 
+  // Returns true if there is a queued entry and the number of picked
+  // entries is less than maxPicked.
+  bool canPickNext() const
+  {
+    return hasNext() && pickedEntries_.size() < maxPicked_;
+  }
+
   T* pickNext()
   {
     if (hasNext()) {
-      pickedEntry_ = std::move(entries_.front());
+      pickedEntries_.push_back(std::move(entries_.front()));
       entries_.pop_front();
-      return pickedEntry_.get();
+      return pickedEntries_.back().get();
     }
     return nullptr;
   }
@@ -74,9 +99,24 @@ public:
 
   size_t countEntryInQueue() const { return entries_.size(); }
 
+  size_t getMaxPicked() const { return maxPicked_; }
+
+  void setMaxPicked(size_t maxPicked) { maxPicked_ = maxPicked; }
+
+  // Returns the first picked entry which satisfies |pred|, or nullptr.
+  T* findPickedEntry(const std::function<bool(const T&)>& pred) const
+  {
+    for (auto& e : pickedEntries_) {
+      if (pred(*e)) {
+        return e.get();
+      }
+    }
+    return nullptr;
+  }
+
   bool isPicked(const std::function<bool(const T&)>& pred) const
   {
-    return pickedEntry_ && pred(*pickedEntry_);
+    return findPickedEntry(pred);
   }
 
   bool isQueued(const std::function<bool(const T&)>& pred) const
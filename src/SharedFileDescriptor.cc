@@ -0,0 +1,82 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "SharedFileDescriptor.h"
+
+#include <cerrno>
+
+#include "a2io.h"
+#include "util.h"
+#include "OpenedFileCounter.h"
+
+namespace aria2 {
+
+SharedFileDescriptor::SharedFileDescriptor(
+    int fd, std::shared_ptr<OpenedFileCounter> openedFileCounter)
+    : fd_(fd), openedFileCounter_(std::move(openedFileCounter))
+{
+}
+
+SharedFileDescriptor::~SharedFileDescriptor()
+{
+  close(fd_);
+  if (openedFileCounter_) {
+    openedFileCounter_->reduceNumOfOpenedFile(1);
+  }
+}
+
+std::shared_ptr<SharedFileDescriptor> SharedFileDescriptor::duplicate(
+    int fd, const std::shared_ptr<OpenedFileCounter>& openedFileCounter)
+{
+#ifdef __MINGW32__
+  return nullptr;
+#else  // !__MINGW32__
+  if (openedFileCounter && !openedFileCounter->tryIncrease(1)) {
+    return nullptr;
+  }
+  int newfd;
+  while ((newfd = dup(fd)) == -1 && errno == EINTR)
+    ;
+  if (newfd == -1) {
+    if (openedFileCounter) {
+      openedFileCounter->reduceNumOfOpenedFile(1);
+    }
+    return nullptr;
+  }
+  util::make_fd_cloexec(newfd);
+  return std::make_shared<SharedFileDescriptor>(newfd, openedFileCounter);
+#endif // !__MINGW32__
+}
+
+} // namespace aria2
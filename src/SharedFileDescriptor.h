@@ -0,0 +1,75 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_SHARED_FILE_DESCRIPTOR_H
+#define D_SHARED_FILE_DESCRIPTOR_H
+
+#include "common.h"
+
+#include <memory>
+
+namespace aria2 {
+
+class OpenedFileCounter;
+
+// A duplicated descriptor of an open file, shared by the uploads
+// which send the file with sendfile(2).  The descriptor is closed
+// when the last reference is gone.  While it is alive, it is counted
+// as an open file by OpenedFileCounter.
+class SharedFileDescriptor {
+public:
+  // Takes the ownership of |fd|, which has been counted by
+  // |openedFileCounter| if it is not nullptr.
+  SharedFileDescriptor(int fd,
+                       std::shared_ptr<OpenedFileCounter> openedFileCounter);
+
+  ~SharedFileDescriptor();
+
+  // Duplicates |fd|.  Returns nullptr if the descriptor cannot be
+  // duplicated, or if |openedFileCounter| is not nullptr and it has
+  // no room for another open file.
+  static std::shared_ptr<SharedFileDescriptor>
+  duplicate(int fd,
+            const std::shared_ptr<OpenedFileCounter>& openedFileCounter);
+
+  int getFd() const { return fd_; }
+
+private:
+  int fd_;
+  std::shared_ptr<OpenedFileCounter> openedFileCounter_;
+};
+
+} // namespace aria2
+
+#endif // D_SHARED_FILE_DESCRIPTOR_H
@@ -36,6 +36,7 @@
 
 #include <cstring>
 #include <cassert>
+#include <algorithm>
 
 #include "BinaryStream.h"
 #include "Segment.h"
@@ -73,13 +74,23 @@ ssize_t SinkStreamFilter::transform(const std::shared_ptr<BinaryStream>& out,
       // If we receive small data (e.g., 1 or 2 bytes), cache entry
       // becomes a headache. To mitigate this problem, we allocate
       // cache buffer at least 4KiB and append the data to the
-      // contagious cache data.
+      // contagious cache data.  A buffer from BufferPool is used
+      // only if the data fill at least half of it.
       size_t alen = piece->appendWrCache(
           wrDiskCache_, segment->getPositionToWrite(), inbuf, wlen);
       if (alen < wlen) {
         size_t len = wlen - alen;
-        size_t capacity = std::max(len, static_cast<size_t>(4_k));
-        auto dataCopy = new unsigned char[capacity];
+        auto& pool = BufferPool::getInstance();
+        size_t capacity;
+        unsigned char* dataCopy;
+        if (len < pool.getBufferSize() / 2) {
+          capacity = std::max(len, static_cast<size_t>(4_k));
+          dataCopy = new unsigned char[capacity];
+        }
+        else {
+          capacity = std::max(len, pool.getBufferSize());
+          dataCopy = pool.allocate(capacity);
+        }
         memcpy(dataCopy, inbuf + alen, len);
         piece->updateWrCache(wrDiskCache_, dataCopy, 0, len, capacity,
                              segment->getPositionToWrite() + alen);
@@ -100,4 +111,27 @@ ssize_t SinkStreamFilter::transform(const std::shared_ptr<BinaryStream>& out,
   return bytesProcessed_;
 }
 
+ssize_t SinkStreamFilter::transform(const std::shared_ptr<Segment>& segment,
+                                    PoolBuffer buf, size_t offset,
+                                    size_t inlen, size_t capacity)
+{
+  assert(wrDiskCache_);
+  assert(segment->getLength() == 0 ||
+         segment->getLength() - segment->getWrittenLength() >=
+             static_cast<int64_t>(inlen));
+  const std::shared_ptr<Piece>& piece = segment->getPiece();
+  assert(piece->getWrDiskCacheEntry());
+  // Hash must be updated before the data are handed over to the
+  // cache, which may write them out and free them immediately.
+  if (hashUpdate_) {
+    segment->updateHash(segment->getWrittenLength(), buf.get() + offset,
+                        inlen);
+  }
+  piece->updateWrCache(wrDiskCache_, buf.release(), offset, inlen, capacity,
+                       segment->getPositionToWrite());
+  segment->updateWrittenLength(inlen);
+  bytesProcessed_ = inlen;
+  return bytesProcessed_;
+}
+
 } // namespace aria2
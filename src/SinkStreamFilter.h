@@ -36,6 +36,7 @@
 #define D_SINK_STREAM_FILTER_H
 
 #include "StreamFilter.h"
+#include "BufferPool.h"
 
 namespace aria2 {
 
@@ -57,6 +58,16 @@ public:
                             const unsigned char* inbuf,
                             size_t inlen) CXX11_OVERRIDE;
 
+  // Same as transform(), but the data are in |buf|, and the
+  // ownership of |buf| is passed to this object.  The
+  // data start at |offset| bytes from the beginning of |buf|, and
+  // |capacity| bytes are valid from there.  The write disk cache must
+  // be enabled for the piece of |segment|, and |inlen| must not
+  // exceed the remaining length of |segment|.
+  ssize_t transform(const std::shared_ptr<Segment>& segment,
+                    PoolBuffer buf, size_t offset,
+                    size_t inlen, size_t capacity);
+
   virtual bool finished() CXX11_OVERRIDE { return true; }
 
   virtual void release() CXX11_OVERRIDE {}
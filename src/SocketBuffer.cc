@@ -39,6 +39,7 @@
 
 #include "SocketCore.h"
 #include "DlAbortEx.h"
+#include "SharedFileDescriptor.h"
 #include "message.h"
 #include "fmt.h"
 #include "LogFactory.h"
@@ -102,6 +103,77 @@ const unsigned char* SocketBuffer::StringBufEntry::getData() const
   return reinterpret_cast<const unsigned char*>(str_.c_str());
 }
 
+#ifdef A2_HAVE_SENDFILE
+SocketBuffer::FileBufEntry::FileBufEntry(
+    std::shared_ptr<SharedFileDescriptor> fd, int64_t offset, size_t length,
+    std::unique_ptr<ProgressUpdate> progressUpdate)
+    : BufEntry(std::move(progressUpdate)),
+      fd_(std::move(fd)),
+      offset_(offset),
+      length_(length)
+{
+}
+
+ssize_t
+SocketBuffer::FileBufEntry::send(const std::shared_ptr<SocketCore>& socket,
+                                 size_t offset)
+{
+  return socket->sendFile(fd_->getFd(), offset_ + offset, length_ - offset);
+}
+
+bool SocketBuffer::FileBufEntry::final(size_t offset) const
+{
+  return length_ <= offset;
+}
+
+size_t SocketBuffer::FileBufEntry::getLength() const { return length_; }
+
+const unsigned char* SocketBuffer::FileBufEntry::getData() const
+{
+  return nullptr;
+}
+#endif // A2_HAVE_SENDFILE
+
+SocketBuffer::SourceBufEntry::SourceBufEntry(
+    std::unique_ptr<BufferSource> source, std::string buf)
+    : BufEntry(nullptr), source_(std::move(source)), buf_(std::move(buf)),
+      eof_(false)
+{
+  if (buf_.empty()) {
+    next();
+  }
+}
+
+ssize_t
+SocketBuffer::SourceBufEntry::send(const std::shared_ptr<SocketCore>& socket,
+                                   size_t offset)
+{
+  return socket->writeData(buf_.data() + offset, buf_.size() - offset);
+}
+
+bool SocketBuffer::SourceBufEntry::final(size_t offset) const
+{
+  return eof_ && buf_.size() <= offset;
+}
+
+size_t SocketBuffer::SourceBufEntry::getLength() const { return buf_.size(); }
+
+const unsigned char* SocketBuffer::SourceBufEntry::getData() const
+{
+  // The entry is always sent alone, so that it can generate the next
+  // chunk.
+  return nullptr;
+}
+
+bool SocketBuffer::SourceBufEntry::next()
+{
+  buf_.clear();
+  while (!eof_ && buf_.empty()) {
+    eof_ = source_->read(buf_);
+  }
+  return !buf_.empty();
+}
+
 SocketBuffer::SocketBuffer(std::shared_ptr<SocketCore> socket)
     : socket_(std::move(socket)), offset_(0)
 {
@@ -127,6 +199,27 @@ void SocketBuffer::pushStr(std::string data,
   }
 }
 
+void SocketBuffer::pushSource(std::unique_ptr<BufferSource> source,
+                              std::string buf)
+{
+  auto entry = make_unique<SourceBufEntry>(std::move(source), std::move(buf));
+  if (entry->getLength() > 0) {
+    bufq_.push_back(std::move(entry));
+  }
+}
+
+#ifdef A2_HAVE_SENDFILE
+void SocketBuffer::pushFile(std::shared_ptr<SharedFileDescriptor> fd,
+                            int64_t offset, size_t length,
+                            std::unique_ptr<ProgressUpdate> progressUpdate)
+{
+  if (length > 0) {
+    bufq_.push_back(make_unique<FileBufEntry>(std::move(fd), offset, length,
+                                              std::move(progressUpdate)));
+  }
+}
+#endif // A2_HAVE_SENDFILE
+
 ssize_t SocketBuffer::send()
 {
   a2iovec iov[A2_IOV_MAX];
@@ -134,29 +227,38 @@ ssize_t SocketBuffer::send()
   while (!bufq_.empty()) {
     size_t num;
     size_t bufqlen = bufq_.size();
-    ssize_t amount = 24_k;
     ssize_t firstlen = bufq_.front()->getLength() - offset_;
-    amount -= firstlen;
-    iov[0].A2IOVEC_BASE = reinterpret_cast<char*>(
-        const_cast<unsigned char*>(bufq_.front()->getData() + offset_));
-    iov[0].A2IOVEC_LEN = firstlen;
-    num = 1;
-    for (auto i = std::begin(bufq_) + 1, eoi = std::end(bufq_);
-         i != eoi && num < A2_IOV_MAX && num < bufqlen && amount > 0;
-         ++i, ++num) {
-
-      ssize_t len = (*i)->getLength();
-
-      if (amount < len) {
-        break;
-      }
+    ssize_t slen;
+    if (bufq_.front()->getData()) {
+      ssize_t amount = 24_k;
+      amount -= firstlen;
+      iov[0].A2IOVEC_BASE = reinterpret_cast<char*>(
+          const_cast<unsigned char*>(bufq_.front()->getData() + offset_));
+      iov[0].A2IOVEC_LEN = firstlen;
+      num = 1;
+      for (auto i = std::begin(bufq_) + 1, eoi = std::end(bufq_);
+           i != eoi && num < A2_IOV_MAX && num < bufqlen && amount > 0;
+           ++i, ++num) {
+
+        ssize_t len = (*i)->getLength();
+
+        if (amount < len || !(*i)->getData()) {
+          break;
+        }
 
-      amount -= len;
-      iov[num].A2IOVEC_BASE =
-          reinterpret_cast<char*>(const_cast<unsigned char*>((*i)->getData()));
-      iov[num].A2IOVEC_LEN = len;
+        amount -= len;
+        iov[num].A2IOVEC_BASE = reinterpret_cast<char*>(
+            const_cast<unsigned char*>((*i)->getData()));
+        iov[num].A2IOVEC_LEN = len;
+      }
+      slen = socket_->writeVector(iov, num);
+    }
+    else {
+      // The data are not in memory; let the entry send them by
+      // itself.
+      num = 1;
+      slen = bufq_.front()->send(socket_, offset_);
     }
-    ssize_t slen = socket_->writeVector(iov, num);
     if (slen == 0 && !socket_->wantRead() && !socket_->wantWrite()) {
       throw DL_ABORT_EX(fmt(EX_SOCKET_SEND, "Connection closed."));
     }
@@ -175,8 +277,12 @@ ssize_t SocketBuffer::send()
 
     slen -= firstlen;
     bufq_.front()->progressUpdate(firstlen, true);
-    bufq_.pop_front();
     offset_ = 0;
+    if (bufq_.front()->next()) {
+      // The entry was sent alone, so slen is 0 here.
+      continue;
+    }
+    bufq_.pop_front();
 
     for (size_t i = 1; i < num; ++i) {
       auto& buf = bufq_.front();
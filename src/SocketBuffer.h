@@ -37,6 +37,8 @@
 
 #include "common.h"
 
+#include "a2io.h"
+
 #include <string>
 #include <deque>
 #include <memory>
@@ -45,12 +47,21 @@
 namespace aria2 {
 
 class SocketCore;
+class SharedFileDescriptor;
 
 struct ProgressUpdate {
   virtual ~ProgressUpdate() = default;
   virtual void update(size_t length, bool complete) = 0;
 };
 
+// Generates data to send on demand.
+struct BufferSource {
+  virtual ~BufferSource() = default;
+  // Appends the next chunk of data to |buf|.  Returns true if there
+  // is no more data.
+  virtual bool read(std::string& buf) = 0;
+};
+
 class SocketBuffer {
 private:
   class BufEntry {
@@ -64,7 +75,14 @@ private:
                          size_t offset) = 0;
     virtual bool final(size_t offset) const = 0;
     virtual size_t getLength() const = 0;
+    // Returns nullptr if the data are not in memory.  Such entry is
+    // sent by send() alone, not by writev().
     virtual const unsigned char* getData() const = 0;
+    // Called when all data of the entry have been sent.  The entry
+    // which generates data on demand replaces them with the next
+    // chunk and returns true.  Returns false if there is no more
+    // data.
+    virtual bool next() { return false; }
     void progressUpdate(size_t length, bool complete)
     {
       if (progressUpdate_) {
@@ -105,6 +123,44 @@ private:
     std::string str_;
   };
 
+#ifdef A2_HAVE_SENDFILE
+  // The range of a file sent by sendfile(2).
+  class FileBufEntry : public BufEntry {
+  public:
+    FileBufEntry(std::shared_ptr<SharedFileDescriptor> fd, int64_t offset,
+                 size_t length, std::unique_ptr<ProgressUpdate> progressUpdate);
+    virtual ssize_t send(const std::shared_ptr<SocketCore>& socket,
+                         size_t offset) CXX11_OVERRIDE;
+    virtual bool final(size_t offset) const CXX11_OVERRIDE;
+    virtual size_t getLength() const CXX11_OVERRIDE;
+    virtual const unsigned char* getData() const CXX11_OVERRIDE;
+
+  private:
+    std::shared_ptr<SharedFileDescriptor> fd_;
+    int64_t offset_;
+    size_t length_;
+  };
+#endif // A2_HAVE_SENDFILE
+
+  // The data generated by BufferSource.  The next chunk is generated
+  // only after the current one has been sent, so that the data are
+  // produced no faster than the peer reads them.
+  class SourceBufEntry : public BufEntry {
+  public:
+    SourceBufEntry(std::unique_ptr<BufferSource> source, std::string buf);
+    virtual ssize_t send(const std::shared_ptr<SocketCore>& socket,
+                         size_t offset) CXX11_OVERRIDE;
+    virtual bool final(size_t offset) const CXX11_OVERRIDE;
+    virtual size_t getLength() const CXX11_OVERRIDE;
+    virtual const unsigned char* getData() const CXX11_OVERRIDE;
+    virtual bool next() CXX11_OVERRIDE;
+
+  private:
+    std::unique_ptr<BufferSource> source_;
+    std::string buf_;
+    bool eof_;
+  };
+
   std::shared_ptr<SocketCore> socket_;
 
   std::deque<std::unique_ptr<BufEntry>> bufq_;
@@ -137,6 +193,21 @@ public:
   void pushStr(std::string data,
                std::unique_ptr<ProgressUpdate> progressUpdate = nullptr);
 
+#ifdef A2_HAVE_SENDFILE
+  // Feeds |length| bytes of the file |fd| starting at |offset| into
+  // queue.  They are sent by sendfile(2), so the socket must not be a
+  // secure one.  |fd| is kept open until the data are sent.  This
+  // function doesn't send data.  progressUpdate is handled in the
+  // same way as pushBytes().
+  void pushFile(std::shared_ptr<SharedFileDescriptor> fd, int64_t offset,
+                size_t length,
+                std::unique_ptr<ProgressUpdate> progressUpdate = nullptr);
+#endif // A2_HAVE_SENDFILE
+
+  // Feeds the data generated by |source| into queue.  |buf| is sent
+  // before them.  This function doesn't send data.
+  void pushSource(std::unique_ptr<BufferSource> source, std::string buf = "");
+
   // Sends data in queue.  Returns the number of bytes sent.
   ssize_t send();
 
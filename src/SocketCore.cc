@@ -796,6 +796,28 @@ ssize_t SocketCore::writeVector(a2iovec* iov, size_t iovcnt)
   return ret;
 }
 
+#ifdef A2_HAVE_SENDFILE
+ssize_t SocketCore::sendFile(int fd, int64_t offset, size_t len)
+{
+  assert(!secure_);
+  ssize_t ret;
+  wantRead_ = false;
+  wantWrite_ = false;
+  a2_off_t off = offset;
+  while ((ret = a2sendfile(sockfd_, fd, &off, len)) == -1 && errno == EINTR)
+    ;
+  int errNum = errno;
+  if (ret == -1) {
+    if (!A2_WOULDBLOCK(errNum)) {
+      throw DL_RETRY_EX(fmt(EX_SOCKET_SEND, errorMsg(errNum).c_str()));
+    }
+    wantWrite_ = true;
+    ret = 0;
+  }
+  return ret;
+}
+#endif // A2_HAVE_SENDFILE
+
 ssize_t SocketCore::writeData(const void* data, size_t len)
 {
   ssize_t ret = 0;
@@ -912,6 +934,19 @@ bool SocketCore::tlsConnect(const std::string& hostname)
   return tlsHandshake(clTlsContext_.get(), hostname);
 }
 
+void SocketCore::setAlpnProtocols(std::vector<std::string> protocols)
+{
+  alpnProtocols_ = std::move(protocols);
+}
+
+std::string SocketCore::getAlpnSelectedProtocol() const
+{
+  if (secure_ != A2_TLS_CONNECTED) {
+    return A2STR::NIL;
+  }
+  return tlsSession_->getAlpnSelectedProtocol();
+}
+
 bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname)
 {
   wantRead_ = false;
@@ -942,6 +977,10 @@ bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname)
                               tlsSession_->getLastErrorString().c_str()));
       }
     }
+    if (tlsctx->getSide() == TLS_CLIENT && !alpnProtocols_.empty() &&
+        tlsSession_->setAlpnProtocols(alpnProtocols_) != TLS_ERR_OK) {
+      A2_LOG_DEBUG("ALPN is not available with this TLS backend");
+    }
     // Done with the setup, now let handshaking begin immediately.
     secure_ = A2_TLS_HANDSHAKING;
     A2_LOG_DEBUG("TLS Handshaking");
@@ -1253,6 +1292,61 @@ ssize_t SocketCore::readDataFrom(void* data, size_t len, Endpoint& sender)
   return r;
 }
 
+size_t SocketCore::readDataFrom(Datagram* datagrams, size_t count)
+{
+#ifdef HAVE_RECVMMSG
+  wantRead_ = false;
+  wantWrite_ = false;
+  std::vector<sockaddr_union> addrs(count);
+  std::vector<iovec> iovs(count);
+  std::vector<mmsghdr> msgs(count);
+  for (size_t i = 0; i < count; ++i) {
+    iovs[i].iov_base = datagrams[i].data;
+    iovs[i].iov_len = datagrams[i].capacity;
+    auto& hdr = msgs[i].msg_hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_name = &addrs[i].sa;
+    hdr.msg_namelen = sizeof(addrs[i]);
+    hdr.msg_iov = &iovs[i];
+    hdr.msg_iovlen = 1;
+  }
+  int flags = 0;
+#ifdef MSG_WAITFORONE
+  // Do not block for the rest once a datagram is received.
+  flags |= MSG_WAITFORONE;
+#endif // MSG_WAITFORONE
+  int r;
+  while ((r = recvmmsg(sockfd_, msgs.data(), count, flags, nullptr)) == -1 &&
+         A2_EINTR == SOCKET_ERRNO)
+    ;
+  int errNum = SOCKET_ERRNO;
+  if (r == -1) {
+    if (!A2_WOULDBLOCK(errNum)) {
+      throw DL_RETRY_EX(fmt(EX_SOCKET_RECV, errorMsg(errNum).c_str()));
+    }
+    wantRead_ = true;
+    return 0;
+  }
+  for (int i = 0; i < r; ++i) {
+    datagrams[i].length = msgs[i].msg_len;
+    datagrams[i].sender = util::getNumericNameInfo(
+        &addrs[i].sa, msgs[i].msg_hdr.msg_namelen);
+  }
+  return r;
+#else  // !HAVE_RECVMMSG
+  size_t i;
+  for (i = 0; i < count; ++i) {
+    auto r = readDataFrom(datagrams[i].data, datagrams[i].capacity,
+                          datagrams[i].sender);
+    if (r == 0) {
+      break;
+    }
+    datagrams[i].length = r;
+  }
+  return i;
+#endif // !HAVE_RECVMMSG
+}
+
 std::string SocketCore::getSocketError() const
 {
   int error;
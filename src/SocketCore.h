@@ -93,6 +93,9 @@ private:
 
   std::shared_ptr<TLSSession> tlsSession_;
 
+  // Application protocols offered by ALPN in client side handshake.
+  std::vector<std::string> alpnProtocols_;
+
   /**
    * Makes this socket secure. The connection must be established
    * before calling this method.
@@ -264,6 +267,15 @@ public:
 
   ssize_t writeVector(a2iovec* iov, size_t iovcnt);
 
+#ifdef A2_HAVE_SENDFILE
+  // Sends up to |len| bytes of the file |fd| starting at |offset|
+  // using sendfile(2), without copying them to user space.  This
+  // function must not be used for the secure socket.  Returns the
+  // number of bytes sent.  If the socket gets EAGAIN, wantWrite_ is
+  // set.
+  ssize_t sendFile(int fd, int64_t offset, size_t len);
+#endif // A2_HAVE_SENDFILE
+
   /**
    * Reads up to len bytes from this socket.
    * data is a pointer pointing the first
@@ -285,6 +297,11 @@ public:
   // sender.addr will be numerihost assigned.
   ssize_t readDataFrom(void* data, size_t len, Endpoint& sender);
 
+  // Receives at most |count| datagrams into |datagrams| with a single
+  // recvmmsg(2) call if available.  Returns the number of datagrams
+  // received, which is 0 if none is available.
+  size_t readDataFrom(Datagram* datagrams, size_t count);
+
 #ifdef ENABLE_SSL
   // Performs TLS server side handshake. If handshake is completed,
   // returns true. If handshake has not been done yet, returns false.
@@ -296,6 +313,16 @@ public:
   // If you are going to verify peer's certificate, hostname must be
   // supplied.
   bool tlsConnect(const std::string& hostname);
+
+  // Sets |protocols| as the list of application protocols offered by
+  // ALPN in the next client side handshake.  This must be called
+  // before the first tlsConnect() call.  If TLS backend does not
+  // support ALPN, the protocols are silently not offered.
+  void setAlpnProtocols(std::vector<std::string> protocols);
+
+  // Returns the application protocol selected by ALPN in the
+  // completed handshake, or empty string if nothing was selected.
+  std::string getAlpnSelectedProtocol() const;
 #endif // ENABLE_SSL
 
 #ifdef HAVE_LIBSSH2
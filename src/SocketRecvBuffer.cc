@@ -36,14 +36,23 @@
 
 #include <cstring>
 #include <cassert>
+#include <algorithm>
 
 #include "SocketCore.h"
 #include "LogFactory.h"
 
 namespace aria2 {
 
+constexpr size_t SocketRecvBuffer::MIN_CAPACITY;
+
+size_t SocketRecvBuffer::maxCapacity_ = 256_k;
+
 SocketRecvBuffer::SocketRecvBuffer(std::shared_ptr<SocketCore> socket)
-    : socket_(std::move(socket)), pos_(buf_.data()), last_(pos_)
+    : bufCapacity_(0),
+      capacity_(MIN_CAPACITY),
+      socket_(std::move(socket)),
+      pos_(nullptr),
+      last_(nullptr)
 {
 }
 
@@ -51,13 +60,41 @@ SocketRecvBuffer::~SocketRecvBuffer() = default;
 
 ssize_t SocketRecvBuffer::recv()
 {
-  size_t n = std::end(buf_) - last_;
-  if (n == 0) {
+  return recv([this](unsigned char* data, size_t len) {
+    socket_->readData(data, len);
+    return len;
+  });
+}
+
+ssize_t SocketRecvBuffer::recv(
+    const std::function<size_t(unsigned char* data, size_t len)>& read)
+{
+  if (!buf_) {
+    buf_ = allocatePoolBuffer(capacity_);
+    bufCapacity_ = capacity_;
+    pos_ = last_ = buf_.get();
+  }
+  size_t requested = buf_.get() + bufCapacity_ - last_;
+  if (requested == 0) {
     A2_LOG_DEBUG("Buffer full");
     return 0;
   }
-  socket_->readData(last_, n);
+  size_t n = read(last_, requested);
+  // Adjust the capacity only when we read into the empty buffer,
+  // which tells how much data the socket had.  The new capacity takes
+  // effect when the buffer is allocated next time.
+  if (requested == bufCapacity_) {
+    if (n == requested) {
+      capacity_ = std::min(bufCapacity_ * 2, maxCapacity_);
+    }
+    else if (n < bufCapacity_ / 4) {
+      capacity_ = std::max(bufCapacity_ / 2, MIN_CAPACITY);
+    }
+  }
   last_ += n;
+  if (pos_ == last_) {
+    truncateBuffer();
+  }
   return n;
 }
 
@@ -70,6 +107,29 @@ void SocketRecvBuffer::drain(size_t n)
   }
 }
 
-void SocketRecvBuffer::truncateBuffer() { pos_ = last_ = buf_.data(); }
+void SocketRecvBuffer::truncateBuffer()
+{
+  buf_.reset();
+  pos_ = last_ = nullptr;
+}
+
+PoolBuffer SocketRecvBuffer::detachBuffer(size_t& offset, size_t& capacity)
+{
+  if (!buf_ || getBufferLength() * 2 < bufCapacity_) {
+    return nullptr;
+  }
+  offset = pos_ - buf_.get();
+  capacity = bufCapacity_ - offset;
+  pos_ = last_ = nullptr;
+  return std::move(buf_);
+}
+
+void SocketRecvBuffer::setMaxCapacity(size_t capacity)
+{
+  assert(capacity >= MIN_CAPACITY);
+  maxCapacity_ = capacity;
+}
+
+size_t SocketRecvBuffer::getMaxCapacity() { return maxCapacity_; }
 
 } // namespace aria2
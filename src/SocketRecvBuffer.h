@@ -38,14 +38,21 @@
 #include "common.h"
 
 #include <memory>
-#include <array>
+#include <functional>
 
 #include "a2functional.h"
+#include "BufferPool.h"
 
 namespace aria2 {
 
 class SocketCore;
 
+// Buffer for the data received from a socket.  The buffer is taken
+// from BufferPool only while it holds data, so that idle connections
+// do not keep memory.  Its capacity starts at 16KiB, and doubles up
+// to getMaxCapacity() while each read fills the whole buffer, that
+// is, while the connection delivers data faster than they are
+// consumed.  It shrinks back when reads become small.
 class SocketRecvBuffer {
 public:
   SocketRecvBuffer(std::shared_ptr<SocketCore> socket);
@@ -53,7 +60,15 @@ public:
   // Reads data from socket as much as capacity allows. Returns the
   // number of bytes read.
   ssize_t recv();
-  // Truncates the contents of buffer to 0.
+  // Same as recv(), but reads data by calling |read| instead of
+  // reading from the socket.  |read| copies at most |len| bytes into
+  // |data| and returns the number of bytes copied.  This is used for
+  // the data which were read from the socket by the other party, like
+  // the data of multiplexed HTTP/2 streams.
+  ssize_t recv(const std::function<size_t(unsigned char* data, size_t len)>&
+                   read);
+  // Truncates the contents of buffer to 0, and gives the memory back
+  // to the pool.
   void truncateBuffer();
   // Drains first n bytes of data from buffer.  It is an programmer's
   // responsibility to ensure that n is smaller or equal to the
@@ -68,11 +83,37 @@ public:
 
   bool bufferEmpty() const { return pos_ == last_; }
 
+  // Returns the capacity of the buffer used by the next read from
+  // the empty state.
+  size_t getCapacity() const { return capacity_; }
+
+  // Hands the buffer over to the caller.
+  // The buffered data start at |offset| bytes from the beginning of
+  // the returned buffer, and |capacity| bytes are valid from there.
+  // After this call, this object is empty.  Returns nullptr without
+  // doing anything if the buffered data are less than half of the
+  // buffer, so that the caller does not keep mostly unused memory.
+  PoolBuffer detachBuffer(size_t& offset, size_t& capacity);
+
+  // Sets the upper limit of the capacity of the buffer.  It must be
+  // greater than or equal to MIN_CAPACITY.
+  static void setMaxCapacity(size_t capacity);
+
+  static size_t getMaxCapacity();
+
+  constexpr static size_t MIN_CAPACITY = 16_k;
+
 private:
-  std::array<unsigned char, 16_k> buf_;
+  PoolBuffer buf_;
+  // The capacity of buf_
+  size_t bufCapacity_;
+  // The capacity of the buffer allocated next
+  size_t capacity_;
   std::shared_ptr<SocketCore> socket_;
   unsigned char* pos_;
   unsigned char* last_;
+
+  static size_t maxCapacity_;
 };
 
 } // namespace aria2
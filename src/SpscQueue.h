@@ -0,0 +1,121 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_SPSC_QUEUE_H
+#define D_SPSC_QUEUE_H
+
+#include "common.h"
+
+#include <atomic>
+
+namespace aria2 {
+
+// Unbounded lock-free queue which one thread pushes values into, and
+// another thread pops them out.  The values are stored in blocks of
+// BlockSize slots, so that the producer allocates memory only once
+// every BlockSize values and never waits for the consumer.  T must be
+// default constructible.
+template <typename T, size_t BlockSize = 256> class SpscQueue {
+public:
+  SpscQueue() : head_{new Block()}, tail_{head_} {}
+
+  ~SpscQueue()
+  {
+    for (auto block = head_; block;) {
+      auto next = block->next.load(std::memory_order_acquire);
+      delete block;
+      block = next;
+    }
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  // Pushes |value|.  This function is only called by the producer.
+  void push(T value)
+  {
+    auto written = tail_->written.load(std::memory_order_relaxed);
+    if (written == BlockSize) {
+      auto block = new Block();
+      tail_->next.store(block, std::memory_order_release);
+      tail_ = block;
+      written = 0;
+    }
+    tail_->slots[written] = std::move(value);
+    tail_->written.store(written + 1, std::memory_order_release);
+  }
+
+  // Pops the oldest value to |value|.  Returns false if the queue is
+  // empty.  This function is only called by the consumer.
+  bool pop(T& value)
+  {
+    for (;;) {
+      if (head_->read < head_->written.load(std::memory_order_acquire)) {
+        value = std::move(head_->slots[head_->read++]);
+        return true;
+      }
+      if (head_->read < BlockSize) {
+        return false;
+      }
+      // The producer moves on to the next block only after it filled
+      // this block.
+      auto next = head_->next.load(std::memory_order_acquire);
+      if (!next) {
+        return false;
+      }
+      delete head_;
+      head_ = next;
+    }
+  }
+
+private:
+  struct Block {
+    Block() : written{0}, next{nullptr}, read{0} {}
+    T slots[BlockSize];
+    // The number of slots filled by the producer.
+    std::atomic<size_t> written;
+    std::atomic<Block*> next;
+    // The number of slots popped by the consumer.
+    size_t read;
+  };
+
+  // Only accessed by the consumer.
+  Block* head_;
+  // Only accessed by the producer.
+  Block* tail_;
+};
+
+} // namespace aria2
+
+#endif // D_SPSC_QUEUE_H
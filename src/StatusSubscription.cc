@@ -0,0 +1,219 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "StatusSubscription.h"
+
+#include <functional>
+
+#include "DownloadEngine.h"
+#include "RequestGroupMan.h"
+#include "RequestGroup.h"
+#include "DownloadResult.h"
+#include "GroupId.h"
+#include "RpcMethodImpl.h"
+#include "wallclock.h"
+
+namespace aria2 {
+
+namespace rpc {
+
+namespace {
+// Computes the hash of the tree, so that the snapshot of a field does
+// not have to keep its value.
+class HashValueBaseVisitor : public ValueBaseVisitor {
+public:
+  HashValueBaseVisitor() : hash{0} {}
+
+  virtual void visit(const String& v) CXX11_OVERRIDE
+  {
+    combine(std::hash<std::string>()(v.s()));
+  }
+
+  virtual void visit(const Integer& v) CXX11_OVERRIDE
+  {
+    combine(std::hash<Integer::ValueType>()(v.i()));
+  }
+
+  virtual void visit(const Bool& v) CXX11_OVERRIDE { combine(v.val() ? 1 : 2); }
+
+  virtual void visit(const Null& v) CXX11_OVERRIDE { combine(3); }
+
+  virtual void visit(const List& v) CXX11_OVERRIDE
+  {
+    combine('[');
+    for (auto& e : v) {
+      e->accept(*this);
+    }
+    combine(']');
+  }
+
+  virtual void visit(const Dict& v) CXX11_OVERRIDE
+  {
+    combine('{');
+    for (auto& e : v) {
+      combine(std::hash<std::string>()(e.first));
+      e.second->accept(*this);
+    }
+    combine('}');
+  }
+
+  size_t hash;
+
+private:
+  void combine(size_t h) { hash ^= h + 0x9e3779b9 + (hash << 6) + (hash >> 2); }
+};
+} // namespace
+
+namespace {
+size_t hashValue(const ValueBase* v)
+{
+  HashValueBaseVisitor visitor;
+  v->accept(visitor);
+  return visitor.hash;
+}
+} // namespace
+
+namespace {
+const char KEY_GID[] = "gid";
+const char KEY_STATUS[] = "status";
+} // namespace
+
+StatusSubscription::StatusSubscription(std::vector<std::string> keys,
+                                       std::chrono::milliseconds interval)
+    : keys_{std::move(keys)},
+      interval_{std::move(interval)},
+      lastCollect_{Timer::zero()},
+      generation_{0}
+{
+  if (!keys_.empty()) {
+    // gid is always reported, but is not a part of snapshot.
+    keys_.push_back(KEY_GID);
+  }
+}
+
+std::chrono::milliseconds StatusSubscription::getWait() const
+{
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      lastCollect_.difference(global::wallclock()));
+  if (elapsed >= interval_) {
+    return std::chrono::milliseconds(0);
+  }
+  return interval_ - elapsed;
+}
+
+void StatusSubscription::diff(List* changes, a2_gid_t gid, Dict* entryDict,
+                              Snapshot& snapshot)
+{
+  snapshot.generation = generation_;
+  auto changed = Dict::g();
+  std::vector<std::pair<std::string, size_t>> fields;
+  fields.reserve(entryDict->size());
+  auto old = std::begin(snapshot.fields);
+  auto eoold = std::end(snapshot.fields);
+  for (auto& e : *entryDict) {
+    if (e.first == KEY_GID) {
+      continue;
+    }
+    for (; old != eoold && (*old).first < e.first; ++old) {
+      changed->put((*old).first, Null::g());
+    }
+    auto hash = hashValue(e.second.get());
+    if (old != eoold && (*old).first == e.first) {
+      if ((*old).second != hash) {
+        changed->put(e.first, std::move(e.second));
+      }
+      ++old;
+    }
+    else {
+      changed->put(e.first, std::move(e.second));
+    }
+    fields.emplace_back(e.first, hash);
+  }
+  for (; old != eoold; ++old) {
+    changed->put((*old).first, Null::g());
+  }
+  snapshot.fields = std::move(fields);
+  if (!changed->empty()) {
+    changed->put(KEY_GID, GroupId::toHex(gid));
+    changes->append(std::move(changed));
+  }
+}
+
+void StatusSubscription::collectGroup(
+    List* changes, const std::shared_ptr<RequestGroup>& group,
+    DownloadEngine* e)
+{
+  auto entryDict = Dict::g();
+  gatherStatus(entryDict.get(), group, e, keys_);
+  diff(changes, group->getGID(), entryDict.get(),
+       snapshots_[group->getGID()]);
+}
+
+std::unique_ptr<List> StatusSubscription::collectChanges(DownloadEngine* e)
+{
+  lastCollect_ = global::wallclock();
+  ++generation_;
+  auto changes = List::g();
+  auto& rgman = e->getRequestGroupMan();
+  for (auto& group : rgman->getRequestGroups()) {
+    collectGroup(changes.get(), group, e);
+  }
+  for (auto& group : rgman->getReservedGroups()) {
+    collectGroup(changes.get(), group, e);
+  }
+  for (auto i = std::begin(snapshots_); i != std::end(snapshots_);) {
+    if ((*i).second.generation == generation_) {
+      ++i;
+      continue;
+    }
+    auto ds = rgman->findDownloadResult((*i).first);
+    if (ds) {
+      auto entryDict = Dict::g();
+      gatherStoppedDownload(entryDict.get(), ds, keys_);
+      diff(changes.get(), (*i).first, entryDict.get(), (*i).second);
+    }
+    else {
+      auto entryDict = Dict::g();
+      entryDict->put(KEY_GID, GroupId::toHex((*i).first));
+      entryDict->put(KEY_STATUS, "removed");
+      changes->append(std::move(entryDict));
+    }
+    i = snapshots_.erase(i);
+  }
+  return changes;
+}
+
+} // namespace rpc
+
+} // namespace aria2
@@ -0,0 +1,107 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_STATUS_SUBSCRIPTION_H
+#define D_STATUS_SUBSCRIPTION_H
+
+#include "common.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <chrono>
+
+#include "TimerA2.h"
+#include "GroupId.h"
+#include "ValueBase.h"
+
+namespace aria2 {
+
+class DownloadEngine;
+class RequestGroup;
+
+namespace rpc {
+
+// Tracks the status of downloads for a client subscribed by
+// aria2.subscribeStatus, and reports only the fields which changed
+// since the last report.
+class StatusSubscription {
+public:
+  // |keys| is the fields to report in the same way as the keys
+  // parameter of aria2.tellStatus.  If it is empty, all fields are
+  // reported.
+  StatusSubscription(std::vector<std::string> keys,
+                     std::chrono::milliseconds interval);
+
+  // Returns the time until the next report is due.
+  std::chrono::milliseconds getWait() const;
+
+  // Returns the list of structs for active, waiting and paused
+  // downloads, and for those which stopped since the last call.  Each
+  // struct contains "gid" and the fields which changed since the last
+  // call.  The field which is no longer available is set to null.  If
+  // a download was removed altogether, its "status" is "removed".
+  std::unique_ptr<List> collectChanges(DownloadEngine* e);
+
+private:
+  struct Snapshot {
+    // Pairs of a field name and the hash of its value, ordered by
+    // name.
+    std::vector<std::pair<std::string, size_t>> fields;
+    uint64_t generation;
+  };
+
+  // Appends the fields in |entryDict| which differ from |snapshot| to
+  // |changes| and updates |snapshot|.
+  void diff(List* changes, a2_gid_t gid, Dict* entryDict,
+            Snapshot& snapshot);
+
+  void collectGroup(List* changes, const std::shared_ptr<RequestGroup>& group,
+                    DownloadEngine* e);
+
+  std::vector<std::string> keys_;
+  std::chrono::milliseconds interval_;
+  Timer lastCollect_;
+  // Incremented on each collectChanges() to find the downloads which
+  // disappeared.
+  uint64_t generation_;
+  std::unordered_map<a2_gid_t, Snapshot> snapshots_;
+};
+
+} // namespace rpc
+
+} // namespace aria2
+
+#endif // D_STATUS_SUBSCRIPTION_H
@@ -36,6 +36,10 @@
 #define TLS_SESSION_H
 
 #include "common.h"
+
+#include <string>
+#include <vector>
+
 #include "a2netcompat.h"
 #include "TLSContext.h"
 
@@ -68,6 +72,22 @@ public:
   // succeeds, or TLS_ERR_ERROR.
   virtual int setSNIHostname(const std::string& hostname) = 0;
 
+  // Sets |protocols| as the list of application protocols offered
+  // by ALPN extension, in the order of preference.  This is only
+  // meaningful for client side session and must be called before
+  // tlsConnect().  This function returns TLS_ERR_OK if it succeeds,
+  // or TLS_ERR_ERROR.  The default implementation returns
+  // TLS_ERR_ERROR, which means the backend does not support ALPN.
+  virtual int setAlpnProtocols(const std::vector<std::string>& protocols)
+  {
+    return TLS_ERR_ERROR;
+  }
+
+  // Returns the application protocol selected by ALPN, or empty
+  // string if no protocol was selected.  The default implementation
+  // returns empty string.
+  virtual std::string getAlpnSelectedProtocol() { return std::string(); }
+
   // Closes the SSL/TLS session. Don't close underlying transport
   // socket. This function returns TLS_ERR_OK if it succeeds, or
   // TLS_ERR_ERROR.
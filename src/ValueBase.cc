@@ -36,6 +36,116 @@
 
 namespace aria2 {
 
+namespace {
+// Size of the blocks obtained from the heap by ValueBaseArena.
+constexpr size_t ARENA_BLOCK_SIZE = 64_k;
+// Every allocation is rounded up to this size, which also gives the
+// alignment of the returned memory.
+constexpr size_t ARENA_ALIGN = 16;
+
+thread_local ValueBaseArena* currentArena = nullptr;
+// The most recently created arena alive in this thread.
+thread_local ValueBaseArena* liveArenas = nullptr;
+} // namespace
+
+ValueBaseArena::Scope::Scope(ValueBaseArena& arena) : prev_{currentArena}
+{
+  currentArena = &arena;
+}
+
+ValueBaseArena::Scope::~Scope() { currentArena = prev_; }
+
+ValueBaseArena::ValueBaseArena()
+    : prevLive_{nullptr},
+      nextLive_{liveArenas},
+      cur_{nullptr},
+      left_{0},
+      allocated_{0}
+{
+  if (liveArenas) {
+    liveArenas->prevLive_ = this;
+  }
+  liveArenas = this;
+}
+
+ValueBaseArena::~ValueBaseArena()
+{
+  if (prevLive_) {
+    prevLive_->nextLive_ = nextLive_;
+  }
+  else {
+    liveArenas = nextLive_;
+  }
+  if (nextLive_) {
+    nextLive_->prevLive_ = prevLive_;
+  }
+}
+
+ValueBaseArena* ValueBaseArena::current() { return currentArena; }
+
+bool ValueBaseArena::ownedByAny(const void* p)
+{
+  for (auto arena = liveArenas; arena; arena = arena->nextLive_) {
+    if (arena->owns(p)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ValueBaseArena::owns(const void* p) const
+{
+  auto q = static_cast<const char*>(p);
+  auto i = blockEnds_.upper_bound(q);
+  if (i == std::begin(blockEnds_)) {
+    return false;
+  }
+  --i;
+  return q < (*i).second;
+}
+
+void* ValueBaseArena::allocate(size_t size)
+{
+  size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+  allocated_ += size;
+  if (size > ARENA_BLOCK_SIZE / 4) {
+    // Large chunk gets its own block, so that the rest of the current
+    // block is not wasted.
+    blocks_.push_back(std::unique_ptr<char[]>(new char[size]));
+    auto p = blocks_.back().get();
+    blockEnds_.insert(std::make_pair(p, p + size));
+    return p;
+  }
+  if (size > left_) {
+    blocks_.push_back(std::unique_ptr<char[]>(new char[ARENA_BLOCK_SIZE]));
+    cur_ = blocks_.back().get();
+    left_ = ARENA_BLOCK_SIZE;
+    blockEnds_.insert(std::make_pair(cur_, cur_ + ARENA_BLOCK_SIZE));
+  }
+  auto p = cur_;
+  cur_ += size;
+  left_ -= size;
+  return p;
+}
+
+void* ValueBase::operator new(size_t size)
+{
+  auto arena = ValueBaseArena::current();
+  if (arena) {
+    return arena->allocate(size);
+  }
+  return ::operator new(size);
+}
+
+void ValueBase::operator delete(void* p)
+{
+  // Outside of RPC, no arena is alive and this only checks a
+  // thread-local pointer.
+  if (!liveArenas || !ValueBaseArena::ownedByAny(p)) {
+    ::operator delete(p);
+  }
+}
+
 String::String(const ValueType& string) : str_{string} {}
 String::String(ValueType&& string) : str_{std::move(string)} {}
 
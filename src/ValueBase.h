@@ -41,6 +41,7 @@
 #include <deque>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "a2functional.h"
 
@@ -48,11 +49,124 @@ namespace aria2 {
 
 class ValueBaseVisitor;
 
+// Monotonic arena for ValueBase trees.  While the arena is made
+// current by ValueBaseArena::Scope, ValueBase objects and the
+// containers of List and Dict created in the same thread are carved
+// out of large blocks owned by the arena instead of being allocated
+// one by one from the heap.  The characters of String values and Dict
+// keys are still std::string, which uses the heap unless they fit in
+// its small buffer.  Destroying the nodes is almost free, and the
+// arena returns all blocks at once when it is destroyed.  Therefore
+// every tree built in the arena must be destroyed before the arena
+// itself, and in the thread which created the arena.
+class ValueBaseArena {
+public:
+  // Makes the arena current in this thread during its lifetime.
+  // Scopes can be nested; the innermost one is used.
+  class Scope {
+  public:
+    Scope(ValueBaseArena& arena);
+    ~Scope();
+
+    // Don't allow copying
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    ValueBaseArena* prev_;
+  };
+
+  ValueBaseArena();
+  ~ValueBaseArena();
+
+  // Don't allow copying
+  ValueBaseArena(const ValueBaseArena&) = delete;
+  ValueBaseArena& operator=(const ValueBaseArena&) = delete;
+
+  // Returns the current arena of this thread, or nullptr.
+  static ValueBaseArena* current();
+
+  // Returns true if one of the arenas alive in this thread allocated
+  // |p|.
+  static bool ownedByAny(const void* p);
+
+  void* allocate(size_t size);
+
+  // Returns true if |p| was allocated by this arena.
+  bool owns(const void* p) const;
+
+  // Returns the number of bytes handed out by this arena.
+  size_t getAllocatedLength() const { return allocated_; }
+
+private:
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  // Maps the start of each block to its end.
+  std::map<const char*, const char*> blockEnds_;
+  // The arenas alive in this thread are linked through these.
+  ValueBaseArena* prevLive_;
+  ValueBaseArena* nextLive_;
+  char* cur_;
+  size_t left_;
+  size_t allocated_;
+};
+
+// Allocator for the containers of List and Dict.  It captures the
+// current arena when it is constructed, so that a container created
+// outside of an arena never holds memory from it.
+template <typename T> class ValueBaseAllocator {
+public:
+  typedef T value_type;
+
+  ValueBaseAllocator() : arena_{ValueBaseArena::current()} {}
+
+  template <typename U>
+  ValueBaseAllocator(const ValueBaseAllocator<U>& other)
+      : arena_{other.arena_}
+  {
+  }
+
+  T* allocate(size_t n)
+  {
+    if (arena_) {
+      return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+    }
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t n)
+  {
+    if (!arena_) {
+      ::operator delete(p);
+    }
+  }
+
+  template <typename U>
+  bool operator==(const ValueBaseAllocator<U>& other) const
+  {
+    return arena_ == other.arena_;
+  }
+
+  template <typename U>
+  bool operator!=(const ValueBaseAllocator<U>& other) const
+  {
+    return arena_ != other.arena_;
+  }
+
+private:
+  template <typename U> friend class ValueBaseAllocator;
+
+  ValueBaseArena* arena_;
+};
+
 class ValueBase {
 public:
   virtual ~ValueBase() = default;
 
   virtual void accept(ValueBaseVisitor& visitor) const = 0;
+
+  // Allocates from the current ValueBaseArena if any.
+  static void* operator new(size_t size);
+  static void operator delete(void* p);
 };
 
 class String;
@@ -174,7 +288,9 @@ private:
 
 class List : public ValueBase {
 public:
-  typedef std::deque<std::unique_ptr<ValueBase>> ValueType;
+  typedef std::deque<std::unique_ptr<ValueBase>,
+                     ValueBaseAllocator<std::unique_ptr<ValueBase>>>
+      ValueType;
 
   List();
 
@@ -246,7 +362,11 @@ private:
 
 class Dict : public ValueBase {
 public:
-  typedef std::map<std::string, std::unique_ptr<ValueBase>> ValueType;
+  typedef std::map<
+      std::string, std::unique_ptr<ValueBase>, std::less<std::string>,
+      ValueBaseAllocator<
+          std::pair<const std::string, std::unique_ptr<ValueBase>>>>
+      ValueType;
 
   Dict();
 
@@ -0,0 +1,122 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "WakeupFd.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef HAVE_SYS_EVENTFD_H
+#  include <sys/eventfd.h>
+#endif // HAVE_SYS_EVENTFD_H
+#ifdef HAVE_FCNTL_H
+#  include <fcntl.h>
+#endif // HAVE_FCNTL_H
+
+#include "a2io.h"
+#include "DlAbortEx.h"
+#include "fmt.h"
+#include "util.h"
+
+namespace aria2 {
+
+WakeupFd::WakeupFd() : readFd_{-1}, writeFd_{-1}
+{
+#if defined(HAVE_SYS_EVENTFD_H)
+  readFd_ = writeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (readFd_ == -1) {
+    int errNum = errno;
+    throw DL_ABORT_EX(
+        fmt("eventfd() failed. cause: %s", util::safeStrerror(errNum).c_str()));
+  }
+#elif !defined(__MINGW32__)
+  int fds[2];
+  if (pipe(fds) == -1) {
+    int errNum = errno;
+    throw DL_ABORT_EX(
+        fmt("pipe() failed. cause: %s", util::safeStrerror(errNum).c_str()));
+  }
+  for (auto fd : fds) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+  readFd_ = fds[0];
+  writeFd_ = fds[1];
+#endif // !__MINGW32__
+}
+
+WakeupFd::~WakeupFd()
+{
+  if (readFd_ != -1) {
+    close(readFd_);
+  }
+  if (writeFd_ != -1 && writeFd_ != readFd_) {
+    close(writeFd_);
+  }
+}
+
+void WakeupFd::notify()
+{
+  if (writeFd_ == -1) {
+    return;
+  }
+#ifdef HAVE_SYS_EVENTFD_H
+  uint64_t n = 1;
+#else  // !HAVE_SYS_EVENTFD_H
+  char n = 0;
+#endif // !HAVE_SYS_EVENTFD_H
+  // If the write would block, the descriptor is readable anyway.
+  while (write(writeFd_, &n, sizeof(n)) == -1 && errno == EINTR)
+    ;
+}
+
+void WakeupFd::drain()
+{
+  if (readFd_ == -1) {
+    return;
+  }
+  char buf[256];
+  for (;;) {
+    auto r = read(readFd_, buf, sizeof(buf));
+    if (r == -1 && errno == EINTR) {
+      continue;
+    }
+    // eventfd(2) is reset by a single read.
+    if (r <= 0 || readFd_ == writeFd_) {
+      break;
+    }
+  }
+}
+
+} // namespace aria2
@@ -0,0 +1,72 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_WAKEUP_FD_H
+#define D_WAKEUP_FD_H
+
+#include "common.h"
+
+namespace aria2 {
+
+// File descriptor which other threads make readable to wake up the
+// thread waiting for it in poll(2) or EventPoll.  It uses eventfd(2)
+// if available, or pipe(2).  On Windows, no file descriptor is
+// available and getFd() returns -1.
+class WakeupFd {
+public:
+  // Throws DlAbortEx if the file descriptor cannot be created.
+  WakeupFd();
+  ~WakeupFd();
+
+  WakeupFd(const WakeupFd&) = delete;
+  WakeupFd& operator=(const WakeupFd&) = delete;
+
+  // Makes getFd() readable.  This function is thread-safe.
+  void notify();
+
+  // Consumes all notifications, so that getFd() is not readable until
+  // notify() is called again.
+  void drain();
+
+  // Returns the file descriptor to wait for reading, or -1.
+  int getFd() const { return readFd_; }
+
+private:
+  int readFd_;
+  int writeFd_;
+};
+
+} // namespace aria2
+
+#endif // D_WAKEUP_FD_H
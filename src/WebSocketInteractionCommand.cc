@@ -43,6 +43,7 @@
 #include "SingletonHolder.h"
 #include "Notifier.h"
 #include "WebSocketSessionMan.h"
+#include "StatusSubscription.h"
 
 namespace aria2 {
 
@@ -89,6 +90,7 @@ bool WebSocketInteractionCommand::execute()
   if (e_->isHaltRequested()) {
     return true;
   }
+  wsSession_->addStatusChanges();
   if (wsSession_->onReadEvent() == -1 || wsSession_->onWriteEvent() == -1) {
     if (wsSession_->closeSent() || wsSession_->closeReceived()) {
       A2_LOG_INFO(
@@ -105,6 +107,18 @@ bool WebSocketInteractionCommand::execute()
     return true;
   }
   updateWriteCheck();
+  auto subscription = wsSession_->getStatusSubscription();
+  if (subscription) {
+    // Wake up in time for the next status notification, which may be
+    // due earlier than the next refresh.  If it is overdue, the
+    // previous message is still being sent and the write event wakes
+    // us up.
+    auto wait = subscription->getWait();
+    if (wait > std::chrono::milliseconds(0) &&
+        wait < e_->getRefreshInterval()) {
+      e_->setRefreshInterval(wait);
+    }
+  }
   e_->addCommand(std::unique_ptr<Command>(this));
   return false;
 }
@@ -50,6 +50,9 @@
 #include "json.h"
 #include "prefs.h"
 #include "Option.h"
+#include "StatusSubscription.h"
+#include "ValueBase.h"
+#include "a2functional.h"
 
 namespace aria2 {
 
@@ -114,21 +117,43 @@ ssize_t recvCallback(wslay_event_context_ptr wsctx, uint8_t* buf, size_t len,
 } // namespace
 
 namespace {
-void addResponse(WebSocketSession* wsSession, const RpcResponse& res)
+void addResponse(WebSocketSession* wsSession, RpcResponse res,
+                 std::shared_ptr<ValueBaseArena> arena)
 {
-  bool notauthorized = rpc::not_authorized(res);
-  std::string response = toJson(res, "", false);
-  wsSession->addTextMessage(response, notauthorized);
+  if (rpc::not_authorized(res)) {
+    wsSession->addTextMessage(toJson(res, "", false), true);
+    return;
+  }
+  wsSession->addTextMessage(
+      make_unique<JsonResponseSource>(std::move(arena), std::move(res), ""));
 }
 } // namespace
 
 namespace {
-void addResponse(WebSocketSession* wsSession,
-                 const std::vector<RpcResponse>& results)
+void addResponse(WebSocketSession* wsSession, std::vector<RpcResponse> results,
+                 std::shared_ptr<ValueBaseArena> arena)
 {
-  bool notauthorized = rpc::any_not_authorized(results.begin(), results.end());
-  std::string response = toJsonBatch(results, "", false);
-  wsSession->addTextMessage(response, notauthorized);
+  if (rpc::any_not_authorized(results.begin(), results.end())) {
+    wsSession->addTextMessage(toJsonBatch(results, "", false), true);
+    return;
+  }
+  wsSession->addTextMessage(make_unique<JsonResponseSource>(
+      std::move(arena), std::move(results), ""));
+}
+} // namespace
+
+namespace {
+ssize_t readTextMessageCallback(wslay_event_context_ptr wsctx, uint8_t* buf,
+                                size_t len,
+                                const union wslay_event_msg_source* source,
+                                int* eof, void* userData)
+{
+  WebSocketSession* wsSession = reinterpret_cast<WebSocketSession*>(userData);
+  ssize_t r = wsSession->readTextMessage(buf, len, eof);
+  if (r < 0) {
+    wslay_event_set_error(wsctx, WSLAY_ERR_CALLBACK_FAILURE);
+  }
+  return r;
 }
 } // namespace
 
@@ -164,20 +189,24 @@ void onMsgRecvCallback(wslay_event_context_ptr wsctx,
   WebSocketSession* wsSession = reinterpret_cast<WebSocketSession*>(userData);
   if (!wslay_is_ctrl_frame(arg->opcode)) {
     // TODO Only process text frame
+    // The request and response trees are built in an arena which
+    // the response keeps until it is sent.
+    auto arena = std::make_shared<ValueBaseArena>();
+    ValueBaseArena::Scope arenaScope(*arena);
     ssize_t error = 0;
     auto json = wsSession->parseFinal(nullptr, 0, error);
     if (error < 0) {
       A2_LOG_INFO("Failed to parse JSON-RPC request");
       RpcResponse res(
           createJsonRpcErrorResponse(-32700, "Parse error.", Null::g()));
-      addResponse(wsSession, res);
+      addResponse(wsSession, std::move(res), arena);
       return;
     }
     Dict* jsondict = downcast<Dict>(json);
     auto e = wsSession->getDownloadEngine();
     if (jsondict) {
-      RpcResponse res = processJsonRpcRequest(jsondict, e);
-      addResponse(wsSession, res);
+      RpcResponse res = processJsonRpcRequest(jsondict, e, wsSession);
+      addResponse(wsSession, std::move(res), arena);
     }
     else {
       List* jsonlist = downcast<List>(json);
@@ -189,23 +218,23 @@ void onMsgRecvCallback(wslay_event_context_ptr wsctx,
              i != eoi; ++i) {
           Dict* jsondict = downcast<Dict>(*i);
           if (jsondict) {
-            auto resp = processJsonRpcRequest(jsondict, e);
+            auto resp = processJsonRpcRequest(jsondict, e, wsSession);
             results.push_back(std::move(resp));
           }
         }
-        addResponse(wsSession, results);
+        addResponse(wsSession, std::move(results), arena);
       }
       else {
         RpcResponse res(
             createJsonRpcErrorResponse(-32600, "Invalid Request.", Null::g()));
-        addResponse(wsSession, res);
+        addResponse(wsSession, std::move(res), arena);
       }
     }
   }
   else {
     RpcResponse res(
         createJsonRpcErrorResponse(-32600, "Invalid Request.", Null::g()));
-    addResponse(wsSession, res);
+    addResponse(wsSession, std::move(res), nullptr);
   }
 }
 } // namespace
@@ -298,6 +327,100 @@ void WebSocketSession::addTextMessage(const std::string& msg, bool delayed)
   wslay_event_queue_msg(wsctx_, &arg);
 }
 
+void WebSocketSession::addTextMessage(std::unique_ptr<BufferSource> source)
+{
+  wslay_event_fragmented_msg arg;
+  arg.opcode = WSLAY_TEXT_FRAME;
+  arg.source.data = source.get();
+  arg.read_callback = readTextMessageCallback;
+  if (wslay_event_queue_fragmented_msg(wsctx_, &arg) == 0) {
+    textSources_.push_back(TextMessageSource{std::move(source), "", 0, false});
+  }
+}
+
+ssize_t WebSocketSession::readTextMessage(uint8_t* buf, size_t len, int* eof)
+{
+  assert(!textSources_.empty());
+  auto& ts = textSources_.front();
+  try {
+    while (ts.offset == ts.buf.size() && !ts.eof) {
+      ts.buf.clear();
+      ts.offset = 0;
+      ts.eof = ts.source->read(ts.buf);
+    }
+  }
+  catch (RecoverableException& e) {
+    A2_LOG_DEBUG_EX(EX_EXCEPTION_CAUGHT, e);
+    return -1;
+  }
+  size_t n = std::min(len, ts.buf.size() - ts.offset);
+  memcpy(buf, ts.buf.data() + ts.offset, n);
+  ts.offset += n;
+  if (ts.eof && ts.offset == ts.buf.size()) {
+    *eof = 1;
+    textSources_.pop_front();
+  }
+  return n;
+}
+
+namespace {
+// The amount of JSON serialized by NotificationSource::read() at
+// once.
+constexpr size_t NOTIFICATION_CHUNK_SIZE = 16_k;
+} // namespace
+
+namespace {
+// Generates JSON of the notification a chunk at a time.  It keeps the
+// notification and the arena it was built in until all data are
+// generated.
+class NotificationSource : public BufferSource {
+public:
+  NotificationSource(std::shared_ptr<ValueBaseArena> arena,
+                     std::unique_ptr<ValueBase> notification)
+      : arena_{std::move(arena)}, notification_{std::move(notification)}
+  {
+    encoder_.pushValue(notification_.get());
+  }
+
+  virtual bool read(std::string& buf) CXX11_OVERRIDE
+  {
+    return encoder_.encode(buf, NOTIFICATION_CHUNK_SIZE);
+  }
+
+private:
+  // Declared first, so that it is destroyed after the notification.
+  std::shared_ptr<ValueBaseArena> arena_;
+  std::unique_ptr<ValueBase> notification_;
+  json::StreamEncoder encoder_;
+};
+} // namespace
+
+void WebSocketSession::setStatusSubscription(
+    std::unique_ptr<StatusSubscription> subscription)
+{
+  statusSubscription_ = std::move(subscription);
+}
+
+void WebSocketSession::addStatusChanges()
+{
+  if (!statusSubscription_ || !textSources_.empty() ||
+      statusSubscription_->getWait() > std::chrono::milliseconds(0)) {
+    return;
+  }
+  auto arena = std::make_shared<ValueBaseArena>();
+  ValueBaseArena::Scope arenaScope(*arena);
+  auto changes = statusSubscription_->collectChanges(e_);
+  if (changes->empty()) {
+    return;
+  }
+  auto dict = Dict::g();
+  dict->put("jsonrpc", "2.0");
+  dict->put("method", "aria2.onStatusChange");
+  dict->put("params", std::move(changes));
+  addTextMessage(
+      make_unique<NotificationSource>(std::move(arena), std::move(dict)));
+}
+
 bool WebSocketSession::closeReceived()
 {
   return wslay_event_get_close_received(wsctx_);
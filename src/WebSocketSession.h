@@ -38,6 +38,7 @@
 #include "common.h"
 
 #include <memory>
+#include <deque>
 
 #include <wslay/wslay.h>
 
@@ -47,10 +48,12 @@ namespace aria2 {
 
 class SocketCore;
 class DownloadEngine;
+struct BufferSource;
 
 namespace rpc {
 
 class WebSocketInteractionCommand;
+class StatusSubscription;
 
 class WebSocketSession {
 public:
@@ -75,6 +78,29 @@ public:
   // Adds text message |msg|. The message is queued and will be sent
   // in onWriteEvent().
   void addTextMessage(const std::string& msg, bool delayed);
+  // Adds text message generated by |source|.  The data are
+  // generated while the message is sent in onWriteEvent(), no faster
+  // than the remote endpoint reads them.
+  void addTextMessage(std::unique_ptr<BufferSource> source);
+  // Stores at most |len| bytes of the message added by
+  // addTextMessage(source) into |buf|.  This function is called by
+  // wslay in the order the messages were added.  This function
+  // returns the number of bytes stored, or -1.
+  ssize_t readTextMessage(uint8_t* buf, size_t len, int* eof);
+  // Replaces the status subscription of this session with
+  // |subscription|.  If |subscription| is nullptr, the subscription is
+  // canceled.
+  void
+  setStatusSubscription(std::unique_ptr<StatusSubscription> subscription);
+  StatusSubscription* getStatusSubscription() const
+  {
+    return statusSubscription_.get();
+  }
+  // Adds aria2.onStatusChange notification if the status subscription
+  // is due and any status changed.  Nothing is added while the
+  // previous message is still being sent, so that the slow remote
+  // endpoint receives fewer but larger notifications.
+  void addStatusChanges();
   // Returns true if the close frame is received.
   bool closeReceived();
   // Returns true if the close frame is sent.
@@ -109,6 +135,17 @@ private:
   int32_t receivedLength_;
   json::ValueBaseJsonParser parser_;
   WebSocketInteractionCommand* command_;
+
+  struct TextMessageSource {
+    std::unique_ptr<BufferSource> source;
+    // The chunk generated by source and the offset of unsent data.
+    std::string buf;
+    size_t offset;
+    bool eof;
+  };
+  // Messages added by addTextMessage(source) and not sent yet.
+  std::deque<TextMessageSource> textSources_;
+  std::unique_ptr<StatusSubscription> statusSubscription_;
 };
 
 } // namespace rpc
@@ -0,0 +1,112 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "WorkerThreadPool.h"
+
+namespace aria2 {
+
+#ifdef HAVE_STD_THREAD
+
+WorkerThreadPool::WorkerThreadPool(size_t numThreads)
+    : numThreads_(numThreads), numPending_(0), shutdown_(false)
+{
+  threads_.reserve(numThreads_);
+  for (size_t i = 0; i < numThreads_; ++i) {
+    threads_.emplace_back(&WorkerThreadPool::run, this);
+  }
+}
+
+WorkerThreadPool::~WorkerThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cond_.notify_all();
+  for (auto& t : threads_) {
+    t.join();
+  }
+}
+
+void WorkerThreadPool::submit(std::function<void()> job)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::move(job));
+    ++numPending_;
+  }
+  cond_.notify_one();
+}
+
+size_t WorkerThreadPool::countPendingJob() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return numPending_;
+}
+
+void WorkerThreadPool::run()
+{
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this]() { return shutdown_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
+        // shutdown_ is set and there is nothing left to do.
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    job();
+    std::lock_guard<std::mutex> lock(mutex_);
+    --numPending_;
+  }
+}
+
+#else // !HAVE_STD_THREAD
+
+WorkerThreadPool::WorkerThreadPool(size_t numThreads) : numThreads_(numThreads)
+{
+}
+
+WorkerThreadPool::~WorkerThreadPool() = default;
+
+void WorkerThreadPool::submit(std::function<void()> job) { job(); }
+
+size_t WorkerThreadPool::countPendingJob() const { return 0; }
+
+#endif // !HAVE_STD_THREAD
+
+} // namespace aria2
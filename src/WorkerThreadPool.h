@@ -0,0 +1,90 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_WORKER_THREAD_POOL_H
+#define D_WORKER_THREAD_POOL_H
+
+#include "common.h"
+
+#include <deque>
+#include <vector>
+#include <functional>
+#ifdef HAVE_STD_THREAD
+#  include <thread>
+#  include <mutex>
+#  include <condition_variable>
+#endif // HAVE_STD_THREAD
+
+namespace aria2 {
+
+// Fixed size pool of worker threads which run CPU bound jobs (e.g.,
+// hashing piece data) off the main event loop thread.  Jobs must not
+// touch any state shared with the main thread except for the data
+// handed over to them; they report back by setting flags which the
+// owning Command polls.  If aria2 is built without thread support,
+// submit() runs the job immediately in the calling thread.
+class WorkerThreadPool {
+public:
+  WorkerThreadPool(size_t numThreads);
+  // Waits for the queued and running jobs to finish and joins all
+  // threads.
+  ~WorkerThreadPool();
+
+  // Queues |job| for execution in one of the worker threads.  |job|
+  // must not throw.
+  void submit(std::function<void()> job);
+
+  size_t getNumThreads() const { return numThreads_; }
+
+  // Returns the number of jobs which are either queued or currently
+  // running.
+  size_t countPendingJob() const;
+
+private:
+  size_t numThreads_;
+#ifdef HAVE_STD_THREAD
+  void run();
+
+  std::vector<std::thread> threads_;
+  std::deque<std::function<void()>> jobs_;
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  size_t numPending_;
+  bool shutdown_;
+#endif // HAVE_STD_THREAD
+};
+
+} // namespace aria2
+
+#endif // D_WORKER_THREAD_POOL_H
@@ -35,14 +35,38 @@
 #include "WrDiskCache.h"
 
 #include <cassert>
+#include <algorithm>
 
 #include "WrDiskCacheEntry.h"
+#include "DiskWriteQueue.h"
+#include "DiskAdaptor.h"
+#include "RecoverableException.h"
+#include "wallclock.h"
 #include "LogFactory.h"
 #include "fmt.h"
 
 namespace aria2 {
 
-WrDiskCache::WrDiskCache(size_t limit) : limit_(limit), total_(0), clock_(0) {}
+namespace {
+// The cache is flushed down to this fraction of the limit, so that
+// data from many entries are written together.
+constexpr size_t LOW_WATERMARK_NUMER = 3;
+constexpr size_t LOW_WATERMARK_DENOM = 4;
+// The whole cache is flushed if it has not been flushed for this
+// long while data keep coming in.
+constexpr auto FLUSH_INTERVAL = 10_s;
+} // namespace
+
+WrDiskCache::WrDiskCache(size_t limit)
+    : limit_(limit),
+      total_(0),
+      clock_(0),
+      queue_(nullptr),
+      lastFlush_(global::wallclock()),
+      stat_{0, 0, 0, Timer::Clock::duration::zero(),
+            Timer::Clock::duration::zero()}
+{
+}
 
 WrDiskCache::~WrDiskCache()
 {
@@ -105,25 +129,143 @@ bool WrDiskCache::update(WrDiskCacheEntry* ent, ssize_t delta)
   }
   total_ += delta;
   ensureLimit();
+  if (delta > 0 &&
+      lastFlush_.difference(global::wallclock()) >= FLUSH_INTERVAL) {
+    A2_LOG_DEBUG("Flush cache entries by timer");
+    flush(0);
+  }
   return true;
 }
 
 void WrDiskCache::ensureLimit()
 {
-  while (total_ > limit_) {
-    auto i = set_.begin();
+  if (total_ > limit_) {
+    flush(limit_ / LOW_WATERMARK_DENOM * LOW_WATERMARK_NUMER);
+  }
+}
+
+void WrDiskCache::flush(size_t target)
+{
+  Timer timer;
+  std::vector<WrDiskCacheEntry*> entries;
+  size_t numBytes = 0;
+  for (auto i = std::begin(set_);
+       i != std::end(set_) && total_ > target && (*i)->getSize() > 0;) {
     WrDiskCacheEntry* ent = *i;
     A2_LOG_DEBUG(fmt("Force flush cache entry size=%lu, clock=%" PRId64,
                      static_cast<unsigned long>(ent->getSizeKey()),
                      ent->getLastUpdate()));
     total_ -= ent->getSize();
-    ent->writeToDisk();
-    set_.erase(i);
+    numBytes += ent->getSize();
+    entries.push_back(ent);
+    i = set_.erase(i);
+  }
+  lastFlush_ = global::wallclock();
+  if (entries.empty()) {
+    return;
+  }
 
+  std::sort(std::begin(entries), std::end(entries),
+            [](const WrDiskCacheEntry* a, const WrDiskCacheEntry* b) {
+              return a->getDiskAdaptor() < b->getDiskAdaptor();
+            });
+  size_t numWrites = 0;
+  for (auto first = std::begin(entries); first != std::end(entries);) {
+    auto last = std::find_if(first, std::end(entries),
+                             [first](const WrDiskCacheEntry* ent) {
+                               return ent->getDiskAdaptor() !=
+                                      (*first)->getDiskAdaptor();
+                             });
+    numWrites += writeEntries(first, last);
+    first = last;
+  }
+
+  for (auto ent : entries) {
     ent->setSizeKey(ent->getSize());
     ent->setLastUpdate(++clock_);
     set_.insert(ent);
   }
+
+  auto elapsed = timer.difference();
+  ++stat_.numFlushes;
+  stat_.numWrites += numWrites;
+  stat_.numBytes += numBytes;
+  stat_.totalFlushTime += elapsed;
+  stat_.maxFlushTime = std::max(stat_.maxFlushTime, elapsed);
+  A2_LOG_DEBUG(fmt("Flushed %lu cache entries, %lu bytes in %lu writes, "
+                   "%" PRId64 " us",
+                   static_cast<unsigned long>(entries.size()),
+                   static_cast<unsigned long>(numBytes),
+                   static_cast<unsigned long>(numWrites),
+                   static_cast<int64_t>(
+                       std::chrono::duration_cast<std::chrono::microseconds>(
+                           elapsed)
+                           .count())));
+}
+
+namespace {
+// Returns the number of contiguous ranges |dataSet| covers.
+size_t countRanges(const WrDiskCacheEntry::DataCellSet& dataSet)
+{
+  size_t n = 0;
+  int64_t end = -1;
+  for (auto& d : dataSet) {
+    if (d->goff != end) {
+      ++n;
+    }
+    end = d->goff + d->len;
+  }
+  return n;
+}
+} // namespace
+
+size_t WrDiskCache::writeEntries(
+    std::vector<WrDiskCacheEntry*>::const_iterator first,
+    std::vector<WrDiskCacheEntry*>::const_iterator last)
+{
+  auto& diskAdaptor = (*first)->getDiskAdaptor();
+  // Keep the order of writes to the same region.
+  for (auto i = first; i != last; ++i) {
+    (*i)->waitForPendingWrite();
+  }
+  const bool async = queue_ && !queue_->isFull();
+  WrDiskCacheEntry::DataCellSet dataSet;
+  size_t size = 0;
+  for (auto i = first; i != last; ++i) {
+    size += (*i)->getSize();
+    // The data cells of different entries never overlap because they
+    // belong to different pieces.
+    if (async) {
+      auto cells = (*i)->releaseDataSet();
+      dataSet.insert(std::begin(cells), std::end(cells));
+    }
+    else {
+      dataSet.insert(std::begin((*i)->getDataSet()),
+                     std::end((*i)->getDataSet()));
+    }
+  }
+  auto numWrites = countRanges(dataSet);
+  if (async) {
+    auto batch = queue_->write(diskAdaptor.get(), std::move(dataSet), size);
+    for (auto i = first; i != last; ++i) {
+      (*i)->setPendingWrite(batch);
+    }
+  }
+  else {
+    try {
+      diskAdaptor->writeDataCells(dataSet);
+    }
+    catch (RecoverableException& e) {
+      A2_LOG_ERROR_EX("Error when trying to flush write cache", e);
+      for (auto i = first; i != last; ++i) {
+        (*i)->setError(e.getErrorCode());
+      }
+    }
+    for (auto i = first; i != last; ++i) {
+      (*i)->clear();
+    }
+  }
+  return numWrites;
 }
 
 } // namespace aria2
@@ -38,15 +38,32 @@
 #include "common.h"
 
 #include <set>
+#include <vector>
 
 #include "a2functional.h"
+#include "TimerA2.h"
 
 namespace aria2 {
 
 class WrDiskCacheEntry;
+class DiskWriteQueue;
 
 class WrDiskCache {
 public:
+  struct Stat {
+    // The number of times the cached data were flushed by this
+    // object.
+    uint64_t numFlushes;
+    // The number of contiguous ranges written by the flushes.
+    uint64_t numWrites;
+    // The number of bytes written by the flushes.
+    uint64_t numBytes;
+    // The total and the maximum time spent in a flush, including the
+    // time to hand the data over to DiskWriteQueue.
+    Timer::Clock::duration totalFlushTime;
+    Timer::Clock::duration maxFlushTime;
+  };
+
   WrDiskCache(size_t limit);
   ~WrDiskCache();
   // Adds the cache entry |ent| to the storage. The size of cached
@@ -59,19 +76,37 @@ public:
   // bytes is increased in this update. If the size is reduced, use
   // negative value.
   bool update(WrDiskCacheEntry* ent, ssize_t delta);
-  // Evicts entries from storage so that total size of cache is kept
-  // under the limit.
+  // If the total size of cache exceeds the limit, flushes entries
+  // until it goes down to 3/4 of the limit.
   void ensureLimit();
   size_t getSize() const { return total_; }
+  // If |queue| is not nullptr, flushed data are handed over to
+  // |queue| unless it is full.
+  void setDiskWriteQueue(DiskWriteQueue* queue) { queue_ = queue; }
+  const Stat& getStat() const { return stat_; }
 
 private:
   typedef std::set<WrDiskCacheEntry*, DerefLess<WrDiskCacheEntry*>> EntrySet;
+  // Flushes the largest entries until the total size of cache is
+  // |target| bytes or less.  The data of the flushed entries are
+  // merged per DiskAdaptor and written in the order of offset, so
+  // that adjacent data from different entries are written at once.
+  void flush(size_t target);
+  // Writes the data of |first|..|last|, which share the same
+  // DiskAdaptor, and returns the number of contiguous ranges.
+  size_t writeEntries(std::vector<WrDiskCacheEntry*>::const_iterator first,
+                      std::vector<WrDiskCacheEntry*>::const_iterator last);
   // Maximum number of bytes the storage can cache.
   size_t limit_;
   // Current number of bytes cached.
   size_t total_;
   EntrySet set_;
   int64_t clock_;
+  DiskWriteQueue* queue_;
+  // The time of the last flush.  The whole cache is flushed if it
+  // has not been flushed for a while.
+  Timer lastFlush_;
+  Stat stat_;
 };
 
 } // namespace aria2
@@ -35,8 +35,11 @@
 #include "WrDiskCacheEntry.h"
 
 #include <cstring>
+#include <cassert>
 
 #include "DiskAdaptor.h"
+#include "DiskWriteQueue.h"
+#include "BufferPool.h"
 #include "RecoverableException.h"
 #include "DownloadFailureException.h"
 #include "LogFactory.h"
@@ -67,7 +70,7 @@ WrDiskCacheEntry::~WrDiskCacheEntry()
 void WrDiskCacheEntry::deleteDataCells()
 {
   for (auto& e : set_) {
-    delete[] e->data;
+    BufferPool::getInstance().deallocate(e->data);
     delete e;
   }
   set_.clear();
@@ -76,17 +79,52 @@ void WrDiskCacheEntry::deleteDataCells()
 
 void WrDiskCacheEntry::writeToDisk()
 {
+  // Keep the order of writes to the same region.
+  waitForPendingWrite();
   try {
     diskAdaptor_->writeCache(this);
   }
   catch (RecoverableException& e) {
     A2_LOG_ERROR_EX("Error when trying to flush write cache", e);
-    error_ = CACHE_ERR_ERROR;
-    errorCode_ = e.getErrorCode();
+    setError(e.getErrorCode());
   }
   deleteDataCells();
 }
 
+WrDiskCacheEntry::DataCellSet WrDiskCacheEntry::releaseDataSet()
+{
+  DataCellSet dataSet;
+  dataSet.swap(set_);
+  size_ = 0;
+  return dataSet;
+}
+
+void WrDiskCacheEntry::setPendingWrite(std::shared_ptr<DiskWriteBatch> batch)
+{
+  assert(!pendingWrite_);
+  pendingWrite_ = std::move(batch);
+}
+
+void WrDiskCacheEntry::setError(error_code::Value errorCode)
+{
+  error_ = CACHE_ERR_ERROR;
+  errorCode_ = errorCode;
+}
+
+void WrDiskCacheEntry::waitForPendingWrite()
+{
+  if (!pendingWrite_) {
+    return;
+  }
+  pendingWrite_->wait();
+  if (pendingWrite_->failed()) {
+    A2_LOG_ERROR(fmt("Error when trying to flush write cache\n%s",
+                     pendingWrite_->getErrorMessage().c_str()));
+    setError(pendingWrite_->getErrorCode());
+  }
+  pendingWrite_.reset();
+}
+
 void WrDiskCacheEntry::clear() { deleteDataCells(); }
 
 bool WrDiskCacheEntry::cacheData(DataCell* dataCell)
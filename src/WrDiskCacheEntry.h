@@ -47,6 +47,7 @@ namespace aria2 {
 
 class DiskAdaptor;
 class WrDiskCache;
+class DiskWriteBatch;
 
 class WrDiskCacheEntry {
 public:
@@ -70,6 +71,19 @@ public:
 
   // Flushes the cached data to the disk and deletes them.
   void writeToDisk();
+  // Moves the cached data out of this object.  The caller takes the
+  // ownership of the returned data cells.
+  DataCellSet releaseDataSet();
+  // Makes waitForPendingWrite() wait for |batch|, which writes the
+  // data released from this object in background.  Call
+  // waitForPendingWrite() before reading the range back from the
+  // disk.
+  void setPendingWrite(std::shared_ptr<DiskWriteBatch> batch);
+  // Waits for the write set by setPendingWrite() to finish.  If it
+  // failed, the error is recorded to this object.
+  void waitForPendingWrite();
+  // Records that writing the cached data failed with |errorCode|.
+  void setError(error_code::Value errorCode);
   // Deletes cached data without flushing to the disk.
   void clear();
 
@@ -98,6 +112,11 @@ public:
 
   const DataCellSet& getDataSet() const { return set_; }
 
+  const std::shared_ptr<DiskAdaptor>& getDiskAdaptor() const
+  {
+    return diskAdaptor_;
+  }
+
 private:
   void deleteDataCells();
 
@@ -112,6 +131,8 @@ private:
   error_code::Value errorCode_;
 
   std::shared_ptr<DiskAdaptor> diskAdaptor_;
+
+  std::shared_ptr<DiskWriteBatch> pendingWrite_;
 };
 
 } // namespace aria2
@@ -52,6 +52,9 @@
 #ifdef HAVE_SHARE_H
 #  include <share.h>
 #endif // HAVE_SHARE_H
+#ifdef HAVE_SYS_SENDFILE_H
+#  include <sys/sendfile.h>
+#endif // HAVE_SYS_SENDFILE_H
 
 // in some platforms following definitions are missing:
 #ifndef EINPROGRESS
@@ -166,6 +169,12 @@ extern int ftruncate64(int fd, off64_t length);
 }
 #  endif
 #  define a2ftruncate(fd, length) ftruncate64(fd, length)
+#  define a2pread(fd, buf, count, offset) pread64(fd, buf, count, offset)
+#  define a2pwrite(fd, buf, count, offset) pwrite64(fd, buf, count, offset)
+#  define a2pwritev(fd, iov, iovcnt, offset)                                   \
+    pwritev64(fd, iov, iovcnt, offset)
+#  define a2sendfile(outfd, infd, offset, count)                               \
+    sendfile64(outfd, infd, offset, count)
 // Use off64_t directly since android does not offer transparent
 // switching between off_t and off64_t.
 #  define a2_off_t off64_t
@@ -184,9 +193,21 @@ extern int ftruncate64(int fd, off64_t length);
 #  define a2open(path, flags, mode) open(path, flags, mode)
 #  define a2fopen(path, mode) fopen(path, mode)
 #  define a2ftruncate(fd, length) ftruncate(fd, length)
+#  define a2pread(fd, buf, count, offset) pread(fd, buf, count, offset)
+#  define a2pwrite(fd, buf, count, offset) pwrite(fd, buf, count, offset)
+#  define a2pwritev(fd, iov, iovcnt, offset) pwritev(fd, iov, iovcnt, offset)
+#  define a2sendfile(outfd, infd, offset, count)                               \
+    sendfile(outfd, infd, offset, count)
 #  define a2_off_t off_t
 #endif
 
+// Linux and Solaris flavor of sendfile(2), which sends a file range
+// to a socket.
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H) &&                  \
+    !defined(__MINGW32__)
+#  define A2_HAVE_SENDFILE 1
+#endif
+
 #define OPEN_MODE S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH
 #define DIR_OPEN_MODE S_IRWXU | S_IRWXG | S_IRWXO
 
@@ -133,6 +133,16 @@ struct Endpoint {
   uint16_t port;
 };
 
+// Buffer for a datagram received by SocketCore::readDataFrom().
+struct Datagram {
+  // Buffer to store the datagram and its size, set by the caller.
+  unsigned char* data;
+  size_t capacity;
+  // The length of the received datagram.
+  size_t length;
+  Endpoint sender;
+};
+
 #define A2_DEFAULT_IOV_MAX 128
 
 #if defined(IOV_MAX) && IOV_MAX < A2_DEFAULT_IOV_MAX
@@ -62,6 +62,9 @@
 #include "SingletonHolder.h"
 #include "Notifier.h"
 #include "ApiCallbackDownloadEventListener.h"
+#include "ApiDownloadEventQueue.h"
+#include "ApiPostCommand.h"
+#include "WakeupFd.h"
 #ifdef ENABLE_BITTORRENT
 #  include "bittorrent_helper.h"
 #endif // ENABLE_BITTORRENT
@@ -69,7 +72,8 @@
 namespace aria2 {
 
 Session::Session(const KeyVals& options)
-    : context(std::make_shared<Context>(false, 0, nullptr, options))
+    : context(std::make_shared<Context>(false, 0, nullptr, options)),
+      postClosed(false)
 {
 }
 
@@ -79,7 +83,8 @@ SessionConfig::SessionConfig()
     : keepRunning(false),
       useSignalHandler(true),
       downloadEventCallback(nullptr),
-      userData(nullptr)
+      userData(nullptr),
+      useEventQueue(false)
 {
 }
 
@@ -137,6 +142,26 @@ Session* sessionNew(const KeyVals& options, const SessionConfig& config)
       SingletonHolder<Notifier>::instance()->addDownloadEventListener(
           session->listener.get());
     }
+    if (config.useEventQueue) {
+      try {
+        session->eventQueue = make_unique<ApiDownloadEventQueue>();
+      }
+      catch (RecoverableException& e) {
+        A2_LOG_ERROR_EX(EX_EXCEPTION_CAUGHT, e);
+        return nullptr;
+      }
+      SingletonHolder<Notifier>::instance()->addDownloadEventListener(
+          session->eventQueue.get());
+    }
+    try {
+      session->postWakeup = make_unique<WakeupFd>();
+    }
+    catch (RecoverableException& e) {
+      A2_LOG_ERROR_EX(EX_EXCEPTION_CAUGHT, e);
+      return nullptr;
+    }
+    e->addCommand(
+        make_unique<ApiPostCommand>(e->newCUID(), e.get(), session.get()));
   }
   else {
     return nullptr;
@@ -157,6 +182,43 @@ int run(Session* session, RUN_MODE mode)
   return e->run(mode == RUN_ONCE);
 }
 
+int post(Session* session, PostedFunction func)
+{
+#ifdef HAVE_STD_THREAD
+  std::lock_guard<std::mutex> lock(session->postMutex);
+#endif // HAVE_STD_THREAD
+  if (session->postClosed) {
+    return -1;
+  }
+  if (session->postQueue.push(std::move(func))) {
+    session->postWakeup->notify();
+  }
+  return 0;
+}
+
+int pollDownloadEvent(Session* session, DownloadEvent* event, A2Gid* gid)
+{
+  if (!session->eventQueue) {
+    return -1;
+  }
+  DownloadEvent ev;
+  A2Gid evgid;
+  if (!session->eventQueue->pop(ev, evgid)) {
+    return 0;
+  }
+  *event = ev;
+  *gid = evgid;
+  return 1;
+}
+
+int getDownloadEventFd(Session* session)
+{
+  if (!session->eventQueue) {
+    return -1;
+  }
+  return session->eventQueue->getFd();
+}
+
 int shutdown(Session* session, bool force)
 {
   auto& e = session->context->reqinfo->getDownloadEngine();
@@ -38,19 +38,40 @@
 #include "common.h"
 
 #include <memory>
+#ifdef HAVE_STD_THREAD
+#  include <mutex>
+#endif // HAVE_STD_THREAD
 
 #include <aria2/aria2.h>
 
+#include "MpscQueue.h"
+
 namespace aria2 {
 
 struct Context;
 class ApiCallbackDownloadEventListener;
+class ApiDownloadEventQueue;
+class WakeupFd;
 
 struct Session {
   Session(const KeyVals& options);
   ~Session();
+  // Wakes up ApiPostCommand when a function is posted.  Declared
+  // before context, so that it outlives ApiPostCommand.
+  std::unique_ptr<WakeupFd> postWakeup;
   std::shared_ptr<Context> context;
   std::unique_ptr<ApiCallbackDownloadEventListener> listener;
+  // Functions posted by post() and not run yet.
+  MpscQueue<PostedFunction> postQueue;
+  // True if ApiPostCommand has exited, and post() refuses functions.
+  bool postClosed;
+#ifdef HAVE_STD_THREAD
+  // Guards postClosed, so that post() either queues a function
+  // before ApiPostCommand runs the queued ones for the last time, or
+  // fails.
+  std::mutex postMutex;
+#endif // HAVE_STD_THREAD
+  std::unique_ptr<ApiDownloadEventQueue> eventQueue;
 };
 
 } // namespace aria2
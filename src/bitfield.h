@@ -94,6 +94,33 @@ inline size_t countBit32(uint32_t n)
          cntbits[(n >> 16) & 0xffu] + cntbits[(n >> 24) & 0xffu];
 }
 
+inline size_t countBit64(uint64_t n)
+{
+#ifdef __GNUC__
+  return __builtin_popcountll(n);
+#else  // !__GNUC__
+  n = n - ((n >> 1) & 0x5555555555555555ULL);
+  n = (n & 0x3333333333333333ULL) + ((n >> 2) & 0x3333333333333333ULL);
+  n = (n + (n >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return (n * 0x0101010101010101ULL) >> 56;
+#endif // !__GNUC__
+}
+
+// The functions below process bitfields 64 bits at a time.  Words
+// are loaded in the host byte order, which is fine because they are
+// only combined bitwise, counted, or tested against zero.
+inline uint64_t loadWord(const unsigned char* p)
+{
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline void storeWord(unsigned char* p, uint64_t v)
+{
+  memcpy(p, &v, sizeof(v));
+}
+
 // Counts set bit in bitfield.
 inline size_t countSetBit(const unsigned char* bitfield, size_t nbits)
 {
@@ -101,22 +128,36 @@ inline size_t countSetBit(const unsigned char* bitfield, size_t nbits)
     return 0;
   }
   size_t count = 0;
-  size_t size = sizeof(uint32_t);
-  size_t len = (nbits + 7) / 8;
-  if (nbits % 32 != 0) {
-    --len;
-    count +=
-        countBit32(static_cast<uint32_t>(bitfield[len] & lastByteMask(nbits)));
-  }
-  size_t to = len / size;
-  for (size_t i = 0; i < to; ++i) {
-    uint32_t v;
-    memcpy(&v, &bitfield[i * size], sizeof(v));
-    count += countBit32(v);
-  }
-  for (size_t i = len - len % size; i < len; ++i) {
-    count += countBit32(static_cast<uint32_t>(bitfield[i]));
+  // The last byte is masked separately.
+  size_t len = (nbits + 7) / 8 - 1;
+  size_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    count += countBit64(loadWord(bitfield + i));
   }
+  for (; i < len; ++i) {
+    count += cntbits[bitfield[i]];
+  }
+  count += cntbits[bitfield[len] & lastByteMask(nbits)];
+  return count;
+}
+
+// Counts set bit in bitwise AND of bitfields a and b.
+inline size_t countSetBitAnd(const unsigned char* a, const unsigned char* b,
+                             size_t nbits)
+{
+  if (nbits == 0) {
+    return 0;
+  }
+  size_t count = 0;
+  size_t len = (nbits + 7) / 8 - 1;
+  size_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    count += countBit64(loadWord(a + i) & loadWord(b + i));
+  }
+  for (; i < len; ++i) {
+    count += cntbits[a[i] & b[i]];
+  }
+  count += cntbits[a[len] & b[len] & lastByteMask(nbits)];
   return count;
 }
 
@@ -142,6 +183,73 @@ size_t countSetBitSlow(const Array& bitfield, size_t nbits)
 
 void flipBit(unsigned char* data, size_t length, size_t bitIndex);
 
+// Calls f(i) for each set bit index i in bitfield in ascending
+// order.  bitfield contains nbits bits.  Zero words are skipped as a
+// whole, so this is fast for sparse bitfields.
+template <typename F>
+void forEachSetBit(const unsigned char* bitfield, size_t nbits, F f)
+{
+  if (nbits == 0) {
+    return;
+  }
+  size_t len = (nbits + 7) / 8 - 1;
+  size_t i = 0;
+  auto eachByte = [&f](unsigned char c, size_t base) {
+    for (; c; c <<= 1, ++base) {
+      if (c & 0x80u) {
+        f(base);
+      }
+    }
+  };
+  for (; i + 8 <= len; i += 8) {
+    if (loadWord(bitfield + i) == 0) {
+      continue;
+    }
+    for (size_t j = i; j < i + 8; ++j) {
+      eachByte(bitfield[j], j * 8);
+    }
+  }
+  for (; i < len; ++i) {
+    eachByte(bitfield[i], i * 8);
+  }
+  eachByte(bitfield[len] & lastByteMask(nbits), len * 8);
+}
+
+// Calls f(i, inA) for each bit index i which differs between
+// bitfields a and b, in ascending order.  inA is true if the bit is
+// set in a, which means that it is not set in b.  Both bitfields
+// contain nbits bits.
+template <typename F>
+void forEachDiffBit(const unsigned char* a, const unsigned char* b,
+                    size_t nbits, F f)
+{
+  if (nbits == 0) {
+    return;
+  }
+  size_t len = (nbits + 7) / 8 - 1;
+  size_t i = 0;
+  auto eachByte = [&f](unsigned char ca, unsigned char cb, size_t base) {
+    for (unsigned char d = ca ^ cb; d; d <<= 1, ca <<= 1, ++base) {
+      if (d & 0x80u) {
+        f(base, (ca & 0x80u) != 0);
+      }
+    }
+  };
+  for (; i + 8 <= len; i += 8) {
+    if (loadWord(a + i) == loadWord(b + i)) {
+      continue;
+    }
+    for (size_t j = i; j < i + 8; ++j) {
+      eachByte(a[j], b[j], j * 8);
+    }
+  }
+  for (; i < len; ++i) {
+    eachByte(a[i], b[i], i * 8);
+  }
+  unsigned char mask = lastByteMask(nbits);
+  eachByte(a[len] & mask, b[len] & mask, len * 8);
+}
+
 // Stores first set bit index of bitfield to index.  bitfield contains
 // nbits. Returns true if set bit is found. Otherwise returns false.
 template <typename Array>
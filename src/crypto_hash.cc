@@ -93,6 +93,16 @@ protected:
 
   virtual void transform(const word_t* buffer) = 0;
 
+  // Transforms |nblocks| consecutive blocks.  Implementations using CPU
+  // extensions override this to keep the state in registers across
+  // blocks.
+  virtual void transformBlocks(const word_t* buffer, size_t nblocks)
+  {
+    for (; nblocks; --nblocks, buffer += bsize) {
+      transform(buffer);
+    }
+  }
+
   virtual std::string digest()
   {
     return std::string((const char*)state_.bytes, sizeof(state_.bytes));
@@ -125,13 +135,13 @@ public:
     }
 
     // |transform| as many blocks as possible.
-    while (len >= sizeof(buffer_)) {
+    if (len >= sizeof(buffer_)) {
       // |offset_| has to be 0 at this point!
       // Which is guaranteed by the block above.
-
-      transform(reinterpret_cast<const word_t*>(bytes));
-      bytes += sizeof(buffer_);
-      len -= sizeof(buffer_);
+      const uint64_t nblocks = len / sizeof(buffer_);
+      transformBlocks(reinterpret_cast<const word_t*>(bytes), nblocks);
+      bytes += nblocks * sizeof(buffer_);
+      len -= nblocks * sizeof(buffer_);
     }
 
     // Buffer remaining bytes, if any.
@@ -1024,6 +1034,187 @@ const SHA384::word_t SHA384::initvec[] = {
     0x152fecd8f70e5939, 0x67332667ffc00b31, 0x8eb44a8768581511,
     0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4};
 
+// SHA-1 and SHA-256 using the x86 SHA extensions.  They are compiled
+// with the target attribute, and only used if CPUID says the CPU
+// supports them.
+#if defined(__GNUG__) && (defined(__x86_64__) || defined(__i386__))
+#  define CRYPTO_HASH_X86_SHA 1
+#  include <cpuid.h>
+#  include <immintrin.h>
+
+#  define __hash_x86_sha __attribute__((target("sha,sse4.1,ssse3")))
+
+static bool cpuHasSHA()
+{
+  unsigned int a, b, c, d;
+  if (!__get_cpuid(1, &a, &b, &c, &d) || !(c & bit_SSSE3) ||
+      !(c & bit_SSE4_1)) {
+    return false;
+  }
+  if (__get_cpuid_max(0, nullptr) < 7) {
+    return false;
+  }
+  __cpuid_count(7, 0, a, b, c, d);
+  // EBX bit 29: SHA extensions
+  return (b & (1u << 29)) != 0;
+}
+
+static const bool hasSHA = cpuHasSHA();
+
+// The message words are big endian.
+#  define __hash_x86_sha1_load(i)                                              \
+    _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(         \
+                         reinterpret_cast<const uint8_t*>(buffer) + (i)*16)),  \
+                     _mm_set_epi64x(0x0001020304050607ULL,                     \
+                                    0x08090a0b0c0d0e0fULL))
+
+// Computes the message words of rounds 4g to 4g+3 into w[g % 4] from
+// those of the previous 4 groups, for g >= 4.
+#  define __hash_x86_sha1_schedule(g)                                          \
+    w[(g) % 4] = _mm_sha1msg2_epu32(                                           \
+        _mm_xor_si128(_mm_sha1msg1_epu32(w[(g) % 4], w[((g) + 1) % 4]),        \
+                      w[((g) + 2) % 4]),                                       \
+        w[((g) + 3) % 4])
+
+// Rounds 4g to 4g+3.  prev holds the state before the previous 4
+// rounds, from which sha1nexte derives E.
+#  define __hash_x86_sha1_rounds(g)                                            \
+    e = _mm_sha1nexte_epu32(prev, w[(g) % 4]);                                 \
+    prev = abcd;                                                               \
+    abcd = _mm_sha1rnds4_epu32(abcd, e, (g) / 5)
+
+template <typename Base> class SHA1X86 : public Base {
+protected:
+  typedef typename Base::word_t word_t;
+
+  virtual void transform(const word_t* buffer) { transformBlocks(buffer, 1); }
+
+  __hash_x86_sha virtual void transformBlocks(const word_t* buffer,
+                                              size_t nblocks)
+  {
+    auto state = this->state_.words;
+    __m128i abcd = _mm_shuffle_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1b);
+    __m128i e0 = _mm_set_epi32(state[4], 0, 0, 0);
+    __m128i e, prev, w[4];
+    for (; nblocks; --nblocks, buffer += 16) {
+      const __m128i abcdSave = abcd;
+      const __m128i e0Save = e0;
+
+      w[0] = __hash_x86_sha1_load(0);
+      w[1] = __hash_x86_sha1_load(1);
+      w[2] = __hash_x86_sha1_load(2);
+      w[3] = __hash_x86_sha1_load(3);
+
+      e = _mm_add_epi32(e0, w[0]);
+      prev = abcd;
+      abcd = _mm_sha1rnds4_epu32(abcd, e, 0);
+      __hash_x86_sha1_rounds(1);
+      __hash_x86_sha1_rounds(2);
+      __hash_x86_sha1_rounds(3);
+      __hash_x86_sha1_schedule(4), __hash_x86_sha1_rounds(4);
+      __hash_x86_sha1_schedule(5), __hash_x86_sha1_rounds(5);
+      __hash_x86_sha1_schedule(6), __hash_x86_sha1_rounds(6);
+      __hash_x86_sha1_schedule(7), __hash_x86_sha1_rounds(7);
+      __hash_x86_sha1_schedule(8), __hash_x86_sha1_rounds(8);
+      __hash_x86_sha1_schedule(9), __hash_x86_sha1_rounds(9);
+      __hash_x86_sha1_schedule(10), __hash_x86_sha1_rounds(10);
+      __hash_x86_sha1_schedule(11), __hash_x86_sha1_rounds(11);
+      __hash_x86_sha1_schedule(12), __hash_x86_sha1_rounds(12);
+      __hash_x86_sha1_schedule(13), __hash_x86_sha1_rounds(13);
+      __hash_x86_sha1_schedule(14), __hash_x86_sha1_rounds(14);
+      __hash_x86_sha1_schedule(15), __hash_x86_sha1_rounds(15);
+      __hash_x86_sha1_schedule(16), __hash_x86_sha1_rounds(16);
+      __hash_x86_sha1_schedule(17), __hash_x86_sha1_rounds(17);
+      __hash_x86_sha1_schedule(18), __hash_x86_sha1_rounds(18);
+      __hash_x86_sha1_schedule(19), __hash_x86_sha1_rounds(19);
+
+      e0 = _mm_sha1nexte_epu32(prev, e0Save);
+      abcd = _mm_add_epi32(abcd, abcdSave);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+                     _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = _mm_extract_epi32(e0, 3);
+  }
+};
+
+#  undef __hash_x86_sha1_rounds
+#  undef __hash_x86_sha1_schedule
+#  undef __hash_x86_sha1_load
+
+static const uint32_t sha256K[] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+// Works for SHA-224 as well, which only differs in the initial state
+// and the digest length.
+template <typename Base> class SHA256X86 : public Base {
+protected:
+  typedef typename Base::word_t word_t;
+
+  virtual void transform(const word_t* buffer) { transformBlocks(buffer, 1); }
+
+  __hash_x86_sha virtual void transformBlocks(const word_t* buffer,
+                                              size_t nblocks)
+  {
+    const __m128i mask =
+        _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    auto state = this->state_.words;
+    // The instructions take the state as ABEF and CDGH.
+    __m128i tmp = _mm_shuffle_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xb1);
+    __m128i state1 = _mm_shuffle_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1b);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+    __m128i w[4];
+    for (; nblocks; --nblocks, buffer += 16) {
+      const __m128i state0Save = state0;
+      const __m128i state1Save = state1;
+      for (int g = 0; g < 16; ++g) {
+        __m128i& wg = w[g % 4];
+        if (g < 4) {
+          wg = _mm_shuffle_epi8(
+              _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer) + g),
+              mask);
+        }
+        else {
+          wg = _mm_sha256msg2_epu32(
+              _mm_add_epi32(_mm_sha256msg1_epu32(wg, w[(g + 1) % 4]),
+                            _mm_alignr_epi8(w[(g + 3) % 4], w[(g + 2) % 4], 4)),
+              w[(g + 3) % 4]);
+        }
+        __m128i msg = _mm_add_epi32(
+            wg, _mm_loadu_si128(reinterpret_cast<const __m128i*>(sha256K) + g));
+        state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+        state0 = _mm_sha256rnds2_epu32(state0, state1,
+                                       _mm_shuffle_epi32(msg, 0x0e));
+      }
+      state0 = _mm_add_epi32(state0, state0Save);
+      state1 = _mm_add_epi32(state1, state1Save);
+    }
+    tmp = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+                     _mm_blend_epi16(tmp, state1, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4),
+                     _mm_alignr_epi8(state1, tmp, 8));
+  }
+};
+
+#  undef __hash_x86_sha
+#endif // defined(__GNUG__) && (defined(__x86_64__) || defined(__i386__))
+
 namespace {
 // For |all|
 static const std::set<std::string> names{
@@ -1053,6 +1244,35 @@ Algorithms crypto::hash::lookup(const std::string& name)
 }
 
 std::unique_ptr<Algorithm> crypto::hash::create(Algorithms algo)
+{
+  switch (algo) {
+#ifdef CRYPTO_HASH_X86_SHA
+  case algoSHA1:
+    if (hasSHA) {
+      return aria2::make_unique<SHA1X86<SHA1>>();
+    }
+    break;
+
+  case algoSHA224:
+    if (hasSHA) {
+      return aria2::make_unique<SHA256X86<SHA224>>();
+    }
+    break;
+
+  case algoSHA256:
+    if (hasSHA) {
+      return aria2::make_unique<SHA256X86<SHA256>>();
+    }
+    break;
+#endif // CRYPTO_HASH_X86_SHA
+
+  default:
+    break;
+  }
+  return createPortable(algo);
+}
+
+std::unique_ptr<Algorithm> crypto::hash::createPortable(Algorithms algo)
 {
   switch (algo) {
   case algoMD5:
@@ -58,6 +58,11 @@ Algorithms lookup(const std::string& name);
 
 std::unique_ptr<Algorithm> create(Algorithms algo);
 
+// Same as create(), but never uses the instructions which only some
+// CPUs have, such as the x86 SHA extensions.  Useful to check the
+// accelerated implementations against.
+std::unique_ptr<Algorithm> createPortable(Algorithms algo);
+
 inline std::unique_ptr<Algorithm> create(const std::string& name)
 {
   return create(lookup(name));
@@ -41,6 +41,7 @@
 
 #include <string>
 #include <vector>
+#include <functional>
 
 // Libaria2: The aim of this library is provide same functionality
 // available in RPC methods. The function signatures are not
@@ -192,6 +193,13 @@ struct SessionConfig {
    * pointer and will not free it. The default value is ``NULL``.
    */
   void* userData;
+  /**
+   * If the |useEventQueue| member is true, download events are also
+   * stored in a queue, so that a thread other than the one calling
+   * :func:`run()` can retrieve them with
+   * :func:`pollDownloadEvent()`. The default value is false.
+   */
+  bool useEventQueue;
 };
 
 /**
@@ -573,6 +581,56 @@ int changePosition(Session* session, A2Gid gid, int pos, OffsetMode how);
  */
 int shutdown(Session* session, bool force = false);
 
+/**
+ * @functypedef
+ *
+ * Function queued by :func:`post()`.  It is called with the session
+ * in the thread which calls :func:`run()`, where it can call any API
+ * function.
+ */
+typedef std::function<void(Session* session)> PostedFunction;
+
+/**
+ * @function
+ *
+ * Queues the |func| to be called in the thread which calls
+ * :func:`run()`.  Unlike the other API functions, this function can
+ * be called from any thread, for example, to add, pause or remove
+ * downloads.  The thread blocked in :func:`run()` wakes up
+ * immediately to call the queued functions in the order they were
+ * queued.  The functions queued before :func:`run()` stops
+ * processing, because shutdown was requested or no download is left,
+ * are called before it returns.  After that, this function fails.
+ * This function returns 0 if it succeeds, or negative error code.
+ */
+int post(Session* session, PostedFunction func);
+
+/**
+ * @function
+ *
+ * Retrieves the oldest download event stored in the queue enabled by
+ * :member:`SessionConfig::useEventQueue`, and stores it in the
+ * |*event| and the |*gid|.  This function can be called from a thread
+ * other than the one which calls :func:`run()`, but only from one
+ * thread at a time.  It does not block.  This function returns 1 if
+ * an event is retrieved, 0 if the queue is empty, or negative error
+ * code if the queue is not enabled.
+ */
+int pollDownloadEvent(Session* session, DownloadEvent* event, A2Gid* gid);
+
+/**
+ * @function
+ *
+ * Returns the file descriptor which becomes readable when a download
+ * event is stored in the queue enabled by
+ * :member:`SessionConfig::useEventQueue`.  The application can wait
+ * for it with :manpage:`poll(2)` and then call
+ * :func:`pollDownloadEvent()` until it returns 0.  The application
+ * must not read or close the descriptor.  This function returns -1
+ * if the queue is not enabled or the platform does not support it.
+ */
+int getDownloadEventFd(Session* session);
+
 /**
  * @enum
  *
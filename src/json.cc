@@ -45,9 +45,8 @@ namespace aria2 {
 
 namespace json {
 
-std::string jsonEscape(const std::string& s)
+void jsonEscape(std::string& t, const std::string& s)
 {
-  std::string t;
   for (std::string::const_iterator i = s.begin(), eoi = s.end(); i != eoi;
        ++i) {
     if (*i == '"' || *i == '\\' || *i == '/') {
@@ -89,6 +88,12 @@ std::string jsonEscape(const std::string& s)
       t.append(i, i + 1);
     }
   }
+}
+
+std::string jsonEscape(const std::string& s)
+{
+  std::string t;
+  jsonEscape(t, s);
   return t;
 }
 
@@ -99,6 +104,147 @@ std::string encode(const ValueBase* json)
   return encode(out, json).str();
 }
 
+namespace {
+// Appends scalar values to out_.  Containers are only recorded, so
+// that StreamEncoder can serialize them step by step.
+class StreamValueBaseVisitor : public ValueBaseVisitor {
+public:
+  StreamValueBaseVisitor(std::string& out)
+      : out_(out), list{nullptr}, dict{nullptr}
+  {
+  }
+
+  virtual void visit(const String& string) CXX11_OVERRIDE
+  {
+    out_ += '"';
+    jsonEscape(out_, string.s());
+    out_ += '"';
+  }
+
+  virtual void visit(const Integer& integer) CXX11_OVERRIDE
+  {
+    out_ += util::itos(integer.i());
+  }
+
+  virtual void visit(const Bool& boolValue) CXX11_OVERRIDE
+  {
+    out_ += boolValue.val() ? "true" : "false";
+  }
+
+  virtual void visit(const Null& nullValue) CXX11_OVERRIDE { out_ += "null"; }
+
+  virtual void visit(const List& v) CXX11_OVERRIDE { list = &v; }
+
+  virtual void visit(const Dict& v) CXX11_OVERRIDE { dict = &v; }
+
+private:
+  std::string& out_;
+
+public:
+  const List* list;
+  const Dict* dict;
+};
+} // namespace
+
+StreamEncoder::StreamEncoder() {}
+
+StreamEncoder::~StreamEncoder() {}
+
+void StreamEncoder::pushText(std::string text)
+{
+  queue_.emplace_back(Frame::TEXT, nullptr);
+  queue_.back().text = std::move(text);
+}
+
+void StreamEncoder::pushValue(const ValueBase* json)
+{
+  queue_.emplace_back(Frame::VALUE, json);
+}
+
+bool StreamEncoder::encode(std::string& out, size_t length)
+{
+  while (out.size() < length) {
+    if (stack_.empty()) {
+      if (queue_.empty()) {
+        return true;
+      }
+      stack_.push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    step(out);
+  }
+  return finished();
+}
+
+bool StreamEncoder::finished() const
+{
+  return stack_.empty() && queue_.empty();
+}
+
+void StreamEncoder::step(std::string& out)
+{
+  auto& frame = stack_.back();
+  switch (frame.type) {
+  case Frame::TEXT:
+    out += frame.text;
+    stack_.pop_back();
+    return;
+  case Frame::VALUE: {
+    StreamValueBaseVisitor visitor(out);
+    frame.value->accept(visitor);
+    if (visitor.list) {
+      out += '[';
+      frame.type = Frame::LIST;
+      frame.listIter = visitor.list->begin();
+      frame.listEnd = visitor.list->end();
+    }
+    else if (visitor.dict) {
+      out += '{';
+      frame.type = Frame::DICT;
+      frame.dictIter = visitor.dict->begin();
+      frame.dictEnd = visitor.dict->end();
+    }
+    else {
+      stack_.pop_back();
+    }
+    return;
+  }
+  case Frame::LIST: {
+    if (frame.listIter == frame.listEnd) {
+      out += ']';
+      stack_.pop_back();
+      return;
+    }
+    if (!frame.first) {
+      out += ',';
+    }
+    frame.first = false;
+    auto value = (*frame.listIter++).get();
+    // frame is invalidated by push_back
+    stack_.emplace_back(Frame::VALUE, value);
+    return;
+  }
+  case Frame::DICT: {
+    if (frame.dictIter == frame.dictEnd) {
+      out += '}';
+      stack_.pop_back();
+      return;
+    }
+    if (!frame.first) {
+      out += ',';
+    }
+    frame.first = false;
+    out += '"';
+    jsonEscape(out, (*frame.dictIter).first);
+    out += "\":";
+    auto value = (*frame.dictIter++).second.get();
+    // frame is invalidated by push_back
+    stack_.emplace_back(Frame::VALUE, value);
+    return;
+  }
+  }
+}
+
 JsonGetParam::JsonGetParam(const std::string& request,
                            const std::string& callback)
     : request(request), callback(callback)
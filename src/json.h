@@ -36,6 +36,10 @@
 #define D_JSON_H
 
 #include "common.h"
+
+#include <deque>
+#include <vector>
+
 #include "ValueBase.h"
 
 namespace aria2 {
@@ -44,6 +48,9 @@ namespace json {
 
 std::string jsonEscape(const std::string& s);
 
+// Appends escaped |s| to |out|.
+void jsonEscape(std::string& out, const std::string& s);
+
 template <typename OutputStream>
 OutputStream& encode(OutputStream& out, const ValueBase* vlb)
 {
@@ -117,6 +124,55 @@ OutputStream& encode(OutputStream& out, const ValueBase* vlb)
 // Serializes JSON object or array.
 std::string encode(const ValueBase* json);
 
+// Serializes queued texts and JSON values a bounded chunk at a time,
+// so that a large tree can be sent without holding its whole
+// serialized form in memory.  The queued values are not copied and
+// must stay alive until they are encoded.
+class StreamEncoder {
+public:
+  StreamEncoder();
+
+  ~StreamEncoder();
+
+  // Queues |text| which is output as is.
+  void pushText(std::string text);
+
+  // Queues |json| which is serialized in the same way as encode().
+  void pushValue(const ValueBase* json);
+
+  // Appends serialized data to |out| until its size reaches |length|
+  // or all queued items are serialized.  A single string value is
+  // never split, so |out| may exceed |length|.  Returns true if all
+  // queued items are serialized.
+  bool encode(std::string& out, size_t length);
+
+  // Returns true if all queued items are serialized.
+  bool finished() const;
+
+private:
+  struct Frame {
+    enum Type { TEXT, VALUE, LIST, DICT };
+    Type type;
+    std::string text;
+    const ValueBase* value;
+    List::ValueType::const_iterator listIter, listEnd;
+    Dict::ValueType::const_iterator dictIter, dictEnd;
+    bool first;
+    Frame(Type type, const ValueBase* value)
+        : type{type}, value{value}, first{true}
+    {
+    }
+  };
+
+  // Serializes the top of stack_ by one step.
+  void step(std::string& out);
+
+  // Items waiting to be serialized.
+  std::deque<Frame> queue_;
+  // Item being serialized and its open containers.
+  std::vector<Frame> stack_;
+};
+
 struct JsonGetParam {
   std::string request;
   std::string callback;
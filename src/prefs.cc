@@ -137,6 +137,7 @@ const std::string V_FEEDBACK("feedback");
 const std::string V_ADAPTIVE("adaptive");
 const std::string V_LIBUV("libuv");
 const std::string V_EPOLL("epoll");
+const std::string V_IO_URING("io_uring");
 const std::string V_KQUEUE("kqueue");
 const std::string V_PORT("port");
 const std::string V_POLL("poll");
@@ -376,6 +377,17 @@ PrefPtr PREF_STDERR = makePref("stderr");
 // value: true | false
 PrefPtr PREF_KEEP_UNFINISHED_DOWNLOAD_RESULT =
     makePref("keep-unfinished-download-result");
+// values: 1*digit
+PrefPtr PREF_CHECK_INTEGRITY_THREADS = makePref("check-integrity-threads");
+// values: 1*digit
+PrefPtr PREF_CHECK_INTEGRITY_READ_SIZE =
+    makePref("check-integrity-read-size");
+// values: 1*digit
+PrefPtr PREF_DISK_IO_THREADS = makePref("disk-io-threads");
+// values: 1*digit
+PrefPtr PREF_MAX_RECV_BUFFER_SIZE = makePref("max-recv-buffer-size");
+// values: 1*digit
+PrefPtr PREF_FILE_ALLOCATION_THREADS = makePref("file-allocation-threads");
 
 /**
  * FTP related preferences
@@ -431,6 +443,12 @@ PrefPtr PREF_CONTENT_DISPOSITION_DEFAULT_UTF8 =
     makePref("content-disposition-default-utf8");
 // value: true | false
 PrefPtr PREF_NO_WANT_DIGEST_HEADER = makePref("no-want-digest-header");
+// value: true | false
+PrefPtr PREF_ENABLE_HTTP2 = makePref("enable-http2");
+// value: true | false
+PrefPtr PREF_HTTP2_PRIOR_KNOWLEDGE = makePref("http2-prior-knowledge");
+// value: 1*digit
+PrefPtr PREF_HTTP2_WINDOW_SIZE = makePref("http2-window-size");
 
 /**
  * Proxy related preferences
@@ -553,6 +571,12 @@ PrefPtr PREF_BT_TRACKER_CONNECT_TIMEOUT =
     makePref("bt-tracker-connect-timeout");
 // values: 1*digit
 PrefPtr PREF_DHT_MESSAGE_TIMEOUT = makePref("dht-message-timeout");
+// values: 1*digit
+PrefPtr PREF_DHT_BUCKET_SIZE = makePref("dht-bucket-size");
+// values: 1*digit
+PrefPtr PREF_DHT_PEER_STORE_SIZE = makePref("dht-peer-store-size");
+// values: 1*digit
+PrefPtr PREF_DHT_QUERY_RATE_LIMIT = makePref("dht-query-rate-limit");
 // values: string
 PrefPtr PREF_ON_BT_DOWNLOAD_COMPLETE = makePref("on-bt-download-complete");
 // values: string
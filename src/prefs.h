@@ -94,6 +94,7 @@ extern const std::string V_FEEDBACK;
 extern const std::string V_ADAPTIVE;
 extern const std::string V_LIBUV;
 extern const std::string V_EPOLL;
+extern const std::string V_IO_URING;
 extern const std::string V_KQUEUE;
 extern const std::string V_PORT;
 extern const std::string V_POLL;
@@ -329,6 +330,16 @@ extern PrefPtr PREF_MAX_MMAP_LIMIT;
 extern PrefPtr PREF_STDERR;
 // value: true | false
 extern PrefPtr PREF_KEEP_UNFINISHED_DOWNLOAD_RESULT;
+// values: 1*digit
+extern PrefPtr PREF_CHECK_INTEGRITY_THREADS;
+// values: 1*digit
+extern PrefPtr PREF_CHECK_INTEGRITY_READ_SIZE;
+// values: 1*digit
+extern PrefPtr PREF_DISK_IO_THREADS;
+// values: 1*digit
+extern PrefPtr PREF_MAX_RECV_BUFFER_SIZE;
+// values: 1*digit
+extern PrefPtr PREF_FILE_ALLOCATION_THREADS;
 
 /**
  * FTP related preferences
@@ -383,6 +394,12 @@ extern PrefPtr PREF_HTTP_ACCEPT_GZIP;
 extern PrefPtr PREF_CONTENT_DISPOSITION_DEFAULT_UTF8;
 // value: true | false
 extern PrefPtr PREF_NO_WANT_DIGEST_HEADER;
+// value: true | false
+extern PrefPtr PREF_ENABLE_HTTP2;
+// value: true | false
+extern PrefPtr PREF_HTTP2_PRIOR_KNOWLEDGE;
+// value: 1*digit
+extern PrefPtr PREF_HTTP2_WINDOW_SIZE;
 
 /**;
  * Proxy related preferences
@@ -503,6 +520,12 @@ extern PrefPtr PREF_BT_TRACKER_TIMEOUT;
 extern PrefPtr PREF_BT_TRACKER_CONNECT_TIMEOUT;
 // values: 1*digit
 extern PrefPtr PREF_DHT_MESSAGE_TIMEOUT;
+// values: 1*digit
+extern PrefPtr PREF_DHT_BUCKET_SIZE;
+// values: 1*digit
+extern PrefPtr PREF_DHT_PEER_STORE_SIZE;
+// values: 1*digit
+extern PrefPtr PREF_DHT_QUERY_RATE_LIMIT;
 // values: string
 extern PrefPtr PREF_ON_BT_DOWNLOAD_COMPLETE;
 // values: string
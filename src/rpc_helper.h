@@ -63,7 +63,10 @@ RpcResponse createJsonRpcErrorResponse(int code, const std::string& msg,
                                        std::unique_ptr<ValueBase> id);
 
 // Processes JSON-RPC request |jsondict| and returns the result.
-RpcResponse processJsonRpcRequest(Dict* jsondict, DownloadEngine* e);
+// |wsSession| is the WebSocket session the request came from, or
+// nullptr.
+RpcResponse processJsonRpcRequest(Dict* jsondict, DownloadEngine* e,
+                                  WebSocketSession* wsSession = nullptr);
 
 } // namespace rpc
 
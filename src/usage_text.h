@@ -192,6 +192,24 @@
   _(" --enable-http-keep-alive[=true|false] Enable HTTP/1.1 persistent connection.")
 #define TEXT_ENABLE_HTTP_PIPELINING                                     \
   _(" --enable-http-pipelining[=true|false] Enable HTTP/1.1 pipelining.")
+#define TEXT_MAX_HTTP_PIPELINING                                        \
+  _(" --max-http-pipelining=NUM    Set the maximum number of range requests sent\n" \
+    "                              over a connection without waiting for their\n" \
+    "                              responses when HTTP/1.1 pipelining is enabled.")
+#define TEXT_ENABLE_HTTP2                                               \
+  _(" --enable-http2[=true|false] Use HTTP/2 for HTTPS downloads if the server\n" \
+    "                              selects it by ALPN. The range requests for a\n" \
+    "                              file are sent as concurrent streams over one\n" \
+    "                              connection. HTTP/2 is not used via proxy.")
+#define TEXT_HTTP2_PRIOR_KNOWLEDGE                                      \
+  _(" --http2-prior-knowledge[=true|false] Use HTTP/2 over cleartext TCP for\n" \
+    "                              HTTP downloads without negotiation. This option\n" \
+    "                              has effect only when --enable-http2 is true.")
+#define TEXT_HTTP2_WINDOW_SIZE                                          \
+  _(" --http2-window-size=SIZE     Set the HTTP/2 flow control window size of each\n" \
+    "                              stream, which limits the data buffered for a\n" \
+    "                              stream before they are written.\n" \
+    "                              You can append K or M (1K = 1024, 1M = 1024K).")
 #define TEXT_CHECK_INTEGRITY                                            \
   _(" -V, --check-integrity[=true|false] Check file integrity by validating piece\n" \
     "                              hashes or a hash of entire file. This option has\n" \
@@ -725,6 +743,20 @@
     "                              instead.")
 #define TEXT_DHT_MESSAGE_TIMEOUT                \
   _(" --dht-message-timeout=SEC    Set timeout in seconds.")
+#define TEXT_DHT_BUCKET_SIZE                    \
+  _(" --dht-bucket-size=NUM        Set the maximum number of nodes in each bucket\n" \
+    "                              of DHT routing table. Larger buckets keep more\n" \
+    "                              nodes and make lookups faster at the cost of\n" \
+    "                              more maintenance traffic.")
+#define TEXT_DHT_PEER_STORE_SIZE                \
+  _(" --dht-peer-store-size=NUM    Set the maximum number of info hashes whose\n" \
+    "                              peers announced to this DHT node are kept. When\n" \
+    "                              full, the info hash announced least recently is\n" \
+    "                              dropped.")
+#define TEXT_DHT_QUERY_RATE_LIMIT               \
+  _(" --dht-query-rate-limit=NUM   Set the maximum number of DHT queries per second\n" \
+    "                              accepted from one IP address. Excess queries\n" \
+    "                              are dropped. 0 means unrestricted.")
 #define TEXT_HTTP_ACCEPT_GZIP                   \
   _(" --http-accept-gzip[=true|false] Send 'Accept-Encoding: deflate, gzip' request\n" \
     "                              header and inflate response if remote server\n" \
@@ -1129,5 +1161,36 @@
     "                              file saved by --bt-save-metadata option. If it is\n" \
     "                              successful, then skip downloading metadata from\n" \
     "                              DHT.")
+#define TEXT_CHECK_INTEGRITY_THREADS                                    \
+  _(" --check-integrity-threads=N  Set the number of threads used to hash pieces\n" \
+    "                              when checking file integrity (see -V option).\n" \
+    "                              Up to N downloads are checked at the same time.\n" \
+    "                              If N is 0, pieces are hashed in the main thread\n" \
+    "                              one download at a time.")
+#define TEXT_CHECK_INTEGRITY_READ_SIZE                                  \
+  _(" --check-integrity-read-size=SIZE Set the size of a read when hashing data\n" \
+    "                              in the main thread during file integrity\n" \
+    "                              check. You can append K or M (1K = 1024,\n" \
+    "                              1M = 1024K).")
+#define TEXT_DISK_IO_THREADS                                            \
+  _(" --disk-io-threads=N          Write the data evicted from the disk cache in N\n" \
+    "                              worker threads so that slow storage does not\n" \
+    "                              stall network I/O. While the data being written\n" \
+    "                              exceed the size of the disk cache, aria2 stops\n" \
+    "                              reading from the network. If N is 0, the data\n" \
+    "                              are written in the main thread. This option has\n" \
+    "                              no effect if --disk-cache is 0.")
+#define TEXT_MAX_RECV_BUFFER_SIZE                                       \
+  _(" --max-recv-buffer-size=SIZE  Set the maximum size of the buffer aria2 reads\n" \
+    "                              data from a socket into. The buffer starts at\n" \
+    "                              16K and grows up to SIZE while the connection\n" \
+    "                              delivers data faster than they are processed.\n" \
+    "                              You can append K or M (1K = 1024, 1M = 1024K).")
+#define TEXT_FILE_ALLOCATION_THREADS                                    \
+  _(" --file-allocation-threads=N  Allocate files in N worker threads. Up to N\n" \
+    "                              downloads, and up to N files of a multi-file\n" \
+    "                              download, are allocated at the same time. If N\n" \
+    "                              is 0, files are allocated in the main thread\n" \
+    "                              one at a time.")
 
 // clang-format on
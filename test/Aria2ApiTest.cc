@@ -25,6 +25,8 @@ class Aria2ApiTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testChangeOption);
   CPPUNIT_TEST(testChangeGlobalOption);
   CPPUNIT_TEST(testDownloadResultDH);
+  CPPUNIT_TEST(testPost);
+  CPPUNIT_TEST(testPost_shutdown);
   CPPUNIT_TEST_SUITE_END();
 
   Session* session_;
@@ -47,6 +49,8 @@ public:
   void testChangeOption();
   void testChangeGlobalOption();
   void testDownloadResultDH();
+  void testPost();
+  void testPost_shutdown();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(Aria2ApiTest);
@@ -248,4 +252,34 @@ void Aria2ApiTest::testDownloadResultDH()
   deleteDownloadHandle(hd);
 }
 
+void Aria2ApiTest::testPost()
+{
+  int called = 0;
+  CPPUNIT_ASSERT_EQUAL(0, post(session_, [&called](Session*) { ++called; }));
+  // No download is left, but the queued function is called before
+  // run() returns.
+  CPPUNIT_ASSERT_EQUAL(0, run(session_, RUN_DEFAULT));
+  CPPUNIT_ASSERT_EQUAL(1, called);
+  // Nothing runs the functions any more.
+  CPPUNIT_ASSERT_EQUAL(-1, post(session_, [&called](Session*) { ++called; }));
+  CPPUNIT_ASSERT_EQUAL(1, called);
+}
+
+void Aria2ApiTest::testPost_shutdown()
+{
+  std::vector<int> called;
+  CPPUNIT_ASSERT_EQUAL(0, post(session_, [&called](Session* session) {
+                         called.push_back(1);
+                         post(session, [&called](Session*) {
+                           called.push_back(2);
+                         });
+                         shutdown(session, true);
+                       }));
+  CPPUNIT_ASSERT_EQUAL(0, run(session_, RUN_DEFAULT));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, called.size());
+  CPPUNIT_ASSERT_EQUAL(1, called[0]);
+  CPPUNIT_ASSERT_EQUAL(2, called[1]);
+  CPPUNIT_ASSERT_EQUAL(-1, post(session_, [](Session*) {}));
+}
+
 } // namespace aria2
@@ -0,0 +1,115 @@
+#include "AsyncFileAllocationIterator.h"
+
+#include <poll.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "File.h"
+#include "DefaultDiskWriter.h"
+#include "SingleFileAllocationIterator.h"
+#include "WorkerThreadPool.h"
+#include "WakeupFd.h"
+#include "DlAbortEx.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class AsyncFileAllocationIteratorTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(AsyncFileAllocationIteratorTest);
+  CPPUNIT_TEST(testAllocate);
+  CPPUNIT_TEST(testAllocate_error);
+  CPPUNIT_TEST(testAllocate_wakeup);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testAllocate();
+  void testAllocate_error();
+  void testAllocate_wakeup();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AsyncFileAllocationIteratorTest);
+
+namespace {
+class FailingFileAllocationIterator : public FileAllocationIterator {
+public:
+  virtual void allocateChunk() CXX11_OVERRIDE
+  {
+    throw DL_ABORT_EX("No space left on device");
+  }
+
+  virtual bool finished() CXX11_OVERRIDE { return false; }
+
+  virtual int64_t getCurrentLength() CXX11_OVERRIDE { return 0; }
+
+  virtual int64_t getTotalLength() CXX11_OVERRIDE { return 1_k; }
+};
+} // namespace
+
+void AsyncFileAllocationIteratorTest::testAllocate()
+{
+  std::string fn =
+      A2_TEST_OUT_DIR "/aria2_AsyncFileAllocationIteratorTest_testAllocate";
+  File(fn).remove();
+
+  DefaultDiskWriter writer(fn);
+  writer.openFile();
+  auto single = make_unique<SingleFileAllocationIterator>(&writer, 0, 1_m + 7);
+  single->init();
+
+  WorkerThreadPool pool(2);
+  AsyncFileAllocationIterator itr(std::move(single), &pool);
+  CPPUNIT_ASSERT(!itr.finished());
+  CPPUNIT_ASSERT_EQUAL((int64_t)0, itr.getCurrentLength());
+  CPPUNIT_ASSERT_EQUAL((int64_t)(1_m + 7), itr.getTotalLength());
+
+  while (!itr.finished()) {
+    itr.allocateChunk();
+  }
+  CPPUNIT_ASSERT_EQUAL((int64_t)(1_m + 7), itr.getCurrentLength());
+  writer.closeFile();
+  CPPUNIT_ASSERT_EQUAL((int64_t)(1_m + 7), File(fn).size());
+}
+
+void AsyncFileAllocationIteratorTest::testAllocate_error()
+{
+  WorkerThreadPool pool(1);
+  AsyncFileAllocationIterator itr(make_unique<FailingFileAllocationIterator>(),
+                                  &pool);
+  try {
+    while (!itr.finished()) {
+      itr.allocateChunk();
+    }
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (DlAbortEx& e) {
+    CPPUNIT_ASSERT_EQUAL(std::string("No space left on device"),
+                         std::string(e.what()));
+  }
+}
+
+void AsyncFileAllocationIteratorTest::testAllocate_wakeup()
+{
+  WakeupFd wakeupFd;
+  if (wakeupFd.getFd() == -1) {
+    return;
+  }
+  WorkerThreadPool pool(1);
+  AsyncFileAllocationIterator itr(make_unique<FailingFileAllocationIterator>(),
+                                  &pool, &wakeupFd);
+  // Submits the job.
+  itr.allocateChunk();
+  // The descriptor becomes readable when the job returns.
+  struct pollfd pfd = {wakeupFd.getFd(), POLLIN, 0};
+  CPPUNIT_ASSERT_EQUAL(1, poll(&pfd, 1, 10000));
+  wakeupFd.drain();
+  try {
+    itr.allocateChunk();
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (DlAbortEx& e) {
+    // success
+  }
+}
+
+} // namespace aria2
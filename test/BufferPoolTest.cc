@@ -0,0 +1,96 @@
+#include "BufferPool.h"
+
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace aria2 {
+
+class BufferPoolTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(BufferPoolTest);
+  CPPUNIT_TEST(testAllocate);
+  CPPUNIT_TEST(testDeallocate_releaseSlab);
+  CPPUNIT_TEST(testAllocate_large);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testAllocate();
+  void testDeallocate_releaseSlab();
+  void testAllocate_large();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BufferPoolTest);
+
+void BufferPoolTest::testAllocate()
+{
+  BufferPool pool(16, 4);
+  auto a = pool.allocate(16);
+  auto b = pool.allocate(1);
+  // Buffers are handed out from the beginning of the slab.
+  CPPUNIT_ASSERT(a + 16 == b);
+  auto stat = pool.getStat();
+  CPPUNIT_ASSERT_EQUAL((size_t)1, stat.numSlabs);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, stat.numBuffersInUse);
+
+  pool.deallocate(a);
+  // The freed buffer is reused.
+  CPPUNIT_ASSERT(a == pool.allocate(16));
+
+  std::vector<unsigned char*> bufs;
+  for (int i = 0; i < 3; ++i) {
+    bufs.push_back(pool.allocate(16));
+  }
+  stat = pool.getStat();
+  CPPUNIT_ASSERT_EQUAL((size_t)2, stat.numSlabs);
+  CPPUNIT_ASSERT_EQUAL((size_t)5, stat.numBuffersInUse);
+  CPPUNIT_ASSERT_EQUAL((size_t)5, stat.maxNumBuffersInUse);
+
+  for (auto buf : bufs) {
+    pool.deallocate(buf);
+  }
+  pool.deallocate(a);
+  pool.deallocate(b);
+  stat = pool.getStat();
+  CPPUNIT_ASSERT_EQUAL((size_t)0, stat.numBuffersInUse);
+  CPPUNIT_ASSERT_EQUAL((size_t)5, stat.maxNumBuffersInUse);
+  // One empty slab is kept.
+  CPPUNIT_ASSERT_EQUAL((size_t)1, stat.numSlabs);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, stat.maxNumSlabs);
+}
+
+void BufferPoolTest::testDeallocate_releaseSlab()
+{
+  BufferPool pool(16, 2);
+  std::vector<unsigned char*> bufs;
+  for (int i = 0; i < 6; ++i) {
+    bufs.push_back(pool.allocate(16));
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)3, pool.getStat().numSlabs);
+  // Empty the 2 slabs.  The first one is kept, and the second one is
+  // freed.
+  for (int i = 0; i < 4; ++i) {
+    pool.deallocate(bufs[i]);
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)2, pool.getStat().numSlabs);
+  // The kept slab is used before allocating a new one.
+  pool.allocate(16);
+  pool.allocate(16);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, pool.getStat().numSlabs);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, pool.getStat().maxNumSlabs);
+}
+
+void BufferPoolTest::testAllocate_large()
+{
+  BufferPool pool(16, 2);
+  auto buf = pool.allocate(17);
+  CPPUNIT_ASSERT_EQUAL((size_t)0, pool.getStat().numSlabs);
+  CPPUNIT_ASSERT_EQUAL((size_t)0, pool.getStat().numBuffersInUse);
+  pool.deallocate(buf);
+  // Memory allocated by new[] is also accepted.
+  pool.deallocate(new unsigned char[16]);
+  pool.deallocate(nullptr);
+  CPPUNIT_ASSERT_EQUAL((size_t)0, pool.getStat().numSlabs);
+}
+
+} // namespace aria2
@@ -19,6 +19,7 @@ class DHTBucketTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testSplitAllowed);
   CPPUNIT_TEST(testSplit);
   CPPUNIT_TEST(testAddNode);
+  CPPUNIT_TEST(testAddNode_bucketSize);
   CPPUNIT_TEST(testMoveToHead);
   CPPUNIT_TEST(testMoveToTail);
   CPPUNIT_TEST(testGetGoodNodes);
@@ -37,6 +38,7 @@ public:
   void testSplitAllowed();
   void testSplit();
   void testAddNode();
+  void testAddNode_bucketSize();
   void testMoveToHead();
   void testMoveToTail();
   void testGetGoodNodes();
@@ -302,6 +304,27 @@ void DHTBucketTest::testAddNode()
   CPPUNIT_ASSERT(*bucket.getNodes().back() == *newNode);
 }
 
+void DHTBucketTest::testAddNode_bucketSize()
+{
+  unsigned char localNodeID[DHT_ID_LENGTH];
+  memset(localNodeID, 0, DHT_ID_LENGTH);
+  std::shared_ptr<DHTNode> localNode(new DHTNode(localNodeID));
+  DHTBucket bucket(localNode, 16);
+
+  unsigned char id[DHT_ID_LENGTH];
+  for (size_t i = 0; i < 16; ++i) {
+    createID(id, 0xf0, i);
+    CPPUNIT_ASSERT(bucket.addNode(std::make_shared<DHTNode>(id)));
+  }
+  createID(id, 0xf0, 0xff);
+  CPPUNIT_ASSERT(!bucket.addNode(std::make_shared<DHTNode>(id)));
+  CPPUNIT_ASSERT(!bucket.needsRefresh());
+
+  // The bucket size is inherited by the new bucket.
+  auto r = bucket.split();
+  CPPUNIT_ASSERT_EQUAL((size_t)16, r->getBucketSize());
+}
+
 void DHTBucketTest::testMoveToHead()
 {
   unsigned char localNodeID[DHT_ID_LENGTH];
@@ -0,0 +1,104 @@
+#include "DHTClosestNodeCache.h"
+
+#include <cstring>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "DHTNode.h"
+#include "wallclock.h"
+
+namespace aria2 {
+
+class DHTClosestNodeCacheTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(DHTClosestNodeCacheTest);
+  CPPUNIT_TEST(testGet);
+  CPPUNIT_TEST(testPut_replace);
+  CPPUNIT_TEST(testPut_capacity);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testGet();
+  void testPut_replace();
+  void testPut_capacity();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DHTClosestNodeCacheTest);
+
+namespace {
+std::vector<std::shared_ptr<DHTNode>> createNodes(size_t n)
+{
+  std::vector<std::shared_ptr<DHTNode>> nodes;
+  for (size_t i = 0; i < n; ++i) {
+    nodes.push_back(std::make_shared<DHTNode>());
+  }
+  return nodes;
+}
+} // namespace
+
+void DHTClosestNodeCacheTest::testGet()
+{
+  DHTClosestNodeCache cache;
+  unsigned char target1[DHT_ID_LENGTH];
+  memset(target1, 0x00, DHT_ID_LENGTH);
+  unsigned char target2[DHT_ID_LENGTH];
+  memset(target2, 0xf0, DHT_ID_LENGTH);
+  auto nodes1 = createNodes(2);
+  auto nodes2 = createNodes(3);
+
+  std::vector<std::shared_ptr<DHTNode>> nodes;
+  cache.get(nodes, target1);
+  CPPUNIT_ASSERT(nodes.empty());
+
+  cache.put(target1, nodes1);
+  cache.put(target2, nodes2);
+
+  unsigned char key[DHT_ID_LENGTH];
+  memset(key, 0xff, DHT_ID_LENGTH);
+  cache.get(nodes, key);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, nodes.size());
+  CPPUNIT_ASSERT(nodes2[0] == nodes[0]);
+
+  nodes.clear();
+  key[0] = 0x01;
+  cache.get(nodes, key);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, nodes.size());
+  CPPUNIT_ASSERT(nodes1[0] == nodes[0]);
+}
+
+void DHTClosestNodeCacheTest::testPut_replace()
+{
+  DHTClosestNodeCache cache;
+  unsigned char target[DHT_ID_LENGTH];
+  memset(target, 0x00, DHT_ID_LENGTH);
+
+  cache.put(target, createNodes(2));
+  auto nodes1 = createNodes(1);
+  cache.put(target, nodes1);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, cache.size());
+
+  std::vector<std::shared_ptr<DHTNode>> nodes;
+  cache.get(nodes, target);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, nodes.size());
+  CPPUNIT_ASSERT(nodes1[0] == nodes[0]);
+}
+
+void DHTClosestNodeCacheTest::testPut_capacity()
+{
+  DHTClosestNodeCache cache(2);
+  unsigned char target[DHT_ID_LENGTH];
+  memset(target, 0x00, DHT_ID_LENGTH);
+
+  for (int i = 0; i < 3; ++i) {
+    target[0] = i;
+    cache.put(target, createNodes(i + 1));
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)2, cache.size());
+
+  // The entry for 0x00... was evicted.
+  std::vector<std::shared_ptr<DHTNode>> nodes;
+  target[0] = 0;
+  cache.get(nodes, target);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, nodes.size());
+}
+
+} // namespace aria2
@@ -95,6 +95,46 @@ void DHTMessageTrackerTest::testMessageArrived()
   }
 }
 
-void DHTMessageTrackerTest::testHandleTimeout() {}
+void DHTMessageTrackerTest::testHandleTimeout()
+{
+  auto localNode = std::make_shared<DHTNode>();
+  auto routingTable = make_unique<DHTRoutingTable>(localNode);
+  auto factory = make_unique<MockDHTMessageFactory>();
+  factory->setLocalNode(localNode);
+
+  auto r1 = std::make_shared<DHTNode>();
+  r1->setIPAddress("192.168.0.1");
+  r1->setPort(6881);
+  auto r2 = std::make_shared<DHTNode>();
+  r2->setIPAddress("192.168.0.2");
+  r2->setPort(6882);
+
+  auto m1 = make_unique<MockDHTMessage>(localNode, r1);
+  auto m2 = make_unique<MockDHTMessage>(localNode, r2);
+
+  DHTMessageTracker tracker;
+  tracker.setRoutingTable(routingTable.get());
+  tracker.setMessageFactory(factory.get());
+  tracker.addMessage(m1.get(), 0_s);
+  tracker.addMessage(m2.get(), DHT_MESSAGE_TIMEOUT);
+
+  tracker.handleTimeout();
+  CPPUNIT_ASSERT(!tracker.getEntryFor(m1.get()));
+  CPPUNIT_ASSERT(tracker.getEntryFor(m2.get()));
+  CPPUNIT_ASSERT_EQUAL((size_t)1, tracker.countEntry());
+
+  // The reply from IPv4-mapped IPv6 address matches the entry.
+  Dict resDict;
+  resDict.put("t", m2->getTransactionID());
+  auto p = tracker.messageArrived(&resDict, "::ffff:192.168.0.2",
+                                  r2->getPort());
+  CPPUNIT_ASSERT(p.first);
+  CPPUNIT_ASSERT_EQUAL((size_t)0, tracker.countEntry());
+
+  // The slot of the answered entry is cleaned up without calling its
+  // timeout handler.
+  tracker.handleTimeout();
+  CPPUNIT_ASSERT_EQUAL((size_t)0, tracker.countEntry());
+}
 
 } // namespace aria2
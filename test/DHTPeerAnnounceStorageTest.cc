@@ -18,10 +18,14 @@ class DHTPeerAnnounceStorageTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(DHTPeerAnnounceStorageTest);
   CPPUNIT_TEST(testAddAnnounce);
+  CPPUNIT_TEST(testAddAnnounce_evict);
+  CPPUNIT_TEST(testAddAnnounce_maxPeer);
   CPPUNIT_TEST_SUITE_END();
 
 public:
   void testAddAnnounce();
+  void testAddAnnounce_evict();
+  void testAddAnnounce_maxPeer();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DHTPeerAnnounceStorageTest);
@@ -47,4 +51,45 @@ void DHTPeerAnnounceStorageTest::testAddAnnounce()
   CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.4"), peers[1]->getIPAddress());
 }
 
+void DHTPeerAnnounceStorageTest::testAddAnnounce_evict()
+{
+  unsigned char infohash1[DHT_ID_LENGTH];
+  memset(infohash1, 0x01, DHT_ID_LENGTH);
+  unsigned char infohash2[DHT_ID_LENGTH];
+  memset(infohash2, 0x02, DHT_ID_LENGTH);
+  unsigned char infohash3[DHT_ID_LENGTH];
+  memset(infohash3, 0x03, DHT_ID_LENGTH);
+  DHTPeerAnnounceStorage storage(2);
+
+  storage.addPeerAnnounce(infohash1, "192.168.0.1", 6881);
+  storage.addPeerAnnounce(infohash2, "192.168.0.2", 6882);
+  // infohash1 becomes the most recently announced one.
+  storage.addPeerAnnounce(infohash1, "192.168.0.3", 6883);
+  storage.addPeerAnnounce(infohash3, "192.168.0.4", 6884);
+
+  CPPUNIT_ASSERT_EQUAL((size_t)2, storage.countEntry());
+  CPPUNIT_ASSERT(storage.contains(infohash1));
+  CPPUNIT_ASSERT(!storage.contains(infohash2));
+  CPPUNIT_ASSERT(storage.contains(infohash3));
+
+  std::vector<std::shared_ptr<Peer>> peers;
+  storage.getPeers(peers, infohash1);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, peers.size());
+}
+
+void DHTPeerAnnounceStorageTest::testAddAnnounce_maxPeer()
+{
+  unsigned char infohash[DHT_ID_LENGTH];
+  memset(infohash, 0xff, DHT_ID_LENGTH);
+  DHTPeerAnnounceStorage storage;
+
+  for (size_t i = 0; i < DHT_PEER_ANNOUNCE_MAX_PEER + 10; ++i) {
+    storage.addPeerAnnounce(infohash, "192.168.0.1", 1024 + i);
+  }
+
+  std::vector<std::shared_ptr<Peer>> peers;
+  storage.getPeers(peers, infohash);
+  CPPUNIT_ASSERT_EQUAL(DHT_PEER_ANNOUNCE_MAX_PEER, peers.size());
+}
+
 } // namespace aria2
@@ -0,0 +1,105 @@
+#include "DHTQueryRateLimiter.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "util.h"
+
+namespace aria2 {
+
+class DHTQueryRateLimiterTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(DHTQueryRateLimiterTest);
+  CPPUNIT_TEST(testAccept);
+  CPPUNIT_TEST(testAccept_unlimited);
+  CPPUNIT_TEST(testAccept_maxSource);
+  CPPUNIT_TEST(testPurge);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testAccept();
+  void testAccept_unlimited();
+  void testAccept_maxSource();
+  void testPurge();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DHTQueryRateLimiterTest);
+
+void DHTQueryRateLimiterTest::testAccept()
+{
+  DHTQueryRateLimiter limiter(2);
+  Timer now(100_s);
+
+  CPPUNIT_ASSERT(limiter.accept("192.168.0.1", now));
+  CPPUNIT_ASSERT(limiter.accept("192.168.0.1", now));
+  CPPUNIT_ASSERT(!limiter.accept("192.168.0.1", now));
+  // Other address has its own bucket.
+  CPPUNIT_ASSERT(limiter.accept("192.168.0.2", now));
+
+  // 1 token is refilled in 500ms.
+  now.advance(500_ms);
+  CPPUNIT_ASSERT(limiter.accept("192.168.0.1", now));
+  CPPUNIT_ASSERT(!limiter.accept("192.168.0.1", now));
+
+  // Tokens are capped at the rate.
+  now.advance(10_s);
+  CPPUNIT_ASSERT(limiter.accept("192.168.0.1", now));
+  CPPUNIT_ASSERT(limiter.accept("192.168.0.1", now));
+  CPPUNIT_ASSERT(!limiter.accept("192.168.0.1", now));
+}
+
+void DHTQueryRateLimiterTest::testAccept_unlimited()
+{
+  DHTQueryRateLimiter limiter(0);
+  Timer now(100_s);
+
+  for (int i = 0; i < 1000; ++i) {
+    CPPUNIT_ASSERT(limiter.accept("192.168.0.1", now));
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)0, limiter.countSource());
+}
+
+void DHTQueryRateLimiterTest::testAccept_maxSource()
+{
+  DHTQueryRateLimiter limiter(2);
+  Timer now(100_s);
+
+  CPPUNIT_ASSERT(limiter.accept("192.168.0.1", now));
+  CPPUNIT_ASSERT(limiter.accept("192.168.0.1", now));
+  for (size_t i = 1; i < DHTQueryRateLimiter::MAX_SOURCE; ++i) {
+    CPPUNIT_ASSERT(limiter.accept("10.0.0." + util::uitos(i), now));
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)DHTQueryRateLimiter::MAX_SOURCE,
+                       limiter.countSource());
+  // Makes 192.168.0.1 the most recent one, although the query is
+  // dropped.
+  CPPUNIT_ASSERT(!limiter.accept("192.168.0.1", now));
+
+  // A new address pushes out the least recent one, that is 10.0.0.1.
+  CPPUNIT_ASSERT(limiter.accept("192.168.0.2", now));
+  CPPUNIT_ASSERT_EQUAL((size_t)DHTQueryRateLimiter::MAX_SOURCE,
+                       limiter.countSource());
+  CPPUNIT_ASSERT(!limiter.accept("192.168.0.1", now));
+  CPPUNIT_ASSERT(limiter.accept("10.0.0.2", now));
+  CPPUNIT_ASSERT(!limiter.accept("10.0.0.2", now));
+  // 10.0.0.1 gets a new bucket.
+  CPPUNIT_ASSERT(limiter.accept("10.0.0.1", now));
+  CPPUNIT_ASSERT(limiter.accept("10.0.0.1", now));
+  CPPUNIT_ASSERT(!limiter.accept("10.0.0.1", now));
+}
+
+void DHTQueryRateLimiterTest::testPurge()
+{
+  DHTQueryRateLimiter limiter(2);
+  Timer now(100_s);
+
+  limiter.accept("192.168.0.1", now);
+  now.advance(900_ms);
+  limiter.accept("192.168.0.2", now);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, limiter.countSource());
+
+  now.advance(100_ms);
+  limiter.purge(now);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, limiter.countSource());
+}
+
+} // namespace aria2
@@ -11,10 +11,12 @@ class DHTTaskExecutorTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(DHTTaskExecutorTest);
   CPPUNIT_TEST(testUpdate);
+  CPPUNIT_TEST(testUpdate_priority);
   CPPUNIT_TEST_SUITE_END();
 
 public:
   void testUpdate();
+  void testUpdate_priority();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DHTTaskExecutorTest);
@@ -45,4 +47,23 @@ void DHTTaskExecutorTest::testUpdate()
   CPPUNIT_ASSERT_EQUAL((size_t)0, tex.getQueueSize());
 }
 
+void DHTTaskExecutorTest::testUpdate_priority()
+{
+  std::shared_ptr<DHTNode> rn;
+  DHTTaskExecutor tex(1);
+  auto task1 = std::make_shared<MockDHTTask>(rn);
+  auto task2 = std::make_shared<MockDHTTask>(rn);
+  tex.addTask(task1);
+  tex.addPriorityTask(task2);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, tex.getQueueSize());
+  tex.update();
+  CPPUNIT_ASSERT(!task1->started_);
+  CPPUNIT_ASSERT(task2->started_);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, tex.getQueueSize());
+  task2->finished_ = true;
+  tex.update();
+  CPPUNIT_ASSERT(task1->started_);
+  CPPUNIT_ASSERT_EQUAL((size_t)0, tex.getQueueSize());
+}
+
 } // namespace aria2
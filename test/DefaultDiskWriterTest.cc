@@ -2,6 +2,13 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "a2functional.h"
+#include "File.h"
+#include "TestUtil.h"
+#include "SharedFileDescriptor.h"
+#include "OpenedFileCounter.h"
+#include "RequestGroupMan.h"
+#include "RequestGroup.h"
+#include "Option.h"
 
 namespace aria2 {
 
@@ -9,6 +16,8 @@ class DefaultDiskWriterTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(DefaultDiskWriterTest);
   CPPUNIT_TEST(testSize);
+  CPPUNIT_TEST(testWriteDataV);
+  CPPUNIT_TEST(testShareFileDescriptor);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -16,6 +25,8 @@ public:
   void setUp() {}
 
   void testSize();
+  void testWriteDataV();
+  void testShareFileDescriptor();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DefaultDiskWriterTest);
@@ -28,4 +39,69 @@ void DefaultDiskWriterTest::testSize()
   CPPUNIT_ASSERT_EQUAL((int64_t)4_k, dw.size());
 }
 
+void DefaultDiskWriterTest::testWriteDataV()
+{
+  std::string path =
+      A2_TEST_OUT_DIR "/aria2_DefaultDiskWriterTest_testWriteDataV";
+  File(path).remove();
+  DefaultDiskWriter dw(path);
+  dw.openFile();
+  std::string data1 = "hello", data2 = "", data3 = " world";
+  a2iovec iov[3];
+  iov[0].A2IOVEC_BASE = &data1[0];
+  iov[0].A2IOVEC_LEN = data1.size();
+  iov[1].A2IOVEC_BASE = &data2[0];
+  iov[1].A2IOVEC_LEN = data2.size();
+  iov[2].A2IOVEC_BASE = &data3[0];
+  iov[2].A2IOVEC_LEN = data3.size();
+  dw.writeDataV(iov, 3, 3);
+  // Empty buffers alone are not treated as no progress.
+  dw.writeDataV(&iov[1], 1, 0);
+  dw.writeData(reinterpret_cast<const unsigned char*>("abc"), 3, 0);
+  CPPUNIT_ASSERT_EQUAL((int64_t)14, dw.size());
+
+  unsigned char buf[14];
+  CPPUNIT_ASSERT_EQUAL((ssize_t)6, dw.readData(buf, 6, 8));
+  CPPUNIT_ASSERT_EQUAL(std::string(" world"), std::string(&buf[0], &buf[6]));
+  CPPUNIT_ASSERT_EQUAL((ssize_t)14, dw.readData(buf, sizeof(buf), 0));
+  CPPUNIT_ASSERT_EQUAL(std::string("abchello world"),
+                       std::string(&buf[0], &buf[14]));
+  dw.closeFile();
+}
+
+void DefaultDiskWriterTest::testShareFileDescriptor()
+{
+#ifndef __MINGW32__
+  Option option;
+  RequestGroupMan rgman(std::vector<std::shared_ptr<RequestGroup>>{}, 0,
+                        &option);
+  auto counter = std::make_shared<OpenedFileCounter>(&rgman, 1);
+  DefaultDiskWriter dw1(A2_TEST_DIR "/4096chunk.txt");
+  DefaultDiskWriter dw2(A2_TEST_DIR "/4096chunk.txt");
+  dw1.enableReadOnly();
+  dw1.openExistingFile();
+  dw2.enableReadOnly();
+  dw2.openExistingFile();
+
+  auto fd = dw1.shareFileDescriptor(counter);
+  CPPUNIT_ASSERT(fd);
+  // The same descriptor is shared until the file is closed.
+  CPPUNIT_ASSERT(fd == dw1.shareFileDescriptor(counter));
+  // No room for another descriptor.
+  CPPUNIT_ASSERT(!dw2.shareFileDescriptor(counter));
+
+  // The descriptor stays open after the file is closed.
+  dw1.closeFile();
+  CPPUNIT_ASSERT(!dw1.shareFileDescriptor(counter));
+  unsigned char buf[1];
+  CPPUNIT_ASSERT_EQUAL((ssize_t)1, pread(fd->getFd(), buf, 1, 0));
+  CPPUNIT_ASSERT(!dw2.shareFileDescriptor(counter));
+
+  // Releasing the last reference makes room for another one.
+  fd.reset();
+  CPPUNIT_ASSERT(dw2.shareFileDescriptor(counter));
+  dw2.closeFile();
+#endif // !__MINGW32__
+}
+
 } // namespace aria2
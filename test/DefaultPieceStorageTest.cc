@@ -27,6 +27,7 @@ class DefaultPieceStorageTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testGetMissingPiece_many);
   CPPUNIT_TEST(testGetMissingPiece_excludedIndexes);
   CPPUNIT_TEST(testGetMissingPiece_manyWithExcludedIndexes);
+  CPPUNIT_TEST(testGetMissingPiece_rarest);
   CPPUNIT_TEST(testGetMissingFastPiece);
   CPPUNIT_TEST(testGetMissingFastPiece_excludedIndexes);
   CPPUNIT_TEST(testHasMissingPiece);
@@ -66,6 +67,7 @@ public:
   void testGetMissingPiece_many();
   void testGetMissingPiece_excludedIndexes();
   void testGetMissingPiece_manyWithExcludedIndexes();
+  void testGetMissingPiece_rarest();
   void testGetMissingFastPiece();
   void testGetMissingFastPiece_excludedIndexes();
   void testHasMissingPiece();
@@ -172,6 +174,30 @@ void DefaultPieceStorageTest::testGetMissingPiece_manyWithExcludedIndexes()
   CPPUNIT_ASSERT(pieces.empty());
 }
 
+void DefaultPieceStorageTest::testGetMissingPiece_rarest()
+{
+  DefaultPieceStorage pss(dctx_, option_.get());
+  peer->setAllBitfield();
+  pss.addPieceStats(peer->getBitfield(), peer->getBitfieldLength());
+
+  pss.markAllPiecesDone();
+  CPPUNIT_ASSERT(!pss.getMissingPiece(peer, 1));
+  // A piece which failed a later check is selected again.
+  pss.markPieceMissing(1);
+  auto piece = pss.getMissingPiece(peer, 1);
+  CPPUNIT_ASSERT(piece);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, piece->getIndex());
+  CPPUNIT_ASSERT(!pss.getMissingPiece(peer, 1));
+
+  pss.markPiecesDone(0);
+  for (int i = 0; i < 2; ++i) {
+    CPPUNIT_ASSERT(pss.getMissingPiece(peer, 1));
+  }
+  pss.cancelPiece(piece, 1);
+  CPPUNIT_ASSERT(pss.getMissingPiece(peer, 1));
+  CPPUNIT_ASSERT(!pss.getMissingPiece(peer, 1));
+}
+
 void DefaultPieceStorageTest::testGetMissingFastPiece()
 {
   DefaultPieceStorage pss(dctx_, option_.get());
@@ -0,0 +1,44 @@
+#include "DownloadEngine.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "SelectEventPoll.h"
+#include "wallclock.h"
+
+namespace aria2 {
+
+class DownloadEngineTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(DownloadEngineTest);
+  CPPUNIT_TEST(testMarkPipeliningUnsupported);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void tearDown() { global::wallclock().reset(); }
+
+  void testMarkPipeliningUnsupported();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DownloadEngineTest);
+
+void DownloadEngineTest::testMarkPipeliningUnsupported()
+{
+  DownloadEngine e(make_unique<SelectEventPoll>());
+  global::wallclock().reset();
+
+  e.markPipeliningUnsupported("localhost", 80);
+  CPPUNIT_ASSERT(e.isPipeliningUnsupported("localhost", 80));
+  CPPUNIT_ASSERT(!e.isPipeliningUnsupported("localhost", 8080));
+  CPPUNIT_ASSERT(!e.isPipeliningUnsupported("example.org", 80));
+
+  global::wallclock().advance(59_min);
+  e.markPipeliningUnsupported("example.org", 80);
+  CPPUNIT_ASSERT(e.isPipeliningUnsupported("localhost", 80));
+
+  // The server is given another chance after an hour.
+  global::wallclock().advance(1_min);
+  CPPUNIT_ASSERT(!e.isPipeliningUnsupported("localhost", 80));
+  CPPUNIT_ASSERT(e.isPipeliningUnsupported("example.org", 80));
+}
+
+} // namespace aria2
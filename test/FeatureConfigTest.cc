@@ -50,6 +50,13 @@ void FeatureConfigTest::testStrSupportedFeature()
 #else  // !HAVE_LIBSSH2
   CPPUNIT_ASSERT(!sftp);
 #endif // !HAVE_LIBSSH2
+
+  auto http2 = strSupportedFeature(FEATURE_HTTP2);
+#ifdef HAVE_LIBNGHTTP2
+  CPPUNIT_ASSERT(http2);
+#else  // !HAVE_LIBNGHTTP2
+  CPPUNIT_ASSERT(!http2);
+#endif // !HAVE_LIBNGHTTP2
 }
 
 void FeatureConfigTest::testFeatureSummary()
@@ -89,6 +96,10 @@ void FeatureConfigTest::testFeatureSummary()
 #ifdef HAVE_LIBSSH2
       "SFTP",
 #endif // HAVE_LIBSSH2
+
+#ifdef HAVE_LIBNGHTTP2
+      "HTTP/2",
+#endif // HAVE_LIBNGHTTP2
   };
 
   std::string featuresString =
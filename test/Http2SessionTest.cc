@@ -0,0 +1,287 @@
+#include "Http2Session.h"
+
+#include <cstring>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "SocketCore.h"
+#include "HttpHeader.h"
+#include "RecoverableException.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class Http2SessionTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(Http2SessionTest);
+  CPPUNIT_TEST(testRequest);
+  CPPUNIT_TEST(testFlowControl);
+  CPPUNIT_TEST(testCloseStream);
+  CPPUNIT_TEST(testTerminate);
+  CPPUNIT_TEST_SUITE_END();
+
+  std::shared_ptr<SocketCore> client_;
+  std::shared_ptr<SocketCore> inbound_;
+  nghttp2_session* server_;
+  // The length of the response body the server sends
+  size_t bodyLength_;
+  size_t bodySent_;
+  uint32_t serverStreamCloseError_;
+  bool serverStreamClosed_;
+  bool serverGoawayReceived_;
+
+public:
+  void setUp()
+  {
+    SocketCore server;
+    server.bind(0);
+    server.beginListen();
+    server.setBlockingMode();
+    auto endpoint = server.getAddrInfo();
+
+    client_ = std::make_shared<SocketCore>();
+    client_->establishConnection("localhost", endpoint.port);
+    while (!client_->isWritable(0)) {
+    }
+    inbound_ = server.acceptConnection();
+    inbound_->setBlockingMode();
+
+    bodyLength_ = 0;
+    bodySent_ = 0;
+    serverStreamCloseError_ = NGHTTP2_NO_ERROR;
+    serverStreamClosed_ = false;
+    serverGoawayReceived_ = false;
+
+    nghttp2_session_callbacks* callbacks;
+    nghttp2_session_callbacks_new(&callbacks);
+    nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks,
+                                                         onFrameRecvCallback);
+    nghttp2_session_callbacks_set_on_stream_close_callback(
+        callbacks, onStreamCloseCallback);
+    nghttp2_session_server_new(&server_, callbacks, this);
+    nghttp2_session_callbacks_del(callbacks);
+    nghttp2_submit_settings(server_, NGHTTP2_FLAG_NONE, nullptr, 0);
+  }
+
+  void tearDown()
+  {
+    nghttp2_session_del(server_);
+    client_.reset();
+    inbound_.reset();
+  }
+
+  void testRequest();
+  void testFlowControl();
+  void testCloseStream();
+  void testTerminate();
+
+private:
+  static ssize_t readBodyCallback(nghttp2_session* session, int32_t streamId,
+                                  uint8_t* buf, size_t length,
+                                  uint32_t* dataFlags,
+                                  nghttp2_data_source* source, void* userData)
+  {
+    auto t = static_cast<Http2SessionTest*>(userData);
+    auto n = std::min(length, t->bodyLength_ - t->bodySent_);
+    memset(buf, 'a', n);
+    t->bodySent_ += n;
+    if (t->bodySent_ == t->bodyLength_) {
+      *dataFlags |= NGHTTP2_DATA_FLAG_EOF;
+    }
+    return n;
+  }
+
+  static int onFrameRecvCallback(nghttp2_session* session,
+                                 const nghttp2_frame* frame, void* userData)
+  {
+    if (frame->hd.type == NGHTTP2_GOAWAY) {
+      static_cast<Http2SessionTest*>(userData)->serverGoawayReceived_ = true;
+      return 0;
+    }
+    if (frame->hd.type != NGHTTP2_HEADERS ||
+        !(frame->hd.flags & NGHTTP2_FLAG_END_STREAM)) {
+      return 0;
+    }
+    nghttp2_nv nva[] = {
+        {(uint8_t*)":status", (uint8_t*)"200", 7, 3, NGHTTP2_NV_FLAG_NONE}};
+    nghttp2_data_provider prd;
+    prd.read_callback = readBodyCallback;
+    nghttp2_submit_response(session, frame->hd.stream_id, nva, 1, &prd);
+    return 0;
+  }
+
+  static int onStreamCloseCallback(nghttp2_session* session, int32_t streamId,
+                                   uint32_t errorCode, void* userData)
+  {
+    auto t = static_cast<Http2SessionTest*>(userData);
+    t->serverStreamClosed_ = true;
+    t->serverStreamCloseError_ = errorCode;
+    return 0;
+  }
+
+  // Exchanges frames between |session| and the server until no more
+  // data are exchanged.
+  void exchange(Http2Session& session)
+  {
+    for (int i = 0; i < 100; ++i) {
+      session.performIO();
+      bool progress = false;
+      while (inbound_->isReadable(0)) {
+        unsigned char buf[16_k];
+        size_t len = sizeof(buf);
+        inbound_->readData(buf, len);
+        if (len == 0) {
+          break;
+        }
+        CPPUNIT_ASSERT_EQUAL((ssize_t)len,
+                             nghttp2_session_mem_recv(server_, buf, len));
+        progress = true;
+      }
+      for (;;) {
+        const uint8_t* data;
+        auto n = nghttp2_session_mem_send(server_, &data);
+        if (n <= 0) {
+          break;
+        }
+        inbound_->writeData(data, n);
+        progress = true;
+      }
+      if (!progress && !client_->isReadable(0)) {
+        return;
+      }
+    }
+  }
+
+  std::vector<std::pair<std::string, std::string>> createRequest()
+  {
+    return {{":method", "GET"},
+            {":scheme", "http"},
+            {":authority", "localhost"},
+            {":path", "/"}};
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(Http2SessionTest);
+
+void Http2SessionTest::testRequest()
+{
+  bodyLength_ = 100;
+  Http2Session session("http://localhost:80", 64_k, nullptr);
+  CPPUNIT_ASSERT(session.isUsable());
+  // Request submitted before the connection is established is sent
+  // later.
+  auto stream = session.submitRequest(createRequest(), nullptr);
+  CPPUNIT_ASSERT_EQUAL((int32_t)1, stream->getStreamId());
+  CPPUNIT_ASSERT_EQUAL((size_t)1, session.countStream());
+  session.onConnected(client_);
+  CPPUNIT_ASSERT_EQUAL(Http2Session::STATE_CONNECTED, session.getState());
+
+  exchange(session);
+
+  CPPUNIT_ASSERT(stream->headersReceived());
+  CPPUNIT_ASSERT_EQUAL(200, stream->getHttpHeader()->getStatusCode());
+  CPPUNIT_ASSERT(stream->closed());
+  CPPUNIT_ASSERT_EQUAL((uint32_t)NGHTTP2_NO_ERROR, stream->getErrorCode());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, session.countStream());
+  CPPUNIT_ASSERT(session.hasBufferedData() == false);
+
+  unsigned char buf[256];
+  CPPUNIT_ASSERT_EQUAL((size_t)100, stream->getBufferedLength());
+  CPPUNIT_ASSERT_EQUAL((size_t)60, session.readData(stream.get(), buf, 60));
+  CPPUNIT_ASSERT_EQUAL(std::string(60, 'a'),
+                       std::string(&buf[0], &buf[60]));
+  CPPUNIT_ASSERT_EQUAL((size_t)40,
+                       session.readData(stream.get(), buf, sizeof(buf)));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, stream->getBufferedLength());
+  session.closeStream(stream);
+}
+
+void Http2SessionTest::testFlowControl()
+{
+  bodyLength_ = 100_k;
+  Http2Session session("http://localhost:80", 16_k, nullptr);
+  session.onConnected(client_);
+  auto stream = session.submitRequest(createRequest(), nullptr);
+
+  exchange(session);
+
+  // The server cannot send more than the window until the data are
+  // read.
+  CPPUNIT_ASSERT(stream->headersReceived());
+  CPPUNIT_ASSERT(!stream->closed());
+  CPPUNIT_ASSERT_EQUAL((size_t)16_k, stream->getBufferedLength());
+  CPPUNIT_ASSERT(session.hasBufferedData());
+
+  size_t total = 0;
+  unsigned char buf[4_k];
+  for (int i = 0; i < 1000 && !stream->closed(); ++i) {
+    size_t n;
+    while ((n = session.readData(stream.get(), buf, sizeof(buf))) > 0) {
+      total += n;
+    }
+    exchange(session);
+    CPPUNIT_ASSERT(stream->getBufferedLength() <= 16_k);
+  }
+  CPPUNIT_ASSERT(stream->closed());
+  size_t n;
+  while ((n = session.readData(stream.get(), buf, sizeof(buf))) > 0) {
+    total += n;
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)100_k, total);
+  session.closeStream(stream);
+}
+
+void Http2SessionTest::testCloseStream()
+{
+  bodyLength_ = 100_k;
+  Http2Session session("http://localhost:80", 16_k, nullptr);
+  session.onConnected(client_);
+  auto stream = session.submitRequest(createRequest(), nullptr);
+
+  exchange(session);
+  CPPUNIT_ASSERT(stream->headersReceived());
+  CPPUNIT_ASSERT(!serverStreamClosed_);
+
+  session.closeStream(stream);
+  CPPUNIT_ASSERT_EQUAL((size_t)0, session.countStream());
+  exchange(session);
+  CPPUNIT_ASSERT(serverStreamClosed_);
+  CPPUNIT_ASSERT_EQUAL((uint32_t)NGHTTP2_CANCEL, serverStreamCloseError_);
+  // The session is still usable for other requests.
+  CPPUNIT_ASSERT(session.isUsable());
+}
+
+void Http2SessionTest::testTerminate()
+{
+  bodyLength_ = 100_k;
+  Http2Session session("http://localhost:80", 16_k, nullptr);
+  session.onConnected(client_);
+  auto stream = session.submitRequest(createRequest(), nullptr);
+
+  exchange(session);
+  session.terminate("bye");
+  CPPUNIT_ASSERT_EQUAL(Http2Session::STATE_CLOSED, session.getState());
+  CPPUNIT_ASSERT_EQUAL(std::string("bye"), session.getError());
+  CPPUNIT_ASSERT(!session.isUsable());
+  CPPUNIT_ASSERT(stream->closed());
+  CPPUNIT_ASSERT_EQUAL((uint32_t)NGHTTP2_INTERNAL_ERROR,
+                       stream->getErrorCode());
+  // The data received before termination are still readable.
+  CPPUNIT_ASSERT_EQUAL((size_t)16_k, stream->getBufferedLength());
+  try {
+    session.submitRequest(createRequest(), nullptr);
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (RecoverableException& e) {
+  }
+  session.closeStream(stream);
+
+  // GOAWAY was sent to the server.
+  unsigned char buf[256];
+  size_t len = sizeof(buf);
+  inbound_->readData(buf, len);
+  CPPUNIT_ASSERT(len > 0);
+  nghttp2_session_mem_recv(server_, buf, len);
+  CPPUNIT_ASSERT(serverGoawayReceived_);
+}
+
+} // namespace aria2
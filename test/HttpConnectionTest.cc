@@ -0,0 +1,176 @@
+#include "HttpConnection.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "HttpRequest.h"
+#include "HttpResponse.h"
+#include "HttpHeader.h"
+#include "Range.h"
+#include "Request.h"
+#include "FileEntry.h"
+#include "Piece.h"
+#include "PiecedSegment.h"
+#include "Option.h"
+#include "AuthConfigFactory.h"
+#include "SocketCore.h"
+#include "SocketRecvBuffer.h"
+#include "DlAbortEx.h"
+
+namespace aria2 {
+
+class HttpConnectionTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(HttpConnectionTest);
+  CPPUNIT_TEST(testPipelinedRequests);
+  CPPUNIT_TEST(testReceiveResponse_noRequest);
+  CPPUNIT_TEST_SUITE_END();
+
+  std::shared_ptr<SocketCore> client_;
+  std::shared_ptr<SocketCore> inbound_;
+  std::unique_ptr<Option> option_;
+  std::unique_ptr<AuthConfigFactory> authConfigFactory_;
+  std::shared_ptr<Request> request_;
+  std::shared_ptr<FileEntry> fileEntry_;
+
+public:
+  void setUp()
+  {
+    SocketCore server;
+    server.bind(0);
+    server.beginListen();
+    server.setBlockingMode();
+    auto endpoint = server.getAddrInfo();
+
+    client_ = std::make_shared<SocketCore>();
+    client_->establishConnection("localhost", endpoint.port);
+    while (!client_->isWritable(0)) {
+    }
+    inbound_ = server.acceptConnection();
+    inbound_->setBlockingMode();
+
+    option_ = make_unique<Option>();
+    authConfigFactory_ = make_unique<AuthConfigFactory>();
+    request_ = std::make_shared<Request>();
+    request_->setUri("http://localhost/file");
+    request_->setPipeliningHint(true);
+    fileEntry_ = std::make_shared<FileEntry>("file", 20, 0);
+  }
+
+  void tearDown()
+  {
+    client_.reset();
+    inbound_.reset();
+  }
+
+  void testPipelinedRequests();
+  void testReceiveResponse_noRequest();
+
+private:
+  std::unique_ptr<HttpRequest>
+  createHttpRequest(const std::shared_ptr<Segment>& segment)
+  {
+    auto httpRequest = make_unique<HttpRequest>();
+    httpRequest->setRequest(request_);
+    httpRequest->setFileEntry(fileEntry_);
+    httpRequest->setSegment(segment);
+    httpRequest->setAuthConfigFactory(authConfigFactory_.get());
+    httpRequest->setOption(option_.get());
+    return httpRequest;
+  }
+
+  std::unique_ptr<HttpResponse> receiveResponse(HttpConnection& conn)
+  {
+    for (int i = 0; i < 100; ++i) {
+      auto httpResponse = conn.receiveResponse();
+      if (httpResponse) {
+        return httpResponse;
+      }
+      client_->isReadable(1);
+    }
+    return nullptr;
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HttpConnectionTest);
+
+void HttpConnectionTest::testPipelinedRequests()
+{
+  auto segment1 =
+      std::make_shared<PiecedSegment>(10, std::make_shared<Piece>(0, 10));
+  auto segment2 =
+      std::make_shared<PiecedSegment>(10, std::make_shared<Piece>(1, 10));
+  auto recvBuffer = std::make_shared<SocketRecvBuffer>(client_);
+  HttpConnection conn(1, client_, recvBuffer);
+
+  conn.sendRequest(createHttpRequest(segment1));
+  CPPUNIT_ASSERT_EQUAL((size_t)1, conn.countOutstandingRequest());
+  CPPUNIT_ASSERT(conn.isIssued(segment1));
+  CPPUNIT_ASSERT(!conn.isIssued(segment2));
+  // The second request is sent without waiting for the first
+  // response.
+  conn.sendRequest(createHttpRequest(segment2));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, conn.countOutstandingRequest());
+  CPPUNIT_ASSERT(conn.isIssued(segment2));
+  CPPUNIT_ASSERT(conn.sendBufferIsEmpty());
+
+  std::string received;
+  while (received.find("bytes=10-19") == std::string::npos) {
+    char buf[4096];
+    size_t len = sizeof(buf);
+    inbound_->readData(buf, len);
+    CPPUNIT_ASSERT(len > 0);
+    received.append(buf, len);
+  }
+  CPPUNIT_ASSERT(received.find("Range: bytes=0-9\r\n") <
+                 received.find("Range: bytes=10-19\r\n"));
+
+  // Both responses arrive in a row, followed by their bodies.
+  std::string res = "HTTP/1.1 206 Partial Content\r\n"
+                    "Content-Range: bytes 0-9/20\r\n"
+                    "Content-Length: 10\r\n"
+                    "\r\n"
+                    "0123456789"
+                    "HTTP/1.1 206 Partial Content\r\n"
+                    "Content-Range: bytes 10-19/20\r\n"
+                    "Content-Length: 10\r\n"
+                    "\r\n"
+                    "abcdefghij";
+  inbound_->writeData(res.data(), res.size());
+
+  auto httpResponse = receiveResponse(conn);
+  CPPUNIT_ASSERT(httpResponse);
+  CPPUNIT_ASSERT_EQUAL((int64_t)9,
+                       httpResponse->getHttpHeader()->getRange().endByte);
+  CPPUNIT_ASSERT(*segment1 == *httpResponse->getHttpRequest()->getSegment());
+  CPPUNIT_ASSERT_EQUAL((size_t)1, conn.countOutstandingRequest());
+  CPPUNIT_ASSERT(!conn.isIssued(segment1));
+
+  while (recvBuffer->getBufferLength() < 10) {
+    recvBuffer->recv();
+  }
+  CPPUNIT_ASSERT_EQUAL(std::string("0123456789"),
+                       std::string(&recvBuffer->getBuffer()[0],
+                                   &recvBuffer->getBuffer()[10]));
+  recvBuffer->drain(10);
+
+  httpResponse = receiveResponse(conn);
+  CPPUNIT_ASSERT(httpResponse);
+  CPPUNIT_ASSERT_EQUAL((int64_t)19,
+                       httpResponse->getHttpHeader()->getRange().endByte);
+  CPPUNIT_ASSERT(*segment2 == *httpResponse->getHttpRequest()->getSegment());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, conn.countOutstandingRequest());
+}
+
+void HttpConnectionTest::testReceiveResponse_noRequest()
+{
+  HttpConnection conn(1, client_, std::make_shared<SocketRecvBuffer>(client_));
+  try {
+    conn.receiveResponse();
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (DlAbortEx& e) {
+    // success
+  }
+}
+
+} // namespace aria2
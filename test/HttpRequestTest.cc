@@ -1,6 +1,7 @@
 #include "HttpRequest.h"
 
 #include <sstream>
+#include <algorithm>
 
 #include <cppunit/extensions/HelperMacros.h>
 
@@ -34,6 +35,7 @@ class HttpRequestTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testCreateRequest_endOffsetOverride);
   CPPUNIT_TEST(testCreateRequest_wantDigest);
   CPPUNIT_TEST(testCreateProxyRequest);
+  CPPUNIT_TEST(testCreateHttp2Request);
   CPPUNIT_TEST(testIsRangeSatisfied);
   CPPUNIT_TEST(testUserAgent);
   CPPUNIT_TEST(testAddHeader);
@@ -65,6 +67,7 @@ public:
   void testCreateRequest_endOffsetOverride();
   void testCreateRequest_wantDigest();
   void testCreateProxyRequest();
+  void testCreateHttp2Request();
   void testIsRangeSatisfied();
   void testUserAgent();
   void testAddHeader();
@@ -696,6 +699,57 @@ void HttpRequestTest::testCreateProxyRequest()
   CPPUNIT_ASSERT_EQUAL(expectedText, httpRequest.createProxyRequest());
 }
 
+void HttpRequestTest::testCreateHttp2Request()
+{
+  auto request = std::make_shared<Request>();
+  request->setUri("https://localhost:8443/archives/aria2-1.0.0.tar.bz2?a=b");
+
+  auto p = std::make_shared<Piece>(1, 1_m);
+  auto segment = std::make_shared<PiecedSegment>(1_m, p);
+  auto fileEntry = std::make_shared<FileEntry>("file", 10_m, 0);
+
+  HttpRequest httpRequest;
+  httpRequest.disableContentEncoding();
+  httpRequest.setRequest(request);
+  httpRequest.setSegment(segment);
+  httpRequest.setFileEntry(fileEntry);
+  httpRequest.setEndOffsetOverride(3_m);
+  httpRequest.setAuthConfigFactory(authConfigFactory_.get());
+  httpRequest.setOption(option_.get());
+  httpRequest.setNoWantDigest(true);
+  httpRequest.addHeader("X-ARIA2: v0.13\nUpgrade: h2c\nTE: trailers");
+
+  auto nva = httpRequest.createHttp2Request();
+  std::vector<std::pair<std::string, std::string>> expected{
+      {":method", "GET"},
+      {":scheme", "https"},
+      {":authority", "localhost:8443"},
+      {":path", "/archives/aria2-1.0.0.tar.bz2?a=b"},
+      {"user-agent", "aria2"},
+      {"accept", "*/*"},
+      {"pragma", "no-cache"},
+      {"cache-control", "no-cache"},
+      {"range", "bytes=1048576-3145727"},
+      {"x-aria2", "v0.13"}};
+  CPPUNIT_ASSERT_EQUAL(expected.size(), nva.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    CPPUNIT_ASSERT_EQUAL(expected[i].first, nva[i].first);
+    CPPUNIT_ASSERT_EQUAL(expected[i].second, nva[i].second);
+  }
+
+  // Host header given by user overrides :authority
+  httpRequest.clearHeader();
+  httpRequest.addHeader("Host: example.org");
+  nva = httpRequest.createHttp2Request();
+  CPPUNIT_ASSERT_EQUAL(std::string(":authority"), nva[2].first);
+  CPPUNIT_ASSERT_EQUAL(std::string("example.org"), nva[2].second);
+  CPPUNIT_ASSERT(std::none_of(
+      std::begin(nva), std::end(nva),
+      [](const std::pair<std::string, std::string>& nv) {
+        return nv.first == "host";
+      }));
+}
+
 void HttpRequestTest::testIsRangeSatisfied()
 {
   auto request = std::make_shared<Request>();
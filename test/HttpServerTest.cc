@@ -4,16 +4,19 @@
 
 #include "SocketCore.h"
 #include "a2functional.h"
+#include "util.h"
 
 namespace aria2 {
 
 class HttpServerTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(HttpServerTest);
   CPPUNIT_TEST(testHttpBasicAuth);
+  CPPUNIT_TEST(testFeedResponse_source);
   CPPUNIT_TEST_SUITE_END();
 
 public:
   void testHttpBasicAuth();
+  void testFeedResponse_source();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(HttpServerTest);
@@ -189,4 +192,104 @@ void HttpServerTest::testHttpBasicAuth()
   }
 }
 
+namespace {
+class TestBufferSource : public BufferSource {
+public:
+  TestBufferSource(size_t numChunks) : numChunks_(numChunks) {}
+
+  virtual bool read(std::string& buf) CXX11_OVERRIDE
+  {
+    buf.append(10_k, 'a');
+    return --numChunks_ == 0;
+  }
+
+private:
+  size_t numChunks_;
+};
+} // namespace
+
+namespace {
+std::string sendResponse(SocketCore& server, const std::string& request,
+                         size_t numChunks)
+{
+  auto endpoint = server.getAddrInfo();
+
+  SocketCore client;
+  client.establishConnection("localhost", endpoint.port);
+  while (!client.isWritable(0)) {
+  }
+  client.setBlockingMode();
+
+  auto inbound = server.acceptConnection();
+  inbound->setBlockingMode();
+  HttpServer httpServer(inbound);
+
+  client.writeData(request);
+  while (!httpServer.receiveRequest()) {
+  }
+  httpServer.feedResponse(make_unique<TestBufferSource>(numChunks),
+                          "text/plain");
+  while (!httpServer.sendBufferIsEmpty()) {
+    httpServer.sendResponse();
+  }
+  inbound->closeConnection();
+
+  std::string res;
+  for (;;) {
+    char buf[4_k];
+    size_t len = sizeof(buf);
+    client.readData(buf, len);
+    if (len == 0) {
+      break;
+    }
+    res.append(buf, len);
+  }
+  return res;
+}
+} // namespace
+
+void HttpServerTest::testFeedResponse_source()
+{
+  SocketCore server;
+  server.bind(0);
+  server.beginListen();
+  server.setBlockingMode();
+
+  {
+    // Small body is sent with Content-Length
+    auto res = sendResponse(server, "GET / HTTP/1.1\r\n\r\n", 2);
+    CPPUNIT_ASSERT(res.find("Content-Length: 20480\r\n") !=
+                   std::string::npos);
+    CPPUNIT_ASSERT(util::endsWith(res, "\r\n\r\n" + std::string(20_k, 'a')));
+  }
+  {
+    // Large body is sent with chunked transfer-encoding
+    auto res = sendResponse(server, "GET / HTTP/1.1\r\n\r\n", 10);
+    CPPUNIT_ASSERT(res.find("Transfer-Encoding: chunked\r\n") !=
+                   std::string::npos);
+    CPPUNIT_ASSERT(res.find("Content-Length") == std::string::npos);
+    std::string body = res.substr(res.find("\r\n\r\n") + 4);
+    std::string data;
+    for (;;) {
+      auto eol = body.find("\r\n");
+      size_t len = strtoul(body.substr(0, eol).c_str(), nullptr, 16);
+      if (len == 0) {
+        CPPUNIT_ASSERT_EQUAL(std::string("0\r\n\r\n"), body);
+        break;
+      }
+      data += body.substr(eol + 2, len);
+      CPPUNIT_ASSERT_EQUAL(std::string("\r\n"), body.substr(eol + 2 + len, 2));
+      body = body.substr(eol + 4 + len);
+    }
+    CPPUNIT_ASSERT_EQUAL(std::string(100_k, 'a'), data);
+  }
+  {
+    // HTTP/1.0 client gets the body delimited by closing connection
+    auto res = sendResponse(server, "GET / HTTP/1.0\r\n\r\n", 10);
+    CPPUNIT_ASSERT(res.find("Connection: close\r\n") != std::string::npos);
+    CPPUNIT_ASSERT(res.find("Transfer-Encoding") == std::string::npos);
+    CPPUNIT_ASSERT(util::endsWith(res, "\r\n\r\n" + std::string(100_k, 'a')));
+  }
+}
+
 } // namespace aria2
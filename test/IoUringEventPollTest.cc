@@ -0,0 +1,199 @@
+#include "IoUringEventPoll.h"
+
+#include <unistd.h>
+#include <poll.h>
+
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Command.h"
+
+namespace aria2 {
+
+class IoUringEventPollTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(IoUringEventPollTest);
+  CPPUNIT_TEST(testAddDeleteEvents);
+  CPPUNIT_TEST(testReAddEvents);
+  CPPUNIT_TEST(testSubmissionQueueFull);
+  CPPUNIT_TEST(testDeleteEvents_releaseFile);
+  CPPUNIT_TEST_SUITE_END();
+
+  std::vector<int> fds_;
+
+public:
+  void tearDown()
+  {
+    for (auto fd : fds_) {
+      close(fd);
+    }
+    fds_.clear();
+  }
+
+  void testAddDeleteEvents();
+  void testReAddEvents();
+  void testSubmissionQueueFull();
+  void testDeleteEvents_releaseFile();
+
+private:
+  // Returns the read end of a new pipe which has data to read.
+  int createReadablePipe()
+  {
+    int fds[2];
+    CPPUNIT_ASSERT_EQUAL(0, pipe(fds));
+    fds_.push_back(fds[0]);
+    fds_.push_back(fds[1]);
+    CPPUNIT_ASSERT_EQUAL((ssize_t)1, write(fds[1], "a", 1));
+    return fds[0];
+  }
+
+  // Creates a pipe with no data, and returns its both ends.  Only the
+  // write end is closed in tearDown().
+  std::pair<int, int> createIdlePipe()
+  {
+    int fds[2];
+    CPPUNIT_ASSERT_EQUAL(0, pipe(fds));
+    fds_.push_back(fds[1]);
+    return {fds[0], fds[1]};
+  }
+
+  static void poll(IoUringEventPoll& e)
+  {
+    struct timeval tv = {0, 100000};
+    e.poll(tv);
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(IoUringEventPollTest);
+
+namespace {
+class MockCommand : public Command {
+public:
+  MockCommand() : Command(1) {}
+
+  virtual bool execute() CXX11_OVERRIDE { return true; }
+
+  using Command::readEventEnabled;
+  using Command::clearIOEvents;
+};
+} // namespace
+
+void IoUringEventPollTest::testAddDeleteEvents()
+{
+  IoUringEventPoll e;
+  if (!e.good()) {
+    return;
+  }
+  int fd = createReadablePipe();
+  MockCommand command;
+  CPPUNIT_ASSERT(e.addEvents(fd, &command, EventPoll::EVENT_READ));
+  poll(e);
+  CPPUNIT_ASSERT(command.readEventEnabled());
+
+  command.clearIOEvents();
+  CPPUNIT_ASSERT(e.deleteEvents(fd, &command, EventPoll::EVENT_READ));
+  // Deleting twice fails.
+  CPPUNIT_ASSERT(!e.deleteEvents(fd, &command, EventPoll::EVENT_READ));
+  poll(e);
+  CPPUNIT_ASSERT(!command.readEventEnabled());
+}
+
+void IoUringEventPollTest::testReAddEvents()
+{
+  IoUringEventPoll e;
+  if (!e.good()) {
+    return;
+  }
+  int fd = createReadablePipe();
+  MockCommand command;
+  CPPUNIT_ASSERT(e.addEvents(fd, &command, EventPoll::EVENT_READ));
+  poll(e);
+  CPPUNIT_ASSERT(command.readEventEnabled());
+
+  // Delete and re-add the same descriptor before the removal is
+  // submitted.
+  CPPUNIT_ASSERT(e.deleteEvents(fd, &command, EventPoll::EVENT_READ));
+  CPPUNIT_ASSERT(e.addEvents(fd, &command, EventPoll::EVENT_READ));
+  command.clearIOEvents();
+  poll(e);
+  CPPUNIT_ASSERT(command.readEventEnabled());
+
+  // Delete after the removal is submitted, and then re-add.
+  CPPUNIT_ASSERT(e.deleteEvents(fd, &command, EventPoll::EVENT_READ));
+  command.clearIOEvents();
+  poll(e);
+  CPPUNIT_ASSERT(!command.readEventEnabled());
+  CPPUNIT_ASSERT(e.addEvents(fd, &command, EventPoll::EVENT_READ));
+  poll(e);
+  CPPUNIT_ASSERT(command.readEventEnabled());
+}
+
+void IoUringEventPollTest::testSubmissionQueueFull()
+{
+  // Much more sockets than the submission queue entries, and all of
+  // them are readable, so that the completion queue overflows, too.
+  IoUringEventPoll e(4);
+  if (!e.good()) {
+    return;
+  }
+  const size_t numCommands = 64;
+  std::vector<MockCommand> commands(numCommands);
+  std::vector<int> fds;
+  for (size_t i = 0; i < numCommands; ++i) {
+    fds.push_back(createReadablePipe());
+    CPPUNIT_ASSERT(e.addEvents(fds[i], &commands[i], EventPoll::EVENT_READ));
+  }
+  for (int i = 0; i < 10; ++i) {
+    poll(e);
+  }
+  for (auto& command : commands) {
+    CPPUNIT_ASSERT(command.readEventEnabled());
+  }
+
+  for (size_t i = 0; i < numCommands; ++i) {
+    CPPUNIT_ASSERT(e.deleteEvents(fds[i], &commands[i], EventPoll::EVENT_READ));
+    commands[i].clearIOEvents();
+  }
+  for (int i = 0; i < 10; ++i) {
+    poll(e);
+  }
+  for (auto& command : commands) {
+    CPPUNIT_ASSERT(!command.readEventEnabled());
+  }
+}
+
+void IoUringEventPollTest::testDeleteEvents_releaseFile()
+{
+  // The poll requests of idle sockets never complete by themselves.
+  // They must be removed, even if the submission queue is full, so
+  // that the sockets are released when closed.
+  IoUringEventPoll e(4);
+  if (!e.good()) {
+    return;
+  }
+  const size_t numCommands = 64;
+  std::vector<MockCommand> commands(numCommands);
+  std::vector<std::pair<int, int>> pipes;
+  for (size_t i = 0; i < numCommands; ++i) {
+    pipes.push_back(createIdlePipe());
+    CPPUNIT_ASSERT(
+        e.addEvents(pipes[i].first, &commands[i], EventPoll::EVENT_READ));
+  }
+  poll(e);
+  for (size_t i = 0; i < numCommands; ++i) {
+    CPPUNIT_ASSERT(
+        e.deleteEvents(pipes[i].first, &commands[i], EventPoll::EVENT_READ));
+    close(pipes[i].first);
+  }
+  poll(e);
+  poll(e);
+  // The write end of a pipe gets POLLERR when no one can read from it.
+  for (auto& p : pipes) {
+    struct pollfd pfd = {p.second, POLLOUT, 0};
+    CPPUNIT_ASSERT_EQUAL(1, ::poll(&pfd, 1, 1000));
+    CPPUNIT_ASSERT(pfd.revents & POLLERR);
+  }
+}
+
+} // namespace aria2
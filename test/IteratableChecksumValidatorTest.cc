@@ -48,6 +48,19 @@ void IteratableChecksumValidatorTest::testValidate()
   }
 
   CPPUNIT_ASSERT(ps->downloadFinished());
+
+  // The file is read in chunks of the read buffer size.
+  ps->markPiecesDone(0);
+  IteratableChecksumValidator validator2(dctx, ps);
+  validator2.setReadBufferSize(100);
+  validator2.init();
+  int chunks = 0;
+  while (!validator2.finished()) {
+    validator2.validateChunk();
+    ++chunks;
+  }
+  CPPUNIT_ASSERT_EQUAL(3, chunks);
+  CPPUNIT_ASSERT(ps->downloadFinished());
 }
 
 void IteratableChecksumValidatorTest::testValidate_fail()
@@ -9,6 +9,7 @@
 #include "DiskAdaptor.h"
 #include "FileEntry.h"
 #include "PieceSelector.h"
+#include "WorkerThreadPool.h"
 
 namespace aria2 {
 
@@ -17,6 +18,7 @@ class IteratableChunkChecksumValidatorTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(IteratableChunkChecksumValidatorTest);
   CPPUNIT_TEST(testValidate);
   CPPUNIT_TEST(testValidate_readError);
+  CPPUNIT_TEST(testValidate_workerThreadPool);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -27,6 +29,7 @@ public:
 
   void testValidate();
   void testValidate_readError();
+  void testValidate_workerThreadPool();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(IteratableChunkChecksumValidatorTest);
@@ -106,4 +109,37 @@ void IteratableChunkChecksumValidatorTest::testValidate_readError()
   CPPUNIT_ASSERT(!ps->hasPiece(4));
 }
 
+void IteratableChunkChecksumValidatorTest::testValidate_workerThreadPool()
+{
+  Option option;
+  std::shared_ptr<DownloadContext> dctx(new DownloadContext(
+      100, 500, A2_TEST_DIR "/chunkChecksumTestFile250.txt"));
+  std::deque<std::string> hashes(&csArray[0], &csArray[3]);
+  hashes[1] = fromHex("ffffffffffffffffffffffffffffffffffffffff");
+  hashes.push_back(fromHex("ffffffffffffffffffffffffffffffffffffffff"));
+  hashes.push_back(fromHex("ffffffffffffffffffffffffffffffffffffffff"));
+  dctx->setPieceHashes("sha-1", hashes.begin(), hashes.end());
+  std::shared_ptr<DefaultPieceStorage> ps(
+      new DefaultPieceStorage(dctx, &option));
+  ps->initStorage();
+  ps->getDiskAdaptor()->enableReadOnly();
+  ps->getDiskAdaptor()->openFile();
+
+  WorkerThreadPool pool(2);
+  IteratableChunkChecksumValidator validator(dctx, ps);
+  validator.init();
+  validator.setWorkerThreadPool(&pool);
+
+  while (!validator.finished()) {
+    validator.validateChunk();
+  }
+
+  CPPUNIT_ASSERT_EQUAL((int64_t)500, validator.getCurrentOffset());
+  CPPUNIT_ASSERT(ps->hasPiece(0));
+  CPPUNIT_ASSERT(!ps->hasPiece(1));
+  CPPUNIT_ASSERT(!ps->hasPiece(2));
+  CPPUNIT_ASSERT(!ps->hasPiece(3));
+  CPPUNIT_ASSERT(!ps->hasPiece(4));
+}
+
 } // namespace aria2
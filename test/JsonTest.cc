@@ -14,12 +14,14 @@ class JsonTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(JsonTest);
   CPPUNIT_TEST(testEncode);
   CPPUNIT_TEST(testDecodeGetParams);
+  CPPUNIT_TEST(testStreamEncoder);
   CPPUNIT_TEST_SUITE_END();
 
 private:
 public:
   void testEncode();
   void testDecodeGetParams();
+  void testStreamEncoder();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(JsonTest);
@@ -105,4 +107,34 @@ void JsonTest::testDecodeGetParams()
   }
 }
 
+void JsonTest::testStreamEncoder()
+{
+  auto dict = Dict::g();
+  auto list = List::g();
+  list->append(Integer::g(1));
+  list->append("\"\\/");
+  list->append(List::g());
+  list->append(Dict::g());
+  list->append(Bool::gTrue());
+  list->append(Null::g());
+  dict->put("list", std::move(list));
+  dict->put("name", "aria2");
+  auto expected = "cb(" + json::encode(dict.get()) + ")";
+  // Encoding 1 byte at a time forces every step to be resumed.
+  for (size_t length : {1, 4096}) {
+    json::StreamEncoder encoder;
+    encoder.pushText("cb(");
+    encoder.pushValue(dict.get());
+    encoder.pushText(")");
+    std::string out;
+    size_t n = 0;
+    while (!encoder.encode(out, out.size() + length)) {
+      ++n;
+    }
+    CPPUNIT_ASSERT(encoder.finished());
+    CPPUNIT_ASSERT_EQUAL(expected, out);
+    CPPUNIT_ASSERT_EQUAL(length == 1, n > 0);
+  }
+}
+
 } // namespace aria2
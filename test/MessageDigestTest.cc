@@ -1,8 +1,13 @@
 #include "MessageDigest.h"
 
+#include <algorithm>
+
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "util.h"
+#ifdef USE_INTERNAL_MD
+#  include "crypto_hash.h"
+#endif // USE_INTERNAL_MD
 
 namespace aria2 {
 
@@ -10,6 +15,10 @@ class MessageDigestTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(MessageDigestTest);
   CPPUNIT_TEST(testDigest);
+  CPPUNIT_TEST(testDigest_sha1);
+#ifdef USE_INTERNAL_MD
+  CPPUNIT_TEST(testDigest_portable);
+#endif // USE_INTERNAL_MD
   CPPUNIT_TEST(testSupports);
   CPPUNIT_TEST(testGetDigestLength);
   CPPUNIT_TEST(testIsStronger);
@@ -32,6 +41,10 @@ public:
   }
 
   void testDigest();
+  void testDigest_sha1();
+#ifdef USE_INTERNAL_MD
+  void testDigest_portable();
+#endif // USE_INTERNAL_MD
   void testSupports();
   void testGetDigestLength();
   void testIsStronger();
@@ -72,6 +85,59 @@ void MessageDigestTest::testDigest()
 #endif // HAVE_ZLIB
 }
 
+void MessageDigestTest::testDigest_sha1()
+{
+  // Test vectors from FIPS 180-2, crossing block boundaries
+  sha1_->update("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56);
+  CPPUNIT_ASSERT_EQUAL(std::string("84983e441c3bd26ebaae4aa1f95129e5e54670f1"),
+                       util::toHex(sha1_->digest()));
+
+  sha1_->reset();
+  CPPUNIT_ASSERT_EQUAL(std::string("da39a3ee5e6b4b0d3255bfef95601890afd80709"),
+                       util::toHex(sha1_->digest()));
+
+  // One million "a", fed in chunks which are not a multiple of the
+  // block size
+  sha1_->reset();
+  std::string a(1000, 'a');
+  for (size_t len = 0; len < 1000000;) {
+    size_t n = std::min(static_cast<size_t>(1000000 - len), len % 997 + 1);
+    sha1_->update(a.data(), n);
+    len += n;
+  }
+  CPPUNIT_ASSERT_EQUAL(std::string("34aa973cd4c4daa4f61eeb2bdbad27316534016f"),
+                       util::toHex(sha1_->digest()));
+}
+
+#ifdef USE_INTERNAL_MD
+void MessageDigestTest::testDigest_portable()
+{
+  // The implementations using CPU extensions, if any, must agree
+  // with the portable ones for every length around the block size.
+  std::string data;
+  for (int i = 0; i < 1000; ++i) {
+    data += static_cast<char>(i * 31 + 7);
+  }
+  for (auto algo : {crypto::hash::algoSHA1, crypto::hash::algoSHA224,
+                    crypto::hash::algoSHA256}) {
+    for (size_t len = 0; len <= data.size(); len += len < 200 ? 1 : 61) {
+      auto ctx = crypto::hash::create(algo);
+      auto portable = crypto::hash::createPortable(algo);
+      // Feed ctx in 2 pieces to exercise partial blocks.
+      ctx->update(data.data(), len / 3);
+      ctx->update(data.data() + len / 3, len - len / 3);
+      portable->update(data.data(), len);
+      CPPUNIT_ASSERT_EQUAL(util::toHex(portable->finalize()),
+                           util::toHex(ctx->finalize()));
+    }
+  }
+  auto ctx = crypto::hash::create(crypto::hash::algoSHA1);
+  ctx->update("abc", 3);
+  CPPUNIT_ASSERT_EQUAL(std::string("a9993e364706816aba3e25717850c26c9cd0d89d"),
+                       util::toHex(ctx->finalize()));
+}
+#endif // USE_INTERNAL_MD
+
 void MessageDigestTest::testSupports()
 {
   CPPUNIT_ASSERT(MessageDigest::supports("md5"));
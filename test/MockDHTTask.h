@@ -18,14 +18,16 @@ public:
 
   bool finished_;
 
+  bool started_;
+
   MockDHTTask(const std::shared_ptr<DHTNode>& remoteNode)
-      : remoteNode_(remoteNode), finished_(false)
+      : remoteNode_(remoteNode), finished_(false), started_(false)
   {
   }
 
   virtual ~MockDHTTask() {}
 
-  virtual void startup() CXX11_OVERRIDE {}
+  virtual void startup() CXX11_OVERRIDE { started_ = true; }
 
   virtual bool finished() CXX11_OVERRIDE { return finished_; }
 
@@ -13,6 +13,8 @@ public:
 
   std::deque<std::shared_ptr<DHTTask>> immediateTaskQueue_;
 
+  std::deque<std::shared_ptr<DHTTask>> peerLookupTaskQueue_;
+
   MockDHTTaskQueue() {}
 
   virtual ~MockDHTTaskQueue() {}
@@ -36,6 +38,17 @@ public:
   {
     immediateTaskQueue_.push_back(task);
   }
+
+  virtual void addPeerLookupTask(const std::shared_ptr<DHTTask>& task,
+                                 bool priority) CXX11_OVERRIDE
+  {
+    if (priority) {
+      peerLookupTaskQueue_.push_front(task);
+    }
+    else {
+      peerLookupTaskQueue_.push_back(task);
+    }
+  }
 };
 
 } // namespace aria2
@@ -0,0 +1,91 @@
+#include "MpscQueue.h"
+
+#include <vector>
+#include <iterator>
+#ifdef HAVE_STD_THREAD
+#  include <thread>
+#endif // HAVE_STD_THREAD
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "a2functional.h"
+
+namespace aria2 {
+
+class MpscQueueTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(MpscQueueTest);
+  CPPUNIT_TEST(testPushPopAll);
+#ifdef HAVE_STD_THREAD
+  CPPUNIT_TEST(testPush_threads);
+#endif // HAVE_STD_THREAD
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testPushPopAll();
+#ifdef HAVE_STD_THREAD
+  void testPush_threads();
+#endif // HAVE_STD_THREAD
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MpscQueueTest);
+
+void MpscQueueTest::testPushPopAll()
+{
+  MpscQueue<std::unique_ptr<int>> q;
+  CPPUNIT_ASSERT(q.empty());
+  CPPUNIT_ASSERT(q.push(make_unique<int>(1)));
+  CPPUNIT_ASSERT(!q.push(make_unique<int>(2)));
+  CPPUNIT_ASSERT(!q.push(make_unique<int>(3)));
+  CPPUNIT_ASSERT(!q.empty());
+
+  std::vector<std::unique_ptr<int>> res;
+  q.popAll(std::back_inserter(res));
+  CPPUNIT_ASSERT(q.empty());
+  CPPUNIT_ASSERT_EQUAL((size_t)3, res.size());
+  CPPUNIT_ASSERT_EQUAL(1, *res[0]);
+  CPPUNIT_ASSERT_EQUAL(2, *res[1]);
+  CPPUNIT_ASSERT_EQUAL(3, *res[2]);
+
+  res.clear();
+  q.popAll(std::back_inserter(res));
+  CPPUNIT_ASSERT(res.empty());
+  CPPUNIT_ASSERT(q.push(make_unique<int>(4)));
+  // The remaining value is freed by the destructor.
+}
+
+#ifdef HAVE_STD_THREAD
+void MpscQueueTest::testPush_threads()
+{
+  MpscQueue<int> q;
+  const int numThreads = 4;
+  const int numValues = 10000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < numThreads; ++i) {
+    threads.emplace_back([&q, i]() {
+      for (int j = 0; j < numValues; ++j) {
+        q.push(i * numValues + j);
+      }
+    });
+  }
+  std::vector<int> res;
+  while (res.size() < (size_t)numThreads * numValues) {
+    q.popAll(std::back_inserter(res));
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+  // Values from each thread keep their order.
+  std::vector<int> last(numThreads, -1);
+  for (auto v : res) {
+    auto i = v / numValues;
+    CPPUNIT_ASSERT(last[i] < v);
+    last[i] = v;
+  }
+  for (int i = 0; i < numThreads; ++i) {
+    CPPUNIT_ASSERT_EQUAL((i + 1) * numValues - 1, last[i]);
+  }
+}
+#endif // HAVE_STD_THREAD
+
+} // namespace aria2
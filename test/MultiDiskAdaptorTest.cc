@@ -358,6 +358,14 @@ void MultiDiskAdaptorTest::testReadData()
   buf[25] = '\0';
   CPPUNIT_ASSERT_EQUAL(std::string("1234567890ABCDEFGHIJKLMNO"),
                        std::string((char*)buf));
+  // prefetch() is just a hint; ranges spanning files or beyond the
+  // end must be accepted silently.
+  adaptor->prefetch(10, 10);
+  adaptor->prefetch(100, 20);
+  adaptor->prefetch(10, 25);
+  adaptor->readData(buf, 4, 20);
+  buf[4] = '\0';
+  CPPUNIT_ASSERT_EQUAL(std::string("KLMN"), std::string((char*)buf));
 }
 
 void MultiDiskAdaptorTest::testCutTrailingGarbage()
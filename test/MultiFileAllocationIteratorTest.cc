@@ -12,6 +12,7 @@
 #include "array_fun.h"
 #include "TestUtil.h"
 #include "DiskWriter.h"
+#include "WorkerThreadPool.h"
 
 namespace aria2 {
 
@@ -19,6 +20,7 @@ class MultiFileAllocationIteratorTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(MultiFileAllocationIteratorTest);
   CPPUNIT_TEST(testAllocate);
+  CPPUNIT_TEST(testAllocate_workerThreads);
   CPPUNIT_TEST(testMakeDiskWriterEntries);
   CPPUNIT_TEST_SUITE_END();
 
@@ -27,6 +29,7 @@ public:
   void setUp() {}
 
   void testAllocate();
+  void testAllocate_workerThreads();
   void testMakeDiskWriterEntries();
 };
 
@@ -204,4 +207,41 @@ void MultiFileAllocationIteratorTest::testAllocate()
   }
 }
 
+void MultiFileAllocationIteratorTest::testAllocate_workerThreads()
+{
+  std::string storeDir = A2_TEST_OUT_DIR
+      "/aria2_MultiFileAllocationIteratorTest_testAllocate_workerThreads";
+
+  auto fs = std::vector<std::shared_ptr<FileEntry>>{
+      std::make_shared<FileEntry>(storeDir + "/file1", 600_k, 0),
+      std::make_shared<FileEntry>(storeDir + "/file2", 0, 600_k),
+      std::make_shared<FileEntry>(storeDir + "/file3", 300_k + 1, 600_k),
+      std::make_shared<FileEntry>(storeDir + "/file4", 10, 900_k + 1),
+      std::make_shared<FileEntry>(storeDir + "/file5", 1_m, 900_k + 11)};
+  fs[3]->setRequested(false);
+  for (auto& fe : fs) {
+    File{fe->getPath()}.remove();
+  }
+
+  MultiDiskAdaptor diskAdaptor;
+  diskAdaptor.setPieceLength(1);
+  diskAdaptor.setFileEntries(std::begin(fs), std::end(fs));
+  diskAdaptor.initAndOpenFile();
+
+  WorkerThreadPool pool(2);
+  auto itr = diskAdaptor.fileAllocationIterator();
+  CPPUNIT_ASSERT(itr->setWorkerThreadPool(&pool, nullptr));
+  while (!itr->finished()) {
+    itr->allocateChunk();
+  }
+  itr.reset();
+  diskAdaptor.closeFile();
+
+  CPPUNIT_ASSERT_EQUAL((int64_t)600_k, File(fs[0]->getPath()).size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)0, File(fs[1]->getPath()).size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)(300_k + 1), File(fs[2]->getPath()).size());
+  CPPUNIT_ASSERT(!File(fs[3]->getPath()).isFile());
+  CPPUNIT_ASSERT_EQUAL((int64_t)1_m, File(fs[4]->getPath()).size());
+}
+
 } // namespace aria2
@@ -6,6 +6,7 @@
 
 #include "Peer.h"
 #include "SocketCore.h"
+#include "bittorrent_helper.h"
 
 namespace aria2 {
 
@@ -13,10 +14,12 @@ class PeerConnectionTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(PeerConnectionTest);
   CPPUNIT_TEST(testReserveBuffer);
+  CPPUNIT_TEST(testDetachMsgPayloadBuffer);
   CPPUNIT_TEST_SUITE_END();
 
 public:
   void testReserveBuffer();
+  void testDetachMsgPayloadBuffer();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(PeerConnectionTest);
@@ -25,7 +28,8 @@ void PeerConnectionTest::testReserveBuffer()
 {
   PeerConnection con(1, std::shared_ptr<Peer>(), std::shared_ptr<SocketCore>());
   con.presetBuffer((unsigned char*)"foo", 3);
-  CPPUNIT_ASSERT_EQUAL((size_t)MAX_BUFFER_CAPACITY, con.getBufferCapacity());
+  CPPUNIT_ASSERT_EQUAL((size_t)DEFAULT_BUFFER_CAPACITY,
+                       con.getBufferCapacity());
   CPPUNIT_ASSERT_EQUAL((size_t)3, con.getBufferLength());
 
   constexpr size_t newLength = 128_k;
@@ -36,4 +40,51 @@ void PeerConnectionTest::testReserveBuffer()
   CPPUNIT_ASSERT(memcmp("foo", con.getBuffer(), 3) == 0);
 }
 
+void PeerConnectionTest::testDetachMsgPayloadBuffer()
+{
+  constexpr size_t payloadLength = 9 + 16_k;
+  // piece message followed by keep-alive message
+  unsigned char data[4 + payloadLength + 4] = {0};
+  bittorrent::setIntParam(data, payloadLength);
+  data[4] = 7;
+  data[4 + payloadLength - 1] = 0xff;
+  size_t offset, capacity;
+  size_t dataLength;
+  {
+    PeerConnection con(1, std::shared_ptr<Peer>(),
+                       std::shared_ptr<SocketCore>());
+    con.presetBuffer(data, 4 + payloadLength);
+    CPPUNIT_ASSERT(con.receiveMessage(nullptr, dataLength));
+    CPPUNIT_ASSERT_EQUAL(payloadLength, dataLength);
+    auto payload = con.getMsgPayloadBuffer();
+    auto buf = con.detachMsgPayloadBuffer(offset, capacity);
+    CPPUNIT_ASSERT(buf);
+    CPPUNIT_ASSERT(payload == buf.get() + offset);
+    CPPUNIT_ASSERT_EQUAL((size_t)4, offset);
+    CPPUNIT_ASSERT_EQUAL((size_t)DEFAULT_BUFFER_CAPACITY - 4, capacity);
+    CPPUNIT_ASSERT_EQUAL((unsigned char)7, buf[offset]);
+    CPPUNIT_ASSERT_EQUAL((unsigned char)0xff, buf[offset + payloadLength - 1]);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, con.getBufferLength());
+    CPPUNIT_ASSERT(buf.get() != con.getBuffer());
+  }
+  {
+    // The buffer also contains the keep-alive message.
+    PeerConnection con(1, std::shared_ptr<Peer>(),
+                       std::shared_ptr<SocketCore>());
+    con.presetBuffer(data, sizeof(data));
+    CPPUNIT_ASSERT(con.receiveMessage(nullptr, dataLength));
+    CPPUNIT_ASSERT(!con.detachMsgPayloadBuffer(offset, capacity));
+    CPPUNIT_ASSERT_EQUAL(sizeof(data), con.getBufferLength());
+  }
+  {
+    // The message is too small for the buffer.
+    unsigned char have[] = {0, 0, 0, 5, 4, 0, 0, 0, 1};
+    PeerConnection con(1, std::shared_ptr<Peer>(),
+                       std::shared_ptr<SocketCore>());
+    con.presetBuffer(have, sizeof(have));
+    CPPUNIT_ASSERT(con.receiveMessage(nullptr, dataLength));
+    CPPUNIT_ASSERT(!con.detachMsgPayloadBuffer(offset, capacity));
+  }
+}
+
 } // namespace aria2
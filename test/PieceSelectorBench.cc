@@ -0,0 +1,110 @@
+// Times RarestPieceSelector::select() late in a download, when most
+// pieces are ours, against a scan of the whole sorted order.
+//
+// Build and run with: make piece_selector_bench && ./piece_selector_bench
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "PieceStatMan.h"
+#include "RarestPieceSelector.h"
+#include "bitfield.h"
+
+using namespace aria2;
+
+namespace {
+
+// Returns the rarest piece in |bitfield| by walking every piece in
+// the sorted order, which is what select() did before pieces we have
+// and pieces no peer has were skipped.
+bool selectFullScan(const PieceStatMan& pieceStatMan, size_t& index,
+                    const unsigned char* bitfield, size_t nbits)
+{
+  for (auto i : pieceStatMan.getSortedOrder()) {
+    if (bitfield::test(bitfield, nbits, i)) {
+      index = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename F> double timeLoop(int rounds, F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; ++i) {
+    f();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+         rounds;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  size_t numPieces = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000;
+  int numPeers = 50;
+  int rounds = 1000;
+  // Fraction of the pieces we already have.
+  double done = 0.99;
+
+  std::mt19937 gen(0);
+  std::bernoulli_distribution peerHas(0.5);
+  size_t bitfieldLength = (numPieces + 7) / 8;
+
+  auto pieceStatMan = std::make_shared<PieceStatMan>(numPieces, true);
+  std::vector<unsigned char> peerBitfield(bitfieldLength);
+  for (int i = 0; i < numPeers; ++i) {
+    std::fill(peerBitfield.begin(), peerBitfield.end(), 0);
+    for (size_t j = 0; j < numPieces; ++j) {
+      if (peerHas(gen)) {
+        bitfield::flipBit(peerBitfield.data(), numPieces, j);
+      }
+    }
+    pieceStatMan->addPieceStats(peerBitfield.data(), peerBitfield.size());
+  }
+
+  // Rarest first leaves the most common pieces for last, so we have
+  // the rarest ones.  |missing| is what DefaultPieceStorage passes in:
+  // the pieces we lack which the last peer has.
+  std::vector<unsigned char> have(bitfieldLength);
+  std::vector<unsigned char> missing(bitfieldLength);
+  const auto& sorted = pieceStatMan->getSortedOrder();
+  size_t numHave = numPieces * done;
+  for (size_t j = 0; j < numPieces; ++j) {
+    auto i = sorted[j];
+    if (j < numHave) {
+      bitfield::flipBit(have.data(), numPieces, i);
+    }
+    else if (bitfield::test(peerBitfield.data(), numPieces, i)) {
+      bitfield::flipBit(missing.data(), numPieces, i);
+    }
+  }
+
+  RarestPieceSelector selector(pieceStatMan);
+  size_t index;
+  size_t sink = 0;
+  double fullScan = timeLoop(rounds, [&] {
+    if (selectFullScan(*pieceStatMan, index, missing.data(), numPieces)) {
+      sink += index;
+    }
+  });
+  pieceStatMan->setHave(have.data(), have.size());
+  double select = timeLoop(rounds, [&] {
+    if (selector.select(index, missing.data(), numPieces)) {
+      sink += index;
+    }
+  });
+
+  printf("pieces=%zu peers=%d have=%.0f%%\n", numPieces, numPeers,
+         done * 100);
+  printf("full scan: %10.2f us/select\n", fullScan);
+  printf("select:    %10.2f us/select\n", select);
+  return sink == 0;
+}
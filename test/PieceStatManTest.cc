@@ -1,7 +1,11 @@
 #include "PieceStatMan.h"
 
+#include <set>
+
 #include <cppunit/extensions/HelperMacros.h>
 
+#include "bitfield.h"
+
 namespace aria2 {
 
 class PieceStatManTest : public CppUnit::TestFixture {
@@ -11,6 +15,9 @@ class PieceStatManTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testAddPieceStats_bitfield);
   CPPUNIT_TEST(testUpdatePieceStats);
   CPPUNIT_TEST(testSubtractPieceStats);
+  CPPUNIT_TEST(testGetSortedOrder);
+  CPPUNIT_TEST(testGetSortedOrder_tie);
+  CPPUNIT_TEST(testAddHave);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -22,6 +29,9 @@ public:
   void testAddPieceStats_bitfield();
   void testUpdatePieceStats();
   void testSubtractPieceStats();
+  void testGetSortedOrder();
+  void testGetSortedOrder_tie();
+  void testAddHave();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(PieceStatManTest);
@@ -126,4 +136,136 @@ void PieceStatManTest::testSubtractPieceStats()
   }
 }
 
+namespace {
+void checkSortedOrder(const PieceStatMan& pieceStatMan)
+{
+  const auto& sorted = pieceStatMan.getSortedOrder();
+  const auto& counts = pieceStatMan.getCounts();
+  std::vector<bool> seen(counts.size());
+  size_t haveStart = pieceStatMan.getAvailableEnd() - sorted.begin();
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    CPPUNIT_ASSERT(!seen[sorted[i]]);
+    seen[sorted[i]] = true;
+    CPPUNIT_ASSERT_EQUAL(i >= haveStart, pieceStatMan.hasPiece(sorted[i]));
+    if (i > 0 && i < haveStart) {
+      CPPUNIT_ASSERT(counts[sorted[i - 1]] <= counts[sorted[i]]);
+    }
+  }
+  for (auto i = sorted.begin(); i != pieceStatMan.getAvailableBegin(); ++i) {
+    CPPUNIT_ASSERT_EQUAL(0, counts[*i]);
+  }
+  for (auto i = pieceStatMan.getAvailableBegin();
+       i != pieceStatMan.getAvailableEnd(); ++i) {
+    CPPUNIT_ASSERT(counts[*i] > 0);
+  }
+}
+} // namespace
+
+void PieceStatManTest::testGetSortedOrder()
+{
+  PieceStatMan pieceStatMan(10, false);
+  pieceStatMan.addPieceStats(3);
+  pieceStatMan.addPieceStats(3);
+  pieceStatMan.addPieceStats(7);
+  {
+    const std::vector<size_t>& sorted = pieceStatMan.getSortedOrder();
+    CPPUNIT_ASSERT_EQUAL((size_t)10, sorted.size());
+    CPPUNIT_ASSERT_EQUAL((size_t)7, sorted[8]);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, sorted[9]);
+  }
+  checkSortedOrder(pieceStatMan);
+
+  // Simulate peers coming and going.
+  PieceStatMan stat(100, true);
+  std::vector<std::vector<unsigned char>> bitfields;
+  for (int i = 0; i < 20; ++i) {
+    std::vector<unsigned char> bf(13);
+    for (size_t j = 0; j < 100; ++j) {
+      if ((j * 7 + i * 13) % (i + 2) == 0) {
+        bitfield::flipBit(bf.data(), 100, j);
+      }
+    }
+    stat.addPieceStats(bf.data(), bf.size());
+    bitfields.push_back(bf);
+    checkSortedOrder(stat);
+  }
+  for (int i = 0; i < 20; i += 2) {
+    stat.updatePieceStats(bitfields[i + 1].data(), bitfields[i + 1].size(),
+                          bitfields[i].data());
+    checkSortedOrder(stat);
+  }
+  for (int i = 1; i < 20; i += 2) {
+    stat.subtractPieceStats(bitfields[i].data(), bitfields[i].size());
+    stat.subtractPieceStats(bitfields[i].data(), bitfields[i].size());
+    checkSortedOrder(stat);
+  }
+  for (auto c : stat.getCounts()) {
+    CPPUNIT_ASSERT_EQUAL(0, c);
+  }
+}
+
+void PieceStatManTest::testGetSortedOrder_tie()
+{
+  // Peers having all pieces come and go.  All pieces are always tied,
+  // and the rarest one picked first must not follow a fixed pattern.
+  PieceStatMan stat(16, true);
+  std::vector<unsigned char> bf(2, 0xff);
+  std::set<size_t> firsts;
+  for (int i = 0; i < 100; ++i) {
+    stat.addPieceStats(bf.data(), bf.size());
+    checkSortedOrder(stat);
+    firsts.insert(stat.getSortedOrder()[0]);
+    stat.subtractPieceStats(bf.data(), bf.size());
+    checkSortedOrder(stat);
+    firsts.insert(stat.getSortedOrder()[0]);
+  }
+  CPPUNIT_ASSERT(firsts.size() > 8);
+}
+
+void PieceStatManTest::testAddHave()
+{
+  PieceStatMan stat(100, true);
+  std::vector<std::vector<unsigned char>> bitfields;
+  for (int i = 0; i < 10; ++i) {
+    std::vector<unsigned char> bf(13);
+    for (size_t j = 0; j < 100; ++j) {
+      if ((j * 7 + i * 13) % (i + 2) == 0) {
+        bitfield::flipBit(bf.data(), 100, j);
+      }
+    }
+    stat.addPieceStats(bf.data(), bf.size());
+    bitfields.push_back(bf);
+  }
+  std::vector<int> counts = stat.getCounts();
+  // Pieces come and go while peers send bitfields.
+  for (size_t i = 0; i < 100; i += 3) {
+    stat.addHave(i);
+    checkSortedOrder(stat);
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)66,
+                       static_cast<size_t>(stat.getAvailableEnd() -
+                                           stat.getSortedOrder().begin()));
+  stat.subtractPieceStats(bitfields[0].data(), bitfields[0].size());
+  checkSortedOrder(stat);
+  for (size_t i = 0; i < 100; i += 6) {
+    stat.removeHave(i);
+    checkSortedOrder(stat);
+  }
+  stat.addPieceStats(bitfields[0].data(), bitfields[0].size());
+  checkSortedOrder(stat);
+  // The counts of the pieces we have are kept.
+  CPPUNIT_ASSERT(counts == stat.getCounts());
+
+  std::vector<unsigned char> have(13, 0xff);
+  stat.setHave(have.data(), have.size());
+  checkSortedOrder(stat);
+  CPPUNIT_ASSERT(stat.getAvailableBegin() == stat.getAvailableEnd());
+  CPPUNIT_ASSERT(stat.getSortedOrder().begin() == stat.getAvailableEnd());
+  std::fill(have.begin(), have.end(), 0);
+  stat.setHave(have.data(), have.size());
+  checkSortedOrder(stat);
+  CPPUNIT_ASSERT(stat.getSortedOrder().end() == stat.getAvailableEnd());
+  CPPUNIT_ASSERT(counts == stat.getCounts());
+}
+
 } // namespace aria2
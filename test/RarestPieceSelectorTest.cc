@@ -12,6 +12,7 @@ class RarestPieceSelectorTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(RarestPieceSelectorTest);
   CPPUNIT_TEST(testSelect);
+  CPPUNIT_TEST(testSelect_noPeer);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -24,6 +25,7 @@ public:
   void testUpdatePieceStats();
   void testSubtractPieceStats();
   void testSelect();
+  void testSelect_noPeer();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RarestPieceSelectorTest);
@@ -33,18 +35,46 @@ void RarestPieceSelectorTest::testSelect()
   std::shared_ptr<PieceStatMan> pieceStatMan(new PieceStatMan(10, false));
   RarestPieceSelector selector(pieceStatMan);
   BitfieldMan bf(1_k, 10_k);
-  bf.setBitRange(0, 2);
+  bf.setBitRange(0, 3);
   size_t index;
 
   pieceStatMan->addPieceStats(0);
+  pieceStatMan->addPieceStats(0);
+  pieceStatMan->addPieceStats(1);
+  pieceStatMan->addPieceStats(2);
+  pieceStatMan->addPieceStats(2);
+  pieceStatMan->addPieceStats(2);
 
   CPPUNIT_ASSERT(selector.select(index, bf.getBitfield(), bf.countBlock()));
   CPPUNIT_ASSERT_EQUAL((size_t)1, index);
 
   pieceStatMan->addPieceStats(1);
+  pieceStatMan->addPieceStats(1);
+
+  CPPUNIT_ASSERT(selector.select(index, bf.getBitfield(), bf.countBlock()));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, index);
+
+  // The pieces we have are never selected.
+  pieceStatMan->addPieceStats(2);
+  pieceStatMan->addHave(0);
+  CPPUNIT_ASSERT(selector.select(index, bf.getBitfield(), bf.countBlock()));
+  CPPUNIT_ASSERT_EQUAL((size_t)1, index);
+}
+
+void RarestPieceSelectorTest::testSelect_noPeer()
+{
+  std::shared_ptr<PieceStatMan> pieceStatMan(new PieceStatMan(10, false));
+  RarestPieceSelector selector(pieceStatMan);
+  BitfieldMan bf(1_k, 10_k);
+  bf.setBitRange(0, 3);
+  size_t index;
 
+  // No peer has piece 0 to 3.
+  pieceStatMan->addPieceStats(5);
+  CPPUNIT_ASSERT(!selector.select(index, bf.getBitfield(), bf.countBlock()));
+  pieceStatMan->addPieceStats(3);
   CPPUNIT_ASSERT(selector.select(index, bf.getBitfield(), bf.countBlock()));
-  CPPUNIT_ASSERT_EQUAL((size_t)2, index);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, index);
 }
 
 } // namespace aria2
@@ -9,6 +9,7 @@ namespace rpc {
 class RpcResponseTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(RpcResponseTest);
   CPPUNIT_TEST(testToJson);
+  CPPUNIT_TEST(testJsonResponseSource);
 #ifdef ENABLE_XML_RPC
   CPPUNIT_TEST(testToXml);
 #endif // ENABLE_XML_RPC
@@ -16,6 +17,7 @@ class RpcResponseTest : public CppUnit::TestFixture {
 
 public:
   void testToJson();
+  void testJsonResponseSource();
 #ifdef ENABLE_XML_RPC
   void testToXml();
 #endif // ENABLE_XML_RPC
@@ -97,6 +99,44 @@ void RpcResponseTest::testToJson()
   }
 }
 
+namespace {
+std::string readAll(BufferSource& source)
+{
+  std::string s;
+  while (!source.read(s))
+    ;
+  return s;
+}
+} // namespace
+
+void RpcResponseTest::testJsonResponseSource()
+{
+  auto arena = std::make_shared<ValueBaseArena>();
+  ValueBaseArena::Scope scope(*arena);
+  auto createResponse = []() {
+    auto param = List::g();
+    for (int i = 0; i < 10000; ++i) {
+      param->append(Integer::g(i));
+    }
+    return RpcResponse(0, RpcResponse::AUTHORIZED, std::move(param),
+                       String::g("9"));
+  };
+  {
+    auto res = createResponse();
+    auto expected = toJson(res, "cb", false);
+    JsonResponseSource source(arena, std::move(res), "cb");
+    CPPUNIT_ASSERT_EQUAL(expected, readAll(source));
+  }
+  {
+    std::vector<RpcResponse> results;
+    results.push_back(createResponse());
+    results.push_back(createResponse());
+    auto expected = toJsonBatch(results, "", false);
+    JsonResponseSource source(arena, std::move(results), "");
+    CPPUNIT_ASSERT_EQUAL(expected, readAll(source));
+  }
+}
+
 #ifdef ENABLE_XML_RPC
 void RpcResponseTest::testToXml()
 {
@@ -10,10 +10,12 @@ class SequentialPickerTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(SequentialPickerTest);
   CPPUNIT_TEST(testPick);
+  CPPUNIT_TEST(testPick_maxPicked);
   CPPUNIT_TEST_SUITE_END();
 
 public:
   void testPick();
+  void testPick_maxPicked();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SequentialPickerTest);
@@ -32,19 +34,50 @@ void SequentialPickerTest::testPick()
   CPPUNIT_ASSERT(picker.hasNext());
   CPPUNIT_ASSERT_EQUAL((size_t)2, picker.countEntryInQueue());
 
-  picker.pickNext();
+  CPPUNIT_ASSERT(picker.canPickNext());
+
+  auto picked = picker.pickNext();
 
   CPPUNIT_ASSERT(picker.isPicked());
-  CPPUNIT_ASSERT_EQUAL(1, *picker.getPickedEntry());
+  CPPUNIT_ASSERT_EQUAL(1, *picked);
+  CPPUNIT_ASSERT_EQUAL(1, *picker.getPickedEntries().front());
+  // Only one entry can be picked by default.
+  CPPUNIT_ASSERT(!picker.canPickNext());
 
-  picker.dropPickedEntry();
+  picker.dropPickedEntry(picked);
 
   CPPUNIT_ASSERT(!picker.isPicked());
   CPPUNIT_ASSERT(picker.hasNext());
 
   picker.pickNext();
 
-  CPPUNIT_ASSERT_EQUAL(2, *picker.getPickedEntry());
+  CPPUNIT_ASSERT_EQUAL(2, *picker.getPickedEntries().front());
+  CPPUNIT_ASSERT(!picker.hasNext());
+}
+
+void SequentialPickerTest::testPick_maxPicked()
+{
+  SequentialPicker<int> picker(2);
+
+  picker.pushEntry(make_unique<int>(1));
+  picker.pushEntry(make_unique<int>(2));
+  picker.pushEntry(make_unique<int>(3));
+
+  auto first = picker.pickNext();
+  CPPUNIT_ASSERT(picker.canPickNext());
+  auto second = picker.pickNext();
+  CPPUNIT_ASSERT_EQUAL(2, *second);
+  CPPUNIT_ASSERT(!picker.canPickNext());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, picker.getPickedEntries().size());
+  CPPUNIT_ASSERT(picker.isPicked([](const int& i) { return i == 2; }));
+  CPPUNIT_ASSERT(!picker.findPickedEntry([](const int& i) { return i == 3; }));
+
+  picker.dropPickedEntry(first);
+
+  CPPUNIT_ASSERT_EQUAL((size_t)1, picker.getPickedEntries().size());
+  CPPUNIT_ASSERT_EQUAL(2, *picker.getPickedEntries().front());
+  CPPUNIT_ASSERT(picker.canPickNext());
+  CPPUNIT_ASSERT_EQUAL(3, *picker.pickNext());
   CPPUNIT_ASSERT(!picker.hasNext());
 }
 
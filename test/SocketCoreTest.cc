@@ -2,6 +2,7 @@
 
 #include <cstring>
 #include <iostream>
+#include <fstream>
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "a2functional.h"
@@ -13,11 +14,15 @@ class SocketCoreTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(SocketCoreTest);
   CPPUNIT_TEST(testWriteAndReadDatagram);
+  CPPUNIT_TEST(testReadDatagrams);
   CPPUNIT_TEST(testGetSocketError);
   CPPUNIT_TEST(testInetNtop);
   CPPUNIT_TEST(testInetPton);
   CPPUNIT_TEST(testGetBinAddr);
   CPPUNIT_TEST(testVerifyHostname);
+#ifdef A2_HAVE_SENDFILE
+  CPPUNIT_TEST(testSendFile);
+#endif // A2_HAVE_SENDFILE
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -26,11 +31,15 @@ public:
   void tearDown() {}
 
   void testWriteAndReadDatagram();
+  void testReadDatagrams();
   void testGetSocketError();
   void testInetNtop();
   void testInetPton();
   void testGetBinAddr();
   void testVerifyHostname();
+#ifdef A2_HAVE_SENDFILE
+  void testSendFile();
+#endif // A2_HAVE_SENDFILE
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SocketCoreTest);
@@ -78,6 +87,48 @@ void SocketCoreTest::testWriteAndReadDatagram()
   }
 }
 
+void SocketCoreTest::testReadDatagrams()
+{
+  SocketCore s(SOCK_DGRAM);
+  s.bind(0);
+  s.setNonBlockingMode();
+  SocketCore c(SOCK_DGRAM);
+  c.bind(0);
+
+  auto remoteEndpoint = s.getAddrInfo();
+  auto localEndpoint = c.getAddrInfo();
+
+  std::string message1 = "hello world.";
+  c.writeData(message1.c_str(), message1.size(), "localhost",
+              remoteEndpoint.port);
+  std::string message2 = "chocolate coated pie";
+  c.writeData(message2.c_str(), message2.size(), "localhost",
+              remoteEndpoint.port);
+
+  unsigned char buf[4][100];
+  Datagram datagrams[4];
+  for (size_t i = 0; i < 4; ++i) {
+    datagrams[i].data = buf[i];
+    datagrams[i].capacity = sizeof(buf[i]);
+    datagrams[i].length = 0;
+  }
+
+  size_t n = 0;
+  for (int i = 0; i < 100 && n < 2; ++i) {
+    n += s.readDataFrom(datagrams + n, 4 - n);
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)2, n);
+  CPPUNIT_ASSERT_EQUAL(message1,
+                       std::string(&buf[0][0], &buf[0][datagrams[0].length]));
+  CPPUNIT_ASSERT_EQUAL(localEndpoint.port, datagrams[0].sender.port);
+  CPPUNIT_ASSERT_EQUAL(message2,
+                       std::string(&buf[1][0], &buf[1][datagrams[1].length]));
+  CPPUNIT_ASSERT_EQUAL(localEndpoint.port, datagrams[1].sender.port);
+
+  // Nothing left to read
+  CPPUNIT_ASSERT_EQUAL((size_t)0, s.readDataFrom(datagrams, 4));
+}
+
 void SocketCoreTest::testGetSocketError()
 {
   SocketCore s;
@@ -239,4 +290,38 @@ void SocketCoreTest::testVerifyHostname()
   }
 }
 
+#ifdef A2_HAVE_SENDFILE
+void SocketCoreTest::testSendFile()
+{
+  std::string path = A2_TEST_OUT_DIR "/aria2_SocketCoreTest_testSendFile";
+  {
+    std::ofstream out(path.c_str(), std::ios::binary);
+    out << "0123456789";
+  }
+  int fd = a2open(path.c_str(), O_RDONLY, OPEN_MODE);
+  CPPUNIT_ASSERT(fd != -1);
+
+  SocketCore server;
+  server.bind(0);
+  server.beginListen();
+  server.setBlockingMode();
+  auto endpoint = server.getAddrInfo();
+
+  SocketCore client;
+  client.establishConnection("localhost", endpoint.port);
+  while (!client.isWritable(0)) {
+  }
+  auto inbound = server.acceptConnection();
+  inbound->setBlockingMode();
+
+  CPPUNIT_ASSERT_EQUAL((ssize_t)5, client.sendFile(fd, 3, 5));
+  close(fd);
+
+  char buf[5];
+  size_t len = sizeof(buf);
+  inbound->readData(buf, len);
+  CPPUNIT_ASSERT_EQUAL(std::string("34567"), std::string(&buf[0], &buf[len]));
+}
+#endif // A2_HAVE_SENDFILE
+
 } // namespace aria2
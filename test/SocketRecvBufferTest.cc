@@ -0,0 +1,130 @@
+#include "SocketRecvBuffer.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "SocketCore.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class SocketRecvBufferTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SocketRecvBufferTest);
+  CPPUNIT_TEST(testRecv);
+  CPPUNIT_TEST(testRecv_maxCapacity);
+  CPPUNIT_TEST(testDetachBuffer);
+  CPPUNIT_TEST_SUITE_END();
+
+  std::unique_ptr<SocketCore> client_;
+  std::shared_ptr<SocketCore> inbound_;
+
+public:
+  void setUp()
+  {
+    SocketCore server;
+    server.bind(0);
+    server.beginListen();
+    server.setBlockingMode();
+    auto endpoint = server.getAddrInfo();
+
+    client_ = make_unique<SocketCore>();
+    client_->establishConnection("localhost", endpoint.port);
+    while (!client_->isWritable(0)) {
+    }
+    client_->setBlockingMode();
+    inbound_ = server.acceptConnection();
+    inbound_->setBlockingMode();
+  }
+
+  void tearDown()
+  {
+    SocketRecvBuffer::setMaxCapacity(256_k);
+    client_.reset();
+    inbound_.reset();
+  }
+
+  void testRecv();
+  void testRecv_maxCapacity();
+  void testDetachBuffer();
+
+private:
+  void send(size_t len)
+  {
+    std::string data(len, 'a');
+    client_->writeData(data);
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SocketRecvBufferTest);
+
+void SocketRecvBufferTest::testRecv()
+{
+  SocketRecvBuffer buf(inbound_);
+  CPPUNIT_ASSERT(buf.bufferEmpty());
+  CPPUNIT_ASSERT(!buf.getBuffer());
+  CPPUNIT_ASSERT_EQUAL(SocketRecvBuffer::MIN_CAPACITY, buf.getCapacity());
+
+  send(16_k + 32_k);
+  // Filling the whole buffer doubles the capacity for the next read.
+  CPPUNIT_ASSERT_EQUAL((ssize_t)16_k, buf.recv());
+  CPPUNIT_ASSERT_EQUAL((size_t)16_k, buf.getBufferLength());
+  CPPUNIT_ASSERT_EQUAL((size_t)32_k, buf.getCapacity());
+  // The buffer is full until it is drained.
+  CPPUNIT_ASSERT_EQUAL((ssize_t)0, buf.recv());
+  buf.drain(16_k);
+  CPPUNIT_ASSERT(buf.bufferEmpty());
+  CPPUNIT_ASSERT(!buf.getBuffer());
+
+  CPPUNIT_ASSERT_EQUAL((ssize_t)32_k, buf.recv());
+  CPPUNIT_ASSERT_EQUAL((size_t)64_k, buf.getCapacity());
+  buf.truncateBuffer();
+  CPPUNIT_ASSERT(!buf.getBuffer());
+
+  // A small read shrinks the capacity.
+  send(100);
+  CPPUNIT_ASSERT_EQUAL((ssize_t)100, buf.recv());
+  CPPUNIT_ASSERT_EQUAL((size_t)32_k, buf.getCapacity());
+  buf.drain(50);
+  // The capacity is only adjusted when reading into the empty buffer.
+  send(10);
+  CPPUNIT_ASSERT_EQUAL((ssize_t)10, buf.recv());
+  CPPUNIT_ASSERT_EQUAL((size_t)60, buf.getBufferLength());
+  CPPUNIT_ASSERT_EQUAL((size_t)32_k, buf.getCapacity());
+}
+
+void SocketRecvBufferTest::testRecv_maxCapacity()
+{
+  SocketRecvBuffer::setMaxCapacity(24_k);
+  SocketRecvBuffer buf(inbound_);
+  send(16_k + 24_k);
+  CPPUNIT_ASSERT_EQUAL((ssize_t)16_k, buf.recv());
+  CPPUNIT_ASSERT_EQUAL((size_t)24_k, buf.getCapacity());
+  buf.truncateBuffer();
+  CPPUNIT_ASSERT_EQUAL((ssize_t)24_k, buf.recv());
+  CPPUNIT_ASSERT_EQUAL((size_t)24_k, buf.getCapacity());
+}
+
+void SocketRecvBufferTest::testDetachBuffer()
+{
+  SocketRecvBuffer buf(inbound_);
+  size_t offset, capacity;
+  CPPUNIT_ASSERT(!buf.detachBuffer(offset, capacity));
+
+  send(100);
+  buf.recv();
+  // Less than half full
+  CPPUNIT_ASSERT(!buf.detachBuffer(offset, capacity));
+  buf.truncateBuffer();
+
+  send(16_k);
+  CPPUNIT_ASSERT_EQUAL((ssize_t)16_k, buf.recv());
+  buf.drain(8_k);
+  auto data = buf.detachBuffer(offset, capacity);
+  CPPUNIT_ASSERT(data);
+  CPPUNIT_ASSERT_EQUAL((size_t)8_k, offset);
+  CPPUNIT_ASSERT_EQUAL((size_t)8_k, capacity);
+  CPPUNIT_ASSERT_EQUAL('a', (char)data[offset]);
+  CPPUNIT_ASSERT(buf.bufferEmpty());
+  CPPUNIT_ASSERT(!buf.getBuffer());
+}
+
+} // namespace aria2
@@ -0,0 +1,78 @@
+#include "SpscQueue.h"
+
+#ifdef HAVE_STD_THREAD
+#  include <thread>
+#endif // HAVE_STD_THREAD
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace aria2 {
+
+class SpscQueueTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(SpscQueueTest);
+  CPPUNIT_TEST(testPushPop);
+#ifdef HAVE_STD_THREAD
+  CPPUNIT_TEST(testPushPop_threads);
+#endif // HAVE_STD_THREAD
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testPushPop();
+#ifdef HAVE_STD_THREAD
+  void testPushPop_threads();
+#endif // HAVE_STD_THREAD
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SpscQueueTest);
+
+void SpscQueueTest::testPushPop()
+{
+  SpscQueue<int, 4> q;
+  int v;
+  CPPUNIT_ASSERT(!q.pop(v));
+  // Cross the boundary of blocks several times.
+  for (int i = 0; i < 10; ++i) {
+    q.push(i);
+  }
+  for (int i = 0; i < 7; ++i) {
+    CPPUNIT_ASSERT(q.pop(v));
+    CPPUNIT_ASSERT_EQUAL(i, v);
+  }
+  q.push(10);
+  for (int i = 7; i <= 10; ++i) {
+    CPPUNIT_ASSERT(q.pop(v));
+    CPPUNIT_ASSERT_EQUAL(i, v);
+  }
+  CPPUNIT_ASSERT(!q.pop(v));
+  q.push(11);
+  CPPUNIT_ASSERT(q.pop(v));
+  CPPUNIT_ASSERT_EQUAL(11, v);
+  CPPUNIT_ASSERT(!q.pop(v));
+}
+
+#ifdef HAVE_STD_THREAD
+void SpscQueueTest::testPushPop_threads()
+{
+  SpscQueue<int, 16> q;
+  const int numValues = 100000;
+  std::thread producer([&q]() {
+    for (int i = 0; i < numValues; ++i) {
+      q.push(i);
+    }
+  });
+  int expected = 0;
+  while (expected < numValues) {
+    int v;
+    if (q.pop(v)) {
+      CPPUNIT_ASSERT_EQUAL(expected, v);
+      ++expected;
+    }
+  }
+  producer.join();
+  int v;
+  CPPUNIT_ASSERT(!q.pop(v));
+}
+#endif // HAVE_STD_THREAD
+
+} // namespace aria2
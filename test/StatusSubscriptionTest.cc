@@ -0,0 +1,112 @@
+#include "StatusSubscription.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "DownloadEngine.h"
+#include "SelectEventPoll.h"
+#include "Option.h"
+#include "RequestGroupMan.h"
+#include "RequestGroup.h"
+#include "DownloadContext.h"
+#include "GroupId.h"
+#include "prefs.h"
+#include "TestUtil.h"
+
+namespace aria2 {
+
+namespace rpc {
+
+class StatusSubscriptionTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(StatusSubscriptionTest);
+  CPPUNIT_TEST(testCollectChanges);
+  CPPUNIT_TEST(testGetWait);
+  CPPUNIT_TEST_SUITE_END();
+
+  std::shared_ptr<DownloadEngine> e_;
+  std::shared_ptr<Option> option_;
+
+public:
+  void setUp()
+  {
+    option_ = std::make_shared<Option>();
+    option_->put(PREF_DIR, A2_TEST_OUT_DIR "/aria2_StatusSubscriptionTest");
+    e_ = make_unique<DownloadEngine>(make_unique<SelectEventPoll>());
+    e_->setOption(option_.get());
+    e_->setRequestGroupMan(make_unique<RequestGroupMan>(
+        std::vector<std::shared_ptr<RequestGroup>>{}, 1, option_.get()));
+  }
+
+  void testCollectChanges();
+  void testGetWait();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(StatusSubscriptionTest);
+
+namespace {
+const String* getString(const List* changes, size_t index,
+                        const std::string& key)
+{
+  return downcast<String>(downcast<Dict>(changes->get(index))->get(key));
+}
+} // namespace
+
+void StatusSubscriptionTest::testCollectChanges()
+{
+  StatusSubscription sub({"status", "dir"}, std::chrono::milliseconds(1000));
+  auto changes = sub.collectChanges(e_.get());
+  CPPUNIT_ASSERT(changes->empty());
+
+  auto group = std::make_shared<RequestGroup>(GroupId::create(), option_);
+  group->setDownloadContext(std::make_shared<DownloadContext>());
+  auto gid = GroupId::toHex(group->getGID());
+  e_->getRequestGroupMan()->addReservedGroup(group);
+
+  // The first report contains all requested fields.
+  changes = sub.collectChanges(e_.get());
+  CPPUNIT_ASSERT_EQUAL((size_t)1, changes->size());
+  CPPUNIT_ASSERT_EQUAL((size_t)3, downcast<Dict>(changes->get(0))->size());
+  CPPUNIT_ASSERT_EQUAL(gid, getString(changes.get(), 0, "gid")->s());
+  CPPUNIT_ASSERT_EQUAL(std::string("waiting"),
+                       getString(changes.get(), 0, "status")->s());
+  CPPUNIT_ASSERT_EQUAL(option_->get(PREF_DIR),
+                       getString(changes.get(), 0, "dir")->s());
+
+  // Nothing changed.
+  changes = sub.collectChanges(e_.get());
+  CPPUNIT_ASSERT(changes->empty());
+
+  // Only the changed field is reported.
+  group->setPauseRequested(true);
+  changes = sub.collectChanges(e_.get());
+  CPPUNIT_ASSERT_EQUAL((size_t)1, changes->size());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, downcast<Dict>(changes->get(0))->size());
+  CPPUNIT_ASSERT_EQUAL(gid, getString(changes.get(), 0, "gid")->s());
+  CPPUNIT_ASSERT_EQUAL(std::string("paused"),
+                       getString(changes.get(), 0, "status")->s());
+
+  // Removed without download result.
+  CPPUNIT_ASSERT(e_->getRequestGroupMan()->removeReservedGroup(
+      group->getGID()));
+  changes = sub.collectChanges(e_.get());
+  CPPUNIT_ASSERT_EQUAL((size_t)1, changes->size());
+  CPPUNIT_ASSERT_EQUAL(gid, getString(changes.get(), 0, "gid")->s());
+  CPPUNIT_ASSERT_EQUAL(std::string("removed"),
+                       getString(changes.get(), 0, "status")->s());
+
+  changes = sub.collectChanges(e_.get());
+  CPPUNIT_ASSERT(changes->empty());
+}
+
+void StatusSubscriptionTest::testGetWait()
+{
+  StatusSubscription sub({}, std::chrono::milliseconds(1000));
+  CPPUNIT_ASSERT(std::chrono::milliseconds(0) == sub.getWait());
+  sub.collectChanges(e_.get());
+  CPPUNIT_ASSERT(std::chrono::milliseconds(0) < sub.getWait());
+  CPPUNIT_ASSERT(std::chrono::milliseconds(1000) >= sub.getWait());
+}
+
+} // namespace rpc
+
+} // namespace aria2
@@ -19,6 +19,7 @@ class ValueBaseTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testList);
   CPPUNIT_TEST(testListIter);
   CPPUNIT_TEST(testDowncast);
+  CPPUNIT_TEST(testArena);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -32,6 +33,7 @@ public:
   void testList();
   void testListIter();
   void testDowncast();
+  void testArena();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ValueBaseTest);
@@ -181,4 +183,57 @@ void ValueBaseTest::testListIter()
   CPPUNIT_ASSERT(ref.end() == ci);
 }
 
+void ValueBaseTest::testArena()
+{
+  auto heapDict = Dict::g();
+  auto heapString = String::g("delta");
+  {
+    ValueBaseArena arena;
+    CPPUNIT_ASSERT(!ValueBaseArena::current());
+    ValueBaseArena::Scope scope(arena);
+    CPPUNIT_ASSERT(&arena == ValueBaseArena::current());
+    auto dict = Dict::g();
+    auto list = List::g();
+    for (int i = 0; i < 1000; ++i) {
+      list->append(Integer::g(i));
+    }
+    dict->put("list", std::move(list));
+    dict->put("string", std::string(100_k, 'a'));
+    dict->put("removed", String::g("foo"));
+    CPPUNIT_ASSERT(arena.getAllocatedLength() > 0);
+    CPPUNIT_ASSERT(arena.owns(dict.get()));
+    CPPUNIT_ASSERT(arena.owns(dict->get("string")));
+    CPPUNIT_ASSERT(!arena.owns(heapDict.get()));
+    {
+      ValueBaseArena inner;
+      ValueBaseArena::Scope innerScope(inner);
+      CPPUNIT_ASSERT(&inner == ValueBaseArena::current());
+      auto x = String::g("inner");
+      CPPUNIT_ASSERT(inner.getAllocatedLength() > 0);
+      CPPUNIT_ASSERT(inner.owns(x.get()));
+      CPPUNIT_ASSERT(!arena.owns(x.get()));
+      CPPUNIT_ASSERT(!inner.owns(dict.get()));
+      // Nodes of the outer arena are destroyed while the inner one is
+      // current.
+      dict->removeKey("removed");
+    }
+    CPPUNIT_ASSERT(&arena == ValueBaseArena::current());
+    CPPUNIT_ASSERT_EQUAL((size_t)1000,
+                         downcast<List>(dict->get("list"))->size());
+    CPPUNIT_ASSERT_EQUAL(
+        (Integer::ValueType)999,
+        downcast<Integer>(downcast<List>(dict->get("list"))->get(999))->i());
+    CPPUNIT_ASSERT_EQUAL((size_t)100_k,
+                         downcast<String>(dict->get("string"))->s().size());
+    // Containers created outside of the arena keep using the heap.
+    heapDict->put("null", std::unique_ptr<ValueBase>());
+    // Nodes on the heap are freed while the arena is alive.
+    heapString.reset();
+  }
+  CPPUNIT_ASSERT(!ValueBaseArena::current());
+  heapDict->put("alpha", String::g("bravo"));
+  CPPUNIT_ASSERT_EQUAL(std::string("bravo"),
+                       downcast<String>(heapDict->get("alpha"))->s());
+}
+
 } // namespace aria2
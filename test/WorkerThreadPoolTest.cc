@@ -0,0 +1,35 @@
+#include "WorkerThreadPool.h"
+
+#include <atomic>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace aria2 {
+
+class WorkerThreadPoolTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(WorkerThreadPoolTest);
+  CPPUNIT_TEST(testSubmit);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testSubmit();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(WorkerThreadPoolTest);
+
+void WorkerThreadPoolTest::testSubmit()
+{
+  std::atomic<int> sum(0);
+  {
+    WorkerThreadPool pool(3);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, pool.getNumThreads());
+    for (int i = 1; i <= 100; ++i) {
+      pool.submit([&sum, i]() { sum += i; });
+    }
+    // The destructor waits for all queued jobs.
+  }
+  CPPUNIT_ASSERT_EQUAL(5050, sum.load());
+}
+
+} // namespace aria2
@@ -7,6 +7,10 @@
 #include "TestUtil.h"
 #include "DirectDiskAdaptor.h"
 #include "ByteArrayDiskWriter.h"
+#include "DefaultDiskWriter.h"
+#include "DiskWriteQueue.h"
+#include "File.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
@@ -14,6 +18,8 @@ class WrDiskCacheTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(WrDiskCacheTest);
   CPPUNIT_TEST(testAdd);
+  CPPUNIT_TEST(testAdd_diskWriteQueue);
+  CPPUNIT_TEST(testFlush_timer);
   CPPUNIT_TEST_SUITE_END();
 
   std::shared_ptr<DirectDiskAdaptor> adaptor_;
@@ -29,6 +35,8 @@ public:
   }
 
   void testAdd();
+  void testAdd_diskWriteQueue();
+  void testFlush_timer();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(WrDiskCacheTest);
@@ -74,4 +82,75 @@ void WrDiskCacheTest::testAdd()
   CPPUNIT_ASSERT_EQUAL((size_t)0, dc.getSize());
 }
 
+void WrDiskCacheTest::testAdd_diskWriteQueue()
+{
+  std::string path =
+      A2_TEST_OUT_DIR "/aria2_WrDiskCacheTest_testAdd_diskWriteQueue";
+  File(path).remove();
+  auto adaptor = std::make_shared<DirectDiskAdaptor>();
+  adaptor->setDiskWriter(make_unique<DefaultDiskWriter>(path));
+  adaptor->openFile();
+  DiskWriteQueue queue(2, 1_m);
+  WrDiskCache dc(20);
+  dc.setDiskWriteQueue(&queue);
+  WrDiskCacheEntry e1(adaptor);
+  e1.cacheData(createDataCell(0, "who knows?"));
+  CPPUNIT_ASSERT(dc.add(&e1));
+
+  WrDiskCacheEntry e2(adaptor);
+  e2.cacheData(createDataCell(10, "hello"));
+  e2.cacheData(createDataCell(15, " world"));
+  CPPUNIT_ASSERT(dc.add(&e2));
+  // e2 is handed over to queue
+  CPPUNIT_ASSERT_EQUAL((size_t)0, e2.getSize());
+  CPPUNIT_ASSERT_EQUAL((size_t)10, dc.getSize());
+
+  e1.cacheData(createDataCell(21, "0123456789abc"));
+  CPPUNIT_ASSERT(dc.update(&e1, 13));
+  // e1 is handed over to queue
+  CPPUNIT_ASSERT_EQUAL((size_t)0, e1.getSize());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, dc.getSize());
+
+  e1.waitForPendingWrite();
+  e2.waitForPendingWrite();
+  CPPUNIT_ASSERT_EQUAL((size_t)0, queue.getPendingSize());
+  CPPUNIT_ASSERT_EQUAL((int)WrDiskCacheEntry::CACHE_ERR_SUCCESS,
+                       e1.getError());
+  CPPUNIT_ASSERT_EQUAL((int)WrDiskCacheEntry::CACHE_ERR_SUCCESS,
+                       e2.getError());
+  adaptor->closeFile();
+  CPPUNIT_ASSERT_EQUAL(std::string("who knows?hello world0123456789abc"),
+                       readFile(path));
+}
+
+void WrDiskCacheTest::testFlush_timer()
+{
+  WrDiskCache dc(1_m);
+  WrDiskCacheEntry e1(adaptor_);
+  e1.cacheData(createDataCell(0, "hello"));
+  CPPUNIT_ASSERT(dc.add(&e1));
+  WrDiskCacheEntry e2(adaptor_);
+  e2.cacheData(createDataCell(5, " world"));
+  CPPUNIT_ASSERT(dc.add(&e2));
+  WrDiskCacheEntry e3(adaptor_);
+  e3.cacheData(createDataCell(20, "bar"));
+  CPPUNIT_ASSERT(dc.add(&e3));
+  CPPUNIT_ASSERT_EQUAL((size_t)14, dc.getSize());
+  CPPUNIT_ASSERT_EQUAL(std::string(), writer_->getString());
+
+  global::wallclock().advance(11_s);
+  e2.cacheData(createDataCell(11, "foo"));
+  CPPUNIT_ASSERT(dc.update(&e2, 3));
+  global::wallclock().reset();
+  // All entries are flushed together, and the data of e1 and e2 are
+  // written as one contiguous range.
+  CPPUNIT_ASSERT_EQUAL((size_t)0, dc.getSize());
+  CPPUNIT_ASSERT_EQUAL(std::string("hello worldfoo\0\0\0\0\0\0bar", 23),
+                       writer_->getString());
+  auto& stat = dc.getStat();
+  CPPUNIT_ASSERT_EQUAL((uint64_t)1, stat.numFlushes);
+  CPPUNIT_ASSERT_EQUAL((uint64_t)2, stat.numWrites);
+  CPPUNIT_ASSERT_EQUAL((uint64_t)17, stat.numBytes);
+}
+
 } // namespace aria2
@@ -1,5 +1,7 @@
 #include "bitfield.h"
 
+#include <vector>
+
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "TimerA2.h"
@@ -13,6 +15,10 @@ class bitfieldTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testCountBit32);
   CPPUNIT_TEST(testCountSetBit);
   CPPUNIT_TEST(testLastByteMask);
+  CPPUNIT_TEST(testCountBit64);
+  CPPUNIT_TEST(testCountSetBitAnd);
+  CPPUNIT_TEST(testForEachSetBit);
+  CPPUNIT_TEST(testForEachDiffBit);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -21,6 +27,10 @@ public:
   void testCountBit32();
   void testCountSetBit();
   void testLastByteMask();
+  void testCountBit64();
+  void testCountSetBitAnd();
+  void testForEachSetBit();
+  void testForEachDiffBit();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(bitfieldTest);
@@ -71,4 +81,64 @@ void bitfieldTest::testLastByteMask()
                        (unsigned int)bitfield::lastByteMask(16));
 }
 
+void bitfieldTest::testCountBit64()
+{
+  CPPUNIT_ASSERT_EQUAL((size_t)64, bitfield::countBit64(UINT64_MAX));
+  CPPUNIT_ASSERT_EQUAL((size_t)9, bitfield::countBit64(0x80000000000000ffULL));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, bitfield::countBit64(0));
+}
+
+void bitfieldTest::testCountSetBitAnd()
+{
+  unsigned char a[20], b[20];
+  memset(a, 0xff, sizeof(a));
+  memset(b, 0x0f, sizeof(b));
+  CPPUNIT_ASSERT_EQUAL((size_t)80, bitfield::countSetBitAnd(a, b, 160));
+  CPPUNIT_ASSERT_EQUAL((size_t)76, bitfield::countSetBitAnd(a, b, 156));
+  CPPUNIT_ASSERT_EQUAL((size_t)72, bitfield::countSetBitAnd(a, b, 148));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, bitfield::countSetBitAnd(a, b, 4));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, bitfield::countSetBitAnd(a, b, 0));
+}
+
+void bitfieldTest::testForEachSetBit()
+{
+  unsigned char bf[20];
+  memset(bf, 0, sizeof(bf));
+  size_t expected[] = {0, 7, 70, 129, 150, 155};
+  for (auto i : expected) {
+    bitfield::flipBit(bf, sizeof(bf), i);
+  }
+  // Bit 159 is set but outside of nbits.
+  bitfield::flipBit(bf, sizeof(bf), 159);
+  std::vector<size_t> res;
+  bitfield::forEachSetBit(bf, 156, [&res](size_t i) { res.push_back(i); });
+  CPPUNIT_ASSERT(std::vector<size_t>(std::begin(expected),
+                                     std::end(expected)) == res);
+  res.clear();
+  bitfield::forEachSetBit(bf, 0, [&res](size_t i) { res.push_back(i); });
+  CPPUNIT_ASSERT(res.empty());
+}
+
+void bitfieldTest::testForEachDiffBit()
+{
+  unsigned char a[20], b[20];
+  memset(a, 0xaa, sizeof(a));
+  memcpy(b, a, sizeof(b));
+  // set in a only
+  bitfield::flipBit(b, sizeof(b), 64);
+  // set in b only
+  bitfield::flipBit(b, sizeof(b), 65);
+  bitfield::flipBit(b, sizeof(b), 153);
+  // outside of nbits
+  bitfield::flipBit(b, sizeof(b), 155);
+  std::vector<std::pair<size_t, bool>> res;
+  bitfield::forEachDiffBit(a, b, 154, [&res](size_t i, bool inA) {
+    res.push_back(std::make_pair(i, inA));
+  });
+  CPPUNIT_ASSERT_EQUAL((size_t)3, res.size());
+  CPPUNIT_ASSERT(std::make_pair((size_t)64, true) == res[0]);
+  CPPUNIT_ASSERT(std::make_pair((size_t)65, false) == res[1]);
+  CPPUNIT_ASSERT(std::make_pair((size_t)153, false) == res[2]);
+}
+
 } // namespace aria2